@@ -36,7 +36,395 @@
 #include <dwmapi.h>         // 用于DWM API
 #pragma comment(lib, "dwmapi.lib")  // 链接DWM库
 
+#include <unordered_map>
+#include <list>
+#include <mutex>
+#include "OtterDisplayList.h"    // 可移植CPU光栅化后端、显示列表与损坏区域
+#include "OtterLruCache.h"      // 字体/画刷/画笔缓存
+#include "OtterBlit.h"          // 预乘图像SIMD合成
+#include "OtterConvert.h"       // 图片像素格式转换
+#include "OtterMip.h"           // 缩放图片的 mip 级与缩放结果缓存
+#include "OtterDecodeQueue.h"   // 后台图片解码
+#include "OtterAssetPack.h"     // 预解码图片资源包
+#include "OtterAtlas.h"         // 小图片精灵图集
+#include "OtterTiles.h"          // 显示列表分块并行光栅化
+#include "OtterFrameScheduler.h" // 动画帧调度
+#include "OtterTrace.h"          // 帧追踪（定义 OTTER_TRACING 后启用）
+#include "OtterGradient.h"       // 线性/径向渐变画刷
+
 namespace OtterWindow {
+    // 创建32位自顶向下DIB作为后备缓冲区，bits 返回像素指针（GDI+与软件光栅化共用）
+    inline HBITMAP CreateBackBufferDIB(HDC hdc, int width, int height, void** bits) {
+        BITMAPINFO bmi = {};
+        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth = max(width, 1);
+        bmi.bmiHeader.biHeight = -max(height, 1);
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+        return CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, bits, NULL, 0);
+    }
+
+    // 池化的后备缓冲区：32位预乘DIB + 内存DC + GDI+绘图对象
+    struct BackBuffer {
+        HDC dc = NULL;
+        HBITMAP bitmap = NULL;
+        HBITMAP oldBitmap = NULL;
+        void* bits = nullptr;
+        int capacityWidth = 0, capacityHeight = 0;     // 实际分配尺寸
+        std::unique_ptr<Gdiplus::Graphics> graphics;
+        OtterRaster::Surface surface;                  // 包装请求尺寸的像素
+
+        int Width() const { return surface.Width(); }
+        int Height() const { return surface.Height(); }
+
+        ~BackBuffer() {
+            graphics.reset();
+            if (dc) {
+                SelectObject(dc, oldBitmap);
+                DeleteDC(dc);
+            }
+            if (bitmap) DeleteObject(bitmap);
+        }
+    };
+
+    // 进程内共享的GDI+初始化：第一个实例调用 GdiplusStartup，最后一个析构时 GdiplusShutdown。
+    // 作为成员时应声明在其他持有GDI+对象的成员之前，保证这些对象先析构
+    class GdiplusSession {
+    public:
+        GdiplusSession() { Acquire(); }
+        ~GdiplusSession() { Release(); }
+        GdiplusSession(const GdiplusSession&) { Acquire(); }
+        GdiplusSession& operator=(const GdiplusSession&) { return *this; }
+
+        static int RefCount() {
+            State& state = GetState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            return state.count;
+        }
+
+        // 最后一个会话释放、GdiplusShutdown 之前调用 hook，用于释放缓存的GDI+对象；owner 用于注销
+        static void AddShutdownHook(const void* owner, std::function<void()> hook) {
+            State& state = GetState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.hooks.emplace_back(owner, std::move(hook));
+        }
+
+        static void RemoveShutdownHook(const void* owner) {
+            State& state = GetState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.hooks.erase(std::remove_if(state.hooks.begin(), state.hooks.end(),
+                [owner](const std::pair<const void*, std::function<void()>>& h) { return h.first == owner; }),
+                state.hooks.end());
+        }
+
+    private:
+        struct State {
+            std::mutex mutex;
+            int count = 0;
+            ULONG_PTR token = 0;
+            std::vector<std::pair<const void*, std::function<void()>>> hooks;
+        };
+
+        static State& GetState() {
+            static State state;
+            return state;
+        }
+
+        static void Acquire() {
+            State& state = GetState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (state.count++ == 0) {
+                Gdiplus::GdiplusStartupInput input;
+                Gdiplus::GdiplusStartup(&state.token, &input, NULL);
+            }
+        }
+
+        static void Release() {
+            State& state = GetState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (--state.count == 0) {
+                for (auto& hook : state.hooks) hook.second();
+                Gdiplus::GdiplusShutdown(state.token);
+                state.token = 0;
+            }
+        }
+    };
+
+    // 后备缓冲区池：按尺寸档位（向上取整到 kGranularity）复用，避免每帧创建DC/位图/Graphics，
+    // 窗口缩放时同一档位内的尺寸变化也不重新分配
+    class BackBufferPool {
+    public:
+        static constexpr int kGranularity = 64;
+
+        struct Stats {
+            size_t created = 0;     // 新建缓冲区次数
+            size_t reused = 0;      // 从池中复用次数
+            size_t evicted = 0;     // 超出上限被释放的次数
+            size_t cached = 0;      // 当前池中空闲缓冲区数
+            size_t cachedBytes = 0; // 空闲缓冲区像素字节数
+        };
+
+        static BackBufferPool& Instance() {
+            static BackBufferPool pool;
+            return pool;
+        }
+
+        // 获取至少 width x height 的缓冲区，Graphics 状态已重置（无裁剪、无变换）
+        std::unique_ptr<BackBuffer> Acquire(int width, int height) {
+            width = max(width, 1);
+            height = max(height, 1);
+            const int cw = RoundUp(width), ch = RoundUp(height);
+            std::unique_ptr<BackBuffer> buffer;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (size_t i = m_free.size(); i-- > 0;) {
+                    if (m_free[i]->capacityWidth == cw && m_free[i]->capacityHeight == ch) {
+                        buffer = std::move(m_free[i]);
+                        m_free.erase(m_free.begin() + i);
+                        ++m_stats.reused;
+                        break;
+                    }
+                }
+                if (!buffer) ++m_stats.created;
+            }
+
+            if (!buffer) {
+                buffer = std::make_unique<BackBuffer>();
+                buffer->dc = CreateCompatibleDC(NULL);
+                buffer->bitmap = CreateBackBufferDIB(buffer->dc, cw, ch, &buffer->bits);
+                buffer->oldBitmap = (HBITMAP)SelectObject(buffer->dc, buffer->bitmap);
+                buffer->capacityWidth = cw;
+                buffer->capacityHeight = ch;
+                buffer->graphics = std::make_unique<Gdiplus::Graphics>(buffer->dc);
+            }
+            else {
+                buffer->graphics->ResetClip();
+                buffer->graphics->ResetTransform();
+                buffer->graphics->SetCompositingMode(Gdiplus::CompositingModeSourceOver);
+            }
+
+            buffer->surface = buffer->bits
+                ? OtterRaster::Surface::Wrap(buffer->bits, width, height, cw * 4)
+                : OtterRaster::Surface();
+            return buffer;
+        }
+
+        // 归还缓冲区；空闲数超过上限时释放最久未用的
+        void Release(std::unique_ptr<BackBuffer> buffer) {
+            if (!buffer) return;
+            buffer->graphics->Flush(Gdiplus::FlushIntentionSync);
+            std::vector<std::unique_ptr<BackBuffer>> evicted;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_free.push_back(std::move(buffer));
+                while (m_free.size() > m_maxCached) {
+                    evicted.push_back(std::move(m_free.front()));
+                    m_free.erase(m_free.begin());
+                    ++m_stats.evicted;
+                }
+            }
+        }
+
+        void SetMaxCached(size_t count) {
+            std::vector<std::unique_ptr<BackBuffer>> evicted;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_maxCached = count;
+            while (m_free.size() > m_maxCached) {
+                evicted.push_back(std::move(m_free.front()));
+                m_free.erase(m_free.begin());
+                ++m_stats.evicted;
+            }
+        }
+
+        // 释放所有空闲缓冲区
+        void Clear() {
+            std::vector<std::unique_ptr<BackBuffer>> released;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            released.swap(m_free);
+        }
+
+        Stats GetStats() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Stats s = m_stats;
+            s.cached = m_free.size();
+            for (const auto& b : m_free) s.cachedBytes += size_t(b->capacityWidth) * b->capacityHeight * 4;
+            return s;
+        }
+
+        static int RoundUp(int v) { return (v + kGranularity - 1) / kGranularity * kGranularity; }
+
+    private:
+        BackBufferPool() = default;
+
+        ~BackBufferPool() {
+            m_free.clear();
+        }
+
+        GdiplusSession m_gdiplus;      // 池持有自己的GDI+引用，保证缓冲区中的 Graphics 在GDI+关闭前释放
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<BackBuffer>> m_free;   // 末尾为最近归还
+        size_t m_maxCached = 4;
+        Stats m_stats;
+    };
+
+    // 字体/画刷/画笔句柄：热循环中用句柄绘制可跳过哈希查找
+    struct FontTag {};
+    struct BrushTag {};
+    struct PenTag {};
+    using FontHandle = OtterCache::Handle<FontTag>;
+    using BrushHandle = OtterCache::Handle<BrushTag>;
+    using PenHandle = OtterCache::Handle<PenTag>;
+
+    struct FontKey {
+        std::wstring family;
+        float size = 0.0f;
+        int style = Gdiplus::FontStyleRegular;
+        bool operator==(const FontKey& o) const { return size == o.size && style == o.style && family == o.family; }
+    };
+
+    struct FontKeyHash {
+        size_t operator()(const FontKey& k) const {
+            size_t h = std::hash<std::wstring>()(k.family);
+            h ^= std::hash<float>()(k.size) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h ^ (static_cast<size_t>(k.style) * 0x9e3779b1u);
+        }
+    };
+
+    struct PenKey {
+        Gdiplus::ARGB color = 0;
+        float width = 1.0f;
+        bool operator==(const PenKey& o) const { return color == o.color && width == o.width; }
+    };
+
+    struct PenKeyHash {
+        size_t operator()(const PenKey& k) const {
+            return std::hash<uint64_t>()((uint64_t(k.color) << 32) ^ std::hash<float>()(k.width));
+        }
+    };
+
+    // 缓存条目同时保存参数，软件后端用句柄绘制时无需查询GDI+对象
+    struct CachedFont {
+        std::unique_ptr<Gdiplus::Font> font;
+        float size = 0.0f;
+    };
+
+    struct CachedBrush {
+        std::unique_ptr<Gdiplus::SolidBrush> brush;
+        Gdiplus::Color color;
+    };
+
+    struct CachedPen {
+        std::unique_ptr<Gdiplus::Pen> pen;
+        Gdiplus::Color color;
+        float width = 1.0f;
+    };
+
+    // GDI+ 字体/纯色画刷/画笔缓存：按 (字体名, 字号, 样式) 与 (颜色, 线宽) 缓存，LRU 淘汰。
+    // 通过 Acquire* 得到的句柄会固定条目，直到 Release。每个线程一份（多个UI线程互不影响，句柄不能跨线程使用）；
+    // 须在持有 GdiplusSession 期间使用，最后一个会话关闭GDI+前自动清空
+    class GdiResourceCache {
+    public:
+        struct Stats {
+            OtterCache::CacheStats fonts, brushes, pens;
+        };
+
+        static GdiResourceCache& Instance() {
+            thread_local GdiResourceCache cache;
+            return cache;
+        }
+
+        Gdiplus::Font* GetFont(const std::wstring& family, float size, int style = Gdiplus::FontStyleRegular) {
+            return m_fonts.Get(FontKey{ family, size, style }, [&] { return MakeFont(family, size, style); })->font.get();
+        }
+
+        Gdiplus::SolidBrush* GetBrush(const Gdiplus::Color& color) {
+            return m_brushes.Get(color.GetValue(), [&] { return MakeBrush(color); })->brush.get();
+        }
+
+        Gdiplus::Pen* GetPen(const Gdiplus::Color& color, float width = 1.0f) {
+            return m_pens.Get(PenKey{ color.GetValue(), width }, [&] { return MakePen(color, width); })->pen.get();
+        }
+
+        FontHandle AcquireFont(const std::wstring& family, float size, int style = Gdiplus::FontStyleRegular) {
+            return m_fonts.Acquire(FontKey{ family, size, style }, [&] { return MakeFont(family, size, style); });
+        }
+
+        BrushHandle AcquireBrush(const Gdiplus::Color& color) {
+            return m_brushes.Acquire(color.GetValue(), [&] { return MakeBrush(color); });
+        }
+
+        PenHandle AcquirePen(const Gdiplus::Color& color, float width = 1.0f) {
+            return m_pens.Acquire(PenKey{ color.GetValue(), width }, [&] { return MakePen(color, width); });
+        }
+
+        // 句柄解析：已 Release 或 Clear 的句柄返回 nullptr
+        CachedFont* Resolve(FontHandle h) { return m_fonts.Resolve(h); }
+        CachedBrush* Resolve(BrushHandle h) { return m_brushes.Resolve(h); }
+        CachedPen* Resolve(PenHandle h) { return m_pens.Resolve(h); }
+
+        void Release(FontHandle h) { m_fonts.Release(h); }
+        void Release(BrushHandle h) { m_brushes.Release(h); }
+        void Release(PenHandle h) { m_pens.Release(h); }
+
+        void SetCapacity(size_t fonts, size_t brushes, size_t pens) {
+            m_fonts.SetCapacity(fonts);
+            m_brushes.SetCapacity(brushes);
+            m_pens.SetCapacity(pens);
+        }
+
+        // 释放全部缓存对象（已发出的句柄失效）
+        void Clear() {
+            m_fonts.Clear();
+            m_brushes.Clear();
+            m_pens.Clear();
+        }
+
+        Stats GetStats() const { return Stats{ m_fonts.Stats(), m_brushes.Stats(), m_pens.Stats() }; }
+
+        void ResetStats() {
+            m_fonts.ResetStats();
+            m_brushes.ResetStats();
+            m_pens.ResetStats();
+        }
+
+    private:
+        GdiResourceCache() {
+            GdiplusSession::AddShutdownHook(this, [this] { Clear(); });
+        }
+
+        ~GdiResourceCache() {
+            GdiplusSession::RemoveShutdownHook(this);
+            Clear();
+        }
+
+        static CachedFont MakeFont(const std::wstring& family, float size, int style) {
+            CachedFont f;
+            f.font = std::make_unique<Gdiplus::Font>(family.c_str(), size, style);
+            f.size = size;
+            return f;
+        }
+
+        static CachedBrush MakeBrush(const Gdiplus::Color& color) {
+            CachedBrush b;
+            b.brush = std::make_unique<Gdiplus::SolidBrush>(color);
+            b.color = color;
+            return b;
+        }
+
+        static CachedPen MakePen(const Gdiplus::Color& color, float width) {
+            CachedPen p;
+            p.pen = std::make_unique<Gdiplus::Pen>(color, width);
+            p.color = color;
+            p.width = width;
+            return p;
+        }
+
+        OtterCache::LruCache<FontKey, CachedFont, FontKeyHash, FontTag> m_fonts{ 64 };
+        OtterCache::LruCache<Gdiplus::ARGB, CachedBrush, std::hash<Gdiplus::ARGB>, BrushTag> m_brushes{ 256 };
+        OtterCache::LruCache<PenKey, CachedPen, PenKeyHash, PenTag> m_pens{ 256 };
+    };
+
     //页面函数
     class OtterWin {
     private:
@@ -54,13 +442,16 @@ namespace OtterWindow {
         bool isTrackingMouse = false;
         bool isLayeredWindow = false; // 标记是否为分层窗口
 
-        // GDI+支持
-        ULONG_PTR gdiplusToken;
-        Gdiplus::GdiplusStartupInput gdiplusStartupInput;
+        // GDI+支持：与渲染器共享一次初始化，最后一个会话关闭前清空资源缓存
+        GdiplusSession m_gdiplus;
 
         // 回调函数存储
         std::function<void()> onPaintCallback;
 
+        // 动画帧调度：消息循环在同步点之间等待消息或定时器，没有动画时无限等待
+        OtterAnim::FrameScheduler m_frames;
+        HANDLE m_frameTimer = NULL;
+
         // 按键处理
         std::map<UINT, std::function<void()>> keyDownCallbacks;    // 按键按下
         std::map<UINT, std::function<void()>> keyUpCallbacks;      // 按键释放
@@ -146,7 +537,9 @@ namespace OtterWindow {
                     // 绘制消息
                 case WM_PAINT:
                     if (pThis->onPaintCallback) {
+                        OTTER_TRACE_FRAME("RB");
                         pThis->onPaintCallback();
+                        ValidateRect(hwnd, NULL);   // 否则系统持续发送 WM_PAINT，消息循环无法空闲
                         return 0;
                     }
                     break;
@@ -154,6 +547,7 @@ namespace OtterWindow {
                     // 键盘消息
                 case WM_KEYDOWN:
                     if (pThis->keyDownCallbacks.find(wParam) != pThis->keyDownCallbacks.end()) {
+                        OTTER_TRACE_SCOPE("input", "OnKeyDown");
                         pThis->keyDownCallbacks[wParam]();
                         pThis->keyPressTimes[wParam] = std::chrono::steady_clock::now();
                     }
@@ -161,6 +555,7 @@ namespace OtterWindow {
 
                 case WM_KEYUP:
                     if (pThis->keyUpCallbacks.find(wParam) != pThis->keyUpCallbacks.end()) {
+                        OTTER_TRACE_SCOPE("input", "OnKeyUp");
                         pThis->keyUpCallbacks[wParam]();
                         pThis->keyPressTimes.erase(wParam);
                     }
@@ -187,12 +582,14 @@ namespace OtterWindow {
                         }
                     }
                     if (pThis->onMouseMove) {
+                        OTTER_TRACE_SCOPE("input", "OnMouseMove");
                         pThis->onMouseMove(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
                     }
                     break;
 
                 case WM_LBUTTONDOWN:
                     if (pThis->onLeftDown) {
+                        OTTER_TRACE_SCOPE("input", "OnLeftDown");
                         pThis->onLeftDown(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
                     }
                     // 添加长按检测
@@ -213,24 +610,28 @@ namespace OtterWindow {
                     KillTimer(hwnd, 1); // 取消长按计时器
                     pThis->EndDrag();
                     if (pThis->onLeftUp) {
+                        OTTER_TRACE_SCOPE("input", "OnLeftUp");
                         pThis->onLeftUp(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
                     }
                     break;
 
                 case WM_RBUTTONDOWN:
                     if (pThis->onRightDown) {
+                        OTTER_TRACE_SCOPE("input", "OnRightDown");
                         pThis->onRightDown(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
                     }
                     break;
 
                 case WM_RBUTTONUP:
                     if (pThis->onRightUp) {
+                        OTTER_TRACE_SCOPE("input", "OnRightUp");
                         pThis->onRightUp(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
                     }
                     break;
 
                 case WM_MOUSEWHEEL:
                     if (pThis->onMouseWheel) {
+                        OTTER_TRACE_SCOPE("input", "OnMouseWheel");
                         pThis->onMouseWheel(GET_WHEEL_DELTA_WPARAM(wParam) / WHEEL_DELTA);
                     }
                     break;
@@ -318,6 +719,38 @@ namespace OtterWindow {
             onPaintCallback = callback;
         }
 
+        /******************** 动画功能 ********************/
+        // 请求动画回调：消息循环按目标帧率每帧调用一次（返回 false 结束），随后同步重绘窗口
+        OtterAnim::FrameScheduler::Id RequestAnimation(OtterAnim::FrameScheduler::Callback callback) {
+            return m_frames.Request(std::move(callback));
+        }
+
+        bool CancelAnimation(OtterAnim::FrameScheduler::Id id) { return m_frames.Cancel(id); }
+
+        // 在下一个同步点重绘一次（比 InvalidateRect 更平稳：与动画帧对齐，同一帧内多次请求只绘制一次）
+        void RequestFrame() { m_frames.RequestFrame(); }
+
+        // 目标帧率，默认60
+        void SetFrameRate(double framesPerSecond) { m_frames.SetTargetRate(framesPerSecond); }
+
+        // 按DWM报告的显示器刷新率与最近一次垂直同步时刻设置帧率与同步相位；DWM不可用时返回 false
+        bool SyncFrameRateToDisplay() {
+            DWM_TIMING_INFO timing = {};
+            timing.cbSize = sizeof(timing);
+            LARGE_INTEGER frequency;
+            if (FAILED(DwmGetCompositionTimingInfo(NULL, &timing)) || !QueryPerformanceFrequency(&frequency)) return false;
+            if (timing.rateRefresh.uiDenominator == 0 || timing.rateRefresh.uiNumerator == 0) return false;
+            m_frames.SetTargetRate(double(timing.rateRefresh.uiNumerator) / timing.rateRefresh.uiDenominator);
+            // steady_clock 与 QueryPerformanceCounter 同源，换算为微秒即可作为同步相位
+            m_frames.SetPhase(static_cast<int64_t>(double(timing.qpcVBlank) * 1e6 / double(frequency.QuadPart)));
+            return true;
+        }
+
+        // 帧数、超出帧预算的帧数、错过的同步点与每帧耗时
+        const OtterAnim::FrameStats& GetFrameStats() const { return m_frames.GetStats(); }
+
+        OtterAnim::FrameScheduler& GetFrameScheduler() { return m_frames; }
+
         /******************** 键盘功能 ********************/
         // 设置按键按下回调
         void OnKeyDown(int vkCode, std::function<void()> callback) {
@@ -380,12 +813,10 @@ namespace OtterWindow {
         }
 
         /******************** 构造/析构 ********************/
-        OtterWin(HWND hwnd):hwndr(hwnd) {
-            Gdiplus::GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, NULL);
-        }
+        OtterWin(HWND hwnd):hwndr(hwnd) {}
 
         ~OtterWin() {
-            Gdiplus::GdiplusShutdown(gdiplusToken);
+            if (m_frameTimer) CloseHandle(m_frameTimer);
         }
 
         void SetWindowAlpha(BYTE alpha) {
@@ -395,20 +826,20 @@ namespace OtterWindow {
             RECT rect;
             GetClientRect(hwndr, &rect);
 
-            // 创建兼容DC
+            // 从缓冲区池获取DC与位图
             HDC hdc = GetDC(hwndr);
-            HDC memDC = CreateCompatibleDC(hdc);
-            HBITMAP hBitmap = CreateCompatibleBitmap(hdc, rect.right, rect.bottom);
-            HBITMAP hOldBitmap = (HBITMAP)SelectObject(memDC, hBitmap);
+            std::unique_ptr<BackBuffer> buffer = BackBufferPool::Instance().Acquire(rect.right, rect.bottom);
+            HDC memDC = buffer->dc;
 
             // 使用GDI+绘制内容
             {
-                Gdiplus::Graphics graphics(memDC);
+                Gdiplus::Graphics& graphics = *buffer->graphics;
                 graphics.Clear(Gdiplus::Color(alpha, 0, 0, 0)); // 设置背景色和透明度
 
                 // 这里可以添加其他绘制内容
                 Gdiplus::SolidBrush brush(Gdiplus::Color(255, 255, 0, 0)); // 红色
                 graphics.FillRectangle(&brush, 50, 50, 200, 100);
+                graphics.Flush(Gdiplus::FlushIntentionSync);
             }
 
             // 更新分层窗口
@@ -421,10 +852,8 @@ namespace OtterWindow {
                 memDC, &ptSrc, 0, &blend, ULW_ALPHA
             );
 
-            // 清理资源
-            SelectObject(memDC, hOldBitmap);
-            DeleteObject(hBitmap);
-            DeleteDC(memDC);
+            // 归还缓冲区
+            BackBufferPool::Instance().Release(std::move(buffer));
             ReleaseDC(hwndr, hdc);
         }
 
@@ -445,70 +874,1120 @@ namespace OtterWindow {
 
     private:
         void MsgBegin() {
-            while (GetMessage(&msg, NULL, 0, 0) > 0) {
-                TranslateMessage(&msg);
-                DispatchMessage(&msg);
+            m_frames.SetFrameHandler([this](const OtterAnim::FrameInfo&) {
+                OTTER_TRACE_SCOPE("anim", "Redraw");
+                if (hwndr) RedrawWindow(hwndr, NULL, NULL, RDW_INVALIDATE | RDW_UPDATENOW);
+            });
+            for (;;) {
+                while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+                    if (msg.message == WM_QUIT) return;
+                    TranslateMessage(&msg);
+                    DispatchMessage(&msg);
+                }
+                m_frames.Tick();
+                WaitForNextFrame();
+            }
+        }
+
+        // 没有动画时无限等待消息；有动画时用高精度可等待定时器等到下一帧，期间有消息立即返回（不忙等）
+        void WaitForNextFrame() {
+            const int64_t timeout = m_frames.TimeoutMicros();
+            if (timeout == 0) return;
+            if (timeout < 0) {
+                MsgWaitForMultipleObjectsEx(0, NULL, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+                return;
+            }
+            if (!m_frameTimer) {
+                const DWORD highResolution = 0x00000002;    // CREATE_WAITABLE_TIMER_HIGH_RESOLUTION（Windows 10 1803 起）
+                m_frameTimer = CreateWaitableTimerExW(NULL, NULL, highResolution, TIMER_ALL_ACCESS);
+                if (!m_frameTimer) m_frameTimer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+            }
+            LARGE_INTEGER due;
+            due.QuadPart = -timeout * 10;   // 相对时间，单位100纳秒
+            if (m_frameTimer && SetWaitableTimer(m_frameTimer, &due, 0, NULL, NULL, FALSE)) {
+                MsgWaitForMultipleObjectsEx(1, &m_frameTimer, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            }
+            else {
+                MsgWaitForMultipleObjectsEx(0, NULL, DWORD((timeout + 999) / 1000), QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            }
+        }
+    };
+
+    // 绘制后端：GDI+ 或内置CPU光栅化（OtterRaster）
+    enum class PaintBackend {
+        GdiPlus,
+        Software
+    };
+
+    // Gdiplus颜色转光栅化颜色
+    inline OtterRaster::Color ToRasterColor(const Gdiplus::Color& c) {
+        return OtterRaster::Color(c.GetA(), c.GetR(), c.GetG(), c.GetB());
+    }
+
+    // 帧耗时叠加图：最近各帧（OTTER_TRACE_FRAME 记录，默认为每次 RB 回调）的耗时柱状图，
+    // 超出 budgetMs 的帧标红，附平均与最大值。未开启追踪时没有数据，只绘制底板
+    inline void DrawFrameTimeOverlay(OtterRaster::Canvas& canvas, int x, int y, int width, int height, float budgetMs = 1000.0f / 60.0f) {
+        const std::vector<float> frames = OtterTrace::Tracer::Instance().Frames().Snapshot();
+        canvas.FillRectangle(x, y, width, height, OtterRaster::Color(180, 16, 16, 16));
+        const int chartTop = y + 16, chartHeight = height - 18;
+        if (chartHeight <= 4 || width <= 4) return;
+
+        float worst = budgetMs, total = 0.0f;
+        for (float ms : frames) {
+            worst = max(worst, ms);
+            total += ms;
+        }
+        const float scale = chartHeight / (worst * 1.1f);
+        const int bars = min((int)frames.size(), width - 4);
+        for (int i = 0; i < bars; ++i) {
+            const float ms = frames[frames.size() - bars + i];
+            const int h = max(1, (int)(ms * scale));
+            const OtterRaster::Color color = ms > budgetMs ? OtterRaster::Color(255, 230, 70, 60) : OtterRaster::Color(255, 80, 200, 120);
+            canvas.FillRectangle(x + 2 + i, chartTop + chartHeight - h, 1, h, color);
+        }
+        const int budgetY = chartTop + chartHeight - (int)(budgetMs * scale);
+        canvas.FillRectangle(x + 2, budgetY, width - 4, 1, OtterRaster::Color(160, 255, 255, 255));
+
+        wchar_t text[96];
+        const float average = frames.empty() ? 0.0f : total / frames.size();
+        const float last = frames.empty() ? 0.0f : frames.back();
+        swprintf_s(text, L"%.1f ms  avg %.1f  max %.1f", last, average, frames.empty() ? 0.0f : worst);
+        canvas.DrawString(text, wcslen(text), float(x + 4), float(y + 2), 8.0f, OtterRaster::Color(255, 255, 255, 255));
+    }
+
+    // GDI+像素格式对应的转换内核；不在其中的格式（48/64位、16位灰度等）交给GDI+转换
+    inline bool ToSourceFormat(Gdiplus::PixelFormat format, OtterRaster::Convert::SourceFormat& out) {
+        using OtterRaster::Convert::SourceFormat;
+        switch (format) {
+        case PixelFormat32bppPARGB: out = SourceFormat::Bgra32Premultiplied; return true;
+        case PixelFormat32bppARGB: out = SourceFormat::Bgra32; return true;
+        case PixelFormat32bppRGB: out = SourceFormat::Bgrx32; return true;
+        case PixelFormat24bppRGB: out = SourceFormat::Bgr24; return true;
+        case PixelFormat16bppRGB565: out = SourceFormat::Bgr565; return true;
+        case PixelFormat16bppRGB555: out = SourceFormat::Bgr555; return true;
+        case PixelFormat8bppIndexed: out = SourceFormat::Indexed8; return true;
+        case PixelFormat4bppIndexed: out = SourceFormat::Indexed4; return true;
+        case PixelFormat1bppIndexed: out = SourceFormat::Indexed1; return true;
+        default: return false;
+        }
+    }
+
+    // 位图转换为32位预乘像素（行按64字节对齐）：常见格式按原格式锁定后由 OtterConvert 转换，
+    // 其余格式由GDI+直接写入 surface 的内存
+    inline bool CopyBitmapToSurface(Gdiplus::Bitmap& bitmap, OtterRaster::Surface& surface) {
+        const int w = (int)bitmap.GetWidth(), h = (int)bitmap.GetHeight();
+        if (w <= 0 || h <= 0) return false;
+        Gdiplus::Rect rect(0, 0, w, h);
+
+        OtterRaster::Convert::SourceFormat format;
+        const Gdiplus::PixelFormat native = bitmap.GetPixelFormat();
+        if (ToSourceFormat(native, format)) {
+            uint32_t palette[256];
+            if (OtterRaster::Convert::IsIndexed(format)) {
+                INT paletteSize = bitmap.GetPaletteSize();
+                std::vector<BYTE> buffer(max(paletteSize, (INT)sizeof(Gdiplus::ColorPalette)));
+                auto* colors = reinterpret_cast<Gdiplus::ColorPalette*>(buffer.data());
+                if (paletteSize <= 0 || bitmap.GetPalette(colors, paletteSize) != Gdiplus::Ok) return false;
+                OtterRaster::Convert::PremultiplyPalette(reinterpret_cast<const uint32_t*>(colors->Entries), colors->Count, palette);
+            }
+            Gdiplus::BitmapData data = {};
+            if (bitmap.LockBits(&rect, Gdiplus::ImageLockModeRead, native, &data) != Gdiplus::Ok) return false;
+            bool ok = OtterRaster::Convert::ConvertImage(static_cast<const uint8_t*>(data.Scan0), data.Stride, w, h,
+                format, palette, surface);
+            bitmap.UnlockBits(&data);
+            return ok;
+        }
+
+        surface.Allocate(w, h);
+        Gdiplus::BitmapData data = {};
+        data.Width = w;
+        data.Height = h;
+        data.Stride = surface.Stride();
+        data.PixelFormat = PixelFormat32bppPARGB;
+        data.Scan0 = surface.Data();
+        if (bitmap.LockBits(&rect, Gdiplus::ImageLockModeRead | Gdiplus::ImageLockModeUserInputBuf,
+            PixelFormat32bppPARGB, &data) != Gdiplus::Ok) {
+            return false;
+        }
+        bitmap.UnlockBits(&data);
+        return true;
+    }
+
+    // 缓存的图片：解码后统一转换为32位预乘像素，bitmap 直接引用这些像素（PARGB）供GDI+绘制，
+    // 绘制时不再有格式转换；原解码位图随即释放（不再占用图片文件）。
+    // scaled 保存缩放绘制用的 mip 级与最近几个目标尺寸的结果，窗口尺寸不变时缩放绘制只是一次混合
+    struct CachedImage {
+        OtterRaster::Surface pixels;
+        std::unique_ptr<Gdiplus::Bitmap> bitmap;
+        OtterRaster::ScaledImageCache scaled;
+        std::shared_ptr<const void> backing;    // pixels 引用共享图片或资源包映射内存时保持其有效
+
+        int Width() const { return pixels.Width(); }
+        int Height() const { return pixels.Height(); }
+    };
+
+    // 接管已转换好的像素并创建引用它们的GDI+位图
+    inline bool AdoptImage(OtterRaster::Surface&& pixels, CachedImage& out) {
+        if (!pixels.Valid()) return false;
+        out.pixels = std::move(pixels);
+        out.bitmap = std::make_unique<Gdiplus::Bitmap>(out.pixels.Width(), out.pixels.Height(), out.pixels.Stride(),
+            PixelFormat32bppPARGB, out.pixels.Data());
+        return out.bitmap->GetLastStatus() == Gdiplus::Ok;
+    }
+
+    inline bool NormalizeImage(Gdiplus::Bitmap& decoded, CachedImage& out) {
+        OtterRaster::Surface pixels;
+        if (!CopyBitmapToSurface(decoded, pixels)) return false;
+        return AdoptImage(std::move(pixels), out);
+    }
+
+    // 进程内共享的解码结果（只读）。各渲染器的 CachedImage 通过 backing 持有引用，
+    // 最后一个引用释放时像素随之释放
+    struct SharedImage {
+        OtterRaster::Surface pixels;
+        uint64_t contentHash = 0;
+    };
+    using SharedImageRef = std::shared_ptr<const SharedImage>;
+
+    // 共享图片存储：同一文件只解码一次（按规范化的完整路径），不同来源解码出的相同像素
+    // 按内容哈希合并为一份。只保存弱引用，不延长图片的生命周期；线程安全，可在解码线程上调用
+    class SharedImageStore {
+    public:
+        struct Stats {
+            size_t decodes = 0;         // 实际解码次数
+            size_t pathHits = 0;        // 同一文件已在使用，未解码
+            size_t dedupeHits = 0;      // 解码后与已有图片内容相同，合并
+            size_t liveImages = 0;
+            size_t liveBytes = 0;
+        };
+
+        static SharedImageStore& Instance() {
+            static SharedImageStore store;
+            return store;
+        }
+
+        // 从文件取得共享图片；同一文件已有引用时直接返回，否则在调用线程上解码（不持锁）
+        SharedImageRef AcquireFile(const std::wstring& filePath) {
+            if (filePath.empty()) return nullptr;
+            const std::wstring path = NormalizePath(filePath);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_byPath.find(path);
+                if (it != m_byPath.end()) {
+                    if (SharedImageRef image = it->second.lock()) {
+                        ++m_stats.pathHits;
+                        return image;
+                    }
+                }
+            }
+            OTTER_TRACE_SCOPE("image", "DecodeFile");
+            Gdiplus::Bitmap bitmap(filePath.c_str());
+            SharedImageRef image = Decode(bitmap);
+            if (!image) return nullptr;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_byPath[path] = image;
+            return image;
+        }
+
+        // 从已解码的位图取得共享图片（如内存中的图片文件），与已有图片按内容合并
+        SharedImageRef AcquireBitmap(Gdiplus::Bitmap& decoded) { return Decode(decoded); }
+
+        // 接管已转换好的像素，与已有图片按内容合并
+        SharedImageRef Adopt(OtterRaster::Surface&& pixels) {
+            if (!pixels.Valid()) return nullptr;
+            auto image = std::make_shared<SharedImage>();
+            image->contentHash = HashPixels(pixels);
+            image->pixels = std::move(pixels);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto range = m_byContent.equal_range(image->contentHash);
+            for (auto it = range.first; it != range.second; ++it) {
+                SharedImageRef existing = it->second.lock();
+                if (existing && SamePixels(existing->pixels, image->pixels)) {
+                    ++m_stats.dedupeHits;
+                    return existing;
+                }
+            }
+            m_byContent.emplace(image->contentHash, image);
+            if (m_byContent.size() + m_byPath.size() >= m_sweepAt) Sweep();
+            return image;
+        }
+
+        Stats GetStats() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Sweep();
+            Stats stats = m_stats;
+            for (auto& kv : m_byContent) {
+                if (SharedImageRef image = kv.second.lock()) {
+                    ++stats.liveImages;
+                    stats.liveBytes += size_t(image->pixels.Stride()) * image->pixels.Height();
+                }
+            }
+            return stats;
+        }
+
+        // 像素内容的64位哈希（只计可见宽度，忽略行尾对齐填充）
+        static uint64_t HashPixels(const OtterRaster::Surface& pixels) {
+            const uint64_t k1 = 0x9E3779B97F4A7C15ull, k2 = 0xC2B2AE3D27D4EB4Full;
+            uint64_t h = k1 ^ ((uint64_t(uint32_t(pixels.Width())) << 32) | uint32_t(pixels.Height()));
+            const size_t rowBytes = size_t(pixels.Width()) * 4;
+            for (int y = 0; y < pixels.Height(); ++y) {
+                const uint8_t* p = reinterpret_cast<const uint8_t*>(pixels.Row(y));
+                size_t i = 0;
+                for (; i + 8 <= rowBytes; i += 8) {
+                    uint64_t v;
+                    std::memcpy(&v, p + i, 8);
+                    h ^= v * k2;
+                    h = ((h << 31) | (h >> 33)) * k1;
+                }
+                if (i < rowBytes) {
+                    uint32_t v;
+                    std::memcpy(&v, p + i, 4);
+                    h ^= uint64_t(v) * k2;
+                    h = ((h << 31) | (h >> 33)) * k1;
+                }
+            }
+            h ^= h >> 33;
+            h *= k2;
+            h ^= h >> 29;
+            return h;
+        }
+
+    private:
+        SharedImageStore() = default;
+
+        SharedImageRef Decode(Gdiplus::Bitmap& bitmap) {
+            if (bitmap.GetLastStatus() != Gdiplus::Ok) return nullptr;
+            OtterRaster::Surface pixels;
+            if (!CopyBitmapToSurface(bitmap, pixels)) return nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_stats.decodes;
+            }
+            return Adopt(std::move(pixels));
+        }
+
+        static std::wstring NormalizePath(const std::wstring& filePath) {
+            std::wstring path = filePath;
+            DWORD length = GetFullPathNameW(filePath.c_str(), 0, NULL, NULL);
+            if (length > 0) {
+                std::wstring full(length, L'\0');
+                length = GetFullPathNameW(filePath.c_str(), length, &full[0], NULL);
+                if (length > 0 && length < full.size()) {
+                    full.resize(length);
+                    path = std::move(full);
+                }
+            }
+            if (!path.empty()) CharLowerBuffW(&path[0], DWORD(path.size()));
+            return path;
+        }
+
+        static bool SamePixels(const OtterRaster::Surface& a, const OtterRaster::Surface& b) {
+            if (a.Width() != b.Width() || a.Height() != b.Height()) return false;
+            for (int y = 0; y < a.Height(); ++y) {
+                if (std::memcmp(a.Row(y), b.Row(y), size_t(a.Width()) * 4) != 0) return false;
+            }
+            return true;
+        }
+
+        // 丢弃已释放图片的弱引用；之后到容量翻倍时再清理
+        void Sweep() {
+            for (auto it = m_byContent.begin(); it != m_byContent.end();) {
+                it = it->second.expired() ? m_byContent.erase(it) : std::next(it);
+            }
+            for (auto it = m_byPath.begin(); it != m_byPath.end();) {
+                it = it->second.expired() ? m_byPath.erase(it) : std::next(it);
+            }
+            m_sweepAt = max(size_t(64), 2 * (m_byContent.size() + m_byPath.size()));
+        }
+
+        std::mutex m_mutex;
+        std::unordered_map<std::wstring, std::weak_ptr<const SharedImage>> m_byPath;
+        std::unordered_multimap<uint64_t, std::weak_ptr<const SharedImage>> m_byContent;
+        size_t m_sweepAt = 64;
+        Stats m_stats;
+    };
+
+    // 引用共享像素（不复制）并创建GDI+位图；out.backing 持有共享图片
+    inline bool ShareImage(const SharedImageRef& shared, CachedImage& out) {
+        if (!shared) return false;
+        const OtterRaster::Surface& p = shared->pixels;
+        if (!AdoptImage(OtterRaster::Surface::Wrap(const_cast<uint8_t*>(p.Data()), p.Width(), p.Height(), p.Stride()), out)) return false;
+        out.backing = shared;
+        return true;
+    }
+
+    // 图片缓存：按解码后实际占用的字节数（像素 + mip级 + 缩放结果）计入预算，超出时按LRU淘汰。
+    // 从文件加载的图片被淘汰后只保留路径与尺寸，下次 Find 时从原路径重新加载（资源包中的图片从资源包重新加载）；
+    // 从内存加载的图片无法重新加载，计入预算但不会被淘汰。重新加载失败的图片被移除。预算为0（默认）时不限制
+    class ImageCache {
+    public:
+        // 从文件以外的来源重新加载被淘汰的图片（如资源包条目）
+        using Reloader = std::function<bool(CachedImage& out)>;
+
+        struct Stats {
+            size_t hits = 0;            // Find 命中常驻图片
+            size_t misses = 0;          // Find 的键不存在
+            size_t reloads = 0;         // 被淘汰后从原路径重新加载
+            size_t reloadFailures = 0;
+            size_t evictions = 0;
+            size_t images = 0;          // 已知的图片（含已淘汰、可重新加载的）
+            size_t residentImages = 0;
+            size_t bytesResident = 0;
+            size_t peakBytes = 0;
+            size_t budget = 0;
+
+            double HitRate() const {
+                const size_t lookups = hits + reloads + misses;
+                return lookups ? double(hits) / lookups : 0.0;
+            }
+        };
+
+        // 返回常驻的图片并标记为最近使用；已淘汰的从原路径重新加载，不存在时返回 nullptr。
+        // 返回的指针在下一次 Store/Find/Trim 前有效
+        CachedImage* Find(const std::wstring& key) {
+            auto it = m_entries.find(key);
+            if (it == m_entries.end()) {
+                ++m_stats.misses;
+                return nullptr;
+            }
+            Entry& entry = it->second;
+            if (!entry.resident) {
+                CachedImage image;
+                if (!(entry.reload ? entry.reload(image) : Decode(entry.sourcePath, image))) {
+                    // 文件已删除或损坏：移除该键，不再每次查找都重新解码；再次 Store/LoadImage 后恢复
+                    ++m_stats.reloadFailures;
+                    m_entries.erase(it);
+                    return nullptr;
+                }
+                ++m_stats.reloads;
+                entry.image = std::move(image);
+                entry.resident = true;
+                entry.bytes = BytesOf(entry.image);
+                m_bytes += entry.bytes;
+                m_lru.push_front(key);
+                entry.lruPos = m_lru.begin();
+                Trim();
+            }
+            else {
+                ++m_stats.hits;
+                m_lru.splice(m_lru.begin(), m_lru, entry.lruPos);
+            }
+            return &entry.image;
+        }
+
+        // 不重新加载、不影响LRU顺序；已淘汰的图片返回记录的尺寸
+        bool GetSize(const std::wstring& key, int& width, int& height) const {
+            auto it = m_entries.find(key);
+            if (it == m_entries.end()) return false;
+            width = it->second.width;
+            height = it->second.height;
+            return true;
+        }
+
+        bool Contains(const std::wstring& key) const { return m_entries.count(key) != 0; }
+
+        bool IsResident(const std::wstring& key) const {
+            auto it = m_entries.find(key);
+            return it != m_entries.end() && it->second.resident;
+        }
+
+        // sourcePath 为空表示无法重新加载（不会被淘汰）
+        void Store(const std::wstring& key, CachedImage&& image, const std::wstring& sourcePath = std::wstring()) {
+            Insert(key, std::move(image)).sourcePath = sourcePath;
+            Trim();
+        }
+
+        // 被淘汰后由 reload 重新加载
+        void Store(const std::wstring& key, CachedImage&& image, Reloader reload) {
+            Insert(key, std::move(image)).reload = std::move(reload);
+            Trim();
+        }
+
+        bool Erase(const std::wstring& key) {
+            auto it = m_entries.find(key);
+            if (it == m_entries.end()) return false;
+            if (it->second.resident) {
+                m_bytes -= it->second.bytes;
+                m_lru.erase(it->second.lruPos);
+            }
+            m_entries.erase(it);
+            return true;
+        }
+
+        void Clear() {
+            m_entries.clear();
+            m_lru.clear();
+            m_bytes = 0;
+        }
+
+        void SetBudget(size_t bytes) {
+            m_budget = bytes;
+            Trim();
+        }
+
+        size_t Budget() const { return m_budget; }
+
+        // 重新统计一张图片的占用：缩放结果与mip级在绘制时按需增长，生成后调用。不淘汰，超出预算留给下一次 Trim
+        void Refresh(const std::wstring& key) {
+            auto it = m_entries.find(key);
+            if (it == m_entries.end() || !it->second.resident) return;
+            Entry& entry = it->second;
+            const size_t bytes = BytesOf(entry.image);
+            m_bytes = m_bytes - entry.bytes + bytes;
+            entry.bytes = bytes;
+            m_stats.peakBytes = (std::max)(m_stats.peakBytes, m_bytes);
+        }
+
+        // 超出预算时从最久未用的开始淘汰，最近使用的一张总是保留。
+        // 占用由 Store、重新加载与 Refresh 增量维护，这里不逐项重新统计。BeginFrame 时调用
+        void Trim() {
+            m_stats.peakBytes = (std::max)(m_stats.peakBytes, m_bytes);
+            if (m_budget == 0 || m_lru.size() < 2) return;
+
+            auto pos = std::prev(m_lru.end());
+            while (m_bytes > m_budget && pos != m_lru.begin()) {
+                auto current = pos--;
+                Entry& entry = m_entries[*current];
+                if (entry.sourcePath.empty() && !entry.reload) continue;
+                m_bytes -= entry.bytes;
+                entry.image = CachedImage();
+                entry.resident = false;
+                entry.bytes = 0;
+                m_lru.erase(current);
+                ++m_stats.evictions;
+            }
+        }
+
+        Stats GetStats() const {
+            Stats stats = m_stats;
+            stats.images = m_entries.size();
+            stats.residentImages = m_lru.size();
+            stats.bytesResident = m_bytes;
+            stats.budget = m_budget;
+            return stats;
+        }
+
+        void ResetStats() { m_stats = Stats(); }
+
+        static size_t BytesOf(const CachedImage& image) {
+            return size_t(image.pixels.Stride()) * image.pixels.Height() + image.scaled.ByteSize();
+        }
+
+        // 经共享图片存储加载：同一文件仍被其他渲染器使用时不重新解码
+        static bool Decode(const std::wstring& filePath, CachedImage& out) {
+            return ShareImage(SharedImageStore::Instance().AcquireFile(filePath), out);
+        }
+
+    private:
+        struct Entry {
+            CachedImage image;
+            std::wstring sourcePath;
+            Reloader reload;                // 非空时代替 sourcePath 重新加载
+            int width = 0, height = 0;
+            size_t bytes = 0;
+            bool resident = false;
+            std::list<std::wstring>::iterator lruPos;
+        };
+
+        Entry& Insert(const std::wstring& key, CachedImage&& image) {
+            Erase(key);
+            Entry& entry = m_entries[key];
+            entry.width = image.Width();
+            entry.height = image.Height();
+            entry.image = std::move(image);
+            entry.resident = true;
+            entry.bytes = BytesOf(entry.image);
+            m_bytes += entry.bytes;
+            m_lru.push_front(key);
+            entry.lruPos = m_lru.begin();
+            return entry;
+        }
+
+        std::unordered_map<std::wstring, Entry> m_entries;
+        std::list<std::wstring> m_lru;      // 常驻图片，最近使用的在前
+        size_t m_bytes = 0;
+        size_t m_budget = 0;
+        Stats m_stats;
+    };
+
+    // 后台加载图片：解码与格式转换在工作线程上完成（经共享图片存储），UI线程 Pump 时才放入渲染器的图片缓存。
+    // 每完成一张默认 InvalidateRect 关联窗口，使UI线程进入下一帧
+    class AsyncImageLoader {
+    public:
+        using ReadyCallback = std::function<void(const std::wstring& key, bool ok)>;
+        // 工作线程的解码结果；filePath 为实际解码的文件，键换了文件后据此丢弃旧结果
+        struct LoadResult {
+            SharedImageRef image;
+            std::wstring filePath;
+        };
+        using LoadQueue = OtterAsync::DecodeQueue<std::wstring, LoadResult>;
+
+        explicit AsyncImageLoader(HWND hWnd) : m_hWnd(hWnd) {}
+        ~AsyncImageLoader() { Shutdown(); }
+
+        AsyncImageLoader(const AsyncImageLoader&) = delete;
+        AsyncImageLoader& operator=(const AsyncImageLoader&) = delete;
+
+        // 提交解码；同一个键重复提交只更新优先级。换了文件时取消旧任务，
+        // 执行中的旧任务完成后由 Pump 按新文件重新提交
+        bool Load(const std::wstring& key, const std::wstring& filePath, int priority) {
+            auto it = m_requests.find(key);
+            if (it != m_requests.end() && it->second.filePath != filePath && m_queue) m_queue->Cancel(key);
+            if (!Queue().Submit(key, MakeJob(filePath), priority)) {
+                m_requests.erase(key);
+                return false;
+            }
+            m_requests[key] = Request{ filePath, priority };
+            return true;
+        }
+
+        bool SetPriority(const std::wstring& key, int priority) {
+            auto it = m_requests.find(key);
+            if (it == m_requests.end()) return false;
+            it->second.priority = priority;
+            return m_queue && m_queue->SetPriority(key, priority);
+        }
+
+        // 取消后不会再放入缓存，也不会调用就绪回调
+        bool Cancel(const std::wstring& key) {
+            if (m_requests.erase(key) == 0) return false;
+            if (m_queue) m_queue->Cancel(key);
+            return true;
+        }
+
+        void CancelAll() {
+            m_requests.clear();
+            if (m_queue) m_queue->CancelAll();
+        }
+
+        bool IsLoading(const std::wstring& key) const { return m_requests.count(key) != 0; }
+        size_t LoadingCount() const { return m_requests.size(); }
+
+        // 就绪回调在UI线程的 Pump 中调用
+        void SetReadyCallback(ReadyCallback callback) { m_onReady = std::move(callback); }
+
+        // 替换默认的唤醒方式（在工作线程上调用）
+        void SetNotify(std::function<void()> notify) { Queue().SetNotify(std::move(notify)); }
+
+        // UI线程调用：把完成的图片放入 cache，返回放入的张数
+        size_t Pump(ImageCache& cache) {
+            if (!m_queue) return 0;
+            OTTER_TRACE_SCOPE("image", "PumpImageLoads");
+            size_t stored = 0;
+            m_queue->Drain([&](LoadQueue::Completion& done) {
+                auto it = m_requests.find(done.key);
+                if (it == m_requests.end()) return;     // 已取消
+                const bool stale = done.status != OtterAsync::DecodeStatus::Dropped &&
+                    done.result.filePath != it->second.filePath;
+                if (done.status == OtterAsync::DecodeStatus::Cancelled || stale) {
+                    // 执行中被取消后又重新请求，或完成的是换文件之前的旧任务：按当前文件重新提交
+                    m_queue->Submit(done.key, MakeJob(it->second.filePath), it->second.priority);
+                    return;
+                }
+                const std::wstring filePath = std::move(it->second.filePath);
+                m_requests.erase(it);
+                bool ok = false;
+                if (done.status == OtterAsync::DecodeStatus::Ready) {
+                    CachedImage image;
+                    ok = ShareImage(done.result.image, image);
+                    if (ok) {
+                        cache.Store(done.key, std::move(image), filePath);
+                        ++stored;
+                    }
+                }
+                if (m_onReady) m_onReady(done.key, ok);
+            });
+            return stored;
+        }
+
+        // 取消全部并等待工作线程退出（须在释放渲染器的GDI+引用之前调用）
+        void Shutdown() {
+            if (m_queue) m_queue->Shutdown();
+            m_queue.reset();
+            m_requests.clear();
+        }
+
+        OtterAsync::DecodeStats GetStats() const { return m_queue ? m_queue->GetStats() : OtterAsync::DecodeStats(); }
+
+    private:
+        struct Request {
+            std::wstring filePath;
+            int priority;
+        };
+
+        LoadQueue& Queue() {
+            if (!m_queue) {
+                m_queue = std::make_unique<LoadQueue>();
+                HWND hWnd = m_hWnd;
+                m_queue->SetNotify([hWnd] { if (hWnd) InvalidateRect(hWnd, NULL, FALSE); });
+            }
+            return *m_queue;
+        }
+
+        static LoadQueue::Job MakeJob(const std::wstring& filePath) {
+            return [filePath](LoadResult& out, const std::atomic<bool>& cancelled) {
+                out.filePath = filePath;
+                if (cancelled) return false;
+                out.image = SharedImageStore::Instance().AcquireFile(filePath);
+                return out.image != nullptr;
+            };
+        }
+
+        HWND m_hWnd;
+        std::unique_ptr<LoadQueue> m_queue;
+        std::unordered_map<std::wstring, Request> m_requests;   // 尚未放入缓存的请求（仅UI线程访问）
+        ReadyCallback m_onReady;
+    };
+
+    inline std::string ToUtf8(const std::wstring& text) {
+        if (text.empty()) return std::string();
+        int length = WideCharToMultiByte(CP_UTF8, 0, text.data(), (int)text.size(), NULL, 0, NULL, NULL);
+        std::string out(length, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, text.data(), (int)text.size(), &out[0], length, NULL, NULL);
+        return out;
+    }
+
+    inline std::wstring FromUtf8(const std::string& text) {
+        if (text.empty()) return std::wstring();
+        int length = MultiByteToWideChar(CP_UTF8, 0, text.data(), (int)text.size(), NULL, 0);
+        std::wstring out(length, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, text.data(), (int)text.size(), &out[0], length);
+        return out;
+    }
+
+    // 打包：把若干图片文件（键, 路径）解码为32位预乘像素写入一个资源包，供发布前离线生成
+    inline bool WriteImagePack(const std::vector<std::pair<std::wstring, std::wstring>>& images,
+        const std::wstring& packPath, bool compress = false) {
+        OtterPack::AssetPackWriter writer;
+        for (const auto& item : images) {
+            Gdiplus::Bitmap bitmap(item.second.c_str());
+            OtterRaster::Surface pixels;
+            if (bitmap.GetLastStatus() != Gdiplus::Ok || !CopyBitmapToSurface(bitmap, pixels) ||
+                !writer.Add(ToUtf8(item.first), pixels, compress)) {
+                OutputDebugStringW((L"图片打包失败: " + item.second + L"\n").c_str());
+                return false;
+            }
+        }
+        return writer.Write(packPath);
+    }
+
+    // 资源包第 index 个条目：未压缩的直接引用映射内存，LZ4条目解压一次
+    inline bool LoadPackEntry(const OtterPack::AssetPack& pack, size_t index, CachedImage& out) {
+        const OtterPack::AssetPack::Entry entry = pack.At(index);
+        OtterRaster::Surface pixels;
+        if (!pack.Load(entry, pixels) || !AdoptImage(std::move(pixels), out)) return false;
+        if (entry.compression == OtterPack::Compression::None) out.backing = pack.Backing();
+        return true;
+    }
+
+    // 映射资源包并把全部条目放入图片缓存，返回放入的张数。条目可被内存预算淘汰，
+    // 之后从资源包重新加载（缓存中仍有该包的条目时映射保持打开）
+    inline size_t RegisterImagePack(const std::wstring& packPath, ImageCache& cache) {
+        auto pack = std::make_shared<OtterPack::AssetPack>();
+        if (!pack->Open(packPath)) return 0;
+        size_t count = 0;
+        for (size_t i = 0; i < pack->Count(); ++i) {
+            CachedImage image;
+            if (!LoadPackEntry(*pack, i, image)) continue;
+            cache.Store(FromUtf8(pack->At(i).key), std::move(image),
+                [pack, i](CachedImage& out) { return LoadPackEntry(*pack, i, out); });
+            ++count;
+        }
+        return count;
+    }
+
+    // DrawSprites 的一项：不缩放地绘制图片
+    struct SpriteDraw {
+        std::wstring key;
+        int x = 0, y = 0;
+        float opacity = 1.0f;
+    };
+
+    // 图片渲染器共用的精灵图集：小图片复制进共享的图集页，按键映射到页内子矩形，
+    // 页面以GDI+位图（直接引用页像素）供 DrawImage 使用。装入图集的键从 cache 中移除
+    class ImageAtlas {
+    public:
+        explicit ImageAtlas(ImageCache& cache) : m_cache(cache) {}
+
+        // 尺寸参数只在图集为空时生效
+        void Enable(bool enabled, int pageSize = OtterRaster::SpriteAtlas::kDefaultPageSize,
+            int maxSprite = OtterRaster::SpriteAtlas::kDefaultMaxSprite) {
+            if (enabled && m_atlas.PageCount() == 0) m_atlas = OtterRaster::SpriteAtlas(pageSize, maxSprite);
+            m_enabled = enabled;
+        }
+
+        bool Enabled() const { return m_enabled; }
+
+        // 把像素装入图集（复制），成功后该键不再占用单独的缓存项
+        bool Add(const std::wstring& key, const OtterRaster::Surface& pixels) {
+            OtterRaster::SpriteAtlas::Sprite sprite;
+            if (!m_atlas.Accepts(pixels.Width(), pixels.Height()) || !m_atlas.Insert(pixels, sprite)) return false;
+            m_cache.Erase(key);
+            m_sprites[key] = sprite;
+            SyncPages();
+            return true;
+        }
+
+        // 把缓存中已加载的图片移入图集，按高度排序装入，比逐张加载更紧凑。返回移入的张数
+        size_t AddLoaded(const std::vector<std::wstring>& keys) {
+            struct Candidate {
+                std::wstring key;
+                int width, height;
+            };
+            std::vector<Candidate> candidates;
+            for (const std::wstring& key : keys) {
+                int width, height;
+                if (m_sprites.count(key) || !m_cache.GetSize(key, width, height)) continue;
+                if (m_atlas.Accepts(width, height)) candidates.push_back(Candidate{ key, width, height });
+            }
+            std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+                return a.height != b.height ? a.height > b.height : a.width > b.width;
+            });
+            size_t count = 0;
+            for (const Candidate& c : candidates) {
+                CachedImage* image = m_cache.Find(c.key);
+                if (image && Add(c.key, image->pixels)) ++count;
+            }
+            return count;
+        }
+
+        bool Contains(const std::wstring& key) const { return m_sprites.count(key) != 0; }
+
+        bool GetSize(const std::wstring& key, int& width, int& height) const {
+            auto sprite = m_sprites.find(key);
+            if (sprite == m_sprites.end()) return false;
+            width = sprite->second.rect.w;
+            height = sprite->second.rect.h;
+            return true;
+        }
+
+        // 查找要绘制的图片；图集中的图片返回所在页，并把源矩形换算为页内坐标，其余查 cache
+        CachedImage* FindDrawable(const std::wstring& key, int& srcX, int& srcY, int& srcWidth, int& srcHeight) {
+            auto sprite = m_sprites.find(key);
+            if (sprite == m_sprites.end()) return m_cache.Find(key);
+            const OtterRaster::Rect& r = sprite->second.rect;
+            if (srcWidth == -1) srcWidth = r.w;
+            if (srcHeight == -1) srcHeight = r.h;
+            srcX += r.x;
+            srcY += r.y;
+            return &m_pages[size_t(sprite->second.page)];
+        }
+
+        // 只解除映射，页内空间不回收（Clear 时整体释放）
+        void Erase(const std::wstring& key) { m_sprites.erase(key); }
+
+        void Clear() {
+            m_sprites.clear();
+            m_pages.clear();
+            m_atlas.Clear();
+        }
+
+        OtterRaster::SpriteAtlas::Stats GetStats() const { return m_atlas.GetStats(); }
+        const OtterRaster::SpriteBatch::Stats& GetBatchStats() const { return m_batch.GetStats(); }
+
+        // 批量不缩放地绘制，按顺序合成：图集中连续位于同一页的图片攒成一段后交给
+        // present(batch, atlas) 合成到后备缓冲区（渲染器在其中同步GDI+并选择目标）；
+        // 不在图集中的图片，以及 writable 为 false（后备缓冲区像素不可直接写）时的全部图片，逐个交给 drawImage(draw)
+        template <typename Present, typename DrawImage>
+        void DrawSprites(const std::vector<SpriteDraw>& draws, bool writable, Present&& present, DrawImage&& drawImage) {
+            auto flush = [&]() {
+                if (!m_batch.Empty()) present(m_batch, m_atlas);
+            };
+            for (const SpriteDraw& draw : draws) {
+                auto sprite = m_sprites.find(draw.key);
+                if (writable && sprite != m_sprites.end()) {
+                    m_batch.Add(sprite->second, draw.x, draw.y, draw.opacity);
+                    continue;
+                }
+                flush();
+                drawImage(draw);
+            }
+            flush();
+        }
+
+    private:
+        void SyncPages() {
+            while (m_pages.size() < m_atlas.PageCount()) {
+                const std::shared_ptr<OtterRaster::Surface>& page = m_atlas.PagePixels(int(m_pages.size()));
+                CachedImage image;
+                AdoptImage(OtterRaster::Surface::Wrap(page->Data(), page->Width(), page->Height(), page->Stride()), image);
+                image.backing = page;
+                m_pages.push_back(std::move(image));
+            }
+        }
+
+        ImageCache& m_cache;
+        OtterRaster::SpriteAtlas m_atlas;
+        bool m_enabled = false;
+        std::unordered_map<std::wstring, OtterRaster::SpriteAtlas::Sprite> m_sprites;
+        std::vector<CachedImage> m_pages;      // m_pages[i] 为第 i 页
+        OtterRaster::SpriteBatch m_batch;
+    };
+
+    // 图片渲染器共用的图片库：图片缓存、精灵图集、后台解码与加载中的占位。
+    // 渲染器只负责把取到的图片绘制到各自的后备缓冲区
+    class ImageLibrary {
+    public:
+        explicit ImageLibrary(HWND hWnd) : m_loader(hWnd) {}
+
+        ImageLibrary(const ImageLibrary&) = delete;
+        ImageLibrary& operator=(const ImageLibrary&) = delete;
+
+        ImageCache& Cache() { return m_cache; }
+        const ImageCache& Cache() const { return m_cache; }
+        ImageAtlas& Atlas() { return m_atlas; }
+        const ImageAtlas& Atlas() const { return m_atlas; }
+        AsyncImageLoader& Loader() { return m_loader; }
+        const AsyncImageLoader& Loader() const { return m_loader; }
+
+        // 在缓存（含已淘汰、可重新加载的）或图集中
+        bool Contains(const std::wstring& key) const { return m_cache.Contains(key) || m_atlas.Contains(key); }
+
+        // 共享图片放入缓存（引用共享像素，不复制）；开启图集时小图片复制进图集
+        bool Store(const std::wstring& key, const SharedImageRef& shared, const std::wstring& sourcePath = std::wstring()) {
+            if (!shared) return false;
+            m_loader.Cancel(key);
+            if (m_atlas.Enabled() && m_atlas.Add(key, shared->pixels)) return true;
+            CachedImage image;
+            if (!ShareImage(shared, image)) return false;
+            m_atlas.Erase(key);     // 替换原先在图集中的同名图片
+            m_cache.Store(key, std::move(image), sourcePath);
+            return true;
+        }
+
+        // 从文件加载；同一文件已被其他渲染器加载时直接共享像素。
+        // replace 为 false 时已加载的键直接返回，为 true 时用新文件替换（加载失败则保留原图片）
+        bool Load(const std::wstring& key, const std::wstring& filePath, bool replace = false) {
+            OTTER_TRACE_SCOPE_ARG("image", "LoadImage", ToUtf8(key));
+            if (!replace && Contains(key)) return true;
+
+            if (!PathFileExists(filePath.c_str())) {
+                OutputDebugStringW((L"图片文件不存在: " + filePath + L"\n").c_str());
+                return false;
+            }
+
+            try {
+                SharedImageRef shared = SharedImageStore::Instance().AcquireFile(filePath);
+                if (!shared) {
+                    OutputDebugStringW((L"图片加载失败: " + filePath + L"\n").c_str());
+                    return false;
+                }
+                return Store(key, shared, filePath);
+            }
+            catch (...) {
+                OutputDebugStringW(L"图片加载异常\n");
+                return false;
+            }
+        }
+
+        bool LoadFromMemory(const std::wstring& key, const BYTE* data, size_t size) {
+            IStream* pStream = SHCreateMemStream(data, static_cast<UINT>(size));
+            if (!pStream) return false;
+
+            auto bitmap = std::make_unique<Gdiplus::Bitmap>(pStream);
+            pStream->Release();
+
+            if (bitmap->GetLastStatus() != Gdiplus::Ok) {
+                return false;
             }
+
+            return Store(key, SharedImageStore::Instance().AcquireBitmap(*bitmap));
+        }
+
+        size_t LoadPack(const std::wstring& packPath) { return RegisterImagePack(packPath, m_cache); }
+
+        bool LoadAsync(const std::wstring& key, const std::wstring& filePath, int priority) {
+            if (Contains(key)) return true;
+            return m_loader.Load(key, filePath, priority);
+        }
+
+        // key 对应图片 image 缩放到 width×height 的结果（见 ScaledImageCache::Get）；
+        // 新生成缩放结果时只重新统计这一张图片的缓存占用
+        const OtterRaster::Surface& Scaled(const std::wstring& key, CachedImage& image, int width, int height) {
+            const size_t builds = image.scaled.GetStats().variantBuilds;
+            const OtterRaster::Surface& scaled = image.scaled.Get(image.pixels, width, height);
+            if (image.scaled.GetStats().variantBuilds != builds) m_cache.Refresh(key);
+            return scaled;
+        }
+
+        // 查找要绘制的图片，图集中的图片换算源矩形（见 ImageAtlas::FindDrawable）
+        CachedImage* FindDrawable(const std::wstring& key, int& srcX, int& srcY, int& srcWidth, int& srcHeight) {
+            return m_atlas.FindDrawable(key, srcX, srcY, srcWidth, srcHeight);
+        }
+
+        bool GetSize(const std::wstring& key, int& width, int& height) const {
+            return m_atlas.GetSize(key, width, height) || m_cache.GetSize(key, width, height);
+        }
+
+        void Remove(const std::wstring& key) {
+            m_loader.Cancel(key);
+            m_cache.Erase(key);
+            m_atlas.Erase(key);
+        }
+
+        void Clear() {
+            m_loader.CancelAll();
+            m_cache.Clear();
+            m_atlas.Clear();
+        }
+
+        // 透明（默认）时不绘制占位
+        void SetPlaceholder(Gdiplus::Color color) { m_placeholderColor = color; }
+
+        // 图片尚在后台解码时在 graphics 上绘制占位（或跳过）并返回 true；未加载过返回 false
+        bool DrawPlaceholder(const std::wstring& key, Gdiplus::Graphics& graphics, int x, int y, int width, int height) {
+            if (!m_loader.IsLoading(key)) return false;
+            if (m_placeholderColor.GetA() == 0 || width <= 0 || height <= 0) return true;
+            Gdiplus::SolidBrush brush(m_placeholderColor);
+            graphics.FillRectangle(&brush, x, y, width, height);
+            m_placeholders[key] = OtterRaster::Rect(x, y, width, height);
+            return true;
         }
+
+        // 把后台解码完成的图片放入缓存，返回张数；画过占位且已结束加载的位置加入 damage（可为空）
+        size_t Pump(OtterRaster::DamageRegion* damage = nullptr) {
+            const size_t stored = m_loader.Pump(m_cache);
+            for (auto it = m_placeholders.begin(); it != m_placeholders.end();) {
+                if (m_loader.IsLoading(it->first)) { ++it; continue; }
+                if (damage) damage->Add(it->second);
+                it = m_placeholders.erase(it);
+            }
+            return stored;
+        }
+
+        // 取消全部并等待工作线程退出（工作线程使用GDI+，须在渲染器释放GDI+之前调用）
+        void Shutdown() { m_loader.Shutdown(); }
+
+    private:
+        ImageCache m_cache;             // 加载时已转换为32位预乘格式，可设置内存预算
+        ImageAtlas m_atlas{ m_cache };  // 开启后小图片装入共享页
+        AsyncImageLoader m_loader;
+        Gdiplus::Color m_placeholderColor = Gdiplus::Color(0, 0, 0, 0);
+        std::unordered_map<std::wstring, OtterRaster::Rect> m_placeholders; // 绘制过占位的位置，就绪后加入损坏区域
     };
 
+    // 把GDI+绘图裁剪到损坏区域
+    inline void ApplyDamageClip(Gdiplus::Graphics& graphics, const OtterRaster::DamageRegion& damage) {
+        Gdiplus::Region region;
+        region.MakeEmpty();
+        for (const OtterRaster::Rect& r : damage.Rects()) {
+            region.Union(Gdiplus::Rect(r.x, r.y, r.w, r.h));
+        }
+        graphics.SetClip(&region);
+    }
+
+    // 后备缓冲区呈现到窗口；damage 非空时只提交损坏区域
+    // （普通窗口逐矩形BitBlt，分层窗口以损坏包围盒作为脏矩形）
+    inline void PresentBackBuffer(HWND hwnd, HDC memDC, int width, int height, bool layered,
+        const OtterRaster::DamageRegion* damage = nullptr) {
+        if (damage && damage->Empty()) return; // 没有变化
+        HDC windowDC = GetDC(hwnd);
+        if (layered) {
+            BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+            POINT ptSrc = { 0, 0 };
+            SIZE sizeWnd = { width, height };
+            UPDATELAYEREDWINDOWINFO info = { sizeof(UPDATELAYEREDWINDOWINFO) };
+            info.hdcDst = windowDC;
+            info.psize = &sizeWnd;
+            info.hdcSrc = memDC;
+            info.pptSrc = &ptSrc;
+            info.pblend = &blend;
+            info.dwFlags = ULW_ALPHA;
+            RECT dirty;
+            if (damage) {
+                OtterRaster::Rect b = damage->Bounds();
+                dirty = { b.x, b.y, b.Right(), b.Bottom() };
+                info.prcDirty = &dirty;
+            }
+            UpdateLayeredWindowIndirect(hwnd, &info);
+        }
+        else if (damage) {
+            for (const OtterRaster::Rect& r : damage->Rects()) {
+                BitBlt(windowDC, r.x, r.y, r.w, r.h, memDC, r.x, r.y, SRCCOPY);
+            }
+        }
+        else {
+            BitBlt(windowDC, 0, 0, width, height, memDC, 0, 0, SRCCOPY);
+        }
+        ReleaseDC(hwnd, windowDC);
+    }
+
     // 画笔工具类
     class OtterPaintbrush {
     private:
         HWND hwnd;
-        HDC hdc;
+        std::unique_ptr<BackBuffer> buffer; // 从 BackBufferPool 获取，析构时归还
         HDC memDC;
-        HBITMAP hBitmap;
         Gdiplus::Graphics* graphics;
         int width, height;
         RECT rect;
         bool isLayered;
         bool antiAlias;
-        std::vector<std::function<void(Gdiplus::Graphics&)>> layers; // 图层存储
-        HBITMAP hBackBuffer; // 后备缓冲区
-        HDC hBackDC;         // 后备设备上下文
-        HBITMAP hOldBitmap; // 添加旧位图句柄保存
 
         std::map<std::string, std::unique_ptr<Gdiplus::Image>> images;
+
+        // 软件光栅化后端
+        PaintBackend backend;
+        OtterRaster::Canvas canvas;
+        std::unique_ptr<OtterRaster::TileRenderer> tiles;   // 多线程回放显示列表，未开启时为空
+
+        // 损坏区域（SetDamage 后绘制与呈现只作用于该区域）
+        OtterRaster::DamageRegion damage;
+        bool hasDamage = false;
+
+        bool IsSoftware() const { return backend == PaintBackend::Software; }
+
+        // GDI+/GDI 绘制后，软件光栅化直接访问像素前需要同步
+        void SyncGdi() {
+            graphics->Flush(Gdiplus::FlushIntentionSync);
+            GdiFlush();
+        }
     public:
         Gdiplus::Graphics* GetGraphics() { return graphics; }
         // 构造函数
-        OtterPaintbrush(HWND hwnd, bool layered, Gdiplus::Color bgColor = Gdiplus::Color(255, 255, 255, 255), bool useAntiAlias = true)
-            : hwnd(hwnd), isLayered(layered), antiAlias(useAntiAlias) {
+        OtterPaintbrush(HWND hwnd, bool layered, Gdiplus::Color bgColor = Gdiplus::Color(255, 255, 255, 255), bool useAntiAlias = true,
+            PaintBackend paintBackend = PaintBackend::GdiPlus)
+            : hwnd(hwnd), isLayered(layered), antiAlias(useAntiAlias), backend(paintBackend) {
 
             GetClientRect(hwnd, &rect);
             width = rect.right - rect.left;
             height = rect.bottom - rect.top;
 
-            hdc = GetDC(hwnd);
-            memDC = CreateCompatibleDC(hdc);
-            hBitmap = CreateCompatibleBitmap(hdc, width, height);
-            SelectObject(memDC, hBitmap);
-            hOldBitmap = (HBITMAP)SelectObject(memDC, hBitmap); // 保存旧位图
+            // 复用池中的DC/位图/Graphics，不再每次构造都创建
+            buffer = BackBufferPool::Instance().Acquire(width, height);
+            memDC = buffer->dc;
+            graphics = buffer->graphics.get();
 
-            graphics = new Gdiplus::Graphics(memDC);
+            if (buffer->surface.Valid()) canvas.SetSurface(&buffer->surface);
 
-            // 设置抗锯齿
-            if (antiAlias) {
-                graphics->SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
-                graphics->SetTextRenderingHint(Gdiplus::TextRenderingHintAntiAlias);
-            }
+            // 设置抗锯齿（复用的Graphics需要显式设置两种状态）
+            SetAntiAlias(antiAlias);
 
             // 背景设置
-            if (isLayered) {
-                graphics->Clear(Gdiplus::Color(0, 0, 0, 0)); // 透明背景
+            Gdiplus::Color clearColor = isLayered ? Gdiplus::Color(0, 0, 0, 0) : bgColor; // 分层窗口透明背景
+            if (IsSoftware()) {
+                canvas.Clear(ToRasterColor(clearColor));
             }
             else {
-                graphics->Clear(bgColor);
+                graphics->Clear(clearColor);
             }
         }
 
         ~OtterPaintbrush() {
-            delete graphics;
-            DeleteObject(hBitmap);
-            DeleteDC(memDC);
-            ReleaseDC(hwnd, hdc);
-            SelectObject(memDC, hOldBitmap); // 恢复旧位图
+            BackBufferPool::Instance().Release(std::move(buffer));
+        }
+
+        OtterPaintbrush(const OtterPaintbrush&) = delete;
+        OtterPaintbrush& operator=(const OtterPaintbrush&) = delete;
+
+        // 当前绘制后端
+        PaintBackend GetBackend() const { return backend; }
+
+        // 软件后端的绘制表面（GDI+后端同样可用，访问前会同步GDI+）
+        OtterRaster::Surface& GetSurface() {
+            SyncGdi();
+            return buffer->surface;
         }
 
         // === 基本绘图方法 ===
@@ -517,9 +1996,13 @@ namespace OtterWindow {
         void DrawText(const std::wstring& text, int x, int y,
             const std::wstring& fontName = L"Arial", float fontSize = 24.0f,
             Gdiplus::Color color = Gdiplus::Color(255, 255, 255, 255)) {
-            Gdiplus::Font font(fontName.c_str(), fontSize);
-            Gdiplus::SolidBrush brush(color);
-            graphics->DrawString(text.c_str(), -1, &font, Gdiplus::PointF((float)x, (float)y), &brush);
+            if (IsSoftware()) {
+                // 软件后端使用内置字体，fontName 不生效
+                canvas.DrawString(text, (float)x, (float)y, fontSize, ToRasterColor(color));
+                return;
+            }
+            auto& resources = GdiResourceCache::Instance();
+            graphics->DrawString(text.c_str(), -1, resources.GetFont(fontName, fontSize), Gdiplus::PointF((float)x, (float)y), resources.GetBrush(color));
         }
 
         // === 新增绘图方法 ===
@@ -527,47 +2010,187 @@ namespace OtterWindow {
         // 绘制矩形
         void DrawRectangle(int x, int y, int width, int height,
             Gdiplus::Color color, float penWidth = 1.0f) {
-            Gdiplus::Pen pen(color, penWidth);
-            graphics->DrawRectangle(&pen, x, y, width, height);
+            if (IsSoftware()) { canvas.DrawRectangle(x, y, width, height, ToRasterColor(color), penWidth); return; }
+            graphics->DrawRectangle(GdiResourceCache::Instance().GetPen(color, penWidth), x, y, width, height);
         }
 
         // 填充矩形
         void FillRectangle(int x, int y, int width, int height, Gdiplus::Color color) {
-            Gdiplus::SolidBrush brush(color);
-            graphics->FillRectangle(&brush, x, y, width, height);
+            if (IsSoftware()) { canvas.FillRectangle(x, y, width, height, ToRasterColor(color)); return; }
+            graphics->FillRectangle(GdiResourceCache::Instance().GetBrush(color), x, y, width, height);
         }
 
         // 绘制圆形
         void DrawCircle(int x, int y, int radius,
             Gdiplus::Color color, float penWidth = 1.0f) {
-            Gdiplus::Pen pen(color, penWidth);
-            graphics->DrawEllipse(&pen, x - radius, y - radius, radius * 2, radius * 2);
+            if (IsSoftware()) { canvas.DrawCircle(x, y, radius, ToRasterColor(color), penWidth); return; }
+            graphics->DrawEllipse(GdiResourceCache::Instance().GetPen(color, penWidth), x - radius, y - radius, radius * 2, radius * 2);
         }
 
         // 填充圆形
         void FillCircle(int x, int y, int radius, Gdiplus::Color color) {
-            Gdiplus::SolidBrush brush(color);
-            graphics->FillEllipse(&brush, x - radius, y - radius, radius * 2, radius * 2);
+            if (IsSoftware()) { canvas.FillCircle(x, y, radius, ToRasterColor(color)); return; }
+            graphics->FillEllipse(GdiResourceCache::Instance().GetBrush(color), x - radius, y - radius, radius * 2, radius * 2);
         }
 
         // 绘制多边形
         void DrawPolygon(const std::vector<Gdiplus::Point>& points,
             Gdiplus::Color color, float penWidth = 1.0f) {
-            Gdiplus::Pen pen(color, penWidth);
-            graphics->DrawPolygon(&pen, points.data(), (int)points.size());
+            if (IsSoftware()) { canvas.DrawPolygon(points, ToRasterColor(color), penWidth); return; }
+            graphics->DrawPolygon(GdiResourceCache::Instance().GetPen(color, penWidth), points.data(), (int)points.size());
         }
 
         // 填充多边形
         void FillPolygon(const std::vector<Gdiplus::Point>& points, Gdiplus::Color color) {
-            Gdiplus::SolidBrush brush(color);
-            graphics->FillPolygon(&brush, points.data(), (int)points.size());
+            if (IsSoftware()) { canvas.FillPolygon(points, ToRasterColor(color)); return; }
+            graphics->FillPolygon(GdiResourceCache::Instance().GetBrush(color), points.data(), (int)points.size());
         }
 
         // 绘制线条
         void DrawLine(int x1, int y1, int x2, int y2,
             Gdiplus::Color color, float penWidth = 1.0f) {
-            Gdiplus::Pen pen(color, penWidth);
-            graphics->DrawLine(&pen, x1, y1, x2, y2);
+            if (IsSoftware()) { canvas.DrawLine(x1, y1, x2, y2, ToRasterColor(color), penWidth); return; }
+            graphics->DrawLine(GdiResourceCache::Instance().GetPen(color, penWidth), x1, y1, x2, y2);
+        }
+
+        // === 句柄绘图（资源来自 GdiResourceCache，由调用方 Acquire/Release） ===
+
+        void DrawText(const std::wstring& text, int x, int y, FontHandle fontHandle, BrushHandle brushHandle) {
+            auto& resources = GdiResourceCache::Instance();
+            CachedFont* font = resources.Resolve(fontHandle);
+            CachedBrush* brush = resources.Resolve(brushHandle);
+            if (!font || !brush) return;
+            if (IsSoftware()) { canvas.DrawString(text, (float)x, (float)y, font->size, ToRasterColor(brush->color)); return; }
+            graphics->DrawString(text.c_str(), -1, font->font.get(), Gdiplus::PointF((float)x, (float)y), brush->brush.get());
+        }
+
+        void DrawRectangle(int x, int y, int width, int height, PenHandle penHandle) {
+            CachedPen* pen = GdiResourceCache::Instance().Resolve(penHandle);
+            if (!pen) return;
+            if (IsSoftware()) { canvas.DrawRectangle(x, y, width, height, ToRasterColor(pen->color), pen->width); return; }
+            graphics->DrawRectangle(pen->pen.get(), x, y, width, height);
+        }
+
+        void FillRectangle(int x, int y, int width, int height, BrushHandle brushHandle) {
+            CachedBrush* brush = GdiResourceCache::Instance().Resolve(brushHandle);
+            if (!brush) return;
+            if (IsSoftware()) { canvas.FillRectangle(x, y, width, height, ToRasterColor(brush->color)); return; }
+            graphics->FillRectangle(brush->brush.get(), x, y, width, height);
+        }
+
+        void DrawCircle(int x, int y, int radius, PenHandle penHandle) {
+            CachedPen* pen = GdiResourceCache::Instance().Resolve(penHandle);
+            if (!pen) return;
+            if (IsSoftware()) { canvas.DrawCircle(x, y, radius, ToRasterColor(pen->color), pen->width); return; }
+            graphics->DrawEllipse(pen->pen.get(), x - radius, y - radius, radius * 2, radius * 2);
+        }
+
+        void FillCircle(int x, int y, int radius, BrushHandle brushHandle) {
+            CachedBrush* brush = GdiResourceCache::Instance().Resolve(brushHandle);
+            if (!brush) return;
+            if (IsSoftware()) { canvas.FillCircle(x, y, radius, ToRasterColor(brush->color)); return; }
+            graphics->FillEllipse(brush->brush.get(), x - radius, y - radius, radius * 2, radius * 2);
+        }
+
+        void DrawPolygon(const std::vector<Gdiplus::Point>& points, PenHandle penHandle) {
+            CachedPen* pen = GdiResourceCache::Instance().Resolve(penHandle);
+            if (!pen) return;
+            if (IsSoftware()) { canvas.DrawPolygon(points, ToRasterColor(pen->color), pen->width); return; }
+            graphics->DrawPolygon(pen->pen.get(), points.data(), (int)points.size());
+        }
+
+        void FillPolygon(const std::vector<Gdiplus::Point>& points, BrushHandle brushHandle) {
+            CachedBrush* brush = GdiResourceCache::Instance().Resolve(brushHandle);
+            if (!brush) return;
+            if (IsSoftware()) { canvas.FillPolygon(points, ToRasterColor(brush->color)); return; }
+            graphics->FillPolygon(brush->brush.get(), points.data(), (int)points.size());
+        }
+
+        void DrawLine(int x1, int y1, int x2, int y2, PenHandle penHandle) {
+            CachedPen* pen = GdiResourceCache::Instance().Resolve(penHandle);
+            if (!pen) return;
+            if (IsSoftware()) { canvas.DrawLine(x1, y1, x2, y2, ToRasterColor(pen->color), pen->width); return; }
+            graphics->DrawLine(pen->pen.get(), x1, y1, x2, y2);
+        }
+
+        // === 损坏区域 ===
+
+        // 只重绘并呈现 region 覆盖的区域，需在绘制前调用
+        void SetDamage(const OtterRaster::DamageRegion& region) {
+            damage = region;
+            damage.Clip(OtterRaster::Rect(0, 0, width, height));
+            hasDamage = true;
+            damage.ApplyTo(canvas);
+            ApplyDamageClip(*graphics, damage);
+        }
+
+        // 恢复整窗绘制与呈现
+        void ClearDamage() {
+            hasDamage = false;
+            damage.Clear();
+            canvas.ResetClipRects();
+            graphics->ResetClip();
+        }
+
+        // === 显示列表 ===
+
+        // 回放录制好的显示列表（由OtterRaster光栅化，两种后端均可用）
+        void Replay(const OtterRaster::DisplayList& list) {
+            OTTER_TRACE_SCOPE("paint", "Replay");
+            SyncGdi();
+            if (tiles) tiles->Render(list, canvas);
+            else list.Replay(canvas);
+        }
+
+        // 合成图层栈：未变化的图层直接复用缓存
+        void DrawLayers(OtterRaster::LayerStack& layers) {
+            OTTER_TRACE_SCOPE("paint", "DrawLayers");
+            SyncGdi();
+            if (tiles) layers.Compose(canvas, [this](const OtterRaster::DisplayList& list, OtterRaster::Canvas& target) { tiles->Render(list, target); });
+            else layers.Compose(canvas);
+        }
+
+        // 显示列表与图层的光栅化线程数（含UI线程）：大于1时按块并行回放，结果与线程数无关；
+        // 0 为硬件线程数，1 为在UI线程上直接回放（默认）
+        void SetRasterThreads(size_t threads) {
+            if (threads == 1) tiles.reset();
+            else tiles = std::make_unique<OtterRaster::TileRenderer>(threads);
+        }
+
+        size_t GetRasterThreads() const { return tiles ? tiles->ThreadCount() : 1; }
+
+        // 帧耗时叠加图（需定义 OTTER_TRACING），通常在绘制最后调用
+        void DrawTraceOverlay(int x, int y, int width = 240, int height = 72) {
+            SyncGdi();
+            OtterWindow::DrawFrameTimeOverlay(canvas, x, y, width, height);
+        }
+
+        // 浮点路径（直线/二次/三次贝塞尔）：两种后端均由CPU抗锯齿光栅化，直接写入后备缓冲区
+        void FillPath(const OtterRaster::Path& path, Gdiplus::Color color,
+            OtterRaster::FillRule rule = OtterRaster::FillRule::NonZero) {
+            SyncGdi();
+            canvas.FillPath(path, ToRasterColor(color), rule);
+        }
+
+        void DrawPath(const OtterRaster::Path& path, Gdiplus::Color color, float penWidth = 1.0f) {
+            SyncGdi();
+            canvas.StrokePath(path, ToRasterColor(color), penWidth);
+        }
+
+        // 按画笔（拐角、线帽、虚线）描边，描边几何按路径/坐标与画笔缓存，静态线条每帧只需填充
+        void DrawPath(const OtterRaster::Path& path, Gdiplus::Color color, const OtterRaster::StrokeStyle& style) {
+            SyncGdi();
+            canvas.StrokePath(path, ToRasterColor(color), style);
+        }
+
+        void DrawPolyline(const std::vector<Gdiplus::PointF>& points, Gdiplus::Color color, const OtterRaster::StrokeStyle& style) {
+            SyncGdi();
+            canvas.DrawPolyline(points, ToRasterColor(color), style);
+        }
+
+        void DrawPolygon(const std::vector<Gdiplus::PointF>& points, Gdiplus::Color color, const OtterRaster::StrokeStyle& style) {
+            SyncGdi();
+            canvas.DrawPolygon(points, ToRasterColor(color), style);
         }
 
         // === 状态设置 ===
@@ -576,6 +2199,7 @@ namespace OtterWindow {
         // 设置抗锯齿
         void SetAntiAlias(bool enabled) {
             antiAlias = enabled;
+            canvas.SetAntiAlias(enabled);
             if (enabled) {
                 graphics->SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
                 graphics->SetTextRenderingHint(Gdiplus::TextRenderingHintAntiAlias);
@@ -604,6 +2228,7 @@ namespace OtterWindow {
             }
 
             graphics->DrawImage(&image, x, y);
+            if (IsSoftware()) SyncGdi(); // 之后的软件绘制直接写像素
             return true;
         }
 
@@ -613,29 +2238,12 @@ namespace OtterWindow {
             return image.GetWidth() <= maxWidth && image.GetHeight() <= maxHeight;
         }
 
-        // 更新到窗口（保持不变）
+        // 更新到窗口：分层窗口使用UpdateLayeredWindow，传统窗口使用双缓冲；设置了损坏区域时只提交该区域
         void Update() {
-            if (isLayered) {
-                // 分层窗口使用UpdateLayeredWindow
-                BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
-                POINT ptSrc = { 0, 0 };
-                SIZE sizeWnd = { width, height };
-                POINT ptPos = { 0, 0 };
-
-                // 使用窗口DC而不是内存DC
-                HDC windowDC = GetDC(hwnd);
-                UpdateLayeredWindow(
-                    hwnd, windowDC, NULL, &sizeWnd,
-                    memDC, &ptPos, 0, &blend, ULW_ALPHA
-                );
-                ReleaseDC(hwnd, windowDC);
-            }
-            else {
-                // 传统窗口使用双缓冲
-                HDC windowDC = GetDC(hwnd);
-                BitBlt(windowDC, 0, 0, width, height, memDC, 0, 0, SRCCOPY);
-                ReleaseDC(hwnd, windowDC);
-            }
+            OTTER_TRACE_SCOPE("paint", "Update");
+            if (IsSoftware()) GdiFlush();
+            else graphics->Flush(Gdiplus::FlushIntentionSync);
+            PresentBackBuffer(hwnd, memDC, width, height, isLayered, hasDamage ? &damage : nullptr);
         }
     };
 
@@ -1116,21 +2724,31 @@ namespace OtterIMG {
     // 高性能图片渲染器
     class OtterImageRenderer {
     private:
+        OtterWindow::GdiplusSession m_gdiplus;     // 进程内共享的GDI+初始化，最后析构
         HWND m_hWnd;                    // 关联窗口句柄
         bool m_isLayered;               // 是否为分层窗口
         int m_width, m_height;          // 当前窗口尺寸
 
         // 双缓冲相关
-        HDC m_hBackBufferDC;            // 后备缓冲区设备上下文
-        HBITMAP m_hBackBuffer;          // 后备缓冲区位图
-        HBITMAP m_hOldBitmap;           // 保存的旧位图
+        std::unique_ptr<OtterWindow::BackBuffer> m_buffer;  // 后备缓冲区（来自 BackBufferPool）
+        HDC m_hBackBufferDC = NULL;     // 后备缓冲区设备上下文
+
+        // 软件光栅化后端
+        OtterWindow::PaintBackend m_backend = OtterWindow::PaintBackend::GdiPlus;
+        OtterRaster::Canvas m_canvas;
+        std::unique_ptr<OtterRaster::TileRenderer> m_tiles;    // 多线程回放显示列表，未开启时为空
+
+        bool IsSoftware() const { return m_backend == OtterWindow::PaintBackend::Software; }
+
+        // 损坏区域跟踪
+        OtterRaster::DamageRegion m_damage;
+        bool m_damageTracking = false;
 
         // GDI+资源
-        ULONG_PTR m_gdiplusToken;       // GDI+令牌
-        std::unique_ptr<Gdiplus::Graphics> m_pGraphics; // 绘图表面
+        Gdiplus::Graphics* m_pGraphics = nullptr;       // 绘图表面（属于 m_buffer）
 
-        // 图片缓存
-        std::unordered_map<std::wstring, std::unique_ptr<Gdiplus::Bitmap>> m_imageCache;
+        // 图片缓存、精灵图集与后台解码（两种渲染器共用的实现）
+        OtterWindow::ImageLibrary m_images;
 
         //视频参数
 
@@ -1182,35 +2800,40 @@ namespace OtterIMG {
 
         // 平铺图片适应窗口
         bool DrawImageTileWindow(const std::wstring& key, float opacity = 1.0f) {
-            int imgWidth, imgHeight;
-            if (!GetImageSize(key, imgWidth, imgHeight)) {
-                return false;
-            }
-
             RECT rect;
             GetClientRect(m_hWnd, &rect);
-            int windowWidth = rect.right - rect.left;
-            int windowHeight = rect.bottom - rect.top;
-
-            for (int y = 0; y < windowHeight; y += imgHeight) {
-                for (int x = 0; x < windowWidth; x += imgWidth) {
-                    int drawWidth = min(imgWidth, windowWidth - x);
-                    int drawHeight = min(imgHeight, windowHeight - y);
-                    if (!DrawImage(key, x, y, opacity, drawWidth, drawHeight)) {
-                        return false;
-                    }
-                }
-            }
+            return DrawImageTiled(key, 0, 0, rect.right - rect.left, rect.bottom - rect.top, opacity);
+        }
+
+        // 用图片重复平铺填充矩形，offsetX/offsetY 为图案在源图中的起始偏移（可用于滚动纹理）。
+        // 一次查找缓存后逐行混合，边缘的图块按矩形裁剪；开启损坏区域时只填充损坏区域内的部分
+        bool DrawImageTiled(const std::wstring& key, int x, int y, int width, int height,
+            float opacity = 1.0f, int offsetX = 0, int offsetY = 0) {
+            int srcX = 0, srcY = 0, srcWidth = -1, srcHeight = -1;
+            OtterWindow::CachedImage* image = m_images.FindDrawable(key, srcX, srcY, srcWidth, srcHeight);
+            if (!image) return false;
+            if (opacity <= 0.0f || width <= 0 || height <= 0) return true;
+            if (srcWidth == -1) srcWidth = image->Width();
+            if (srcHeight == -1) srcHeight = image->Height();
+            // 图集中的图片只平铺其子矩形
+            const OtterRaster::Surface pattern = OtterRaster::Surface::Wrap(image->pixels.Row(srcY) + srcX,
+                srcWidth, srcHeight, image->pixels.Stride());
+
+            SyncGdi();
+            OtterRaster::Surface* surface = m_canvas.GetSurface();
+            if (!surface) return false;
+            const OtterRaster::Point origin = m_canvas.GetOrigin();
+            const OtterRaster::Rect area(x + origin.X, y + origin.Y, width, height);
+            m_canvas.ForEachClip([&](const OtterRaster::Rect& clip) {
+                OtterRaster::Blit::FillPattern(*surface, clip, area, pattern,
+                    area.x - offsetX, area.y - offsetY, opacity);
+            });
             return true;
         }
 
         // 构造函数
         OtterImageRenderer(HWND hWnd, bool isLayered)
-            : m_hWnd(hWnd), m_isLayered(isLayered) {
-
-            // 初始化GDI+
-            Gdiplus::GdiplusStartupInput gdiplusStartupInput;
-            Gdiplus::GdiplusStartup(&m_gdiplusToken, &gdiplusStartupInput, NULL);
+            : m_hWnd(hWnd), m_isLayered(isLayered), m_images(hWnd) {
 
             // 初始化双缓冲
             InitializeBackBuffer();
@@ -1218,15 +2841,11 @@ namespace OtterIMG {
 
         // 析构函数
         ~OtterImageRenderer() {
-            // 清理双缓冲资源
-            if (m_hBackBufferDC) {
-                SelectObject(m_hBackBufferDC, m_hOldBitmap);
-                DeleteObject(m_hBackBuffer);
-                DeleteDC(m_hBackBufferDC);
-            }
+            m_images.Shutdown();    // 工作线程使用GDI+，须在 m_gdiplus 释放之前退出
 
-            // 清理GDI+
-            Gdiplus::GdiplusShutdown(m_gdiplusToken);
+            // 归还双缓冲资源
+            m_canvas.SetSurface(nullptr);
+            OtterWindow::BackBufferPool::Instance().Release(std::move(m_buffer));
         }
 
         // 初始化双缓冲
@@ -1236,26 +2855,41 @@ namespace OtterIMG {
             m_width = rect.right - rect.left;
             m_height = rect.bottom - rect.top;
 
-            // 清理旧资源
-            if (m_hBackBufferDC) {
-                SelectObject(m_hBackBufferDC, m_hOldBitmap);
-                DeleteObject(m_hBackBuffer);
-                DeleteDC(m_hBackBufferDC);
-            }
+            // 旧缓冲区归还到池中；同一尺寸档位内缩放会直接取回同一块缓冲区
+            auto& pool = OtterWindow::BackBufferPool::Instance();
+            pool.Release(std::move(m_buffer));
+            m_buffer = pool.Acquire(m_width, m_height);
+            m_hBackBufferDC = m_buffer->dc;
 
-            HDC hdc = GetDC(m_hWnd);
+            // GDI+绘图表面
+            m_pGraphics = m_buffer->graphics.get();
+            SetAntiAlias(m_canvas.GetAntiAlias());
 
-            // 创建兼容DC和位图
-            m_hBackBufferDC = CreateCompatibleDC(hdc);
-            m_hBackBuffer = CreateCompatibleBitmap(hdc, m_width, m_height);
-            m_hOldBitmap = (HBITMAP)SelectObject(m_hBackBufferDC, m_hBackBuffer);
+            // 软件光栅化表面包装同一块像素
+            m_canvas.SetSurface(m_buffer->surface.Valid() ? &m_buffer->surface : nullptr);
 
-            // 创建GDI+绘图表面
-            m_pGraphics = std::make_unique<Gdiplus::Graphics>(m_hBackBufferDC);
-            m_pGraphics->SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
-            m_pGraphics->SetTextRenderingHint(Gdiplus::TextRenderingHintAntiAlias);
+            // 缓冲区内容未定义，整窗损坏
+            m_damage.SetFull(OtterRaster::Rect(0, 0, m_width, m_height));
+        }
 
-            ReleaseDC(m_hWnd, hdc);
+        // 设置绘制后端（图元与文本；图片仍由GDI+绘制）
+        void SetBackend(OtterWindow::PaintBackend backend) {
+            SyncGdi();
+            m_backend = backend;
+        }
+
+        OtterWindow::PaintBackend GetBackend() const { return m_backend; }
+
+        // 后备缓冲区表面（访问前同步GDI+）
+        OtterRaster::Surface& GetSurface() {
+            SyncGdi();
+            return m_buffer->surface;
+        }
+
+        // GDI+/GDI 绘制后同步，保证直接访问像素时内容完整
+        void SyncGdi() {
+            if (m_pGraphics) m_pGraphics->Flush(Gdiplus::FlushIntentionSync);
+            GdiFlush();
         }
 
         // 更新窗口尺寸
@@ -1266,66 +2900,62 @@ namespace OtterIMG {
             int newHeight = rect.bottom - rect.top;
 
             if (newWidth != m_width || newHeight != m_height) {
-                m_width = newWidth;
-                m_height = newHeight;
-
-                // 重新创建双缓冲
-                SelectObject(m_hBackBufferDC, m_hOldBitmap);
-                DeleteObject(m_hBackBuffer);
-                DeleteDC(m_hBackBufferDC);
-
+                // 重新创建双缓冲（InitializeBackBuffer 会释放旧资源）
                 InitializeBackBuffer();
             }
         }
 
         // 加载图片到缓存
-        bool LoadImage(const std::wstring& key, const std::wstring& filePath) {
-            if (m_imageCache.find(key) != m_imageCache.end()) {
-                return true; // 已加载
-            }
+        bool LoadImage(const std::wstring& key, const std::wstring& filePath) { return m_images.Load(key, filePath); }
 
-            if (!PathFileExists(filePath.c_str())) {
-                OutputDebugStringW((L"图片文件不存在: " + filePath + L"\n").c_str());
-                return false;
-            }
+        // 从内存加载图片
+        bool LoadImageFromMemory(const std::wstring& key, const BYTE* data, size_t size) {
+            return m_images.LoadFromMemory(key, data, size);
+        }
 
-            try {
-                auto bitmap = std::make_unique<Gdiplus::Bitmap>(filePath.c_str());
-                if (bitmap->GetLastStatus() != Gdiplus::Ok) {
-                    OutputDebugStringW((L"图片加载失败: " + filePath + L"\n").c_str());
-                    return false;
-                }
+        // === 损坏区域 ===
 
-                m_imageCache[key] = std::move(bitmap);
-                return true;
-            }
-            catch (...) {
-                OutputDebugStringW(L"图片加载异常\n");
-                return false;
-            }
+        // 开启后每帧只清空、绘制并呈现损坏区域；未开启时每帧整窗重绘（默认）
+        void EnableDamageTracking(bool enabled) {
+            m_damageTracking = enabled;
+            m_damage.SetFull(OtterRaster::Rect(0, 0, m_width, m_height));
         }
 
-        // 从内存加载图片
-        bool LoadImageFromMemory(const std::wstring& key, const BYTE* data, size_t size) {
-            IStream* pStream = SHCreateMemStream(data, static_cast<UINT>(size));
-            if (!pStream) return false;
+        bool IsDamageTracking() const { return m_damageTracking; }
 
-            auto bitmap = std::make_unique<Gdiplus::Bitmap>(pStream);
-            pStream->Release();
+        // 标记需要重绘的矩形
+        void Invalidate(int x, int y, int width, int height) {
+            m_damage.Add(OtterRaster::Rect(x, y, width, height));
+        }
 
-            if (bitmap->GetLastStatus() != Gdiplus::Ok) {
-                return false;
-            }
+        void InvalidateAll() {
+            m_damage.SetFull(OtterRaster::Rect(0, 0, m_width, m_height));
+        }
 
-            m_imageCache[key] = std::move(bitmap);
-            return true;
+        // 把图层栈中变化的图层区域加入损坏区域（在 BeginFrame 之前调用）
+        void InvalidateLayers(const OtterRaster::LayerStack& layers) {
+            layers.CollectDamage(m_damage, OtterRaster::Rect(0, 0, m_width, m_height));
         }
 
+        const OtterRaster::DamageRegion& GetDamage() const { return m_damage; }
+
         // 开始绘制帧
         void BeginFrame(Gdiplus::Color clearColor = Gdiplus::Color(0, 0, 0, 0)) {
+            OTTER_TRACE_SCOPE("paint", "BeginFrame");
+            PumpImageLoads();
+            m_images.Cache().Trim();
+            if (m_damageTracking) {
+                m_damage.Clip(OtterRaster::Rect(0, 0, m_width, m_height));
+                m_damage.ApplyTo(m_canvas);
+                OtterWindow::ApplyDamageClip(*m_pGraphics, m_damage);
+            }
+
             // 清空背景
             if (m_isLayered) {
-                m_pGraphics->Clear(Gdiplus::Color(0, 0, 0, 0)); // 透明背景
+                clearColor = Gdiplus::Color(0, 0, 0, 0); // 透明背景
+            }
+            if (IsSoftware()) {
+                m_canvas.Clear(OtterWindow::ToRasterColor(clearColor));
             }
             else {
                 m_pGraphics->Clear(clearColor);
@@ -1341,10 +2971,11 @@ namespace OtterIMG {
             int srcX = 0, int srcY = 0,
             int srcWidth = -1, int srcHeight = -1) {
 
-            auto it = m_imageCache.find(key);
-            if (it == m_imageCache.end()) return false;
+            OTTER_TRACE_SCOPE("paint", "DrawImage");
+            OtterWindow::CachedImage* image = m_images.FindDrawable(key, srcX, srcY, srcWidth, srcHeight);
+            if (!image) return m_images.DrawPlaceholder(key, *m_pGraphics, x, y, destWidth, destHeight);
 
-            Gdiplus::Bitmap* pBitmap = it->second.get();
+            Gdiplus::Bitmap* pBitmap = image->bitmap.get();
 
             // 计算源矩形
             if (srcWidth == -1) srcWidth = pBitmap->GetWidth();
@@ -1354,6 +2985,25 @@ namespace OtterIMG {
             if (destWidth == -1) destWidth = srcWidth;
             if (destHeight == -1) destHeight = srcHeight;
 
+            if (opacity <= 0.0f) return true;
+
+            // 整幅图片缩放绘制：取缓存的缩放结果（从最接近的 mip 级插值得到）后直接混合
+            if ((destWidth != srcWidth || destHeight != srcHeight) && destWidth > 0 && destHeight > 0 &&
+                srcX == 0 && srcY == 0 && srcWidth == image->Width() && srcHeight == image->Height()) {
+                SyncGdi();
+                OtterRaster::Blit::DrawSurface(m_canvas, m_images.Scaled(key, *image, destWidth, destHeight),
+                    x, y, opacity);
+                return true;
+            }
+
+            // 不缩放的半透明绘制直接对预乘像素做SIMD混合，不走GDI+ ColorMatrix的通用路径
+            if (opacity < 1.0f && destWidth == srcWidth && destHeight == srcHeight) {
+                SyncGdi();
+                OtterRaster::Blit::DrawSurface(m_canvas, image->pixels,
+                    OtterRaster::Rect(srcX, srcY, srcWidth, srcHeight), x, y, opacity);
+                return true;
+            }
+
             // 使用透明度
             if (opacity < 1.0f) {
                 Gdiplus::ColorMatrix matrix = {
@@ -1392,95 +3042,162 @@ namespace OtterIMG {
                 }
             }
 
+            if (IsSoftware()) SyncGdi();
             return true;
         }
 
-        // 结束帧并呈现
+        // 结束帧并呈现（损坏区域跟踪开启时只提交损坏区域）
         void EndFrame() {
-            HDC hdc = GetDC(m_hWnd);
+            OTTER_TRACE_SCOPE("paint", "EndFrame");
+            SyncGdi();
+            OtterWindow::PresentBackBuffer(m_hWnd, m_hBackBufferDC, m_width, m_height, m_isLayered,
+                m_damageTracking ? &m_damage : nullptr);
 
-            if (m_isLayered) {
-                BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
-                SIZE size = { m_width, m_height };
-                POINT ptSrc = { 0, 0 };
-                UpdateLayeredWindow(
-                    m_hWnd, hdc, NULL, &size,
-                    m_hBackBufferDC, &ptSrc, 0, &blend, ULW_ALPHA);
-            }
-            else {
-                BitBlt(hdc, 0, 0, m_width, m_height, m_hBackBufferDC, 0, 0, SRCCOPY);
+            if (m_damageTracking) {
+                m_damage.Clear();
+                m_canvas.ResetClipRects();
+                m_pGraphics->ResetClip();
             }
-
-            ReleaseDC(m_hWnd, hdc);
         }
 
         // 其他实用方法
         bool GetImageSize(const std::wstring& key, int& width, int& height) {
-            auto it = m_imageCache.find(key);
-            if (it == m_imageCache.end()) return false;
+            return m_images.GetSize(key, width, height);
+        }
 
-            width = it->second->GetWidth();
-            height = it->second->GetHeight();
-            return true;
+        // 图集中的图片只解除映射，页内空间不回收（ClearCache 时整体释放）
+        void RemoveImage(const std::wstring& key) { m_images.Remove(key); }
+
+        void ClearCache() { m_images.Clear(); }
+
+        // 图片缓存内存预算（字节），0 为不限制（默认）；超出时淘汰最久未用、可从文件重新加载的图片
+        void SetImageMemoryBudget(size_t bytes) { m_images.Cache().SetBudget(bytes); }
+
+        // 命中率、重新加载次数、常驻字节数等
+        OtterWindow::ImageCache::Stats GetImageCacheStats() const { return m_images.Cache().GetStats(); }
+
+        // 进程内共享图片存储的统计（所有渲染器共用）：解码次数、同文件共享与内容合并次数、存活字节数
+        OtterWindow::SharedImageStore::Stats GetSharedImageStats() const { return OtterWindow::SharedImageStore::Instance().GetStats(); }
+
+        // === 精灵图集 ===
+
+        // 开启后，之后加载的不超过 maxSprite 的小图片装入共享的图集页（页大小 pageSize），
+        // 不再各自占用一个缓存项；DrawImage 等按键绘制自动换算到页内子矩形。尺寸参数只在图集为空时生效
+        void EnableSpriteAtlas(bool enabled, int pageSize = OtterRaster::SpriteAtlas::kDefaultPageSize,
+            int maxSprite = OtterRaster::SpriteAtlas::kDefaultMaxSprite) {
+            m_images.Atlas().Enable(enabled, pageSize, maxSprite);
+        }
+
+        bool IsSpriteAtlasEnabled() const { return m_images.Atlas().Enabled(); }
+
+        // 把已加载的图片移入图集；一次移入多张时按高度排序装入，比逐张加载更紧凑。返回移入的张数
+        size_t AddToAtlas(const std::vector<std::wstring>& keys) { return m_images.Atlas().AddLoaded(keys); }
+
+        bool IsInAtlas(const std::wstring& key) const { return m_images.Atlas().Contains(key); }
+
+        // 页数、图片数与装箱效率（图片像素占页面积的比例）
+        OtterRaster::SpriteAtlas::Stats GetAtlasStats() const { return m_images.Atlas().GetStats(); }
+
+        // 绘制次数与合并后的段数（同一页的连续绘制算一段）
+        const OtterRaster::SpriteBatch::Stats& GetSpriteBatchStats() const { return m_images.Atlas().GetBatchStats(); }
+
+        // 批量不缩放地绘制图片，按顺序合成；图集中连续位于同一页的图片合并为一段直接混合，
+        // 不在图集中的图片逐个走 DrawImage
+        void DrawSprites(const std::vector<OtterWindow::SpriteDraw>& draws) {
+            const OtterRaster::Surface* surface = m_canvas.GetSurface();
+            m_images.Atlas().DrawSprites(draws, surface && surface->Valid(),
+                [this](OtterRaster::SpriteBatch& batch, const OtterRaster::SpriteAtlas& atlas) {
+                    SyncGdi();
+                    batch.Flush(atlas, m_canvas);   // 按画布原点与损坏区域裁剪
+                },
+                [this](const OtterWindow::SpriteDraw& draw) { DrawImage(draw.key, draw.x, draw.y, draw.opacity); });
+        }
+
+        // 映射预解码的资源包（WriteImagePack 生成）并登记其中全部图片，启动时不再逐个打开与解码文件
+        size_t LoadImagePack(const std::wstring& packPath) {
+            return m_images.LoadPack(packPath);
         }
 
-        void RemoveImage(const std::wstring& key) {
-            m_imageCache.erase(key);
+        // === 后台加载 ===
+
+        // 立即返回，在工作线程上解码；完成后由下一次 BeginFrame 放入缓存。priority 见 OtterAsync::kPriority*
+        bool LoadImageAsync(const std::wstring& key, const std::wstring& filePath,
+            int priority = OtterAsync::kPriorityNormal) {
+            return m_images.LoadAsync(key, filePath, priority);
         }
 
-        void ClearCache() {
-            m_imageCache.clear();
+        // 调整尚未开始解码的图片的优先级（如滚动后变为可见）
+        bool SetImagePriority(const std::wstring& key, int priority) { return m_images.Loader().SetPriority(key, priority); }
+
+        bool CancelImageLoad(const std::wstring& key) { return m_images.Loader().Cancel(key); }
+
+        bool IsImageLoading(const std::wstring& key) const { return m_images.Loader().IsLoading(key); }
+
+        // 图片就绪或加载失败时在UI线程调用
+        void SetImageReadyCallback(OtterWindow::AsyncImageLoader::ReadyCallback callback) {
+            m_images.Loader().SetReadyCallback(std::move(callback));
         }
 
+        // 工作线程每完成一张图片的唤醒方式，默认 InvalidateRect 关联窗口
+        void SetImageLoadNotify(std::function<void()> notify) { m_images.Loader().SetNotify(std::move(notify)); }
+
+        // 加载中的图片以此颜色填充目标矩形（需指定 destWidth/destHeight）；透明（默认）时跳过不画
+        void SetImagePlaceholder(Gdiplus::Color color) { m_images.SetPlaceholder(color); }
+
+        OtterAsync::DecodeStats GetImageLoadStats() const { return m_images.Loader().GetStats(); }
+
+        // 把后台解码完成的图片放入缓存，返回张数；BeginFrame 会自动调用
+        size_t PumpImageLoads() { return m_images.Pump(m_damageTracking ? &m_damage : nullptr); }
+
         //图片绘制
         // 绘制线条
         void DrawLine(int x1, int y1, int x2, int y2,
             Gdiplus::Color color, float width = 1.0f) {
-            Gdiplus::Pen pen(color, width);
-            m_pGraphics->DrawLine(&pen, x1, y1, x2, y2);
+            if (IsSoftware()) { m_canvas.DrawLine(x1, y1, x2, y2, OtterWindow::ToRasterColor(color), width); return; }
+            m_pGraphics->DrawLine(OtterWindow::GdiResourceCache::Instance().GetPen(color, width), x1, y1, x2, y2);
         }
 
         // 绘制矩形（空心）
         void DrawRectangle(int x, int y, int width, int height,
             Gdiplus::Color color, float penWidth = 1.0f) {
-            Gdiplus::Pen pen(color, penWidth);
-            m_pGraphics->DrawRectangle(&pen, x, y, width, height);
+            if (IsSoftware()) { m_canvas.DrawRectangle(x, y, width, height, OtterWindow::ToRasterColor(color), penWidth); return; }
+            m_pGraphics->DrawRectangle(OtterWindow::GdiResourceCache::Instance().GetPen(color, penWidth), x, y, width, height);
         }
 
         // 填充矩形（实心）
         void FillRectangle(int x, int y, int width, int height,
             Gdiplus::Color color) {
-            Gdiplus::SolidBrush brush(color);
-            m_pGraphics->FillRectangle(&brush, x, y, width, height);
+            if (IsSoftware()) { m_canvas.FillRectangle(x, y, width, height, OtterWindow::ToRasterColor(color)); return; }
+            m_pGraphics->FillRectangle(OtterWindow::GdiResourceCache::Instance().GetBrush(color), x, y, width, height);
         }
 
         // 绘制圆形（空心）
         void DrawCircle(int x, int y, int radius,
             Gdiplus::Color color, float penWidth = 1.0f) {
-            Gdiplus::Pen pen(color, penWidth);
-            m_pGraphics->DrawEllipse(&pen, x - radius, y - radius,
+            if (IsSoftware()) { m_canvas.DrawCircle(x, y, radius, OtterWindow::ToRasterColor(color), penWidth); return; }
+            m_pGraphics->DrawEllipse(OtterWindow::GdiResourceCache::Instance().GetPen(color, penWidth), x - radius, y - radius,
                 radius * 2, radius * 2);
         }
 
         // 填充圆形（实心）
         void FillCircle(int x, int y, int radius, Gdiplus::Color color) {
-            Gdiplus::SolidBrush brush(color);
-            m_pGraphics->FillEllipse(&brush, x - radius, y - radius,
+            if (IsSoftware()) { m_canvas.FillCircle(x, y, radius, OtterWindow::ToRasterColor(color)); return; }
+            m_pGraphics->FillEllipse(OtterWindow::GdiResourceCache::Instance().GetBrush(color), x - radius, y - radius,
                 radius * 2, radius * 2);
         }
 
         // 绘制多边形（空心）
         void DrawPolygon(const std::vector<Gdiplus::Point>& points,
             Gdiplus::Color color, float penWidth = 1.0f) {
-            Gdiplus::Pen pen(color, penWidth);
-            m_pGraphics->DrawPolygon(&pen, points.data(), (int)points.size());
+            if (IsSoftware()) { m_canvas.DrawPolygon(points, OtterWindow::ToRasterColor(color), penWidth); return; }
+            m_pGraphics->DrawPolygon(OtterWindow::GdiResourceCache::Instance().GetPen(color, penWidth), points.data(), (int)points.size());
         }
 
         // 填充多边形（实心）
         void FillPolygon(const std::vector<Gdiplus::Point>& points,
             Gdiplus::Color color) {
-            Gdiplus::SolidBrush brush(color);
-            m_pGraphics->FillPolygon(&brush, points.data(), (int)points.size());
+            if (IsSoftware()) { m_canvas.FillPolygon(points, OtterWindow::ToRasterColor(color)); return; }
+            m_pGraphics->FillPolygon(OtterWindow::GdiResourceCache::Instance().GetBrush(color), points.data(), (int)points.size());
         }
 
         // 绘制文本
@@ -1488,14 +3205,109 @@ namespace OtterIMG {
             const std::wstring& fontName = L"Arial",
             float fontSize = 12.0f,
             Gdiplus::Color color = Gdiplus::Color(255, 0, 0, 0)) {
-            Gdiplus::Font font(fontName.c_str(), fontSize);
-            Gdiplus::SolidBrush brush(color);
-            m_pGraphics->DrawString(text.c_str(), -1, &font,
-                Gdiplus::PointF((float)x, (float)y), &brush);
+            if (IsSoftware()) {
+                // 软件后端使用内置字体，fontName 不生效
+                m_canvas.DrawString(text, (float)x, (float)y, fontSize, OtterWindow::ToRasterColor(color));
+                return;
+            }
+            auto& resources = OtterWindow::GdiResourceCache::Instance();
+            m_pGraphics->DrawString(text.c_str(), -1, resources.GetFont(fontName, fontSize),
+                Gdiplus::PointF((float)x, (float)y), resources.GetBrush(color));
+        }
+
+        // === 句柄绘图（资源来自 OtterWindow::GdiResourceCache，由调用方 Acquire/Release） ===
+
+        void DrawText(const std::wstring& text, int x, int y, OtterWindow::FontHandle fontHandle, OtterWindow::BrushHandle brushHandle) {
+            auto& resources = OtterWindow::GdiResourceCache::Instance();
+            OtterWindow::CachedFont* font = resources.Resolve(fontHandle);
+            OtterWindow::CachedBrush* brush = resources.Resolve(brushHandle);
+            if (!font || !brush) return;
+            if (IsSoftware()) { m_canvas.DrawString(text, (float)x, (float)y, font->size, OtterWindow::ToRasterColor(brush->color)); return; }
+            m_pGraphics->DrawString(text.c_str(), -1, font->font.get(), Gdiplus::PointF((float)x, (float)y), brush->brush.get());
+        }
+
+        void DrawRectangle(int x, int y, int width, int height, OtterWindow::PenHandle penHandle) {
+            OtterWindow::CachedPen* pen = OtterWindow::GdiResourceCache::Instance().Resolve(penHandle);
+            if (!pen) return;
+            if (IsSoftware()) { m_canvas.DrawRectangle(x, y, width, height, OtterWindow::ToRasterColor(pen->color), pen->width); return; }
+            m_pGraphics->DrawRectangle(pen->pen.get(), x, y, width, height);
+        }
+
+        void FillRectangle(int x, int y, int width, int height, OtterWindow::BrushHandle brushHandle) {
+            OtterWindow::CachedBrush* brush = OtterWindow::GdiResourceCache::Instance().Resolve(brushHandle);
+            if (!brush) return;
+            if (IsSoftware()) { m_canvas.FillRectangle(x, y, width, height, OtterWindow::ToRasterColor(brush->color)); return; }
+            m_pGraphics->FillRectangle(brush->brush.get(), x, y, width, height);
+        }
+
+        void DrawCircle(int x, int y, int radius, OtterWindow::PenHandle penHandle) {
+            OtterWindow::CachedPen* pen = OtterWindow::GdiResourceCache::Instance().Resolve(penHandle);
+            if (!pen) return;
+            if (IsSoftware()) { m_canvas.DrawCircle(x, y, radius, OtterWindow::ToRasterColor(pen->color), pen->width); return; }
+            m_pGraphics->DrawEllipse(pen->pen.get(), x - radius, y - radius, radius * 2, radius * 2);
+        }
+
+        void FillCircle(int x, int y, int radius, OtterWindow::BrushHandle brushHandle) {
+            OtterWindow::CachedBrush* brush = OtterWindow::GdiResourceCache::Instance().Resolve(brushHandle);
+            if (!brush) return;
+            if (IsSoftware()) { m_canvas.FillCircle(x, y, radius, OtterWindow::ToRasterColor(brush->color)); return; }
+            m_pGraphics->FillEllipse(brush->brush.get(), x - radius, y - radius, radius * 2, radius * 2);
+        }
+
+        void DrawPolygon(const std::vector<Gdiplus::Point>& points, OtterWindow::PenHandle penHandle) {
+            OtterWindow::CachedPen* pen = OtterWindow::GdiResourceCache::Instance().Resolve(penHandle);
+            if (!pen) return;
+            if (IsSoftware()) { m_canvas.DrawPolygon(points, OtterWindow::ToRasterColor(pen->color), pen->width); return; }
+            m_pGraphics->DrawPolygon(pen->pen.get(), points.data(), (int)points.size());
+        }
+
+        void FillPolygon(const std::vector<Gdiplus::Point>& points, OtterWindow::BrushHandle brushHandle) {
+            OtterWindow::CachedBrush* brush = OtterWindow::GdiResourceCache::Instance().Resolve(brushHandle);
+            if (!brush) return;
+            if (IsSoftware()) { m_canvas.FillPolygon(points, OtterWindow::ToRasterColor(brush->color)); return; }
+            m_pGraphics->FillPolygon(brush->brush.get(), points.data(), (int)points.size());
+        }
+
+        void DrawLine(int x1, int y1, int x2, int y2, OtterWindow::PenHandle penHandle) {
+            OtterWindow::CachedPen* pen = OtterWindow::GdiResourceCache::Instance().Resolve(penHandle);
+            if (!pen) return;
+            if (IsSoftware()) { m_canvas.DrawLine(x1, y1, x2, y2, OtterWindow::ToRasterColor(pen->color), pen->width); return; }
+            m_pGraphics->DrawLine(pen->pen.get(), x1, y1, x2, y2);
+        }
+
+        // 回放显示列表
+        void Replay(const OtterRaster::DisplayList& list) {
+            OTTER_TRACE_SCOPE("paint", "Replay");
+            SyncGdi();
+            if (m_tiles) m_tiles->Render(list, m_canvas);
+            else list.Replay(m_canvas);
+        }
+
+        // 合成图层栈
+        void DrawLayers(OtterRaster::LayerStack& layers) {
+            OTTER_TRACE_SCOPE("paint", "DrawLayers");
+            SyncGdi();
+            if (m_tiles) layers.Compose(m_canvas, [this](const OtterRaster::DisplayList& list, OtterRaster::Canvas& target) { m_tiles->Render(list, target); });
+            else layers.Compose(m_canvas);
+        }
+
+        // 显示列表与图层的光栅化线程数（含UI线程），大于1时按块并行回放；0 为硬件线程数，1 为不并行（默认）
+        void SetRasterThreads(size_t threads) {
+            if (threads == 1) m_tiles.reset();
+            else m_tiles = std::make_unique<OtterRaster::TileRenderer>(threads);
+        }
+
+        size_t GetRasterThreads() const { return m_tiles ? m_tiles->ThreadCount() : 1; }
+
+        // 帧耗时叠加图（需定义 OTTER_TRACING），在 EndFrame 前调用
+        void DrawTraceOverlay(int x, int y, int width = 240, int height = 72) {
+            SyncGdi();
+            OtterWindow::DrawFrameTimeOverlay(m_canvas, x, y, width, height);
         }
 
         // 设置抗锯齿
         void SetAntiAlias(bool enabled) {
+            m_canvas.SetAntiAlias(enabled);
             if (enabled) {
                 m_pGraphics->SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
                 m_pGraphics->SetTextRenderingHint(Gdiplus::TextRenderingHintAntiAlias);
@@ -1506,21 +3318,22 @@ namespace OtterIMG {
             }
         }
 
-        // 创建颜色渐变画刷
-        Gdiplus::LinearGradientBrush* CreateGradientBrush(
+        // 创建线性渐变画刷（值类型，无需释放；相同颜色的画刷共享缓存的颜色查找表，可每帧重新创建）
+        OtterRaster::GradientPaint CreateGradientBrush(
             int x1, int y1, int x2, int y2,
             Gdiplus::Color startColor, Gdiplus::Color endColor) {
-            return new Gdiplus::LinearGradientBrush(
-                Gdiplus::Point(x1, y1),
-                Gdiplus::Point(x2, y2),
-                startColor,
-                endColor);
+            return OtterRaster::GradientPaint::Linear(
+                OtterRaster::PointF((float)x1, (float)y1),
+                OtterRaster::PointF((float)x2, (float)y2),
+                OtterWindow::ToRasterColor(startColor),
+                OtterWindow::ToRasterColor(endColor));
         }
 
         // 使用渐变画刷填充矩形
         void FillRectangleWithBrush(int x, int y, int width, int height,
             Gdiplus::Brush* brush) {
             m_pGraphics->FillRectangle(brush, x, y, width, height);
+            if (IsSoftware()) SyncGdi();
         }
 
         // 使用渐变画刷填充圆形
@@ -1528,12 +3341,67 @@ namespace OtterIMG {
             Gdiplus::Brush* brush) {
             m_pGraphics->FillEllipse(brush, x - radius, y - radius,
                 radius * 2, radius * 2);
+            if (IsSoftware()) SyncGdi();
         }
 
         // 使用渐变画刷填充多边形
         void FillPolygonWithBrush(const std::vector<Gdiplus::Point>& points,
             Gdiplus::Brush* brush) {
             m_pGraphics->FillPolygon(brush, points.data(), (int)points.size());
+            if (IsSoftware()) SyncGdi();
+        }
+
+        // 渐变画刷（OtterRaster::GradientPaint）填充：两种后端均由CPU逐行查表着色，直接写入后备缓冲区
+        void FillRectangleWithBrush(int x, int y, int width, int height,
+            const OtterRaster::GradientPaint& paint) {
+            SyncGdi();
+            m_canvas.FillRectangle(x, y, width, height, paint);
+        }
+
+        void FillCircleWithBrush(int x, int y, int radius,
+            const OtterRaster::GradientPaint& paint) {
+            SyncGdi();
+            m_canvas.FillCircle(x, y, radius, paint);
+        }
+
+        void FillPolygonWithBrush(const std::vector<Gdiplus::Point>& points,
+            const OtterRaster::GradientPaint& paint) {
+            SyncGdi();
+            m_canvas.FillPolygon(points, paint);
+        }
+
+        void FillPathWithBrush(const OtterRaster::Path& path, const OtterRaster::GradientPaint& paint,
+            OtterRaster::FillRule rule = OtterRaster::FillRule::NonZero) {
+            SyncGdi();
+            m_canvas.FillPath(path, paint, rule);
+        }
+
+        // 浮点路径（直线/二次/三次贝塞尔）：两种后端均由CPU抗锯齿光栅化，直接写入后备缓冲区
+        void FillPath(const OtterRaster::Path& path, Gdiplus::Color color,
+            OtterRaster::FillRule rule = OtterRaster::FillRule::NonZero) {
+            SyncGdi();
+            m_canvas.FillPath(path, OtterWindow::ToRasterColor(color), rule);
+        }
+
+        void DrawPath(const OtterRaster::Path& path, Gdiplus::Color color, float penWidth = 1.0f) {
+            SyncGdi();
+            m_canvas.StrokePath(path, OtterWindow::ToRasterColor(color), penWidth);
+        }
+
+        // 按画笔（拐角、线帽、虚线）描边，描边几何按路径/坐标与画笔缓存，静态线条每帧只需填充
+        void DrawPath(const OtterRaster::Path& path, Gdiplus::Color color, const OtterRaster::StrokeStyle& style) {
+            SyncGdi();
+            m_canvas.StrokePath(path, OtterWindow::ToRasterColor(color), style);
+        }
+
+        void DrawPolyline(const std::vector<Gdiplus::PointF>& points, Gdiplus::Color color, const OtterRaster::StrokeStyle& style) {
+            SyncGdi();
+            m_canvas.DrawPolyline(points, OtterWindow::ToRasterColor(color), style);
+        }
+
+        void DrawPolygon(const std::vector<Gdiplus::PointF>& points, Gdiplus::Color color, const OtterRaster::StrokeStyle& style) {
+            SyncGdi();
+            m_canvas.DrawPolygon(points, OtterWindow::ToRasterColor(color), style);
         }
 
 
@@ -1541,23 +3409,24 @@ namespace OtterIMG {
 
     class UltimateImageRenderer {
     private:
+        OtterWindow::GdiplusSession m_gdiplus;     // 进程内共享的GDI+初始化，最后析构
         HWND m_hWnd;                    // 关联窗口句柄
         bool m_isActive;                // 渲染器是否激活
         bool m_isLayered;               // 是否为分层窗口
         bool m_isSizeDirty;             // 尺寸是否需要更新
 
-        // 双缓冲资源
+        // 双缓冲资源（32位DIB，像素可直接读写）
         HDC m_hBackBufferDC;
         HBITMAP m_hBackBuffer;
         HBITMAP m_hOldBitmap;
         int m_bufferWidth, m_bufferHeight;
+        OtterRaster::Surface m_surface;     // 包装 m_hBackBuffer 的像素
 
         // GDI+资源
-        ULONG_PTR m_gdiplusToken;
         std::unique_ptr<Gdiplus::Graphics> m_pGraphics;
 
-        // 图片缓存
-        std::unordered_map<std::wstring, std::unique_ptr<Gdiplus::Bitmap>> m_imageCache;
+        // 图片缓存、精灵图集与后台解码（两种渲染器共用的实现）
+        OtterWindow::ImageLibrary m_images;
 
         // 私有方法
         void CleanupBackBuffer() {
@@ -1574,6 +3443,7 @@ namespace OtterIMG {
                 m_hBackBufferDC = NULL;
             }
             m_pGraphics.reset();
+            m_surface = OtterRaster::Surface();
         }
 
         void SetupBackBuffer(int width, int height) {
@@ -1581,8 +3451,10 @@ namespace OtterIMG {
 
             HDC hdc = GetDC(m_hWnd);
             m_hBackBufferDC = CreateCompatibleDC(hdc);
-            m_hBackBuffer = CreateCompatibleBitmap(hdc, width, height);
+            void* bits = nullptr;
+            m_hBackBuffer = OtterWindow::CreateBackBufferDIB(hdc, width, height, &bits);
             m_hOldBitmap = (HBITMAP)SelectObject(m_hBackBufferDC, m_hBackBuffer);
+            if (bits) m_surface = OtterRaster::Surface::Wrap(bits, max(width, 1), max(height, 1), max(width, 1) * 4);
 
             m_pGraphics = std::make_unique<Gdiplus::Graphics>(m_hBackBufferDC);
             m_pGraphics->SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
@@ -1612,11 +3484,7 @@ namespace OtterIMG {
     public:
         // 构造函数
         UltimateImageRenderer(HWND hWnd, bool isLayered, bool startActive = true)
-            : m_hWnd(hWnd), m_isLayered(isLayered), m_isActive(startActive) {
-
-            // 初始化GDI+
-            Gdiplus::GdiplusStartupInput gdiplusStartupInput;
-            Gdiplus::GdiplusStartup(&m_gdiplusToken, &gdiplusStartupInput, NULL);
+            : m_hWnd(hWnd), m_isLayered(isLayered), m_isActive(startActive), m_images(hWnd) {
 
             // 初始尺寸标记为需要更新
             m_isSizeDirty = true;
@@ -1628,9 +3496,9 @@ namespace OtterIMG {
 
         // 析构函数
         ~UltimateImageRenderer() {
+            m_images.Shutdown();    // 工作线程使用GDI+，须在 m_gdiplus 释放之前退出
             SetActive(false); // 确保停止所有操作
             CleanupBackBuffer();
-            Gdiplus::GdiplusShutdown(m_gdiplusToken);
         }
 
         // 设置激活状态
@@ -1657,29 +3525,21 @@ namespace OtterIMG {
         // 加载图片到缓存
         bool LoadImage(const std::wstring& key, const std::wstring& filePath) {
             if (!m_isActive) return false;
-
-            try {
-                auto bitmap = std::make_unique<Gdiplus::Bitmap>(filePath.c_str());
-                if (bitmap->GetLastStatus() != Gdiplus::Ok) {
-                    return false;
-                }
-
-                m_imageCache[key] = std::move(bitmap);
-                return true;
-            }
-            catch (...) {
-                return false;
-            }
+            return m_images.Load(key, filePath, true);     // 同一个键再次加载时替换为新文件
         }
 
         // 开始绘制帧
         bool BeginFrame(Gdiplus::Color clearColor = Gdiplus::Color(0, 0, 0, 0)) {
             if (!m_isActive) return false;
+            OTTER_TRACE_SCOPE("paint", "BeginFrame");
 
             CheckAndUpdateSize(); // 确保尺寸正确
 
             if (!m_pGraphics) return false;
 
+            PumpImageLoads();
+            m_images.Cache().Trim();
+
             // 清空背景
             if (m_isLayered) {
                 m_pGraphics->Clear(Gdiplus::Color(0, 0, 0, 0)); // 透明背景
@@ -1701,11 +3561,12 @@ namespace OtterIMG {
             int srcWidth = -1, int srcHeight = -1) {
 
             if (!m_isActive || !m_pGraphics) return false;
+            OTTER_TRACE_SCOPE("paint", "DrawImage");
 
-            auto it = m_imageCache.find(key);
-            if (it == m_imageCache.end()) return false;
+            OtterWindow::CachedImage* image = m_images.FindDrawable(key, srcX, srcY, srcWidth, srcHeight);
+            if (!image) return m_images.DrawPlaceholder(key, *m_pGraphics, x, y, destWidth, destHeight);
 
-            Gdiplus::Bitmap* pBitmap = it->second.get();
+            Gdiplus::Bitmap* pBitmap = image->bitmap.get();
 
             // 计算源矩形
             if (srcWidth == -1) srcWidth = pBitmap->GetWidth();
@@ -1715,6 +3576,28 @@ namespace OtterIMG {
             if (destWidth == -1) destWidth = srcWidth;
             if (destHeight == -1) destHeight = srcHeight;
 
+            if (opacity <= 0.0f) return true;
+
+            // 整幅图片缩放绘制：取缓存的缩放结果（从最接近的 mip 级插值得到）后直接混合
+            if ((destWidth != srcWidth || destHeight != srcHeight) && destWidth > 0 && destHeight > 0 &&
+                srcX == 0 && srcY == 0 && srcWidth == image->Width() && srcHeight == image->Height() &&
+                m_surface.Valid()) {
+                m_pGraphics->Flush(Gdiplus::FlushIntentionSync);
+                GdiFlush();
+                const OtterRaster::Surface& scaled = m_images.Scaled(key, *image, destWidth, destHeight);
+                OtterRaster::Blit::Composite(m_surface, m_surface.Bounds(), x, y, scaled, scaled.Bounds(), opacity);
+                return true;
+            }
+
+            // 不缩放的半透明绘制直接对预乘像素做SIMD混合
+            if (opacity < 1.0f && destWidth == srcWidth && destHeight == srcHeight && m_surface.Valid()) {
+                m_pGraphics->Flush(Gdiplus::FlushIntentionSync);
+                GdiFlush();
+                OtterRaster::Blit::Composite(m_surface, m_surface.Bounds(), x, y, image->pixels,
+                    OtterRaster::Rect(srcX, srcY, srcWidth, srcHeight), opacity);
+                return true;
+            }
+
             // 使用透明度
             if (opacity < 1.0f) {
                 Gdiplus::ColorMatrix matrix = {
@@ -1749,6 +3632,7 @@ namespace OtterIMG {
         // 结束帧并呈现
         void EndFrame() {
             if (!m_isActive || !m_hBackBufferDC || !m_pGraphics) return;
+            OTTER_TRACE_SCOPE("paint", "EndFrame");
 
             HDC hdc = GetDC(m_hWnd);
 
@@ -1771,21 +3655,93 @@ namespace OtterIMG {
 
         // 其他方法
         bool GetImageSize(const std::wstring& key, int& width, int& height) {
-            auto it = m_imageCache.find(key);
-            if (it == m_imageCache.end()) return false;
+            return m_images.GetSize(key, width, height);
+        }
 
-            width = it->second->GetWidth();
-            height = it->second->GetHeight();
-            return true;
+        // 图集中的图片只解除映射，页内空间不回收（ClearCache 时整体释放）
+        void RemoveImage(const std::wstring& key) { m_images.Remove(key); }
+
+        void ClearCache() { m_images.Clear(); }
+
+        // 图片缓存内存预算（字节），0 为不限制（默认）；超出时淘汰最久未用、可从文件重新加载的图片
+        void SetImageMemoryBudget(size_t bytes) { m_images.Cache().SetBudget(bytes); }
+
+        // 命中率、重新加载次数、常驻字节数等
+        OtterWindow::ImageCache::Stats GetImageCacheStats() const { return m_images.Cache().GetStats(); }
+
+        // 进程内共享图片存储的统计（所有渲染器共用）：解码次数、同文件共享与内容合并次数、存活字节数
+        OtterWindow::SharedImageStore::Stats GetSharedImageStats() const { return OtterWindow::SharedImageStore::Instance().GetStats(); }
+
+        // === 精灵图集 ===
+
+        // 开启后，之后加载的不超过 maxSprite 的小图片装入共享的图集页（页大小 pageSize），
+        // 不再各自占用一个缓存项；DrawImage 等按键绘制自动换算到页内子矩形。尺寸参数只在图集为空时生效
+        void EnableSpriteAtlas(bool enabled, int pageSize = OtterRaster::SpriteAtlas::kDefaultPageSize,
+            int maxSprite = OtterRaster::SpriteAtlas::kDefaultMaxSprite) {
+            m_images.Atlas().Enable(enabled, pageSize, maxSprite);
+        }
+
+        bool IsSpriteAtlasEnabled() const { return m_images.Atlas().Enabled(); }
+
+        // 把已加载的图片移入图集；一次移入多张时按高度排序装入，比逐张加载更紧凑。返回移入的张数
+        size_t AddToAtlas(const std::vector<std::wstring>& keys) { return m_images.Atlas().AddLoaded(keys); }
+
+        bool IsInAtlas(const std::wstring& key) const { return m_images.Atlas().Contains(key); }
+
+        // 页数、图片数与装箱效率（图片像素占页面积的比例）
+        OtterRaster::SpriteAtlas::Stats GetAtlasStats() const { return m_images.Atlas().GetStats(); }
+
+        // 绘制次数与合并后的段数（同一页的连续绘制算一段）
+        const OtterRaster::SpriteBatch::Stats& GetSpriteBatchStats() const { return m_images.Atlas().GetBatchStats(); }
+
+        // 批量不缩放地绘制图片，按顺序合成；图集中连续位于同一页的图片合并为一段直接混合，
+        // 不在图集中的图片逐个走 DrawImage
+        void DrawSprites(const std::vector<OtterWindow::SpriteDraw>& draws) {
+            if (!m_isActive || !m_pGraphics) return;
+            m_images.Atlas().DrawSprites(draws, m_surface.Valid(),
+                [this](OtterRaster::SpriteBatch& batch, const OtterRaster::SpriteAtlas& atlas) {
+                    m_pGraphics->Flush(Gdiplus::FlushIntentionSync);
+                    GdiFlush();
+                    batch.Flush(atlas, m_surface, m_surface.Bounds());
+                },
+                [this](const OtterWindow::SpriteDraw& draw) { DrawImage(draw.key, draw.x, draw.y, draw.opacity); });
+        }
+
+        // 映射预解码的资源包（WriteImagePack 生成）并登记其中全部图片，启动时不再逐个打开与解码文件
+        size_t LoadImagePack(const std::wstring& packPath) {
+            return m_images.LoadPack(packPath);
         }
 
-        void RemoveImage(const std::wstring& key) {
-            m_imageCache.erase(key);
+        // === 后台加载 ===
+
+        // 立即返回，在工作线程上解码；完成后由下一次 BeginFrame 放入缓存。priority 见 OtterAsync::kPriority*
+        bool LoadImageAsync(const std::wstring& key, const std::wstring& filePath,
+            int priority = OtterAsync::kPriorityNormal) {
+            return m_images.LoadAsync(key, filePath, priority);
         }
 
-        void ClearCache() {
-            m_imageCache.clear();
+        // 调整尚未开始解码的图片的优先级（如滚动后变为可见）
+        bool SetImagePriority(const std::wstring& key, int priority) { return m_images.Loader().SetPriority(key, priority); }
+
+        bool CancelImageLoad(const std::wstring& key) { return m_images.Loader().Cancel(key); }
+
+        bool IsImageLoading(const std::wstring& key) const { return m_images.Loader().IsLoading(key); }
+
+        // 图片就绪或加载失败时在UI线程调用
+        void SetImageReadyCallback(OtterWindow::AsyncImageLoader::ReadyCallback callback) {
+            m_images.Loader().SetReadyCallback(std::move(callback));
         }
+
+        // 工作线程每完成一张图片的唤醒方式，默认 InvalidateRect 关联窗口
+        void SetImageLoadNotify(std::function<void()> notify) { m_images.Loader().SetNotify(std::move(notify)); }
+
+        // 加载中的图片以此颜色填充目标矩形（需指定 destWidth/destHeight）；透明（默认）时跳过不画
+        void SetImagePlaceholder(Gdiplus::Color color) { m_images.SetPlaceholder(color); }
+
+        OtterAsync::DecodeStats GetImageLoadStats() const { return m_images.Loader().GetStats(); }
+
+        // 把后台解码完成的图片放入缓存，返回张数；BeginFrame 会自动调用
+        size_t PumpImageLoads() { return m_images.Pump(); }
     };
     
 }
@@ -0,0 +1,474 @@
+#pragma once
+// OtterAssetPack.h
+// 图片资源包：一个文件保存多张已解码的32位预乘像素（行按64字节对齐，可选LZ4压缩），
+// 附按键哈希排序的索引。运行时映射整个文件，未压缩的条目直接包装映射内存，不复制也不解码。
+// 所有整数按小端存储。除文件映射外不依赖Windows
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "OtterRaster.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace OtterPack {
+
+#ifdef _WIN32
+    using PathString = std::wstring;
+#else
+    using PathString = std::string;
+#endif
+
+    // LZ4 块格式（与 LZ4_compress_default / LZ4_decompress_safe 兼容），只实现本格式需要的部分
+    namespace Lz4 {
+
+        constexpr size_t kMinMatch = 4;
+        constexpr size_t kLastLiterals = 5;     // 最后5字节必须是字面量
+        constexpr size_t kMatchLimit = 12;      // 最后一个匹配必须在结尾12字节之前开始
+        constexpr int kHashBits = 14;
+
+        inline uint32_t Read32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        inline uint32_t HashOf(uint32_t v) { return (v * 2654435761u) >> (32 - kHashBits); }
+
+        inline void WriteLength(std::vector<uint8_t>& out, size_t length) {
+            for (; length >= 255; length -= 255) out.push_back(255);
+            out.push_back(uint8_t(length));
+        }
+
+        inline void EmitSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalCount,
+            size_t offset, size_t matchLength) {
+            const size_t matchCode = matchLength ? matchLength - kMinMatch : 0;
+            out.push_back(uint8_t(((literalCount >= 15 ? 15 : literalCount) << 4) | (matchCode >= 15 ? 15 : matchCode)));
+            if (literalCount >= 15) WriteLength(out, literalCount - 15);
+            out.insert(out.end(), literals, literals + literalCount);
+            if (matchLength == 0) return;
+            out.push_back(uint8_t(offset & 0xFF));
+            out.push_back(uint8_t(offset >> 8));
+            if (matchCode >= 15) WriteLength(out, matchCode - 15);
+        }
+
+        // 贪心哈希匹配压缩，结果追加到 out
+        inline void Compress(const uint8_t* src, size_t size, std::vector<uint8_t>& out) {
+            size_t anchor = 0;
+            if (size > kMatchLimit) {
+                std::vector<int64_t> table(size_t(1) << kHashBits, -1);
+                const size_t limit = size - kMatchLimit;
+                const size_t matchEnd = size - kLastLiterals;
+                size_t ip = 0;
+                while (ip < limit) {
+                    const uint32_t sequence = Read32(src + ip);
+                    int64_t& slot = table[HashOf(sequence)];
+                    const int64_t ref = slot;
+                    slot = int64_t(ip);
+                    if (ref < 0 || ip - size_t(ref) > 65535 || Read32(src + ref) != sequence) {
+                        ++ip;
+                        continue;
+                    }
+                    size_t length = kMinMatch;
+                    while (ip + length < matchEnd && src[size_t(ref) + length] == src[ip + length]) ++length;
+                    EmitSequence(out, src + anchor, ip - anchor, ip - size_t(ref), length);
+                    ip += length;
+                    anchor = ip;
+                }
+            }
+            EmitSequence(out, src + anchor, size - anchor, 0, 0);
+        }
+
+        // 解压到容量为 dstSize 的缓冲区，输出必须恰好 dstSize 字节；任何越界都返回 false
+        inline bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+            const uint8_t* ip = src;
+            const uint8_t* const iend = src + srcSize;
+            uint8_t* op = dst;
+            uint8_t* const oend = dst + dstSize;
+            auto readLength = [&](size_t& length) {
+                uint8_t b;
+                do {
+                    if (ip >= iend) return false;
+                    b = *ip++;
+                    length += b;
+                } while (b == 255);
+                return true;
+            };
+            while (ip < iend) {
+                const uint8_t token = *ip++;
+                size_t literals = token >> 4;
+                if (literals == 15 && !readLength(literals)) return false;
+                if (size_t(iend - ip) < literals || size_t(oend - op) < literals) return false;
+                std::memcpy(op, ip, literals);
+                ip += literals;
+                op += literals;
+                if (ip == iend) break;      // 最后一个序列只有字面量
+
+                if (iend - ip < 2) return false;
+                const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+                ip += 2;
+                if (offset == 0 || offset > size_t(op - dst)) return false;
+                size_t length = token & 15;
+                if (length == 15 && !readLength(length)) return false;
+                length += kMinMatch;
+                if (size_t(oend - op) < length) return false;
+                const uint8_t* match = op - offset;
+                if (offset >= length) {
+                    std::memcpy(op, match, length);
+                    op += length;
+                }
+                else {
+                    for (size_t i = 0; i < length; ++i) *op++ = match[i];    // 重叠复制（重复图案）
+                }
+            }
+            return op == oend;
+        }
+    }
+
+    constexpr uint32_t kMagic = 0x4B50544Fu;   // "OTPK"
+    constexpr uint32_t kVersion = 1;
+    constexpr size_t kDataAlign = 64;           // 与 Surface 行对齐一致，映射后可直接使用
+
+    enum class Compression : uint32_t {
+        None = 0,
+        Lz4 = 1
+    };
+
+    // 文件布局：Header | 索引（按 hash 升序）| 键字符串 | 像素数据（每条按64字节对齐）
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t indexOffset;
+        uint64_t stringsOffset;
+        uint64_t fileSize;
+        uint8_t padding[24];
+    };
+
+    struct IndexEntry {
+        uint64_t hash;              // 键（UTF-8）的 FNV-1a 64
+        uint32_t keyOffset;         // 相对键字符串区
+        uint32_t keyLength;
+        uint32_t width;
+        uint32_t height;
+        uint32_t stride;            // 字节
+        uint32_t compression;
+        uint64_t dataOffset;
+        uint64_t storedSize;        // 文件中的字节数
+        uint64_t rawSize;           // stride * height
+    };
+
+    static_assert(sizeof(Header) == 64, "pack header layout");
+    static_assert(sizeof(IndexEntry) == 56, "pack index layout");
+
+    inline uint64_t HashKey(const char* key, size_t length) {
+        uint64_t h = 14695981039346656037ull;
+        for (size_t i = 0; i < length; ++i) {
+            h ^= uint8_t(key[i]);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    inline size_t AlignUp(size_t value, size_t align) { return (value + align - 1) / align * align; }
+
+    // 打包：Add 若干张图片后写出。compress 时只有压缩后不超过原大小 7/8 的条目才保存为LZ4
+    class AssetPackWriter {
+    public:
+        // 空图片或边长超过65536时返回 false 且不加入（AssetPack 打开时会拒绝含这类条目的整个包）
+        bool Add(const std::string& key, const OtterRaster::Surface& pixels, bool compress = false) {
+            if (pixels.Width() <= 0 || pixels.Height() <= 0 || pixels.Width() > 65536 || pixels.Height() > 65536) {
+                return false;
+            }
+            Item item;
+            item.key = key;
+            item.width = pixels.Width();
+            item.height = pixels.Height();
+            item.stride = int(AlignUp(size_t(pixels.Width()) * 4, kDataAlign));
+            item.raw.assign(size_t(item.stride) * item.height, 0);
+            for (int y = 0; y < item.height; ++y) {
+                std::memcpy(item.raw.data() + size_t(y) * item.stride, pixels.Row(y), size_t(item.width) * 4);
+            }
+            if (compress && !item.raw.empty()) {
+                std::vector<uint8_t> packed;
+                Lz4::Compress(item.raw.data(), item.raw.size(), packed);
+                if (packed.size() <= item.raw.size() / 8 * 7) {
+                    item.stored = std::move(packed);
+                    item.compression = Compression::Lz4;
+                }
+            }
+            m_items.push_back(std::move(item));
+            return true;
+        }
+
+        size_t Count() const { return m_items.size(); }
+
+        // 生成整个文件的内容；同名的键只保留最后一次 Add
+        std::vector<uint8_t> Build() const {
+            std::vector<const Item*> items;
+            for (size_t i = m_items.size(); i-- > 0;) {
+                const Item* item = &m_items[i];
+                bool duplicate = std::any_of(items.begin(), items.end(), [&](const Item* o) { return o->key == item->key; });
+                if (!duplicate) items.push_back(item);
+            }
+            std::vector<std::pair<uint64_t, const Item*>> sorted;
+            for (const Item* item : items) sorted.emplace_back(HashKey(item->key.data(), item->key.size()), item);
+            std::stable_sort(sorted.begin(), sorted.end(),
+                [](const auto& a, const auto& b) { return a.first < b.first; });
+
+            const size_t indexOffset = sizeof(Header);
+            const size_t stringsOffset = indexOffset + sorted.size() * sizeof(IndexEntry);
+            size_t stringsSize = 0;
+            for (const auto& s : sorted) stringsSize += s.second->key.size();
+            size_t cursor = AlignUp(stringsOffset + stringsSize, kDataAlign);
+
+            std::vector<IndexEntry> index(sorted.size());
+            size_t keyCursor = 0;
+            for (size_t i = 0; i < sorted.size(); ++i) {
+                const Item& item = *sorted[i].second;
+                IndexEntry& e = index[i];
+                std::memset(&e, 0, sizeof(e));
+                e.hash = sorted[i].first;
+                e.keyOffset = uint32_t(keyCursor);
+                e.keyLength = uint32_t(item.key.size());
+                e.width = uint32_t(item.width);
+                e.height = uint32_t(item.height);
+                e.stride = uint32_t(item.stride);
+                e.compression = uint32_t(item.compression);
+                e.dataOffset = cursor;
+                e.storedSize = item.Stored().size();
+                e.rawSize = item.raw.size();
+                keyCursor += item.key.size();
+                cursor = AlignUp(cursor + size_t(e.storedSize), kDataAlign);
+            }
+
+            std::vector<uint8_t> file(cursor, 0);
+            Header header;
+            std::memset(&header, 0, sizeof(header));
+            header.magic = kMagic;
+            header.version = kVersion;
+            header.entryCount = uint32_t(index.size());
+            header.indexOffset = indexOffset;
+            header.stringsOffset = stringsOffset;
+            header.fileSize = file.size();
+            std::memcpy(file.data(), &header, sizeof(header));
+            if (!index.empty()) std::memcpy(file.data() + indexOffset, index.data(), index.size() * sizeof(IndexEntry));
+            for (size_t i = 0; i < sorted.size(); ++i) {
+                const Item& item = *sorted[i].second;
+                std::memcpy(file.data() + stringsOffset + index[i].keyOffset, item.key.data(), item.key.size());
+                const std::vector<uint8_t>& data = item.Stored();
+                if (!data.empty()) std::memcpy(file.data() + index[i].dataOffset, data.data(), data.size());
+            }
+            return file;
+        }
+
+        bool Write(const PathString& path) const {
+            const std::vector<uint8_t> file = Build();
+#ifdef _WIN32
+            FILE* fp = _wfopen(path.c_str(), L"wb");
+#else
+            FILE* fp = std::fopen(path.c_str(), "wb");
+#endif
+            if (!fp) return false;
+            const bool ok = std::fwrite(file.data(), 1, file.size(), fp) == file.size();
+            return std::fclose(fp) == 0 && ok;
+        }
+
+    private:
+        struct Item {
+            std::string key;
+            int width = 0, height = 0, stride = 0;
+            Compression compression = Compression::None;
+            std::vector<uint8_t> raw;
+            std::vector<uint8_t> stored;    // 仅压缩时使用
+
+            const std::vector<uint8_t>& Stored() const { return compression == Compression::None ? raw : stored; }
+        };
+
+        std::vector<Item> m_items;
+    };
+
+    // 只读文件映射
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { Close(); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const PathString& path) {
+            Close();
+#ifdef _WIN32
+            HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+            if (file == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { CloseHandle(file); return false; }
+            HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            CloseHandle(file);
+            if (!mapping) return false;
+            m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+            if (!m_data) return false;
+            m_size = size_t(size.QuadPart);
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+            void* p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED) return false;
+            m_data = static_cast<const uint8_t*>(p);
+            m_size = size_t(st.st_size);
+#endif
+            return true;
+        }
+
+        void Close() {
+            if (!m_data) return;
+#ifdef _WIN32
+            UnmapViewOfFile(m_data);
+#else
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        const uint8_t* Data() const { return m_data; }
+        size_t Size() const { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+    // 读取资源包。打开时校验头部与全部索引项，之后的查找不再做边界检查
+    class AssetPack {
+    public:
+        struct Entry {
+            std::string key;
+            int width = 0, height = 0, stride = 0;
+            Compression compression = Compression::None;
+            const uint8_t* data = nullptr;      // 指向映射内存
+            size_t storedSize = 0;
+            size_t rawSize = 0;
+        };
+
+        bool Open(const PathString& path) {
+            auto file = std::make_shared<MappedFile>();
+            if (!file->Open(path)) return false;
+            const uint8_t* data = file->Data();
+            const size_t size = file->Size();
+            return OpenMemory(data, size, std::shared_ptr<const void>(file, data));
+        }
+
+        // 使用调用方提供的内存；keepAlive 持有该内存（可为空，由调用方保证生命周期）
+        bool OpenMemory(const void* data, size_t size, std::shared_ptr<const void> keepAlive = nullptr) {
+            Reset();
+            const uint8_t* base = static_cast<const uint8_t*>(data);
+            if (!base || size < sizeof(Header)) return false;
+            Header header;
+            std::memcpy(&header, base, sizeof(header));
+            if (header.magic != kMagic || header.version != kVersion || header.fileSize > size) return false;
+            const uint64_t indexBytes = uint64_t(header.entryCount) * sizeof(IndexEntry);
+            if (header.indexOffset > size || indexBytes > size - header.indexOffset) return false;
+            if (header.stringsOffset > size) return false;
+
+            std::vector<IndexEntry> index(header.entryCount);
+            if (!index.empty()) std::memcpy(index.data(), base + header.indexOffset, size_t(indexBytes));
+            const size_t stringsSize = size - size_t(header.stringsOffset);
+            for (size_t i = 0; i < index.size(); ++i) {
+                const IndexEntry& e = index[i];
+                if (i > 0 && index[i - 1].hash > e.hash) return false;
+                if (uint64_t(e.keyOffset) + e.keyLength > stringsSize) return false;
+                if (e.width == 0 || e.height == 0 || e.width > 65536 || e.height > 65536) return false;
+                if (e.stride != AlignUp(size_t(e.width) * 4, kDataAlign)) return false;
+                if (e.rawSize != uint64_t(e.stride) * e.height) return false;
+                if (e.dataOffset > size || e.storedSize > size - e.dataOffset) return false;
+                if (e.compression == uint32_t(Compression::None)) {
+                    if (e.storedSize != e.rawSize || e.dataOffset % kDataAlign != 0) return false;
+                }
+                else if (e.compression != uint32_t(Compression::Lz4)) {
+                    return false;
+                }
+            }
+            m_base = base;
+            m_size = size;
+            m_stringsOffset = size_t(header.stringsOffset);
+            m_index = std::move(index);
+            m_keepAlive = std::move(keepAlive);
+            return true;
+        }
+
+        void Reset() {
+            m_base = nullptr;
+            m_size = 0;
+            m_index.clear();
+            m_keepAlive.reset();
+        }
+
+        bool IsOpen() const { return m_base != nullptr; }
+        size_t Count() const { return m_index.size(); }
+        size_t ByteSize() const { return m_size; }
+
+        Entry At(size_t i) const {
+            const IndexEntry& e = m_index[i];
+            Entry out;
+            out.key.assign(reinterpret_cast<const char*>(m_base + m_stringsOffset + e.keyOffset), e.keyLength);
+            out.width = int(e.width);
+            out.height = int(e.height);
+            out.stride = int(e.stride);
+            out.compression = Compression(e.compression);
+            out.data = m_base + e.dataOffset;
+            out.storedSize = size_t(e.storedSize);
+            out.rawSize = size_t(e.rawSize);
+            return out;
+        }
+
+        // 二分查找哈希，再比较键（处理哈希冲突）
+        bool Find(const std::string& key, Entry& out) const {
+            const uint64_t hash = HashKey(key.data(), key.size());
+            auto it = std::lower_bound(m_index.begin(), m_index.end(), hash,
+                [](const IndexEntry& e, uint64_t h) { return e.hash < h; });
+            for (; it != m_index.end() && it->hash == hash; ++it) {
+                if (it->keyLength == key.size() &&
+                    std::memcmp(m_base + m_stringsOffset + it->keyOffset, key.data(), key.size()) == 0) {
+                    out = At(size_t(it - m_index.begin()));
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // 未压缩的条目直接包装映射内存（只读，不得写入）；LZ4条目解压到新分配的像素
+        bool Load(const Entry& entry, OtterRaster::Surface& out) const {
+            if (entry.compression == Compression::None) {
+                out = OtterRaster::Surface::Wrap(const_cast<uint8_t*>(entry.data), entry.width, entry.height, entry.stride);
+                return true;
+            }
+            OtterRaster::Surface pixels(entry.width, entry.height);
+            if (pixels.Stride() != entry.stride) return false;
+            if (!Lz4::Decompress(entry.data, entry.storedSize, pixels.Data(), entry.rawSize)) return false;
+            out = std::move(pixels);
+            return true;
+        }
+
+        // 持有映射；包装映射内存的 Surface 使用期间需保持
+        std::shared_ptr<const void> Backing() const { return m_keepAlive; }
+
+    private:
+        const uint8_t* m_base = nullptr;
+        size_t m_size = 0;
+        size_t m_stringsOffset = 0;
+        std::vector<IndexEntry> m_index;
+        std::shared_ptr<const void> m_keepAlive;
+    };
+}
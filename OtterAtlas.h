@@ -0,0 +1,204 @@
+#pragma once
+// OtterAtlas.h
+// 精灵图集：把小图片用 SkylinePacker 装入共享的大页（每张四周留出复制边缘像素的间隙，缩放采样不串色），
+// 绘制时按页内子矩形取像素；SpriteBatch 把连续使用同一页的绘制合并处理。不依赖Windows
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "OtterBlit.h"
+
+namespace OtterRaster {
+
+    class SpriteAtlas {
+    public:
+        static constexpr int kDefaultPageSize = 1024;
+        static constexpr int kDefaultMaxSprite = 128;
+
+        struct Sprite {
+            int page = -1;
+            Rect rect;                  // 页内位置（不含间隙）
+
+            bool Valid() const { return page >= 0; }
+        };
+
+        struct Stats {
+            size_t pages = 0;
+            size_t sprites = 0;
+            size_t rejected = 0;        // 超过 maxSprite 或装不下
+            long long spriteArea = 0;   // 图片本身的像素数
+            long long packedArea = 0;   // 含间隙
+            long long pageArea = 0;
+
+            // 图片像素占全部页面积的比例
+            double Efficiency() const { return pageArea > 0 ? double(spriteArea) / double(pageArea) : 0.0; }
+        };
+
+        explicit SpriteAtlas(int pageSize = kDefaultPageSize, int maxSprite = kDefaultMaxSprite, int padding = 1)
+            : m_pageSize((std::max)(pageSize, 16)), m_maxSprite((std::max)(1, (std::min)(maxSprite, pageSize / 2))),
+            m_padding((std::max)(padding, 0)) {}
+
+        int PageSize() const { return m_pageSize; }
+        int MaxSprite() const { return m_maxSprite; }
+
+        bool Accepts(int width, int height) const {
+            return width > 0 && height > 0 && width <= m_maxSprite && height <= m_maxSprite;
+        }
+
+        // 装入一张图片（加载时逐张调用）；依次尝试已有各页，都放不下时新开一页
+        bool Insert(const Surface& pixels, Sprite& out) {
+            if (!Accepts(pixels.Width(), pixels.Height())) {
+                ++m_stats.rejected;
+                return false;
+            }
+            const int w = pixels.Width() + 2 * m_padding, h = pixels.Height() + 2 * m_padding;
+            Point at;
+            for (size_t i = 0; i < m_pages.size(); ++i) {
+                if (m_pages[i]->packer.Insert(w, h, at)) {
+                    Place(int(i), at, pixels, out);
+                    return true;
+                }
+            }
+            m_pages.push_back(std::make_unique<Page>(m_pageSize));
+            if (!m_pages.back()->packer.Insert(w, h, at)) {
+                m_pages.pop_back();
+                ++m_stats.rejected;
+                return false;
+            }
+            Place(int(m_pages.size()) - 1, at, pixels, out);
+            return true;
+        }
+
+        // 一次装入多张（离线或批量加载时）：按高度从大到小放入，比逐张装入更紧凑；out 与 images 一一对应
+        size_t InsertAll(const std::vector<const Surface*>& images, std::vector<Sprite>& out) {
+            out.assign(images.size(), Sprite());
+            std::vector<size_t> order(images.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                if (images[a]->Height() != images[b]->Height()) return images[a]->Height() > images[b]->Height();
+                return images[a]->Width() > images[b]->Width();
+            });
+            size_t inserted = 0;
+            for (size_t i : order) {
+                if (Insert(*images[i], out[i])) ++inserted;
+            }
+            return inserted;
+        }
+
+        size_t PageCount() const { return m_pages.size(); }
+
+        // 页的像素由 shared_ptr 持有，外部（如GDI+位图）引用期间保持有效；之后装入的图片会写入已有页
+        const std::shared_ptr<Surface>& PagePixels(int page) const { return m_pages[size_t(page)]->pixels; }
+
+        void Clear() {
+            m_pages.clear();
+            m_stats = Stats();
+        }
+
+        Stats GetStats() const {
+            Stats stats = m_stats;
+            stats.pages = m_pages.size();
+            stats.pageArea = (long long)m_pageSize * m_pageSize * (long long)m_pages.size();
+            return stats;
+        }
+
+    private:
+        struct Page {
+            std::shared_ptr<Surface> pixels;
+            SkylinePacker packer;
+
+            explicit Page(int size) : pixels(std::make_shared<Surface>(size, size)), packer(size, size) {}
+        };
+
+        // 复制像素，并把边缘像素向外复制到间隙中
+        void Place(int page, const Point& at, const Surface& pixels, Sprite& out) {
+            Surface& dst = *m_pages[size_t(page)]->pixels;
+            const int w = pixels.Width(), h = pixels.Height(), pad = m_padding;
+            for (int y = -pad; y < h + pad; ++y) {
+                const uint32_t* src = pixels.Row((std::min)((std::max)(y, 0), h - 1));
+                uint32_t* row = dst.Row(at.Y + pad + y) + at.X + pad;
+                for (int x = -pad; x < 0; ++x) row[x] = src[0];
+                std::memcpy(row, src, size_t(w) * 4);
+                for (int x = w; x < w + pad; ++x) row[x] = src[w - 1];
+            }
+            out.page = page;
+            out.rect = Rect(at.X + pad, at.Y + pad, w, h);
+            ++m_stats.sprites;
+            m_stats.spriteArea += (long long)w * h;
+            m_stats.packedArea += (long long)(w + 2 * pad) * (h + 2 * pad);
+        }
+
+        int m_pageSize;
+        int m_maxSprite;
+        int m_padding;
+        std::vector<std::unique_ptr<Page>> m_pages;
+        Stats m_stats;
+    };
+
+    // 精灵批量绘制：按提交顺序合成（保持覆盖关系），连续使用同一页的绘制只解析一次页面
+    class SpriteBatch {
+    public:
+        struct Stats {
+            size_t draws = 0;
+            size_t runs = 0;            // 同一页的连续绘制算一段
+        };
+
+        void Add(const SpriteAtlas::Sprite& sprite, int x, int y, float opacity = 1.0f) {
+            if (!sprite.Valid() || opacity <= 0.0f) return;
+            m_items.push_back(Item{ sprite.page, sprite.rect, x, y, opacity });
+        }
+
+        size_t Size() const { return m_items.size(); }
+        bool Empty() const { return m_items.empty(); }
+        void Clear() { m_items.clear(); }
+
+        // 合成到 dst 的 clip 内，然后清空
+        void Flush(const SpriteAtlas& atlas, Surface& dst, const Rect& clip) {
+            ForEachRun(atlas, [&](const Surface& page, const Item& item) {
+                Blit::Composite(dst, clip, item.x, item.y, page, item.rect, item.opacity);
+            });
+        }
+
+        // 按画布的原点与裁剪区域合成，然后清空
+        void Flush(const SpriteAtlas& atlas, Canvas& canvas) {
+            Surface* dst = canvas.GetSurface();
+            if (!dst || !dst->Valid()) { m_items.clear(); return; }
+            const Point origin = canvas.GetOrigin();
+            ForEachRun(atlas, [&](const Surface& page, const Item& item) {
+                canvas.ForEachClip([&](const Rect& clip) {
+                    Blit::Composite(*dst, clip, item.x + origin.X, item.y + origin.Y, page, item.rect, item.opacity);
+                });
+            });
+        }
+
+        const Stats& GetStats() const { return m_stats; }
+        void ResetStats() { m_stats = Stats(); }
+
+    private:
+        struct Item {
+            int page;
+            Rect rect;
+            int x, y;
+            float opacity;
+        };
+
+        template <typename Fn>
+        void ForEachRun(const SpriteAtlas& atlas, Fn&& fn) {
+            int current = -1;
+            const Surface* page = nullptr;
+            for (const Item& item : m_items) {
+                if (item.page >= int(atlas.PageCount())) continue;
+                if (item.page != current) {
+                    current = item.page;
+                    page = atlas.PagePixels(current).get();
+                    ++m_stats.runs;
+                }
+                fn(*page, item);
+                ++m_stats.draws;
+            }
+            m_items.clear();
+        }
+
+        std::vector<Item> m_items;
+        Stats m_stats;
+    };
+}
@@ -0,0 +1,283 @@
+#pragma once
+// OtterBlit.h
+// 预乘BGRA图像合成：常量不透明度的 source-over 与 copy 两种模式，
+// 提供标量/SSE2/AVX2 三套行内核，首次使用时按CPU选择。不依赖Windows
+#include <chrono>
+#include <vector>
+#include "OtterRaster.h"
+
+namespace OtterRaster {
+    namespace Blit {
+
+        enum class BlendMode {
+            SourceOver,     // dst = src*k + dst*(1 - srcA*k)
+            Copy            // dst = src*k
+        };
+
+        enum class Isa { Scalar, SSE2, AVX2 };
+
+        // 行内核：k 为不透明度 0-255
+        using RowFn = void(*)(uint32_t* dst, const uint32_t* src, int count, uint32_t k);
+
+        inline void OverScalar(uint32_t* dst, const uint32_t* src, int count, uint32_t k) {
+            for (int i = 0; i < count; ++i) {
+                uint32_t s = k == 255 ? src[i] : Span::ScalePixel(src[i], k);
+                if (s == 0) continue;
+                dst[i] = (s >> 24) == 255 ? s : Span::OverPixel(dst[i], s);
+            }
+        }
+
+        inline void CopyScalar(uint32_t* dst, const uint32_t* src, int count, uint32_t k) {
+            if (k == 255) { std::memcpy(dst, src, size_t(count) * 4); return; }
+            for (int i = 0; i < count; ++i) dst[i] = Span::ScalePixel(src[i], k);
+        }
+
+#if OTTER_HAS_SSE2
+        inline void OverSse2(uint32_t* dst, const uint32_t* src, int count, uint32_t k) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i kk = _mm_set1_epi16(static_cast<short>(k));
+            int i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xFFFF) continue;   // 4个像素全透明
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                __m128i slo = Span::Div255(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), kk));
+                __m128i shi = Span::Div255(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), kk));
+                __m128i lo = Span::Over16(_mm_unpacklo_epi8(d, zero), slo);
+                __m128i hi = Span::Over16(_mm_unpackhi_epi8(d, zero), shi);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+            OverScalar(dst + i, src + i, count - i, k);
+        }
+
+        inline void CopySse2(uint32_t* dst, const uint32_t* src, int count, uint32_t k) {
+            if (k == 255) { std::memcpy(dst, src, size_t(count) * 4); return; }
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i kk = _mm_set1_epi16(static_cast<short>(k));
+            int i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128i lo = Span::Div255(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), kk));
+                __m128i hi = Span::Div255(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), kk));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+            CopyScalar(dst + i, src + i, count - i, k);
+        }
+#endif
+
+#if OTTER_HAS_AVX2_DISPATCH
+        OTTER_TARGET_AVX2 inline __m256i Div255x16(__m256i x) {
+            x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+            return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+        }
+
+        OTTER_TARGET_AVX2 inline __m256i Over16x16(__m256i dst16, __m256i src16) {
+            __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(src16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+            return _mm256_add_epi16(src16, Div255x16(_mm256_mullo_epi16(dst16, inv)));
+        }
+
+        // unpack/pack 都在128位通道内进行，像素顺序保持不变
+        OTTER_TARGET_AVX2 inline void OverAvx2(uint32_t* dst, const uint32_t* src, int count, uint32_t k) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i kk = _mm256_set1_epi16(static_cast<short>(k));
+            int i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                if (_mm256_testz_si256(s, s)) continue;                                 // 8个像素全透明
+                __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+                __m256i slo = Div255x16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), kk));
+                __m256i shi = Div255x16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), kk));
+                __m256i lo = Over16x16(_mm256_unpacklo_epi8(d, zero), slo);
+                __m256i hi = Over16x16(_mm256_unpackhi_epi8(d, zero), shi);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+            }
+            OverScalar(dst + i, src + i, count - i, k);
+        }
+
+        OTTER_TARGET_AVX2 inline void CopyAvx2(uint32_t* dst, const uint32_t* src, int count, uint32_t k) {
+            if (k == 255) { std::memcpy(dst, src, size_t(count) * 4); return; }
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i kk = _mm256_set1_epi16(static_cast<short>(k));
+            int i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                __m256i lo = Div255x16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), kk));
+                __m256i hi = Div255x16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), kk));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+            }
+            CopyScalar(dst + i, src + i, count - i, k);
+        }
+#endif
+
+        struct Kernels {
+            Isa isa;
+            RowFn over;
+            RowFn copy;
+        };
+
+        inline bool Supported(Isa isa) {
+            switch (isa) {
+            case Isa::Scalar: return true;
+            case Isa::SSE2: return OTTER_HAS_SSE2 != 0;
+            case Isa::AVX2: return OTTER_HAS_SSE2 && OtterSimd::HasAvx2();
+            }
+            return false;
+        }
+
+        inline Kernels KernelsFor(Isa isa) {
+#if OTTER_HAS_AVX2_DISPATCH
+            if (isa == Isa::AVX2 && Supported(Isa::AVX2)) return Kernels{ Isa::AVX2, OverAvx2, CopyAvx2 };
+#endif
+#if OTTER_HAS_SSE2
+            if (isa != Isa::Scalar) return Kernels{ Isa::SSE2, OverSse2, CopySse2 };
+#endif
+            return Kernels{ Isa::Scalar, OverScalar, CopyScalar };
+        }
+
+        inline Kernels& Active() {
+            static Kernels kernels = KernelsFor(Isa::AVX2);  // 取支持的最高档
+            return kernels;
+        }
+
+        inline Isa CurrentIsa() { return Active().isa; }
+
+        // 强制使用指定内核（用于对比测试与基准），不支持时返回 false；非线程安全，应在绘制线程外调用
+        inline bool SetIsa(Isa isa) {
+            if (!Supported(isa)) return false;
+            Active() = KernelsFor(isa);
+            return true;
+        }
+
+        inline const char* IsaName(Isa isa) {
+            switch (isa) {
+            case Isa::Scalar: return "scalar";
+            case Isa::SSE2: return "sse2";
+            case Isa::AVX2: return "avx2";
+            }
+            return "";
+        }
+
+        inline uint32_t OpacityToAlpha(float opacity) {
+            if (!(opacity > 0.0f)) return 0;
+            if (opacity >= 1.0f) return 255;
+            return static_cast<uint32_t>(opacity * 255.0f + 0.5f);
+        }
+
+        // 把 src 的 srcRect 部分以 opacity 合成到 dst 的 (x, y)，只写入 clip 内
+        inline void Composite(Surface& dst, const Rect& clip, int x, int y,
+            const Surface& src, const Rect& srcRect, float opacity, BlendMode mode = BlendMode::SourceOver) {
+            if (!dst.Valid() || !src.Valid()) return;
+            const uint32_t k = OpacityToAlpha(opacity);
+            if (k == 0 && mode == BlendMode::SourceOver) return;
+            const Rect from = srcRect.Intersect(src.Bounds());
+            if (from.IsEmpty()) return;
+            x += from.x - srcRect.x;
+            y += from.y - srcRect.y;
+            const Rect target = Rect(x, y, from.w, from.h).Intersect(clip).Intersect(dst.Bounds());
+            if (target.IsEmpty()) return;
+
+            const RowFn fn = mode == BlendMode::Copy ? Active().copy : Active().over;
+            const int sx = from.x + (target.x - x);
+            for (int row = target.y; row < target.Bottom(); ++row) {
+                fn(dst.Row(row) + target.x, src.Row(from.y + (row - y)) + sx, target.w, k);
+            }
+        }
+
+        // 按画布的原点与裁剪区域合成
+        inline void DrawSurface(Canvas& canvas, const Surface& src, const Rect& srcRect, int x, int y,
+            float opacity, BlendMode mode = BlendMode::SourceOver) {
+            Surface* dst = canvas.GetSurface();
+            if (!dst || !dst->Valid()) return;
+            const Point origin = canvas.GetOrigin();
+            canvas.ForEachClip([&](const Rect& clip) {
+                Composite(*dst, clip, x + origin.X, y + origin.Y, src, srcRect, opacity, mode);
+            });
+        }
+
+        inline void DrawSurface(Canvas& canvas, const Surface& src, int x, int y,
+            float opacity, BlendMode mode = BlendMode::SourceOver) {
+            DrawSurface(canvas, src, src.Bounds(), x, y, opacity, mode);
+        }
+
+        // 用 src 重复平铺填充 area 与 clip 的交集，(originX, originY) 处对齐图案左上角。
+        // 逐行取对应的源行，按图案宽度分段调用行内核；边缘的图块被裁剪而不是缩放
+        inline void FillPattern(Surface& dst, const Rect& clip, const Rect& area, const Surface& src,
+            int originX, int originY, float opacity, BlendMode mode = BlendMode::SourceOver) {
+            if (!dst.Valid() || !src.Valid()) return;
+            const uint32_t k = OpacityToAlpha(opacity);
+            if (k == 0 && mode == BlendMode::SourceOver) return;
+            const Rect target = area.Intersect(clip).Intersect(dst.Bounds());
+            if (target.IsEmpty()) return;
+
+            const RowFn fn = mode == BlendMode::Copy ? Active().copy : Active().over;
+            const int sw = src.Width(), sh = src.Height();
+            auto wrap = [](int v, int n) { v %= n; return v < 0 ? v + n : v; };
+            const int startX = wrap(target.x - originX, sw);
+            int sy = wrap(target.y - originY, sh);
+            for (int row = target.y; row < target.Bottom(); ++row) {
+                uint32_t* out = dst.Row(row) + target.x;
+                const uint32_t* in = src.Row(sy);
+                int sx = startX, remaining = target.w;
+                while (remaining > 0) {
+                    const int count = (std::min)(sw - sx, remaining);
+                    fn(out, in + sx, count, k);
+                    out += count;
+                    remaining -= count;
+                    sx = 0;
+                }
+                if (++sy == sh) sy = 0;
+            }
+        }
+
+        // 按画布的原点与裁剪区域平铺，图案从 area 左上角开始
+        inline void FillPattern(Canvas& canvas, const Surface& src, const Rect& area,
+            float opacity, BlendMode mode = BlendMode::SourceOver) {
+            Surface* dst = canvas.GetSurface();
+            if (!dst || !dst->Valid()) return;
+            const Point origin = canvas.GetOrigin();
+            const Rect moved(area.x + origin.X, area.y + origin.Y, area.w, area.h);
+            canvas.ForEachClip([&](const Rect& clip) {
+                FillPattern(*dst, clip, moved, src, moved.x, moved.y, opacity, mode);
+            });
+        }
+
+        // 各内核吞吐量（百万像素/秒）
+        struct Benchmark {
+            Isa isa;
+            double overMPixPerSec = 0, copyMPixPerSec = 0;
+        };
+
+        inline std::vector<Benchmark> BenchmarkBlit(int width = 1920, int height = 1080, int iterations = 20, float opacity = 0.5f) {
+            using Clock = std::chrono::steady_clock;
+            Surface src(width, height), dst(width, height);
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    Color c(uint8_t((x * 7 + y) & 0xFF), uint8_t(x), uint8_t(y), uint8_t(x ^ y));
+                    src.Row(y)[x] = Premultiply(c);
+                    dst.Row(y)[x] = 0xFF808080u;
+                }
+            }
+            const double mpix = double(width) * height * iterations / 1e6;
+            auto run = [&](BlendMode mode) {
+                auto t0 = Clock::now();
+                for (int i = 0; i < iterations; ++i) Composite(dst, dst.Bounds(), 0, 0, src, src.Bounds(), opacity, mode);
+                double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+                return sec > 0 ? mpix / sec : 0.0;
+            };
+
+            const Isa saved = CurrentIsa();
+            std::vector<Benchmark> results;
+            for (Isa isa : { Isa::Scalar, Isa::SSE2, Isa::AVX2 }) {
+                if (!SetIsa(isa)) continue;
+                Benchmark b;
+                b.isa = isa;
+                b.overMPixPerSec = run(BlendMode::SourceOver);
+                b.copyMPixPerSec = run(BlendMode::Copy);
+                results.push_back(b);
+            }
+            SetIsa(saved);
+            return results;
+        }
+    }
+}
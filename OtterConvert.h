@@ -0,0 +1,196 @@
+#pragma once
+// OtterConvert.h
+// 像素格式转换：把解码得到的各种位图格式（24位、调色板、16位等）一次性转换为
+// 渲染器原生的32位预乘BGRA（Surface 行按64字节对齐）。不依赖Windows
+#include <chrono>
+#include <vector>
+#include "OtterRaster.h"
+
+namespace OtterRaster {
+    namespace Convert {
+
+        // 源像素格式，内存字节顺序与 Windows DIB / GDI+ 一致
+        enum class SourceFormat {
+            Bgra32Premultiplied,    // PixelFormat32bppPARGB
+            Bgra32,                 // PixelFormat32bppARGB（非预乘）
+            Bgrx32,                 // PixelFormat32bppRGB（第4字节无意义）
+            Bgr24,                  // PixelFormat24bppRGB
+            Bgr565,                 // PixelFormat16bppRGB565
+            Bgr555,                 // PixelFormat16bppRGB555
+            Indexed8,               // 调色板格式，每像素1字节
+            Indexed4,               // 每字节2像素，高4位在前
+            Indexed1                // 每字节8像素，高位在前
+        };
+
+        inline const char* FormatName(SourceFormat format) {
+            switch (format) {
+            case SourceFormat::Bgra32Premultiplied: return "pbgra32";
+            case SourceFormat::Bgra32: return "bgra32";
+            case SourceFormat::Bgrx32: return "bgrx32";
+            case SourceFormat::Bgr24: return "bgr24";
+            case SourceFormat::Bgr565: return "bgr565";
+            case SourceFormat::Bgr555: return "bgr555";
+            case SourceFormat::Indexed8: return "indexed8";
+            case SourceFormat::Indexed4: return "indexed4";
+            case SourceFormat::Indexed1: return "indexed1";
+            }
+            return "";
+        }
+
+        inline bool IsIndexed(SourceFormat format) {
+            return format == SourceFormat::Indexed8 || format == SourceFormat::Indexed4 || format == SourceFormat::Indexed1;
+        }
+
+        // 调色板（非预乘ARGB）转为256项预乘表，缺少的项为透明
+        inline void PremultiplyPalette(const uint32_t* argb, size_t count, uint32_t out[256]) {
+            for (size_t i = 0; i < 256; ++i) out[i] = i < count ? Premultiply(Color::FromArgb(argb[i])) : 0;
+        }
+
+        inline void PremultiplyRow(uint32_t* dst, const uint32_t* src, int count) {
+            int i = 0;
+#if OTTER_HAS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            const __m128i rgbLanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+            const __m128i alphaLane = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+            for (; i + 4 <= count; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128i a = _mm_and_si128(s, alphaMask);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, alphaMask)) == 0xFFFF) {     // 4个像素全不透明
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), s);
+                    continue;
+                }
+                __m128i lo = _mm_unpacklo_epi8(s, zero), hi = _mm_unpackhi_epi8(s, zero);
+                // 颜色通道乘以alpha，alpha通道乘以255（保持不变）
+                __m128i klo = _mm_or_si128(_mm_and_si128(Span::AlphaOf(lo), rgbLanes), alphaLane);
+                __m128i khi = _mm_or_si128(_mm_and_si128(Span::AlphaOf(hi), rgbLanes), alphaLane);
+                lo = Span::Div255(_mm_mullo_epi16(lo, klo));
+                hi = Span::Div255(_mm_mullo_epi16(hi, khi));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+#endif
+            for (; i < count; ++i) {
+                uint32_t s = src[i];
+                dst[i] = (s >> 24) == 255 ? s : Premultiply(Color::FromArgb(s));
+            }
+        }
+
+        inline void OpaqueRow(uint32_t* dst, const uint32_t* src, int count) {
+            int i = 0;
+#if OTTER_HAS_SSE2
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            for (; i + 4 <= count; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(s, alpha));
+            }
+#endif
+            for (; i < count; ++i) dst[i] = src[i] | 0xFF000000u;
+        }
+
+        inline void Bgr24Row(uint32_t* dst, const uint8_t* src, int count) {
+            for (int i = 0; i < count; ++i, src += 3) {
+                dst[i] = 0xFF000000u | (uint32_t(src[2]) << 16) | (uint32_t(src[1]) << 8) | src[0];
+            }
+        }
+
+        // 5/6位通道扩展到8位：高位复制到低位，使 0 与满值精确映射到 0 与 255
+        inline uint32_t Expand5(uint32_t v) { return (v << 3) | (v >> 2); }
+        inline uint32_t Expand6(uint32_t v) { return (v << 2) | (v >> 4); }
+
+        inline void Bgr565Row(uint32_t* dst, const uint8_t* src, int count) {
+            for (int i = 0; i < count; ++i) {
+                uint32_t v = uint32_t(src[2 * i]) | (uint32_t(src[2 * i + 1]) << 8);
+                dst[i] = 0xFF000000u | (Expand5(v >> 11) << 16) | (Expand6((v >> 5) & 63) << 8) | Expand5(v & 31);
+            }
+        }
+
+        inline void Bgr555Row(uint32_t* dst, const uint8_t* src, int count) {
+            for (int i = 0; i < count; ++i) {
+                uint32_t v = uint32_t(src[2 * i]) | (uint32_t(src[2 * i + 1]) << 8);
+                dst[i] = 0xFF000000u | (Expand5((v >> 10) & 31) << 16) | (Expand5((v >> 5) & 31) << 8) | Expand5(v & 31);
+            }
+        }
+
+        // 调色板格式：palette 为 PremultiplyPalette 得到的预乘表
+        inline void IndexedRow(uint32_t* dst, const uint8_t* src, int count, int bits, const uint32_t* palette) {
+            if (bits == 8) {
+                for (int i = 0; i < count; ++i) dst[i] = palette[src[i]];
+            }
+            else if (bits == 4) {
+                for (int i = 0; i < count; ++i) dst[i] = palette[(src[i >> 1] >> ((i & 1) ? 0 : 4)) & 0x0F];
+            }
+            else {
+                for (int i = 0; i < count; ++i) dst[i] = palette[(src[i >> 3] >> (7 - (i & 7))) & 1];
+            }
+        }
+
+        // 转换一行；调色板格式需要 palette（256项预乘表）
+        inline void ConvertRow(SourceFormat format, uint32_t* dst, const uint8_t* src, int count, const uint32_t* palette = nullptr) {
+            const uint32_t* src32 = reinterpret_cast<const uint32_t*>(src);
+            switch (format) {
+            case SourceFormat::Bgra32Premultiplied: std::memcpy(dst, src, size_t(count) * 4); break;
+            case SourceFormat::Bgra32: PremultiplyRow(dst, src32, count); break;
+            case SourceFormat::Bgrx32: OpaqueRow(dst, src32, count); break;
+            case SourceFormat::Bgr24: Bgr24Row(dst, src, count); break;
+            case SourceFormat::Bgr565: Bgr565Row(dst, src, count); break;
+            case SourceFormat::Bgr555: Bgr555Row(dst, src, count); break;
+            case SourceFormat::Indexed8: IndexedRow(dst, src, count, 8, palette); break;
+            case SourceFormat::Indexed4: IndexedRow(dst, src, count, 4, palette); break;
+            case SourceFormat::Indexed1: IndexedRow(dst, src, count, 1, palette); break;
+            }
+        }
+
+        // 整幅转换到新分配的 dst；srcStride 为字节数（自下而上的位图传负值并让 src 指向首行）
+        inline bool ConvertImage(const uint8_t* src, int srcStride, int width, int height,
+            SourceFormat format, const uint32_t* palette, Surface& dst) {
+            if (!src || width <= 0 || height <= 0) return false;
+            if (IsIndexed(format) && !palette) return false;
+            dst.Allocate(width, height);
+            for (int y = 0; y < height; ++y) {
+                ConvertRow(format, dst.Row(y), src + (ptrdiff_t)y * srcStride, width, palette);
+            }
+            return true;
+        }
+
+        inline int BitsPerPixel(SourceFormat format) {
+            switch (format) {
+            case SourceFormat::Bgr24: return 24;
+            case SourceFormat::Bgr565: case SourceFormat::Bgr555: return 16;
+            case SourceFormat::Indexed8: return 8;
+            case SourceFormat::Indexed4: return 4;
+            case SourceFormat::Indexed1: return 1;
+            default: return 32;
+            }
+        }
+
+        // 各格式转换吞吐量（百万像素/秒）
+        struct Benchmark {
+            SourceFormat format;
+            double mpixPerSec = 0;
+        };
+
+        inline std::vector<Benchmark> BenchmarkConvert(int width = 1920, int height = 1080, int iterations = 10) {
+            using Clock = std::chrono::steady_clock;
+            const int stride = (width * 4 + 3) & ~3;
+            std::vector<uint8_t> src(size_t(stride) * height);
+            for (size_t i = 0; i < src.size(); ++i) src[i] = uint8_t((i * 2654435761u) >> 13);
+            uint32_t palette[256];
+            for (uint32_t i = 0; i < 256; ++i) palette[i] = Premultiply(Color(uint8_t(i), uint8_t(i * 3), uint8_t(i * 5), uint8_t(i * 7)));
+            Surface dst(width, height);
+
+            std::vector<Benchmark> results;
+            for (SourceFormat format : { SourceFormat::Bgra32Premultiplied, SourceFormat::Bgra32, SourceFormat::Bgrx32,
+                SourceFormat::Bgr24, SourceFormat::Bgr565, SourceFormat::Bgr555,
+                SourceFormat::Indexed8, SourceFormat::Indexed4, SourceFormat::Indexed1 }) {
+                const int rowBytes = ((width * BitsPerPixel(format) + 31) / 32) * 4;
+                auto t0 = Clock::now();
+                for (int it = 0; it < iterations; ++it) {
+                    for (int y = 0; y < height; ++y) ConvertRow(format, dst.Row(y), src.data() + size_t(y) * rowBytes, width, palette);
+                }
+                double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+                results.push_back(Benchmark{ format, sec > 0 ? double(width) * height * iterations / 1e6 / sec : 0.0 });
+            }
+            return results;
+        }
+    }
+}
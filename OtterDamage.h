@@ -0,0 +1,142 @@
+#pragma once
+// OtterDamage.h
+// 损坏区域跟踪：记录需要重绘的矩形，合并为数量有上限的矩形列表，
+// 绘制时按这些矩形裁剪，呈现时只提交变化的区域。纯整数运算，不依赖Windows
+#include <cstddef>
+#include <vector>
+#include "OtterRaster.h"
+
+namespace OtterRaster {
+
+    class DamageRegion {
+    public:
+        static constexpr size_t kDefaultMaxRects = 8;
+
+        explicit DamageRegion(size_t maxRects = kDefaultMaxRects)
+            : m_maxRects(maxRects == 0 ? 1 : maxRects) {}
+
+        // 添加损坏矩形：被已有矩形包含则忽略，合并浪费面积不超过阈值的重叠/相邻矩形，
+        // 超过上限时合并代价最小的一对
+        void Add(const Rect& rect) {
+            if (rect.IsEmpty()) return;
+            Rect r = rect;
+            for (const Rect& e : m_rects) {
+                if (e.Contains(r)) return;
+            }
+
+            // 与可合并的矩形反复合并，直到不再变化
+            bool merged = true;
+            while (merged) {
+                merged = false;
+                for (size_t i = 0; i < m_rects.size(); ++i) {
+                    if (r.Contains(m_rects[i]) || ShouldMerge(r, m_rects[i])) {
+                        r = r.Union(m_rects[i]);
+                        m_rects.erase(m_rects.begin() + i);
+                        merged = true;
+                        break;
+                    }
+                }
+            }
+            m_rects.push_back(r);
+
+            while (m_rects.size() > m_maxRects) MergeCheapestPair();
+        }
+
+        void Add(int x, int y, int width, int height) { Add(Rect(x, y, width, height)); }
+
+        // 整个区域损坏（如窗口尺寸变化）
+        void SetFull(const Rect& bounds) {
+            m_rects.clear();
+            if (!bounds.IsEmpty()) m_rects.push_back(bounds);
+        }
+
+        // 与另一区域合并
+        void Add(const DamageRegion& other) {
+            for (const Rect& r : other.m_rects) Add(r);
+        }
+
+        // 所有矩形与 bounds 求交，丢弃空矩形
+        void Clip(const Rect& bounds) {
+            size_t out = 0;
+            for (const Rect& r : m_rects) {
+                Rect c = r.Intersect(bounds);
+                if (!c.IsEmpty()) m_rects[out++] = c;
+            }
+            m_rects.resize(out);
+        }
+
+        // 平移（如图层原点变化）
+        void Offset(int dx, int dy) {
+            for (Rect& r : m_rects) { r.x += dx; r.y += dy; }
+        }
+
+        void Clear() { m_rects.clear(); }
+        bool Empty() const { return m_rects.empty(); }
+        size_t Size() const { return m_rects.size(); }
+        size_t MaxRects() const { return m_maxRects; }
+        const std::vector<Rect>& Rects() const { return m_rects; }
+
+        Rect Bounds() const {
+            Rect b;
+            for (const Rect& r : m_rects) b = b.Union(r);
+            return b;
+        }
+
+        // 覆盖面积（矩形之间可能有少量重叠，重叠部分会重复计入）
+        long long Area() const {
+            long long a = 0;
+            for (const Rect& r : m_rects) a += r.Area();
+            return a;
+        }
+
+        bool Intersects(const Rect& rect) const {
+            for (const Rect& r : m_rects) {
+                if (!r.Intersect(rect).IsEmpty()) return true;
+            }
+            return false;
+        }
+
+        bool Contains(int x, int y) const {
+            for (const Rect& r : m_rects) {
+                if (x >= r.x && y >= r.y && x < r.Right() && y < r.Bottom()) return true;
+            }
+            return false;
+        }
+
+        // 把画布裁剪到损坏区域；区域为空时全部裁掉
+        void ApplyTo(Canvas& canvas) const {
+            canvas.SetClipRects(m_rects.data(), m_rects.size());
+        }
+
+    private:
+        // 合并后多出的面积（并集减去两者实际覆盖面积）
+        static long long MergeWaste(const Rect& a, const Rect& b) {
+            long long covered = a.Area() + b.Area() - a.Intersect(b).Area();
+            return a.Union(b).Area() - covered;
+        }
+
+        // 重叠或相邻，且合并浪费不超过较小矩形面积时直接合并
+        static bool ShouldMerge(const Rect& a, const Rect& b) {
+            bool touching = a.x <= b.Right() && b.x <= a.Right() && a.y <= b.Bottom() && b.y <= a.Bottom();
+            if (!touching) return false;
+            long long smaller = a.Area() < b.Area() ? a.Area() : b.Area();
+            return MergeWaste(a, b) <= smaller;
+        }
+
+        void MergeCheapestPair() {
+            size_t bi = 0, bj = 1;
+            long long best = -1;
+            for (size_t i = 0; i < m_rects.size(); ++i) {
+                for (size_t j = i + 1; j < m_rects.size(); ++j) {
+                    long long w = MergeWaste(m_rects[i], m_rects[j]);
+                    if (best < 0 || w < best) { best = w; bi = i; bj = j; }
+                }
+            }
+            m_rects[bi] = m_rects[bi].Union(m_rects[bj]);
+            m_rects.erase(m_rects.begin() + bj);
+        }
+
+        size_t m_maxRects;
+        std::vector<Rect> m_rects;
+    };
+}
@@ -0,0 +1,305 @@
+#pragma once
+// OtterDecodeQueue.h
+// 后台解码队列：固定数量的工作线程按优先级（高者先，同级先进先出）执行解码任务，
+// 等待队列有上限，可随时调整优先级或取消。完成结果留在队列中，由UI线程调用 Drain 取走；
+// 每完成一个任务在工作线程上调用一次通知回调（用于唤醒UI线程）。不依赖Windows
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "OtterTrace.h"
+
+namespace OtterAsync {
+
+    // 常用优先级，数值越大越先解码
+    constexpr int kPriorityBackground = 0;
+    constexpr int kPriorityNormal = 1;
+    constexpr int kPriorityVisible = 2;
+
+    enum class DecodeStatus {
+        Ready,          // 解码成功
+        Failed,         // 解码失败
+        Cancelled,      // 执行中被取消
+        Dropped         // 队列已满，被更高优先级的任务挤出
+    };
+
+    struct DecodeStats {
+        size_t submitted = 0;
+        size_t ready = 0;
+        size_t failed = 0;
+        size_t cancelled = 0;       // 包括尚未执行即被取消的任务
+        size_t dropped = 0;
+        size_t peakPending = 0;
+    };
+
+    template <typename Key, typename Result, typename Hash = std::hash<Key>>
+    class DecodeQueue {
+    public:
+        // 在工作线程上执行；解码到 out，返回是否成功。耗时的任务应定期检查 cancelled
+        using Job = std::function<bool(Result& out, const std::atomic<bool>& cancelled)>;
+
+        // Ready 时 result 为解码结果；Failed 时保留任务写入的内容（可携带失败原因或来源），其余为默认值
+        struct Completion {
+            Key key;
+            DecodeStatus status;
+            Result result;
+        };
+
+        // workers 为0时取硬件线程数减1（至少1个）
+        explicit DecodeQueue(size_t workers = 0, size_t maxPending = 256)
+            : m_maxPending(maxPending == 0 ? 1 : maxPending) {
+            if (workers == 0) {
+                const unsigned hw = std::thread::hardware_concurrency();
+                workers = hw > 1 ? hw - 1 : 1;
+            }
+            for (size_t i = 0; i < workers; ++i) m_workers.emplace_back([this] { WorkerLoop(); });
+        }
+
+        ~DecodeQueue() { Shutdown(); }
+
+        DecodeQueue(const DecodeQueue&) = delete;
+        DecodeQueue& operator=(const DecodeQueue&) = delete;
+
+        // 停止接受新任务，取消全部任务并等待工作线程退出；未取走的完成结果保留
+        void Shutdown() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_stopping) return;
+                m_stopping = true;
+                m_stats.cancelled += m_pending.size();
+                m_pending.clear();
+                m_order.clear();
+                for (auto& kv : m_running) kv.second->store(true);
+            }
+            m_wake.notify_all();
+            for (std::thread& t : m_workers) {
+                if (t.joinable()) t.join();
+            }
+            m_workers.clear();
+        }
+
+        // 提交任务。同一个键已在等待时只更新优先级；已在执行时返回 true 且不重复提交。
+        // 队列已满时挤出优先级最低且最新的任务，若没有比新任务更低的则返回 false
+        bool Submit(const Key& key, Job job, int priority = kPriorityNormal) {
+            std::vector<Key> droppedKeys;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_stopping) return false;
+                if (m_running.count(key)) return true;
+                auto it = m_pending.find(key);
+                if (it != m_pending.end()) {
+                    Reorder(it->first, it->second, priority);
+                    return true;
+                }
+                if (m_pending.size() >= m_maxPending) {
+                    auto lowest = std::prev(m_order.end());
+                    if (lowest->priority >= priority) return false;
+                    Key victim = lowest->key;
+                    m_order.erase(lowest);
+                    m_pending.erase(victim);
+                    ++m_stats.dropped;
+                    m_done.push_back(Completion{ victim, DecodeStatus::Dropped, Result() });
+                    droppedKeys.push_back(std::move(victim));
+                }
+                Pending entry;
+                entry.priority = priority;
+                entry.sequence = m_nextSequence++;
+                entry.job = std::move(job);
+                m_order.insert(OrderKey{ entry.priority, entry.sequence, key });
+                m_pending.emplace(key, std::move(entry));
+                ++m_stats.submitted;
+                m_stats.peakPending = (std::max)(m_stats.peakPending, m_pending.size());
+            }
+            m_wake.notify_one();
+            if (!droppedKeys.empty()) Notify();
+            return true;
+        }
+
+        // 调整等待中任务的优先级（如滚动后可见的图片提前）
+        bool SetPriority(const Key& key, int priority) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_pending.find(key);
+            if (it == m_pending.end()) return false;
+            Reorder(it->first, it->second, priority);
+            return true;
+        }
+
+        // 取消任务：等待中的直接移除（不产生完成结果），执行中的置取消标志，完成后报告 Cancelled
+        bool Cancel(const Key& key) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_pending.find(key);
+            if (it != m_pending.end()) {
+                m_order.erase(OrderKey{ it->second.priority, it->second.sequence, key });
+                m_pending.erase(it);
+                ++m_stats.cancelled;
+                if (m_pending.empty() && m_running.empty()) m_idle.notify_all();
+                return true;
+            }
+            auto running = m_running.find(key);
+            if (running == m_running.end()) return false;
+            running->second->store(true);
+            return true;
+        }
+
+        void CancelAll() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.cancelled += m_pending.size();
+            m_pending.clear();
+            m_order.clear();
+            for (auto& kv : m_running) kv.second->store(true);
+            if (m_running.empty()) m_idle.notify_all();
+        }
+
+        // 等待中或执行中
+        bool IsQueued(const Key& key) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_pending.count(key) != 0 || m_running.count(key) != 0;
+        }
+
+        size_t PendingCount() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_pending.size();
+        }
+
+        size_t WorkerCount() const { return m_workers.size(); }
+
+        // 在工作线程上调用；应只做唤醒（如投递消息），不要访问UI状态
+        void SetNotify(std::function<void()> notify) {
+            std::lock_guard<std::mutex> lock(m_notifyMutex);
+            m_notify = std::move(notify);
+        }
+
+        // 取走全部完成结果，逐个调用 fn(Completion&)；返回个数
+        template <typename Fn>
+        size_t Drain(Fn&& fn) {
+            std::deque<Completion> done;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                done.swap(m_done);
+            }
+            for (Completion& c : done) fn(c);
+            return done.size();
+        }
+
+        // 阻塞直到没有等待中与执行中的任务
+        void WaitIdle() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this] { return m_pending.empty() && m_running.empty(); });
+        }
+
+        DecodeStats GetStats() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_stats;
+        }
+
+    private:
+        struct Pending {
+            int priority = 0;
+            uint64_t sequence = 0;
+            Job job;
+        };
+
+        struct OrderKey {
+            int priority;
+            uint64_t sequence;
+            Key key;
+
+            // 优先级高的在前，同级按提交顺序
+            bool operator<(const OrderKey& o) const {
+                if (priority != o.priority) return priority > o.priority;
+                return sequence < o.sequence;
+            }
+        };
+
+        void Reorder(const Key& key, Pending& entry, int priority) {
+            if (entry.priority == priority) return;
+            m_order.erase(OrderKey{ entry.priority, entry.sequence, key });
+            entry.priority = priority;
+            m_order.insert(OrderKey{ entry.priority, entry.sequence, key });
+        }
+
+        void Notify() {
+            std::function<void()> notify;
+            {
+                std::lock_guard<std::mutex> lock(m_notifyMutex);
+                notify = m_notify;
+            }
+            if (notify) notify();
+        }
+
+        void WorkerLoop() {
+            OTTER_TRACE_THREAD_NAME("decode worker");
+            for (;;) {
+                Key key;
+                Job job;
+                std::shared_ptr<std::atomic<bool>> cancelled;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_wake.wait(lock, [this] { return m_stopping || !m_order.empty(); });
+                    if (m_stopping) return;
+                    auto first = m_order.begin();
+                    key = first->key;
+                    m_order.erase(first);
+                    auto it = m_pending.find(key);
+                    job = std::move(it->second.job);
+                    m_pending.erase(it);
+                    cancelled = std::make_shared<std::atomic<bool>>(false);
+                    m_running.emplace(key, cancelled);
+                }
+
+                Result result{};
+                bool ok = false;
+                try {
+                    OTTER_TRACE_SCOPE("decode", "Job");
+                    ok = job(result, *cancelled);
+                }
+                catch (...) {
+                    ok = false;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_running.erase(key);
+                    DecodeStatus status = cancelled->load() ? DecodeStatus::Cancelled
+                        : ok ? DecodeStatus::Ready : DecodeStatus::Failed;
+                    switch (status) {
+                    case DecodeStatus::Ready: ++m_stats.ready; break;
+                    case DecodeStatus::Failed: ++m_stats.failed; break;
+                    default: ++m_stats.cancelled; break;
+                    }
+                    if (status == DecodeStatus::Cancelled) result = Result();
+                    m_done.push_back(Completion{ std::move(key), status, std::move(result) });
+                    if (m_pending.empty() && m_running.empty()) m_idle.notify_all();
+                }
+                Notify();
+            }
+        }
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+        std::unordered_map<Key, Pending, Hash> m_pending;
+        std::set<OrderKey> m_order;
+        std::unordered_map<Key, std::shared_ptr<std::atomic<bool>>, Hash> m_running;
+        std::deque<Completion> m_done;
+        uint64_t m_nextSequence = 0;
+        size_t m_maxPending;
+        bool m_stopping = false;
+        DecodeStats m_stats;
+
+        std::mutex m_notifyMutex;
+        std::function<void()> m_notify;
+
+        std::vector<std::thread> m_workers;
+    };
+}
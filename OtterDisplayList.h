@@ -0,0 +1,523 @@
+#pragma once
+// OtterDisplayList.h
+// 保留模式绘制：绘制调用录制为紧凑的POD命令缓冲区，可重复回放到 OtterRaster::Canvas
+// LayerStack 按图层缓存显示列表与其光栅化结果，输入未变化的图层跨帧复用
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "OtterRaster.h"
+#include "OtterDamage.h"
+
+namespace OtterRaster {
+
+    enum class DrawOp : uint8_t {
+        Clear,
+        FillRectangle,
+        DrawRectangle,
+        FillCircle,
+        DrawCircle,
+        FillPolygon,
+        DrawPolygon,
+        DrawLine,
+        DrawString,
+        SetClip,
+        ResetClip,
+        SetAntiAlias,
+    };
+
+    // 单条绘制命令（36字节，无填充，可按字节哈希）
+    struct DrawCommand {
+        DrawOp op;
+        uint8_t rule;           // FillRule / 抗锯齿开关
+        uint16_t reserved;
+        uint32_t color;         // 非预乘 ARGB
+        float v[5];             // 坐标参数，最后一项通常为线宽/字号
+        uint32_t first;         // 点/文本在数据区的起始下标
+        uint32_t count;         // 点/文本数量
+    };
+    static_assert(std::is_trivially_copyable<DrawCommand>::value, "DrawCommand must be POD");
+    static_assert(sizeof(DrawCommand) == 36, "DrawCommand must not contain padding");
+
+    // 显示列表：接口与 Canvas 一致，录制后可多次回放
+    class DisplayList {
+    public:
+        // 清空命令但保留容量，便于每帧重录不分配内存
+        void Reset() {
+            m_commands.clear();
+            m_commandBounds.clear();
+            m_points.clear();
+            m_text.clear();
+            m_bounds = Rect();
+            m_coversAll = false;
+            m_hashValid = false;
+        }
+
+        void Clear(Color color) {
+            Push(DrawOp::Clear, color);
+            m_coversAll = true;
+        }
+
+        void FillRectangle(int x, int y, int width, int height, Color color) {
+            DrawCommand& c = Push(DrawOp::FillRectangle, color);
+            Set(c, float(x), float(y), float(width), float(height));
+            AddBounds(float(x), float(y), float(x + width), float(y + height), 0.0f);
+        }
+
+        void DrawRectangle(int x, int y, int width, int height, Color color, float penWidth = 1.0f) {
+            DrawCommand& c = Push(DrawOp::DrawRectangle, color);
+            Set(c, float(x), float(y), float(width), float(height), penWidth);
+            AddBounds(float(x), float(y), float(x + width), float(y + height), penWidth);
+        }
+
+        void FillCircle(int x, int y, int radius, Color color) {
+            DrawCommand& c = Push(DrawOp::FillCircle, color);
+            Set(c, float(x), float(y), float(radius));
+            AddBounds(float(x - radius), float(y - radius), float(x + radius), float(y + radius), 0.0f);
+        }
+
+        void DrawCircle(int x, int y, int radius, Color color, float penWidth = 1.0f) {
+            DrawCommand& c = Push(DrawOp::DrawCircle, color);
+            Set(c, float(x), float(y), float(radius), 0.0f, penWidth);
+            AddBounds(float(x - radius), float(y - radius), float(x + radius), float(y + radius), penWidth);
+        }
+
+        template <typename PointT>
+        void FillPolygon(const std::vector<PointT>& points, Color color, FillRule rule = FillRule::NonZero) {
+            FillPolygon(points.data(), points.size(), color, rule);
+        }
+
+        template <typename PointT>
+        void FillPolygon(const PointT* points, size_t count, Color color, FillRule rule = FillRule::NonZero) {
+            if (count < 3) return;
+            DrawCommand& c = Push(DrawOp::FillPolygon, color);
+            c.rule = static_cast<uint8_t>(rule);
+            AddPoints(c, points, count, 0.0f);
+        }
+
+        template <typename PointT>
+        void DrawPolygon(const std::vector<PointT>& points, Color color, float penWidth = 1.0f) {
+            DrawPolygon(points.data(), points.size(), color, penWidth);
+        }
+
+        template <typename PointT>
+        void DrawPolygon(const PointT* points, size_t count, Color color, float penWidth = 1.0f) {
+            if (count < 2) return;
+            DrawCommand& c = Push(DrawOp::DrawPolygon, color);
+            c.v[4] = penWidth;
+            AddPoints(c, points, count, penWidth);
+        }
+
+        void DrawLine(int x1, int y1, int x2, int y2, Color color, float penWidth = 1.0f) {
+            DrawLine(float(x1), float(y1), float(x2), float(y2), color, penWidth);
+        }
+
+        void DrawLine(float x1, float y1, float x2, float y2, Color color, float penWidth = 1.0f) {
+            DrawCommand& c = Push(DrawOp::DrawLine, color);
+            Set(c, x1, y1, x2, y2, penWidth);
+            AddBounds((std::min)(x1, x2), (std::min)(y1, y2), (std::max)(x1, x2), (std::max)(y1, y2), penWidth);
+        }
+
+        void DrawString(const std::wstring& text, float x, float y, float fontSize, Color color) {
+            if (text.empty()) return;
+            DrawCommand& c = Push(DrawOp::DrawString, color);
+            Set(c, x, y, 0.0f, 0.0f, fontSize);
+            c.first = static_cast<uint32_t>(m_text.size());
+            c.count = static_cast<uint32_t>(text.size());
+            m_text.insert(m_text.end(), text.begin(), text.end());
+            PointF size = Canvas::MeasureString(text, fontSize);
+            float overhang = Canvas::EmPixels(fontSize) * 0.1f;    // 字形可能略超出步进宽度
+            AddBounds(x - overhang, y - 1.0f, x + size.X + overhang, y + size.Y + 1.0f, 0.0f);  // 基线取整可能移动1像素
+        }
+
+        void SetClip(const Rect& clip) {
+            DrawCommand& c = Push(DrawOp::SetClip, Color());
+            Set(c, float(clip.x), float(clip.y), float(clip.w), float(clip.h));
+        }
+
+        void ResetClip() { Push(DrawOp::ResetClip, Color()); }
+
+        void SetAntiAlias(bool enabled) {
+            DrawCommand& c = Push(DrawOp::SetAntiAlias, Color());
+            c.rule = enabled ? 1 : 0;
+        }
+
+        // 回放到画布：使用画布当前的原点与裁剪，录制的 SetClip 与其求交
+        void Replay(Canvas& canvas) const {
+            ReplayEach(canvas, m_commands.size(), [](size_t i) { return i; });
+        }
+
+        // 只回放 indices 列出的命令（按给定顺序），用于分块光栅化等只关心部分区域的回放
+        void Replay(Canvas& canvas, const uint32_t* indices, size_t count) const {
+            ReplayEach(canvas, count, [indices](size_t i) { return size_t(indices[i]); });
+        }
+
+        // 内容哈希：命令与数据相同则哈希相同，用于判断重录后是否需要重新光栅化
+        uint64_t Hash() const {
+            if (m_hashValid) return m_hash;
+            uint64_t h = 1469598103934665603ull;
+            h = HashBytes(h, m_commands.data(), m_commands.size() * sizeof(DrawCommand));
+            h = HashBytes(h, m_points.data(), m_points.size() * sizeof(PointF));
+            h = HashBytes(h, m_text.data(), m_text.size() * sizeof(wchar_t));
+            m_hash = h;
+            m_hashValid = true;
+            return h;
+        }
+
+        // 所有命令的保守设备包围盒（未含原点偏移）；含 Clear 时 CoversAll() 为 true
+        const Rect& Bounds() const { return m_bounds; }
+        bool CoversAll() const { return m_coversAll; }
+
+        bool Empty() const { return m_commands.empty(); }
+        size_t Size() const { return m_commands.size(); }
+        size_t ByteSize() const {
+            return m_commands.size() * sizeof(DrawCommand) + m_points.size() * sizeof(PointF) + m_text.size() * sizeof(wchar_t);
+        }
+        const std::vector<DrawCommand>& Commands() const { return m_commands; }
+
+        // 每条命令的保守包围盒（未含原点偏移），与 Commands() 一一对应；
+        // 不绘制像素的状态命令（SetClip、ResetClip、SetAntiAlias）与 Clear 为空矩形
+        const std::vector<Rect>& CommandBounds() const { return m_commandBounds; }
+
+        // 影响其后所有命令或覆盖整个裁剪区域的命令，分块回放时每块都需要
+        static bool IsStateOp(DrawOp op) {
+            return op == DrawOp::Clear || op == DrawOp::SetClip || op == DrawOp::ResetClip || op == DrawOp::SetAntiAlias;
+        }
+
+    private:
+        static int I(float v) { return static_cast<int>(v); }
+
+        template <typename IndexFn>
+        void ReplayEach(Canvas& canvas, size_t count, IndexFn&& indexAt) const {
+            const Rect baseClip = canvas.GetClip();
+            const Point origin = canvas.GetOrigin();
+            const bool baseAntiAlias = canvas.GetAntiAlias();
+            for (size_t n = 0; n < count; ++n) {
+                const DrawCommand& c = m_commands[indexAt(n)];
+                Color color = Color::FromArgb(c.color);
+                switch (c.op) {
+                case DrawOp::Clear:
+                    canvas.Clear(color);
+                    break;
+                case DrawOp::FillRectangle:
+                    canvas.FillRectangle(I(c.v[0]), I(c.v[1]), I(c.v[2]), I(c.v[3]), color);
+                    break;
+                case DrawOp::DrawRectangle:
+                    canvas.DrawRectangle(I(c.v[0]), I(c.v[1]), I(c.v[2]), I(c.v[3]), color, c.v[4]);
+                    break;
+                case DrawOp::FillCircle:
+                    canvas.FillCircle(I(c.v[0]), I(c.v[1]), I(c.v[2]), color);
+                    break;
+                case DrawOp::DrawCircle:
+                    canvas.DrawCircle(I(c.v[0]), I(c.v[1]), I(c.v[2]), color, c.v[4]);
+                    break;
+                case DrawOp::FillPolygon:
+                    canvas.FillPolygon(m_points.data() + c.first, c.count, color, static_cast<FillRule>(c.rule));
+                    break;
+                case DrawOp::DrawPolygon:
+                    canvas.DrawPolygon(m_points.data() + c.first, c.count, color, c.v[4]);
+                    break;
+                case DrawOp::DrawLine:
+                    canvas.DrawLine(c.v[0], c.v[1], c.v[2], c.v[3], color, c.v[4]);
+                    break;
+                case DrawOp::DrawString:
+                    canvas.DrawString(m_text.data() + c.first, c.count, c.v[0], c.v[1], c.v[4], color);
+                    break;
+                case DrawOp::SetClip:
+                    canvas.SetClip(Rect(I(c.v[0]) + origin.X, I(c.v[1]) + origin.Y, I(c.v[2]), I(c.v[3])).Intersect(baseClip));
+                    break;
+                case DrawOp::ResetClip:
+                    canvas.SetClip(baseClip);
+                    break;
+                case DrawOp::SetAntiAlias:
+                    canvas.SetAntiAlias(c.rule != 0);
+                    break;
+                }
+            }
+            canvas.SetClip(baseClip);
+            canvas.SetAntiAlias(baseAntiAlias);
+        }
+
+        static uint64_t HashBytes(uint64_t h, const void* data, size_t size) {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+            return h;
+        }
+
+        DrawCommand& Push(DrawOp op, Color color) {
+            DrawCommand c{};
+            c.op = op;
+            c.color = (uint32_t(color.a) << 24) | (uint32_t(color.r) << 16) | (uint32_t(color.g) << 8) | color.b;
+            m_commands.push_back(c);
+            m_commandBounds.push_back(Rect());
+            m_hashValid = false;
+            return m_commands.back();
+        }
+
+        static void Set(DrawCommand& c, float a, float b, float d = 0.0f, float e = 0.0f, float w = 0.0f) {
+            c.v[0] = a; c.v[1] = b; c.v[2] = d; c.v[3] = e; c.v[4] = w;
+        }
+
+        template <typename PointT>
+        void AddPoints(DrawCommand& c, const PointT* points, size_t count, float penWidth) {
+            c.first = static_cast<uint32_t>(m_points.size());
+            c.count = static_cast<uint32_t>(count);
+            float x0 = 1e30f, y0 = 1e30f, x1 = -1e30f, y1 = -1e30f;
+            for (size_t i = 0; i < count; ++i) {
+                PointF p(float(points[i].X), float(points[i].Y));
+                m_points.push_back(p);
+                x0 = (std::min)(x0, p.X); y0 = (std::min)(y0, p.Y);
+                x1 = (std::max)(x1, p.X); y1 = (std::max)(y1, p.Y);
+            }
+            AddBounds(x0, y0, x1, y1, penWidth);
+        }
+
+        // 描边外扩半线宽，再留1像素抗锯齿与半像素偏移余量
+        void AddBounds(float x0, float y0, float x1, float y1, float penWidth) {
+            float pad = penWidth * 0.5f + 1.0f;
+            int l = static_cast<int>(std::floor(x0 - pad)), t = static_cast<int>(std::floor(y0 - pad));
+            int r = static_cast<int>(std::ceil(x1 + pad)), b = static_cast<int>(std::ceil(y1 + pad));
+            m_commandBounds.back() = Rect(l, t, r - l, b - t);
+            m_bounds = m_bounds.Union(m_commandBounds.back());
+        }
+
+        std::vector<DrawCommand> m_commands;
+        std::vector<Rect> m_commandBounds;
+        std::vector<PointF> m_points;
+        std::vector<wchar_t> m_text;
+        Rect m_bounds;
+        bool m_coversAll = false;
+        mutable uint64_t m_hash = 0;
+        mutable bool m_hashValid = false;
+    };
+
+    // 图层栈：按首次录制顺序合成；输入键未变化的图层不重录，内容未变化的图层复用缓存位图
+    class LayerStack {
+    public:
+        struct Stats {
+            size_t recorded = 0;        // 重录的图层数
+            size_t reused = 0;          // 输入未变化、跳过录制的图层数
+            size_t rasterized = 0;      // 重新光栅化缓存位图的次数
+            size_t cacheHits = 0;       // 直接混合缓存位图的次数
+            size_t replayed = 0;        // 直接回放（未缓存）的次数
+        };
+
+        // 开始录制图层：inputKey 与上次相同且未失效时返回 nullptr（沿用上次内容），
+        // 否则返回已清空的显示列表供重录
+        DisplayList* Record(const std::string& name, uint64_t inputKey) {
+            Layer& layer = GetLayer(name);
+            if (layer.recorded && layer.inputKey == inputKey) {
+                ++m_stats.reused;
+                return nullptr;
+            }
+            layer.inputKey = inputKey;
+            layer.recorded = true;
+            layer.list.Reset();
+            ++m_stats.recorded;
+            return &layer.list;
+        }
+
+        // 强制下一次 Record 重录
+        void Invalidate(const std::string& name) {
+            auto it = m_index.find(name);
+            if (it != m_index.end()) m_layers[it->second]->recorded = false;
+        }
+
+        void InvalidateAll() {
+            for (auto& layer : m_layers) layer->recorded = false;
+        }
+
+        void SetVisible(const std::string& name, bool visible) { GetLayer(name).visible = visible; }
+
+        // 是否缓存图层的光栅化结果（默认开启；内容每帧都变化的图层可关闭以节省内存）
+        void SetCached(const std::string& name, bool cached) {
+            Layer& layer = GetLayer(name);
+            layer.cached = cached;
+            if (!cached) layer.cache = Surface();
+        }
+
+        const DisplayList* Find(const std::string& name) const {
+            auto it = m_index.find(name);
+            return it == m_index.end() ? nullptr : &m_layers[it->second]->list;
+        }
+
+        void Remove(const std::string& name) {
+            auto it = m_index.find(name);
+            if (it == m_index.end()) return;
+            const Layer& layer = *m_layers[it->second];
+            if (layer.composedVisible) m_removedDamage.push_back(layer.composedBounds);
+            m_layers.erase(m_layers.begin() + it->second);
+            m_index.clear();
+            for (size_t i = 0; i < m_layers.size(); ++i) m_index[m_layers[i]->name] = i;
+        }
+
+        void Clear() {
+            for (auto& layer : m_layers) {
+                if (layer->composedVisible) m_removedDamage.push_back(layer->composedBounds);
+            }
+            m_layers.clear();
+            m_index.clear();
+        }
+
+        size_t Size() const { return m_layers.size(); }
+
+        // 收集自上次 Compose 以来内容或可见性变化的图层区域（旧位置与新位置），
+        // origin 与 Compose 时画布原点一致；含 Clear 的图层变化时整个 fullBounds 损坏
+        void CollectDamage(DamageRegion& damage, const Rect& fullBounds, Point origin = Point()) const {
+            for (const Rect& r : m_removedDamage) damage.Add(r);
+            for (const auto& layerPtr : m_layers) {
+                const Layer& layer = *layerPtr;
+                bool visible = layer.visible && !layer.list.Empty();
+                if (visible == layer.composedVisible && (!visible || layer.list.Hash() == layer.composedHash)) continue;
+                if (layer.composedVisible) damage.Add(layer.composedBounds);
+                if (visible) damage.Add(DeviceBounds(layer.list, fullBounds, origin));
+            }
+        }
+
+        // 按顺序合成所有可见图层
+        void Compose(Canvas& canvas) {
+            Compose(canvas, [](const DisplayList& list, Canvas& target) { list.Replay(target); });
+        }
+
+        // 同上，图层内容的光栅化由 replay(const DisplayList&, Canvas&) 完成（如 TileRenderer 多线程分块回放）
+        template <typename ReplayFn>
+        void Compose(Canvas& canvas, ReplayFn&& replay) {
+            Surface* target = canvas.GetSurface();
+            if (!target || !target->Valid()) return;
+            const Point origin = canvas.GetOrigin();
+            m_removedDamage.clear();
+            for (auto& layerPtr : m_layers) {
+                Layer& layer = *layerPtr;
+                layer.composedVisible = layer.visible && !layer.list.Empty();
+                if (!layer.composedVisible) continue;
+                layer.composedHash = layer.list.Hash();
+                layer.composedBounds = DeviceBounds(layer.list, target->Bounds(), origin);
+
+                // 含 Clear 的图层依赖目标已有内容，不能离屏缓存
+                if (!layer.cached || layer.list.CoversAll()) {
+                    replay(layer.list, canvas);
+                    ++m_stats.replayed;
+                    continue;
+                }
+
+                Rect bounds = layer.list.Bounds();
+                Rect area = Rect(bounds.x + origin.X, bounds.y + origin.Y, bounds.w, bounds.h).Intersect(target->Bounds());
+                if (area.IsEmpty()) continue;
+
+                const uint64_t hash = layer.composedHash;
+                if (!layer.cache.Valid() || layer.cacheHash != hash || layer.cacheArea != area) {
+                    if (layer.cache.Width() != area.w || layer.cache.Height() != area.h) layer.cache.Allocate(area.w, area.h);
+                    else std::memset(layer.cache.Data(), 0, size_t(layer.cache.Stride()) * area.h);
+                    Canvas offscreen(&layer.cache);
+                    offscreen.SetAntiAlias(canvas.GetAntiAlias());
+                    offscreen.SetOrigin(origin.X - area.x, origin.Y - area.y);
+                    replay(layer.list, offscreen);
+                    layer.cacheHash = hash;
+                    layer.cacheArea = area;
+                    ++m_stats.rasterized;
+                }
+                else {
+                    ++m_stats.cacheHits;
+                }
+                canvas.DrawSurface(layer.cache, area.x - origin.X, area.y - origin.Y);
+            }
+        }
+
+        const Stats& GetStats() const { return m_stats; }
+        void ResetStats() { m_stats = Stats(); }
+
+    private:
+        struct Layer {
+            std::string name;
+            DisplayList list;
+            uint64_t inputKey = 0;
+            bool recorded = false;
+            bool visible = true;
+            bool cached = true;
+            Surface cache;
+            uint64_t cacheHash = 0;
+            Rect cacheArea;
+            // 上次合成时的状态，用于损坏区域计算
+            bool composedVisible = false;
+            uint64_t composedHash = 0;
+            Rect composedBounds;
+        };
+
+        static Rect DeviceBounds(const DisplayList& list, const Rect& fullBounds, Point origin) {
+            if (list.CoversAll()) return fullBounds;
+            Rect b = list.Bounds();
+            return Rect(b.x + origin.X, b.y + origin.Y, b.w, b.h);
+        }
+
+        Layer& GetLayer(const std::string& name) {
+            auto it = m_index.find(name);
+            if (it != m_index.end()) return *m_layers[it->second];
+            m_index[name] = m_layers.size();
+            m_layers.push_back(std::make_unique<Layer>());
+            m_layers.back()->name = name;
+            return *m_layers.back();
+        }
+
+        std::vector<std::unique_ptr<Layer>> m_layers;
+        std::unordered_map<std::string, size_t> m_index;
+        std::vector<Rect> m_removedDamage;
+        Stats m_stats;
+    };
+
+    // 静态界面每帧耗时对比：立即绘制 vs 图层缓存合成（仅状态栏图层每帧变化）
+    struct DisplayListBenchmark {
+        int primitives = 0;
+        double immediateFramesPerSec = 0;
+        double layeredFramesPerSec = 0;
+    };
+
+    inline DisplayListBenchmark BenchmarkDisplayList(int width = 1280, int height = 720, int primitives = 2000, int frames = 120) {
+        using Clock = std::chrono::steady_clock;
+        Surface surface(width, height);
+        Canvas canvas(&surface);
+        DisplayListBenchmark bench;
+        bench.primitives = primitives;
+
+        // 与 Canvas 接口一致，立即绘制与录制共用同一段绘制代码
+        auto drawStatic = [&](auto& target) {
+            for (int i = 0; i < primitives; ++i) {
+                int x = (i * 7919) % width, y = (i * 104729) % height;
+                switch (i % 4) {
+                case 0: target.FillRectangle(x, y, 40, 24, Color(220, 40, 120, 200)); break;
+                case 1: target.FillCircle(x, y, 12, Color(200, 220, 80, 40)); break;
+                case 2: target.DrawLine(x, y, x + 50, y + 20, Color(255, 30, 30, 30), 1.5f); break;
+                default: target.DrawString(L"Label", float(x), float(y), 9.0f, Color(255, 0, 0, 0)); break;
+                }
+            }
+        };
+        auto drawStatus = [&](auto& target, int frame) {
+            target.FillRectangle(0, height - 24, width, 24, Color(255, 32, 32, 32));
+            target.DrawString(L"frame " + std::to_wstring(frame), 8.0f, float(height - 22), 10.0f, Color(255, 255, 255, 255));
+        };
+
+        auto t0 = Clock::now();
+        for (int f = 0; f < frames; ++f) {
+            canvas.Clear(Color(255, 255, 255, 255));
+            drawStatic(canvas);
+            drawStatus(canvas, f);
+        }
+        double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        bench.immediateFramesPerSec = sec > 0 ? frames / sec : 0.0;
+
+        LayerStack layers;
+        t0 = Clock::now();
+        for (int f = 0; f < frames; ++f) {
+            canvas.Clear(Color(255, 255, 255, 255));
+            if (DisplayList* list = layers.Record("static", 1)) drawStatic(*list);
+            if (DisplayList* list = layers.Record("status", static_cast<uint64_t>(f))) drawStatus(*list, f);
+            layers.Compose(canvas);
+        }
+        sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        bench.layeredFramesPerSec = sec > 0 ? frames / sec : 0.0;
+        return bench;
+    }
+}
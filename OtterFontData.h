@@ -0,0 +1,291 @@
+#pragma once
+// OtterFontData.h
+// 内置矢量字体：ASCII 32-126 的TrueType二次曲线轮廓，取自 DejaVu Sans（https://dejavu-fonts.github.io/）
+// Copyright (c) 2003 by Bitstream, Inc. All Rights Reserved. Bitstream Vera is a trademark of Bitstream, Inc.
+// DejaVu changes are in public domain.
+// 字形数据按 Bitstream Vera 字体许可分发，复制本文件时须附带仓库根目录的 LICENSE-DejaVu（完整版权与许可声明）
+// 供软件光栅化后端在无系统字体（如Linux无头环境）时使用
+#include <cstdint>
+
+namespace OtterRaster {
+    namespace FontData {
+        constexpr int kUnitsPerEm = 2048;
+        constexpr int kAscender = 1901;
+        constexpr int kDescender = -483;
+        constexpr int kFirstChar = 32;
+        constexpr int kLastChar = 126;
+
+        struct Glyph {
+            uint16_t advance;       // 字宽（字体单位）
+            uint16_t firstContour;  // kContourEnds 中的起始下标
+            uint16_t contourCount;
+        };
+
+        constexpr Glyph kGlyphs[kLastChar - kFirstChar + 1] = {
+            { 651, 0, 0 }, { 821, 0, 2 }, { 942, 2, 2 }, { 1716, 4, 2 }, { 1303, 6, 3 }, { 1946, 9, 5 },
+            { 1597, 14, 2 }, { 563, 16, 1 }, { 799, 17, 1 }, { 799, 18, 1 }, { 1024, 19, 1 }, { 1716, 20, 1 },
+            { 651, 21, 1 }, { 739, 22, 1 }, { 651, 23, 1 }, { 690, 24, 1 }, { 1303, 25, 2 }, { 1303, 27, 1 },
+            { 1303, 28, 1 }, { 1303, 29, 1 }, { 1303, 30, 2 }, { 1303, 32, 1 }, { 1303, 33, 2 }, { 1303, 35, 1 },
+            { 1303, 36, 3 }, { 1303, 39, 2 }, { 690, 41, 2 }, { 690, 43, 2 }, { 1716, 45, 1 }, { 1716, 46, 2 },
+            { 1716, 48, 1 }, { 1087, 49, 2 }, { 2048, 51, 2 }, { 1401, 53, 2 }, { 1405, 55, 3 }, { 1430, 58, 1 },
+            { 1577, 59, 2 }, { 1294, 61, 1 }, { 1178, 62, 1 }, { 1587, 63, 1 }, { 1540, 64, 1 }, { 604, 65, 1 },
+            { 604, 66, 1 }, { 1343, 67, 1 }, { 1141, 68, 1 }, { 1767, 69, 1 }, { 1532, 70, 1 }, { 1612, 71, 2 },
+            { 1235, 73, 2 }, { 1612, 75, 2 }, { 1423, 77, 2 }, { 1300, 79, 1 }, { 1251, 80, 1 }, { 1499, 81, 1 },
+            { 1401, 82, 1 }, { 2025, 83, 1 }, { 1403, 84, 1 }, { 1251, 85, 1 }, { 1403, 86, 1 }, { 799, 87, 1 },
+            { 690, 88, 1 }, { 799, 89, 1 }, { 1716, 90, 1 }, { 1024, 91, 1 }, { 1024, 92, 1 }, { 1255, 93, 2 },
+            { 1300, 95, 2 }, { 1126, 97, 1 }, { 1300, 98, 2 }, { 1260, 100, 2 }, { 721, 102, 1 }, { 1300, 103, 2 },
+            { 1298, 105, 1 }, { 569, 106, 2 }, { 569, 108, 2 }, { 1186, 110, 1 }, { 569, 111, 1 }, { 1995, 112, 1 },
+            { 1298, 113, 1 }, { 1253, 114, 2 }, { 1300, 116, 2 }, { 1300, 118, 2 }, { 842, 120, 1 }, { 1067, 121, 1 },
+            { 803, 122, 1 }, { 1298, 123, 2 }, { 1212, 125, 1 }, { 1675, 126, 1 }, { 1212, 127, 1 }, { 1212, 128, 1 },
+            { 1075, 129, 1 }, { 1303, 130, 1 }, { 690, 131, 1 }, { 1303, 132, 1 }, { 1716, 133, 1 },
+        };
+
+        // 每个轮廓在 kPoints 中的结束点下标（不含）
+        constexpr uint16_t kContourEnds[] = {
+            4, 10, 14, 18, 22, 50, 84, 91, 98, 110, 122, 134, 138, 150, 160, 199,
+            203, 217, 231, 249, 261, 267, 271, 275, 279, 291, 303, 314, 343, 384, 387, 398,
+            428, 440, 465, 472, 484, 508, 520, 545, 557, 561, 565, 569, 575, 582, 586, 590,
+            597, 601, 634, 646, 711, 714, 722, 731, 740, 755, 781, 790, 799, 811, 821, 851,
+            863, 867, 879, 890, 896, 909, 919, 931, 943, 952, 963, 975, 993, 1013, 1022, 1062,
+            1070, 1088, 1095, 1108, 1120, 1129, 1139, 1147, 1151, 1159, 1166, 1170, 1174, 1185, 1212, 1224,
+            1241, 1267, 1284, 1296, 1317, 1324, 1344, 1356, 1385, 1405, 1409, 1413, 1425, 1429, 1440, 1444,
+            1479, 1499, 1511, 1523, 1540, 1552, 1564, 1581, 1599, 1639, 1659, 1679, 1680, 1687, 1700, 1712,
+            1728, 1738, 1775, 1779, 1816, 1846,
+        };
+
+        // 轮廓点：每点两个值 (x * 2 + 在曲线上标志, y)
+        constexpr int16_t kPoints[] = {
+            619, 254, 1025, 254, 1025, 0, 619, 0, 619, 1493, 1025, 1493, 1025, 838, 985, 481,
+            661, 481, 619, 838, 735, 1493, 735, 938, 395, 938, 395, 1493, 1491, 1493, 1491, 938,
+            1151, 938, 1151, 1493, 2095, 901, 1513, 901, 1345, 567, 1931, 567, 1795, 1470, 1587, 1055,
+            2171, 1055, 2381, 1470, 2701, 1470, 2495, 1055, 3119, 1055, 3119, 901, 2417, 901, 2253, 567,
+            2889, 567, 2889, 414, 2175, 414, 1967, 0, 1647, 0, 1853, 414, 1267, 414, 1061, 0,
+            739, 0, 947, 414, 317, 414, 317, 567, 1021, 567, 1189, 901, 545, 901, 545, 1055,
+            1267, 1055, 1471, 1470, 1385, -301, 1185, -301, 1183, 0, 972, 2, 552, 47, 341, 92,
+            341, 272, 544, 208, 962, 143, 1185, 142, 1185, 598, 742, 634, 340, 806, 341, 956,
+            340, 1119, 776, 1307, 1185, 1321, 1185, 1556, 1385, 1556, 1385, 1324, 1570, 1320, 1918, 1289,
+            2085, 1262, 2085, 1087, 1918, 1129, 1568, 1175, 1385, 1179, 1385, 752, 1838, 717, 2266, 537,
+            2267, 381, 2266, 212, 1812, 17, 1385, 2, 1185, 770, 1185, 1180, 952, 1167, 708, 1061,
+            709, 973, 708, 887, 934, 791, 1385, 578, 1385, 145, 1638, 162, 1896, 272, 1897, 362,
+            1896, 450, 1650, 554, 2979, 657, 2804, 657, 2606, 509, 2607, 377, 2606, 247, 2804, 98,
+            2979, 98, 3148, 98, 3346, 247, 3347, 377, 3346, 508, 3148, 657, 2979, 784, 3294, 784,
+            3666, 564, 3667, 377, 3666, 190, 3292, -29, 2979, -29, 2658, -29, 2286, 190, 2287, 377,
+            2286, 565, 2660, 784, 915, 1393, 742, 1393, 544, 1244, 545, 1114, 544, 982, 740, 834,
+            915, 834, 1088, 834, 1286, 982, 1287, 1114, 1286, 1243, 1086, 1393, 2721, 1520, 3041, 1520,
+            1173, -29, 853, -29, 915, 1520, 1230, 1520, 1606, 1301, 1607, 1114, 1606, 925, 1232, 707,
+            915, 707, 596, 707, 226, 926, 227, 1114, 226, 1300, 598, 1520, 997, 803, 814, 722,
+            644, 561, 645, 473, 644, 327, 1068, 133, 1389, 133, 1578, 133, 1910, 196, 2057, 260,
+            1279, 915, 2295, 395, 2412, 484, 2544, 687, 2557, 801, 2929, 801, 2904, 669, 2696, 411,
+            2511, 285, 3069, 0, 2565, 0, 2279, 147, 2070, 58, 1614, -29, 1353, -29, 870, -29,
+            258, 246, 259, 461, 258, 589, 526, 814, 795, 913, 698, 976, 598, 1101, 599, 1161,
+            598, 1323, 1042, 1520, 1411, 1520, 1576, 1520, 1906, 1484, 2077, 1448, 2077, 1266, 1902, 1313,
+            1586, 1362, 1451, 1362, 1240, 1362, 978, 1251, 979, 1163, 978, 1112, 1096, 1009, 735, 1493,
+            735, 938, 395, 938, 395, 1493, 1271, 1554, 1002, 1324, 742, 874, 743, 643, 742, 412,
+            1004, -41, 1271, -270, 951, -270, 650, -35, 352, 419, 353, 643, 352, 866, 648, 1318,
+            951, 1554, 329, 1554, 649, 1554, 948, 1318, 1246, 866, 1247, 643, 1246, 419, 948, -35,
+            649, -270, 329, -270, 594, -41, 856, 412, 857, 643, 856, 874, 594, 1324, 1927, 1247,
+            1209, 1053, 1927, 858, 1811, 760, 1139, 963, 1139, 586, 911, 586, 911, 963, 239, 760,
+            123, 858, 841, 1053, 123, 1247, 239, 1346, 911, 1143, 911, 1520, 1139, 1520, 1139, 1143,
+            1811, 1346, 1885, 1284, 1885, 727, 2999, 727, 2999, 557, 1885, 557, 1885, 0, 1549, 0,
+            1549, 557, 435, 557, 435, 727, 1549, 727, 1549, 1284, 481, 254, 903, 254, 903, 82,
+            575, -238, 317, -238, 481, 82, 201, 643, 1279, 643, 1279, 479, 201, 479, 439, 254,
+            861, 254, 861, 0, 439, 0, 1041, 1493, 1381, 1493, 341, -190, 1, -190, 1303, 1360,
+            990, 1360, 676, 1053, 677, 745, 676, 438, 990, 131, 1303, 131, 1616, 131, 1930, 438,
+            1931, 745, 1930, 1053, 1616, 1360, 1303, 1520, 1804, 1520, 2334, 1123, 2335, 745, 2334, 368,
+            1804, -29, 1303, -29, 800, -29, 270, 368, 271, 745, 270, 1123, 800, 1520, 509, 170,
+            1169, 170, 1169, 1309, 451, 1237, 451, 1421, 1165, 1493, 1569, 1493, 1569, 170, 2229, 170,
+            2229, 0, 509, 0, 787, 170, 2197, 170, 2197, 0, 301, 0, 301, 170, 530, 289,
+            1324, 690, 1427, 748, 1620, 857, 1774, 1008, 1775, 1081, 1774, 1200, 1440, 1350, 1173, 1350,
+            982, 1350, 560, 1284, 321, 1217, 321, 1421, 564, 1470, 988, 1520, 1165, 1520, 1628, 1520,
+            2180, 1288, 2181, 1094, 2180, 1002, 2042, 837, 1861, 725, 1810, 696, 1274, 419, 1663, 805,
+            1952, 774, 2278, 578, 2279, 434, 2278, 213, 1670, -29, 1111, -29, 922, -29, 524, 8,
+            313, 45, 313, 240, 480, 191, 880, 141, 1099, 141, 1478, 141, 1876, 291, 1877, 434,
+            1876, 566, 1506, 715, 1177, 715, 829, 715, 829, 881, 1193, 881, 1490, 881, 1806, 1000,
+            1807, 1112, 1806, 1227, 1480, 1350, 1177, 1350, 1010, 1350, 630, 1314, 403, 1276, 403, 1456,
+            632, 1488, 1034, 1520, 1213, 1520, 1672, 1520, 2208, 1311, 2209, 1133, 2208, 1009, 1924, 838,
+            1549, 1317, 529, 520, 1549, 520, 1443, 1493, 1951, 1493, 1951, 520, 2377, 520, 2377, 352,
+            1951, 352, 1951, 0, 1549, 0, 1549, 352, 201, 352, 201, 547, 443, 1493, 2029, 1493,
+            2029, 1323, 813, 1323, 813, 957, 900, 972, 1076, 987, 1165, 987, 1664, 987, 2248, 713,
+            2249, 479, 2248, 238, 1648, -29, 1103, -29, 914, -29, 524, 3, 317, 35, 317, 238,
+            496, 189, 880, 141, 1095, 141, 1440, 141, 1844, 323, 1845, 479, 1844, 635, 1440, 817,
+            1095, 817, 932, 817, 610, 781, 443, 743, 1353, 827, 1080, 827, 762, 641, 763, 479,
+            762, 318, 1080, 131, 1353, 131, 1624, 131, 1942, 318, 1943, 479, 1942, 641, 1624, 827,
+            2155, 1460, 2155, 1276, 2002, 1312, 1692, 1350, 1541, 1350, 1140, 1350, 718, 1080, 689, 807,
+            806, 894, 1162, 987, 1377, 987, 1826, 987, 2348, 714, 2349, 479, 2348, 249, 1804, -29,
+            1353, -29, 834, -29, 286, 368, 287, 745, 286, 1099, 958, 1520, 1525, 1520, 1676, 1520,
+            1986, 1490, 337, 1493, 2257, 1493, 2257, 1407, 1173, 0, 751, 0, 1771, 1323, 337, 1323,
+            1303, 709, 1014, 709, 684, 555, 685, 420, 684, 285, 1014, 131, 1303, 131, 1590, 131,
+            1922, 286, 1923, 420, 1922, 555, 1592, 709, 899, 795, 638, 827, 348, 1005, 349, 1133,
+            348, 1312, 858, 1520, 1303, 1520, 1748, 1520, 2256, 1312, 2257, 1133, 2256, 1005, 1966, 827,
+            1709, 795, 2000, 761, 2326, 563, 2327, 420, 2326, 203, 1796, -29, 1303, -29, 808, -29,
+            278, 203, 279, 420, 278, 563, 606, 761, 751, 1114, 750, 998, 1040, 868, 1303, 868,
+            1562, 868, 1856, 998, 1857, 1114, 1856, 1230, 1562, 1360, 1303, 1360, 1040, 1360, 750, 1230,
+            451, 31, 451, 215, 602, 179, 914, 141, 1065, 141, 1464, 141, 1886, 410, 1917, 684,
+            1800, 598, 1444, 506, 1229, 506, 780, 506, 258, 777, 259, 1012, 258, 1242, 802, 1520,
+            1255, 1520, 1772, 1520, 2318, 1123, 2319, 745, 2318, 392, 1648, -29, 1083, -29, 930, -29,
+            618, 1, 1255, 664, 1526, 664, 1844, 850, 1845, 1012, 1844, 1173, 1526, 1360, 1255, 1360,
+            982, 1360, 664, 1173, 665, 1012, 664, 850, 982, 664, 481, 254, 903, 254, 903, 0,
+            481, 0, 481, 1059, 903, 1059, 903, 805, 481, 805, 481, 1059, 903, 1059, 903, 805,
+            481, 805, 481, 254, 903, 254, 903, 82, 575, -238, 317, -238, 481, 82, 2999, 1008,
+            935, 641, 2999, 276, 2999, 94, 435, 559, 435, 725, 2999, 1190, 435, 930, 2999, 930,
+            2999, 762, 435, 762, 435, 522, 2999, 522, 2999, 352, 435, 352, 435, 1008, 435, 1190,
+            2999, 725, 2999, 559, 435, 94, 435, 276, 2495, 641, 783, 254, 1189, 254, 1189, 0,
+            783, 0, 1177, 401, 795, 401, 795, 555, 794, 656, 906, 786, 1087, 872, 1267, 961,
+            1380, 1014, 1482, 1108, 1483, 1157, 1482, 1246, 1220, 1356, 1005, 1356, 846, 1356, 488, 1286,
+            295, 1219, 295, 1407, 482, 1464, 868, 1520, 1075, 1520, 1442, 1520, 1888, 1326, 1889, 1167,
+            1888, 1091, 1744, 954, 1565, 868, 1389, 782, 1294, 735, 1216, 682, 1201, 657, 1188, 636,
+            1176, 576, 1177, 524, 1525, 537, 1524, 394, 1808, 231, 2057, 231, 2302, 231, 2584, 395,
+            2585, 537, 2584, 677, 2296, 842, 2053, 842, 1810, 842, 1524, 678, 2615, 238, 2494, 161,
+            2184, 88, 1979, 88, 1634, 88, 1204, 337, 1205, 537, 1204, 737, 1636, 987, 1979, 987,
+            2184, 987, 2496, 912, 2615, 836, 2615, 967, 2901, 967, 2901, 231, 3192, 253, 3522, 476,
+            3523, 653, 3522, 760, 3396, 948, 3269, 1028, 3060, 1159, 2462, 1298, 2111, 1298, 1864, 1298,
+            1412, 1233, 1221, 1169, 906, 1067, 552, 736, 553, 543, 552, 384, 782, 106, 1001, 0,
+            1210, -104, 1762, -213, 2077, -213, 2334, -213, 2832, -126, 3041, -45, 3221, -156, 2970, -253,
+            2380, -356, 2077, -356, 1706, -356, 1050, -225, 795, -100, 538, 25, 270, 354, 271, 543,
+            270, 725, 542, 1055, 795, 1180, 1052, 1307, 1728, 1442, 2107, 1442, 2530, 1442, 3256, 1268,
+            3503, 1108, 3652, 1010, 3810, 780, 3811, 657, 3810, 394, 3174, 90, 2615, 84, 1401, 1294,
+            853, 551, 1951, 551, 1173, 1493, 1631, 1493, 2769, 0, 2349, 0, 2077, 383, 731, 383,
+            459, 0, 33, 0, 807, 713, 807, 166, 1455, 166, 1780, 166, 2094, 301, 2095, 440,
+            2094, 580, 1780, 713, 1455, 713, 807, 1327, 807, 877, 1405, 877, 1700, 877, 1990, 988,
+            1991, 1102, 1990, 1215, 1700, 1327, 1405, 1327, 403, 1493, 1435, 1493, 1896, 1493, 2396, 1301,
+            2397, 1124, 2396, 987, 2140, 825, 1893, 805, 2190, 773, 2520, 570, 2521, 418, 2520, 218,
+            1976, 0, 1475, 0, 403, 0, 2639, 1378, 2639, 1165, 2434, 1260, 1972, 1354, 1713, 1354,
+            1200, 1354, 656, 1041, 657, 745, 656, 450, 1200, 137, 1713, 137, 1972, 137, 2434, 231,
+            2639, 326, 2639, 115, 2426, 43, 1952, -29, 1689, -29, 1010, -29, 230, 386, 231, 745,
+            230, 1105, 1010, 1520, 1689, 1520, 1956, 1520, 2430, 1449, 807, 1327, 807, 166, 1295, 166,
+            1912, 166, 2486, 446, 2487, 748, 2486, 1048, 1912, 1327, 1295, 1327, 403, 1493, 1233, 1493,
+            2100, 1493, 2912, 1132, 2913, 748, 2912, 362, 2096, 0, 1233, 0, 403, 0, 403, 1493,
+            2291, 1493, 2291, 1323, 807, 1323, 807, 881, 2229, 881, 2229, 711, 807, 711, 807, 170,
+            2327, 170, 2327, 0, 403, 0, 403, 1493, 2119, 1493, 2119, 1323, 807, 1323, 807, 883,
+            1991, 883, 1991, 713, 807, 713, 807, 0, 403, 0, 2439, 213, 2439, 614, 1779, 614,
+            1779, 780, 2839, 780, 2839, 139, 2604, 56, 2040, -29, 1721, -29, 1020, -29, 230, 380,
+            231, 745, 230, 1111, 1020, 1520, 1721, 1520, 2012, 1520, 2538, 1448, 2761, 1378, 2761, 1163,
+            2536, 1258, 2032, 1354, 1755, 1354, 1206, 1354, 656, 1048, 657, 745, 656, 443, 1206, 137,
+            1755, 137, 1968, 137, 2304, 174, 403, 1493, 807, 1493, 807, 881, 2275, 881, 2275, 1493,
+            2679, 1493, 2679, 0, 2275, 0, 2275, 711, 807, 711, 807, 0, 403, 0, 403, 1493,
+            807, 1493, 807, 0, 403, 0, 403, 1493, 807, 1493, 807, 104, 806, -166, 396, -410,
+            -57, -410, -211, -410, -211, -240, -85, -240, 182, -240, 402, -90, 403, 104, 403, 1493,
+            807, 1493, 807, 862, 2147, 1493, 2667, 1493, 1185, 797, 2773, 0, 2241, 0, 807, 719,
+            807, 0, 403, 0, 403, 1493, 807, 1493, 807, 170, 2261, 170, 2261, 0, 403, 0,
+            403, 1493, 1005, 1493, 1767, 477, 2533, 1493, 3135, 1493, 3135, 0, 2741, 0, 2741, 1311,
+            1971, 287, 1565, 287, 795, 1311, 795, 0, 403, 0, 403, 1493, 947, 1493, 2271, 244,
+            2271, 1493, 2663, 1493, 2663, 0, 2119, 0, 795, 1249, 795, 0, 403, 0, 1615, 1356,
+            1174, 1356, 656, 1028, 657, 745, 656, 463, 1174, 135, 1615, 135, 2054, 135, 2568, 463,
+            2569, 745, 2568, 1028, 2054, 1356, 1615, 1520, 2242, 1520, 2994, 1099, 2995, 745, 2994, 392,
+            2242, -29, 1615, -29, 984, -29, 230, 391, 231, 745, 230, 1099, 984, 1520, 807, 1327,
+            807, 766, 1315, 766, 1596, 766, 1904, 912, 1905, 1047, 1904, 1181, 1596, 1327, 1315, 1327,
+            403, 1493, 1315, 1493, 1816, 1493, 2330, 1266, 2331, 1047, 2330, 826, 1816, 600, 1315, 600,
+            807, 600, 807, 0, 403, 0, 1615, 1356, 1174, 1356, 656, 1028, 657, 745, 656, 463,
+            1174, 135, 1615, 135, 2054, 135, 2568, 463, 2569, 745, 2568, 1028, 2054, 1356, 2181, 27,
+            2713, -264, 2225, -264, 1783, -25, 1716, -27, 1646, -29, 1615, -29, 984, -29, 230, 392,
+            231, 745, 230, 1099, 984, 1520, 1615, 1520, 2242, 1520, 2994, 1099, 2995, 745, 2994, 485,
+            2576, 115, 1819, 700, 1948, 678, 2194, 534, 2319, 408, 2729, 0, 2295, 0, 1913, 383,
+            1764, 533, 1486, 631, 1247, 631, 807, 631, 807, 0, 403, 0, 403, 1493, 1315, 1493,
+            1826, 1493, 2330, 1279, 2331, 1063, 2330, 922, 2068, 736, 807, 1327, 807, 797, 1315, 797,
+            1606, 797, 1904, 932, 1905, 1063, 1904, 1194, 1606, 1327, 1315, 1327, 2193, 1444, 2193, 1247,
+            1962, 1302, 1554, 1356, 1365, 1356, 1034, 1356, 676, 1228, 677, 1110, 676, 1011, 914, 910,
+            1247, 879, 1491, 854, 1942, 811, 2372, 594, 2373, 412, 2372, 195, 1790, -29, 1229, -29,
+            1016, -29, 538, 19, 283, 66, 283, 274, 528, 205, 1000, 135, 1229, 135, 1574, 135,
+            1950, 271, 1951, 397, 1950, 507, 1680, 631, 1373, 662, 1127, 686, 674, 731, 270, 923,
+            271, 1094, 270, 1292, 828, 1520, 1319, 1520, 1528, 1520, 1964, 1482, -11, 1493, 2515, 1493,
+            2515, 1323, 1455, 1323, 1455, 0, 1049, 0, 1049, 1323, -11, 1323, 357, 1493, 763, 1493,
+            763, 586, 762, 346, 1110, 135, 1501, 135, 1888, 135, 2236, 346, 2237, 586, 2237, 1493,
+            2643, 1493, 2643, 561, 2642, 269, 2064, -29, 1501, -29, 934, -29, 356, 269, 357, 561,
+            1173, 0, 33, 1493, 455, 1493, 1401, 236, 2349, 1493, 2769, 1493, 1631, 0, 137, 1493,
+            545, 1493, 1173, 231, 1799, 1493, 2253, 1493, 2881, 231, 3507, 1493, 3917, 1493, 3167, 0,
+            2659, 0, 2029, 1296, 1393, 0, 885, 0, 259, 1493, 693, 1493, 1435, 938, 2181, 1493,
+            2615, 1493, 1655, 776, 2679, 0, 2245, 0, 1405, 635, 559, 0, 123, 0, 1189, 797,
+            -7, 1493, 427, 1493, 1255, 879, 2077, 1493, 2511, 1493, 1455, 711, 1455, 0, 1049, 0,
+            1049, 711, 231, 1493, 2577, 1493, 2577, 1339, 689, 170, 2623, 170, 2623, 0, 185, 0,
+            185, 154, 2073, 1323, 231, 1323, 353, 1556, 1201, 1556, 1201, 1413, 721, 1413, 721, -127,
+            1201, -127, 1201, -270, 353, -270, 341, 1493, 1381, -190, 1041, -190, 1, 1493, 1247, 1556,
+            1247, -270, 399, -270, 399, -127, 877, -127, 877, 1413, 399, 1413, 399, 1556, 1913, 1493,
+            2999, 936, 2597, 936, 1717, 1331, 837, 936, 435, 936, 1521, 1493, 2089, -340, 2089, -483,
+            -39, -483, -39, -340, 735, 1638, 1299, 1264, 993, 1264, 341, 1638, 1405, 563, 958, 563,
+            614, 461, 615, 338, 614, 240, 872, 125, 1095, 125, 1400, 125, 1770, 342, 1771, 522,
+            1771, 563, 2139, 639, 2139, 0, 1771, 0, 1771, 170, 1644, 68, 1268, -29, 997, -29,
+            652, -29, 246, 164, 247, 326, 246, 515, 752, 707, 1255, 707, 1771, 707, 1771, 725,
+            1770, 852, 1436, 991, 1135, 991, 942, 991, 578, 945, 411, 899, 411, 1069, 612, 1108,
+            992, 1147, 1173, 1147, 1658, 1147, 2138, 895, 1995, 559, 1994, 762, 1660, 993, 1369, 993,
+            1076, 993, 742, 762, 743, 559, 742, 356, 1076, 125, 1369, 125, 1660, 125, 1994, 356,
+            743, 950, 858, 1050, 1212, 1147, 1459, 1147, 1866, 1147, 2376, 823, 2377, 559, 2376, 295,
+            1866, -29, 1459, -29, 1212, -29, 858, 68, 743, 168, 743, 0, 373, 0, 373, 1556,
+            743, 1556, 1999, 1077, 1999, 905, 1842, 948, 1528, 991, 1369, 991, 1010, 991, 614, 764,
+            615, 559, 614, 354, 1010, 127, 1369, 127, 1528, 127, 1842, 170, 1999, 213, 1999, 43,
+            1844, 7, 1514, -29, 1329, -29, 822, -29, 226, 289, 227, 559, 226, 833, 828, 1147,
+            1353, 1147, 1522, 1147, 1846, 1112, 1861, 950, 1861, 1556, 2229, 1556, 2229, 0, 1861, 0,
+            1861, 168, 1744, 68, 1390, -29, 1143, -29, 736, -29, 226, 295, 227, 559, 226, 823,
+            736, 1147, 1143, 1147, 1390, 1147, 1744, 1050, 607, 559, 606, 356, 940, 125, 1233, 125,
+            1524, 125, 1860, 356, 1861, 559, 1860, 762, 1524, 993, 1233, 993, 940, 993, 606, 762,
+            2303, 606, 2303, 516, 611, 516, 634, 326, 1044, 127, 1411, 127, 1622, 127, 2020, 179,
+            2217, 231, 2217, 57, 2018, 15, 1602, -29, 1389, -29, 852, -29, 226, 283, 227, 549,
+            226, 824, 820, 1147, 1325, 1147, 1776, 1147, 2302, 856, 1935, 660, 1930, 811, 1600, 991,
+            1329, 991, 1020, 991, 650, 817, 623, 659, 1521, 1556, 1521, 1403, 1169, 1403, 970, 1403,
+            816, 1323, 817, 1219, 817, 1120, 1423, 1120, 1423, 977, 817, 977, 817, 0, 447, 0,
+            447, 977, 95, 977, 95, 1120, 447, 1120, 447, 1198, 446, 1385, 794, 1556, 1173, 1556,
+            1861, 573, 1860, 773, 1530, 993, 1233, 993, 936, 993, 606, 773, 607, 573, 606, 374,
+            936, 154, 1233, 154, 1530, 154, 1860, 374, 2229, 139, 2228, -147, 1720, -426, 1197, -426,
+            1002, -426, 658, -397, 497, -367, 497, -188, 658, -232, 974, -274, 1139, -274, 1500, -274,
+            1860, -85, 1861, 106, 1861, 197, 1746, 98, 1390, 0, 1143, 0, 730, 0, 226, 314,
+            227, 573, 226, 833, 730, 1147, 1143, 1147, 1390, 1147, 1746, 1049, 1861, 950, 1861, 1120,
+            2229, 1120, 2249, 676, 2249, 0, 1881, 0, 1881, 670, 1880, 829, 1632, 987, 1385, 987,
+            1086, 987, 742, 797, 743, 633, 743, 0, 373, 0, 373, 1556, 743, 1556, 743, 946,
+            874, 1047, 1232, 1147, 1467, 1147, 1852, 1147, 2248, 908, 387, 1120, 755, 1120, 755, 0,
+            387, 0, 387, 1556, 755, 1556, 755, 1323, 387, 1323, 387, 1120, 755, 1120, 755, -20,
+            754, -234, 428, -426, 67, -426, -73, -426, -73, -270, 25, -270, 234, -270, 386, -173,
+            387, -20, 387, 1556, 755, 1556, 755, 1323, 387, 1323, 373, 1556, 743, 1556, 743, 637,
+            1841, 1120, 2311, 1120, 1123, 596, 2361, 0, 1881, 0, 743, 547, 743, 0, 373, 0,
+            387, 1556, 755, 1556, 755, 0, 387, 0, 2131, 905, 2268, 1029, 2652, 1147, 2913, 1147,
+            3262, 1147, 3642, 902, 3643, 676, 3643, 0, 3273, 0, 3273, 670, 3272, 831, 3044, 987,
+            2811, 987, 2524, 987, 2192, 797, 2193, 633, 2193, 0, 1823, 0, 1823, 670, 1822, 832,
+            1594, 987, 1357, 987, 1074, 987, 742, 796, 743, 633, 743, 0, 373, 0, 373, 1120,
+            743, 1120, 743, 946, 868, 1049, 1220, 1147, 1463, 1147, 1706, 1147, 2048, 1023, 2249, 676,
+            2249, 0, 1881, 0, 1881, 670, 1880, 829, 1632, 987, 1385, 987, 1086, 987, 742, 797,
+            743, 633, 743, 0, 373, 0, 373, 1120, 743, 1120, 743, 946, 874, 1047, 1232, 1147,
+            1467, 1147, 1852, 1147, 2248, 908, 1255, 991, 958, 991, 614, 760, 615, 559, 614, 358,
+            956, 127, 1255, 127, 1548, 127, 1892, 359, 1893, 559, 1892, 758, 1548, 991, 1255, 1147,
+            1734, 1147, 2282, 835, 2283, 559, 2282, 284, 1734, -29, 1255, -29, 772, -29, 226, 284,
+            227, 559, 226, 835, 772, 1147, 743, 168, 743, -426, 373, -426, 373, 1120, 743, 1120,
+            743, 950, 858, 1050, 1212, 1147, 1459, 1147, 1866, 1147, 2376, 823, 2377, 559, 2376, 295,
+            1866, -29, 1459, -29, 1212, -29, 858, 68, 1995, 559, 1994, 762, 1660, 993, 1369, 993,
+            1076, 993, 742, 762, 743, 559, 742, 356, 1076, 125, 1369, 125, 1660, 125, 1994, 356,
+            607, 559, 606, 356, 940, 125, 1233, 125, 1524, 125, 1860, 356, 1861, 559, 1860, 762,
+            1524, 993, 1233, 993, 940, 993, 606, 762, 1861, 168, 1744, 68, 1390, -29, 1143, -29,
+            736, -29, 226, 295, 227, 559, 226, 823, 736, 1147, 1143, 1147, 1390, 1147, 1744, 1050,
+            1861, 950, 1861, 1120, 2229, 1120, 2229, -426, 1861, -426, 1685, 948, 1622, 966, 1476, 983,
+            1389, 983, 1076, 983, 742, 780, 743, 590, 743, 0, 373, 0, 373, 1120, 743, 1120,
+            743, 946, 858, 1048, 1230, 1147, 1497, 1147, 1534, 1147, 1626, 1142, 1683, 1137, 1815, 1087,
+            1815, 913, 1658, 953, 1322, 993, 1143, 993, 868, 993, 594, 909, 595, 825, 594, 761,
+            790, 688, 1087, 655, 1213, 641, 1604, 599, 1934, 446, 1935, 309, 1934, 153, 1440, -29,
+            1009, -29, 828, -29, 438, 6, 223, 41, 223, 231, 426, 178, 822, 125, 1017, 125,
+            1276, 125, 1556, 214, 1557, 295, 1556, 370, 1354, 450, 1013, 487, 885, 502, 542, 538,
+            238, 687, 239, 817, 238, 975, 686, 1147, 1099, 1147, 1302, 1147, 1662, 1117, 751, 1438,
+            751, 1120, 1509, 1120, 1509, 977, 751, 977, 751, 369, 750, 232, 900, 154, 1131, 154,
+            1509, 154, 1509, 0, 1131, 0, 704, 0, 380, 159, 381, 369, 381, 977, 111, 977,
+            111, 1120, 381, 1120, 381, 1438, 349, 442, 349, 1120, 717, 1120, 717, 449, 716, 290,
+            964, 131, 1213, 131, 1510, 131, 1856, 321, 1857, 485, 1857, 1120, 2225, 1120, 2225, 0,
+            1857, 0, 1857, 172, 1722, 70, 1368, -29, 1135, -29, 748, -29, 348, 211, 1275, 1147,
+            123, 1120, 513, 1120, 1213, 180, 1913, 1120, 2303, 1120, 1463, 0, 963, 0, 173, 1120,
+            541, 1120, 1001, 246, 1459, 1120, 1893, 1120, 2353, 246, 2811, 1120, 3179, 1120, 2593, 0,
+            2159, 0, 1677, 918, 1193, 0, 759, 0, 2249, 1120, 1439, 575, 2291, 0, 1857, 0,
+            1205, 440, 553, 0, 119, 0, 989, 586, 193, 1120, 627, 1120, 1221, 721, 1815, 1120,
+            1319, -104, 1162, -304, 866, -426, 619, -426, 325, -426, 325, -272, 541, -272, 692, -272,
+            860, -200, 963, -66, 1029, 18, 123, 1120, 513, 1120, 1213, 244, 1913, 1120, 2303, 1120,
+            227, 1120, 1975, 1120, 1975, 952, 591, 147, 1975, 147, 1975, 0, 177, 0, 177, 168,
+            1561, 973, 227, 973, 2095, -190, 2095, -334, 1971, -334, 1472, -334, 1134, -186, 1135, 35,
+            1135, 274, 1134, 425, 918, 541, 635, 541, 513, 541, 513, 684, 635, 684, 920, 684,
+            1134, 799, 1135, 948, 1135, 1188, 1134, 1409, 1472, 1556, 1971, 1556, 2095, 1556, 2095, 1413,
+            1959, 1413, 1676, 1413, 1504, 1325, 1505, 1184, 1505, 936, 1504, 779, 1322, 637, 1103, 612,
+            1324, 585, 1504, 443, 1505, 287, 1505, 39, 1504, -102, 1676, -190, 1959, -190, 861, 1565,
+            861, -483, 521, -483, 521, 1565, 513, -190, 653, -190, 932, -190, 1102, -104, 1103, 39,
+            1103, 287, 1102, 443, 1282, 585, 1505, 612, 1282, 637, 1102, 779, 1103, 936, 1103, 1184,
+            1102, 1326, 932, 1413, 653, 1413, 513, 1413, 513, 1556, 639, 1556, 1136, 1556, 1470, 1409,
+            1471, 1188, 1471, 948, 1470, 799, 1686, 684, 1971, 684, 2095, 684, 2095, 541, 1971, 541,
+            1686, 541, 1470, 425, 1471, 274, 1471, 35, 1470, -186, 1136, -334, 639, -334, 513, -334,
+            2999, 817, 2999, 639, 2788, 560, 2430, 492, 2237, 492, 2016, 492, 1725, 551, 1702, 555,
+            1693, 557, 1678, 560, 1649, 565, 1338, 627, 1151, 627, 974, 627, 630, 550, 435, 467,
+            435, 645, 644, 724, 1002, 793, 1197, 793, 1416, 793, 1711, 733, 1730, 729, 1741, 727,
+            1756, 724, 1785, 719, 2094, 657, 2283, 657, 2454, 657, 2792, 733,
+        };
+    }
+}
@@ -0,0 +1,231 @@
+#pragma once
+// OtterFrameScheduler.h
+// 动画帧调度：按目标帧率运行已请求的动画回调，帧时刻对齐到类似垂直同步的等间隔时钟，
+// 统计超出帧预算的帧与错过的同步点。没有动画时 TimeoutMicros() 返回 -1，消息循环可无限等待。
+// 时钟可替换（FakeFrameClock 用于测试）。不依赖Windows
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "OtterTrace.h"
+
+namespace OtterAnim {
+
+    // 单调时钟，单位微秒
+    class FrameClock {
+    public:
+        virtual ~FrameClock() = default;
+        virtual int64_t NowMicros() const = 0;
+    };
+
+    class SteadyFrameClock : public FrameClock {
+    public:
+        int64_t NowMicros() const override {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        static SteadyFrameClock& Instance() {
+            static SteadyFrameClock clock;
+            return clock;
+        }
+    };
+
+    // 手动推进的时钟：测试中在回调里 Advance 可模拟帧内耗时
+    class FakeFrameClock : public FrameClock {
+    public:
+        explicit FakeFrameClock(int64_t startMicros = 0) : m_now(startMicros) {}
+
+        int64_t NowMicros() const override { return m_now; }
+        void Set(int64_t micros) { m_now = micros; }
+        void Advance(int64_t micros) { m_now += micros; }
+
+    private:
+        int64_t m_now;
+    };
+
+    struct FrameInfo {
+        uint64_t frame = 0;             // 帧序号
+        int64_t timeUs = 0;             // 本帧对应的同步点时刻（动画应按此时刻取值，而非实际执行时刻）
+        int64_t deltaUs = 0;            // 与上一帧同步点的间隔；动画从空闲开始的第一帧为一个帧间隔
+        int missedVblanks = 0;          // 与上一帧之间错过的同步点数（上一帧超时造成的掉帧）
+    };
+
+    struct FrameStats {
+        size_t frames = 0;
+        size_t overruns = 0;            // 回调与绘制总耗时超过一个帧间隔的帧数
+        size_t missedVblanks = 0;
+        size_t idleStarts = 0;          // 从空闲恢复动画的次数
+        int64_t lastWorkUs = 0;
+        int64_t worstWorkUs = 0;
+        int64_t totalWorkUs = 0;
+
+        double AverageWorkUs() const { return frames ? double(totalWorkUs) / frames : 0.0; }
+        double OverrunRate() const { return frames ? double(overruns) / frames : 0.0; }
+    };
+
+    class FrameScheduler {
+    public:
+        // 返回 false 表示动画结束，不再调用
+        using Callback = std::function<bool(const FrameInfo&)>;
+        using Id = uint64_t;
+
+        explicit FrameScheduler(const FrameClock& clock = SteadyFrameClock::Instance(), double framesPerSecond = 60.0)
+            : m_clock(&clock) {
+            SetTargetRate(framesPerSecond);
+        }
+
+        // 目标帧率（1~1000）
+        void SetTargetRate(double framesPerSecond) {
+            framesPerSecond = (std::min)((std::max)(framesPerSecond, 1.0), 1000.0);
+            m_interval = (std::max)(int64_t(1), static_cast<int64_t>(1e6 / framesPerSecond + 0.5));
+        }
+
+        double TargetRate() const { return 1e6 / double(m_interval); }
+        int64_t IntervalMicros() const { return m_interval; }
+
+        // 同步点相位：同步点为 vblankUs + k * 帧间隔（如显示器最近一次垂直同步的时刻）
+        void SetPhase(int64_t vblankUs) { m_phase = vblankUs; }
+
+        // 请求动画回调，每帧调用一次直到返回 false 或被 Cancel
+        Id Request(Callback callback) {
+            if (!callback) return 0;
+            WakeFromIdle();
+            const Id id = ++m_nextId;
+            m_callbacks.push_back(Entry{ id, std::move(callback) });
+            return id;
+        }
+
+        bool Cancel(Id id) {
+            for (Entry& e : m_callbacks) {
+                if (e.id == id && e.callback) {
+                    e.callback = nullptr;   // 在 Tick 结束时移除，允许在回调中取消
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void CancelAll() {
+            for (Entry& e : m_callbacks) e.callback = nullptr;
+            m_frameRequested = false;
+        }
+
+        // 只请求一帧（不注册回调），如数据变化后需要重绘一次
+        void RequestFrame() {
+            WakeFromIdle();
+            m_frameRequested = true;
+        }
+
+        // 每帧在动画回调之后调用（如同步绘制窗口），耗时计入帧预算
+        void SetFrameHandler(std::function<void(const FrameInfo&)> handler) { m_onFrame = std::move(handler); }
+
+        bool IsAnimating() const {
+            for (const Entry& e : m_callbacks) {
+                if (e.callback) return true;
+            }
+            return false;
+        }
+
+        bool Idle() const { return !m_frameRequested && !IsAnimating(); }
+
+        // 下一帧应运行的时刻；空闲时为 -1
+        int64_t NextFrameTime() const {
+            if (Idle()) return -1;
+            if (!m_continuous) return m_wakeTime;       // 从空闲恢复：立即运行
+            return m_lastVblank + m_interval;
+        }
+
+        // 距下一帧的等待时间（微秒）：0 为已到期，-1 为空闲（可无限等待消息）
+        int64_t TimeoutMicros() const {
+            const int64_t next = NextFrameTime();
+            if (next < 0) return -1;
+            return (std::max)(int64_t(0), next - m_clock->NowMicros());
+        }
+
+        // 到期时运行一帧并返回 true；未到期或空闲时返回 false
+        bool Tick() {
+            if (Idle()) return false;
+            const int64_t now = m_clock->NowMicros();
+            if (now < NextFrameTime()) return false;
+
+            OTTER_TRACE_SCOPE("anim", "Tick");
+            FrameInfo info;
+            info.frame = m_frame++;
+            info.timeUs = AlignDown(now);
+            if (m_continuous) {
+                info.deltaUs = info.timeUs - m_lastVblank;
+                info.missedVblanks = static_cast<int>((std::max)(int64_t(0), info.deltaUs / m_interval - 1));
+            }
+            else {
+                info.deltaUs = m_interval;
+                ++m_stats.idleStarts;
+            }
+            m_frameRequested = false;
+
+            // 回调中新请求的动画从下一帧开始
+            const size_t count = m_callbacks.size();
+            for (size_t i = 0; i < count; ++i) {
+                if (!m_callbacks[i].callback) continue;
+                Callback callback = m_callbacks[i].callback;     // 回调中可能 Request 导致容器重新分配
+                if (!callback(info)) m_callbacks[i].callback = nullptr;
+            }
+            m_callbacks.erase(std::remove_if(m_callbacks.begin(), m_callbacks.end(),
+                [](const Entry& e) { return !e.callback; }), m_callbacks.end());
+            if (m_onFrame) m_onFrame(info);
+
+            const int64_t work = m_clock->NowMicros() - now;
+            ++m_stats.frames;
+            m_stats.lastWorkUs = work;
+            m_stats.totalWorkUs += work;
+            m_stats.worstWorkUs = (std::max)(m_stats.worstWorkUs, work);
+            if (work > m_interval) {
+                ++m_stats.overruns;
+                OTTER_TRACE_INSTANT("anim", "Overrun");
+            }
+            m_stats.missedVblanks += size_t(info.missedVblanks);
+
+            m_lastVblank = info.timeUs;
+            m_continuous = !Idle();
+            return true;
+        }
+
+        const FrameStats& GetStats() const { return m_stats; }
+        void ResetStats() { m_stats = FrameStats(); }
+
+    private:
+        struct Entry {
+            Id id;
+            Callback callback;
+        };
+
+        // 不大于 t 的最近同步点
+        int64_t AlignDown(int64_t t) const {
+            int64_t k = (t - m_phase) / m_interval;
+            if ((t - m_phase) % m_interval < 0) --k;
+            return m_phase + k * m_interval;
+        }
+
+        void WakeFromIdle() {
+            if (Idle()) {
+                m_continuous = false;
+                m_wakeTime = m_clock->NowMicros();
+            }
+        }
+
+        const FrameClock* m_clock;
+        int64_t m_interval = 16667;
+        int64_t m_phase = 0;
+        std::vector<Entry> m_callbacks;
+        std::function<void(const FrameInfo&)> m_onFrame;
+        Id m_nextId = 0;
+        uint64_t m_frame = 0;
+        bool m_frameRequested = false;
+        bool m_continuous = false;      // 上一帧之后仍有动画，下一帧对齐到上一帧的下一个同步点
+        int64_t m_lastVblank = 0;
+        int64_t m_wakeTime = 0;
+        FrameStats m_stats;
+    };
+}
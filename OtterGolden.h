@@ -0,0 +1,533 @@
+#pragma once
+// OtterGolden.h
+// 无头黄金图像测试与图元吞吐量基准：按固定场景（形状、多边形、文字、缩放与不透明图片、平铺、渐变、浮点路径、描边、分块光栅化）
+// 在 Canvas 上绘制，与目录中的黄金PNG按容差逐像素比较（失败时写出实际图与差异图）；
+// 各图元的每秒次数与百万像素/秒输出为JSON，可与基准文件比较发现性能回退。
+// OtterPaintbrush 与 OtterImageRenderer 的软件后端即此 Canvas，可在Linux下运行。不依赖Windows
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "OtterRaster.h"
+#include "OtterBlit.h"
+#include "OtterGradient.h"
+#include "OtterMip.h"
+#include "OtterTiles.h"
+#include "OtterJson.h"
+#include "OtterPng.h"
+
+namespace OtterRaster {
+    namespace Golden {
+
+        struct Scene {
+            const char* name;
+            int width, height;
+            void (*draw)(Canvas& canvas);
+        };
+
+        // 场景共用的测试图片：渐变、棋盘格与半透明边缘，尺寸为 size×size
+        inline void MakeTestImage(Surface& out, int size = 128) {
+            out.Allocate(size, size);
+            for (int y = 0; y < size; ++y) {
+                uint32_t* row = out.Row(y);
+                for (int x = 0; x < size; ++x) {
+                    const bool check = ((x / 16) + (y / 16)) % 2 == 0;
+                    const int edge = (std::min)((std::min)(x, y), (std::min)(size - 1 - x, size - 1 - y));
+                    const uint8_t a = uint8_t(edge >= 8 ? 255 : 64 + edge * 24);
+                    const uint8_t r = uint8_t(x * 255 / (size - 1));
+                    const uint8_t g = uint8_t(y * 255 / (size - 1));
+                    row[x] = Premultiply(Color(a, r, g, uint8_t(check ? 220 : 40)));
+                }
+            }
+        }
+
+        namespace Scenes {
+
+            inline void Shapes(Canvas& c) {
+                c.Clear(Color(255, 255, 255, 255));
+                for (int i = 0; i < 8; ++i) {
+                    c.FillRectangle(10 + i * 38, 10, 30, 30, Color(uint8_t(80 + i * 25), uint8_t(i * 32), 90, uint8_t(255 - i * 30)));
+                    c.DrawRectangle(10 + i * 38, 50, 30, 20, Color(255, 20, 20, 20), 1.0f + i * 0.5f);
+                }
+                for (int i = 0; i < 6; ++i) {
+                    c.FillCircle(30 + i * 50, 110, 8 + i * 3, Color(200, 220, 60, uint8_t(40 * i)));
+                    c.DrawCircle(30 + i * 50, 170, 6 + i * 3, Color(255, 30, 90, 200), 1.0f + i * 0.75f);
+                }
+                for (int i = 0; i < 24; ++i) {
+                    const float angle = i * 3.14159265f / 24.0f;
+                    c.DrawLine(160.0f, 290.0f, 160.0f + 110.0f * std::cos(angle), 290.0f - 90.0f * std::sin(angle),
+                        Color(255, 0, 0, 0), 0.75f + (i % 4) * 0.5f);
+                }
+                c.SetAntiAlias(false);
+                for (int i = 0; i < 8; ++i) c.DrawLine(12, 300 + i * 2, 100, 220 + i * 9, Color(255, 200, 30, 30));
+                c.SetAntiAlias(true);
+            }
+
+            inline void Polygons(Canvas& c) {
+                c.Clear(Color(255, 250, 250, 250));
+                auto star = [](float cx, float cy, float outer, float inner, int points) {
+                    std::vector<PointF> pts;
+                    for (int i = 0; i < points * 2; ++i) {
+                        const float r = (i % 2) ? inner : outer;
+                        const float a = i * 3.14159265f / points - 1.5707963f;
+                        pts.push_back(PointF(cx + r * std::cos(a), cy + r * std::sin(a)));
+                    }
+                    return pts;
+                };
+                // 五角星按顶点隔一连接：非零与奇偶规则的中心区域不同
+                std::vector<PointF> pentagram;
+                for (int i = 0; i < 5; ++i) {
+                    const float a = (i * 2 % 5) * 2.0f * 3.14159265f / 5 - 1.5707963f;
+                    pentagram.push_back(PointF(80 + 60 * std::cos(a), 80 + 60 * std::sin(a)));
+                }
+                c.FillPolygon(pentagram, Color(255, 40, 120, 200), FillRule::NonZero);
+                for (PointF& p : pentagram) p.X += 140;
+                c.FillPolygon(pentagram, Color(255, 200, 80, 40), FillRule::EvenOdd);
+                c.FillPolygon(star(80, 230, 60, 25, 7), Color(180, 20, 160, 90));
+                c.DrawPolygon(star(220, 230, 60, 30, 9), Color(255, 0, 0, 0), 1.5f);
+                const Point concave[] = { {20, 320}, {120, 300}, {70, 340}, {130, 380}, {30, 390} };
+                c.FillPolygon(concave, 5, Color(220, 120, 40, 180));
+                c.SetAntiAlias(false);
+                c.FillPolygon(star(230, 350, 40, 18, 5), Color(255, 90, 90, 90));
+                c.SetAntiAlias(true);
+                for (int i = 0; i < 40; ++i) {     // 亚像素小三角形
+                    const float x = 10.0f + i * 7.3f, y = 395.0f + (i % 3) * 0.33f;
+                    const PointF tri[] = { {x, y}, {x + 4.5f, y + 1.2f}, {x + 1.7f, y + 3.9f} };
+                    c.FillPolygon(tri, 3, Color(255, 0, 0, 0));
+                }
+            }
+
+            inline void Text(Canvas& c) {
+                c.Clear(Color(255, 255, 255, 255));
+                const float sizes[] = { 8.0f, 9.0f, 10.5f, 12.0f, 16.0f, 24.0f, 36.0f };
+                float y = 6.0f;
+                for (float size : sizes) {
+                    c.DrawString(L"OtterGUI 0123456789 %+-.,:", 8.0f, y, size, Color(255, 20, 20, 20));
+                    y += size * 1.5f;
+                }
+                for (int i = 0; i < 4; ++i) {      // 亚像素起点
+                    c.DrawString(L"Subpixel AVWT", 8.0f + i * 0.25f, y + i * 14.0f, 10.0f, Color(255, 0, 0, 0));
+                }
+                c.FillRectangle(0, 260, 320, 60, Color(255, 30, 40, 60));
+                c.DrawString(L"Light on dark 42%", 10.0f, 268.0f, 14.0f, Color(255, 240, 240, 240));
+                c.DrawString(L"Translucent", 10.0f, 290.0f, 14.0f, Color(128, 255, 200, 0));
+            }
+
+            inline void Images(Canvas& c) {
+                c.Clear(Color(255, 236, 236, 236));
+                Surface image;
+                MakeTestImage(image, 128);
+                Blit::DrawSurface(c, image, 8, 8, 1.0f, Blit::BlendMode::Copy);          // 不透明复制
+                Blit::DrawSurface(c, image, 144, 8, 1.0f);                               // 带透明边缘混合
+                Blit::DrawSurface(c, image, 280, 8, 0.5f);                               // 整体半透明
+                Blit::DrawSurface(c, image, Rect(32, 32, 64, 64), 8, 144, 1.0f);        // 子矩形
+
+                ScaledImageCache scaled;
+                const Surface& down = scaled.Get(image, 47, 47);                         // 缩小（经 mip 级）
+                Blit::DrawSurface(c, down, 88, 144, 1.0f);
+                const Surface& up = scaled.Get(image, 300, 180);                         // 放大
+                Blit::DrawSurface(c, up, 144, 144, 1.0f);
+                Blit::FillPattern(c, image, Rect(8, 336, 440, 110), 0.8f);               // 平铺
+            }
+
+            inline void Clipped(Canvas& c) {
+                c.Clear(Color(255, 255, 255, 255));
+                const Rect rects[] = { Rect(10, 10, 120, 80), Rect(150, 40, 60, 150), Rect(40, 120, 90, 60) };
+                c.SetClipRects(rects, 3);
+                for (int i = 0; i < 12; ++i) c.FillCircle(20 + i * 18, 20 + i * 14, 30, Color(160, uint8_t(i * 20), 80, 200));
+                c.DrawString(L"clipped text clipped text", 0.0f, 60.0f, 16.0f, Color(255, 0, 0, 0));
+                c.ResetClipRects();
+                c.SetOrigin(120, 140);
+                c.SetClip(Rect(120, 140, 100, 80));
+                c.FillRectangle(-20, -20, 200, 200, Color(120, 0, 150, 0));
+                c.DrawLine(0, 0, 100, 80, Color(255, 0, 0, 0), 3.0f);
+                c.SetOrigin(0, 0);
+                c.ResetClip();
+            }
+
+            inline void Gradients(Canvas& c) {
+                c.Clear(Color(255, 255, 255, 255));
+                const std::vector<GradientStop> stops = { {0.0f, Color(255, 220, 40, 40)}, {0.5f, Color(128, 40, 200, 60)},
+                    {1.0f, Color(255, 40, 60, 220)} };
+                c.FillRectangle(8, 8, 150, 70, GradientPaint::Linear(PointF(8, 8), PointF(158, 8), stops));
+                c.FillRectangle(166, 8, 150, 70, GradientPaint::Linear(PointF(166, 8), PointF(196, 38), stops, GradientSpread::Reflect));
+                c.FillRectangle(8, 86, 308, 10, GradientPaint::Linear(PointF(8, 0), PointF(316, 0), Color(0, 0, 0, 0), Color(255, 0, 0, 0)));
+                c.FillCircle(70, 160, 55, GradientPaint::Radial(PointF(55, 145), 70, Color(255, 255, 255, 255), Color(255, 20, 80, 160)));
+                const PointF tri[] = { {150, 110}, {310, 125}, {200, 230} };
+                c.FillPolygon(tri, 3, GradientPaint::Radial(PointF(220, 160), 18, stops, GradientSpread::Repeat));
+                const std::vector<GradientStop> hard = { {0.0f, Color(255, 0, 0, 0)}, {0.5f, Color(255, 0, 0, 0)},
+                    {0.5f, Color(255, 250, 200, 0)}, {1.0f, Color(255, 250, 200, 0)} };
+                c.FillRectangle(8, 240, 308, 30, GradientPaint::Linear(PointF(8, 0), PointF(48, 0), hard, GradientSpread::Repeat));
+            }
+
+            // 浮点路径：二次/三次曲线、两种填充规则、子路径、折线描边
+            inline void Paths(Canvas& c) {
+                c.Clear(Color(255, 255, 255, 255));
+                Path blob;
+                blob.MoveTo(20.3f, 20.7f);
+                blob.QuadTo(80.0f, 0.0f, 140.5f, 60.25f);
+                blob.CubicTo(160.0f, 120.0f, 40.0f, 160.0f, 20.0f, 100.0f);
+                blob.Close();
+                c.FillPath(blob, Color(255, 30, 120, 220));
+                Path rings;
+                rings.AddEllipse(230.5f, 70.0f, 70.0f, 45.0f);
+                rings.AddEllipse(230.5f, 70.0f, 35.0f, 22.5f);
+                c.FillPath(rings, Color(255, 220, 60, 40), FillRule::EvenOdd);
+                Path star;
+                for (int i = 0; i < 5; ++i) {
+                    const float a = -1.5707963f + i * 2.5132741f;
+                    const float x = 80.0f + 60.0f * std::cos(a), y = 210.0f + 60.0f * std::sin(a);
+                    if (i == 0) star.MoveTo(x, y);
+                    else star.LineTo(x, y);
+                }
+                star.Close();
+                c.FillPath(star, Color(200, 60, 160, 40), FillRule::NonZero);
+                Path wave;
+                for (int i = 0; i <= 120; ++i) {
+                    const float x = 160.0f + i * 1.25f, y = 220.0f - 40.0f * std::sin(i * 0.15f) + 0.37f;
+                    if (i == 0) wave.MoveTo(x, y);
+                    else wave.LineTo(x, y);
+                }
+                c.StrokePath(wave, Color(255, 0, 0, 0), 1.5f);
+            }
+
+            // 描边：三种拐角与线帽、虚线（含零长度圆点与闭合折线首尾相连）、半透明自相交折线只混合一次
+            inline void Strokes(Canvas& c) {
+                c.Clear(Color(255, 255, 255, 255));
+                const LineJoin joins[3] = { LineJoin::Miter, LineJoin::Bevel, LineJoin::Round };
+                const LineCap caps[3] = { LineCap::Flat, LineCap::Square, LineCap::Round };
+                for (int i = 0; i < 3; ++i) {
+                    const float x = 20.0f + i * 100.0f;
+                    const PointF zig[] = { {x, 70}, {x + 20, 20}, {x + 45, 70}, {x + 75, 30} };
+                    c.DrawPolyline(zig, 4, Color(255, 40, 90, 180), StrokeStyle(10.0f, joins[i], caps[i]));
+                    c.DrawPolyline(zig, 4, Color(255, 255, 255, 255), StrokeStyle(1.0f));
+                }
+                StrokeStyle dash(3.0f);
+                dash.dashes = { 12.0f, 6.0f };
+                c.DrawRectangle(20, 100, 130, 60, Color(255, 200, 60, 40), dash);
+                StrokeStyle dots(6.0f, LineJoin::Round, LineCap::Round);
+                dots.dashes = { 0.0f, 12.0f };
+                c.DrawLine(170.0f, 110.0f, 300.0f, 150.0f, Color(255, 30, 140, 60), dots);
+                StrokeStyle ring(4.0f);
+                ring.dashes = { 14.0f, 5.0f, 3.0f, 5.0f };
+                ring.dashOffset = 7.0f;
+                c.DrawCircle(80, 225, 40, Color(255, 120, 40, 160), ring);
+                const PointF knot[] = { {170, 190}, {300, 260}, {300, 190}, {170, 260}, {235, 180} };
+                c.DrawPolyline(knot, 5, Color(140, 0, 0, 0), StrokeStyle(8.0f, LineJoin::Round, LineCap::Round));
+            }
+
+            // 分块并行光栅化：仪表盘显示列表，多线程回放
+            inline void Tiles(Canvas& c) {
+                Surface* surface = c.GetSurface();
+                DisplayList list;
+                RecordDashboard(list, surface->Width(), surface->Height(), 12);
+                TileRenderer tiles(4, 64);
+                tiles.Render(list, c);
+            }
+        }
+
+        inline const std::vector<Scene>& AllScenes() {
+            static const std::vector<Scene> scenes = {
+                { "shapes", 320, 320, Scenes::Shapes },
+                { "polygons", 320, 410, Scenes::Polygons },
+                { "text", 320, 320, Scenes::Text },
+                { "images", 460, 456, Scenes::Images },
+                { "clipped", 256, 256, Scenes::Clipped },
+                { "gradients", 320, 280, Scenes::Gradients },
+                { "paths", 320, 280, Scenes::Paths },
+                { "strokes", 320, 280, Scenes::Strokes },
+                { "tiles", 480, 360, Scenes::Tiles },
+            };
+            return scenes;
+        }
+
+        inline void RenderScene(const Scene& scene, Surface& out) {
+            out.Allocate(scene.width, scene.height);
+            Canvas canvas(&out);
+            scene.draw(canvas);
+        }
+
+        // 差异图：超出容差的像素按差值深浅标红，其余为淡化的期望图
+        inline void DiffImage(const Surface& expected, const Surface& actual, int tolerance, Surface& out) {
+            const int w = (std::min)(expected.Width(), actual.Width()), h = (std::min)(expected.Height(), actual.Height());
+            out.Allocate((std::max)(w, 1), (std::max)(h, 1));
+            for (int y = 0; y < h; ++y) {
+                const uint32_t* re = expected.Row(y);
+                const uint32_t* ra = actual.Row(y);
+                uint32_t* ro = out.Row(y);
+                for (int x = 0; x < w; ++x) {
+                    int worst = 0;
+                    for (int s = 0; s < 32; s += 8) {
+                        worst = (std::max)(worst, std::abs(int((re[x] >> s) & 0xFF) - int((ra[x] >> s) & 0xFF)));
+                    }
+                    if (worst > tolerance) {
+                        ro[x] = Premultiply(Color(255, uint8_t(128 + worst / 2), 0, 0));
+                        continue;
+                    }
+                    const Color e = Unpremultiply(re[x]);
+                    const int luma = (e.r * 77 + e.g * 150 + e.b * 29) >> 8;
+                    const uint8_t faded = uint8_t(192 + luma / 4);
+                    ro[x] = Premultiply(Color(faded, faded, faded));
+                }
+            }
+        }
+
+        enum class Mode {
+            Compare,        // 与黄金图比较，缺少黄金图视为失败
+            Record,         // 重新生成黄金图
+        };
+
+        struct Options {
+            std::string directory = "golden";
+            int tolerance = 2;              // 每通道允许的差值（不同编译器的浮点结果、SIMD档位）
+            long long maxMismatched = 0;    // 允许超出容差的像素数
+            Mode mode = Mode::Compare;
+            bool writeFailures = true;      // 失败时写出 <场景>.actual.png 与 <场景>.diff.png
+            std::string failureDirectory;   // 失败图写入的目录，为空时写入 directory
+        };
+
+        struct Result {
+            std::string scene;
+            bool passed = false;
+            bool missing = false;           // 没有黄金图（或无法解码）
+            bool recorded = false;
+            CompareResult compare;
+            double renderMs = 0;
+        };
+
+        inline std::vector<Result> RunSuite(const Options& options = Options()) {
+            using Clock = std::chrono::steady_clock;
+            std::vector<Result> results;
+            for (const Scene& scene : AllScenes()) {
+                Result r;
+                r.scene = scene.name;
+                Surface actual;
+                const auto t0 = Clock::now();
+                RenderScene(scene, actual);
+                r.renderMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+                const std::string base = options.directory + "/" + scene.name;
+                if (options.mode == Mode::Record) {
+                    r.recorded = Png::Save(base + ".png", actual);
+                    r.passed = r.recorded;
+                    results.push_back(r);
+                    continue;
+                }
+                Surface expected;
+                if (!Png::Load(base + ".png", expected)) {
+                    r.missing = true;
+                    r.compare.sameSize = false;
+                }
+                else {
+                    r.compare = CompareSurfaces(expected, actual, options.tolerance);
+                    r.passed = r.compare.sameSize && r.compare.mismatched <= options.maxMismatched;
+                }
+                if (!r.passed && options.writeFailures) {
+                    const std::string out = (options.failureDirectory.empty() ? options.directory : options.failureDirectory)
+                        + "/" + scene.name;
+                    Png::Save(out + ".actual.png", actual);
+                    if (r.compare.sameSize) {
+                        Surface diff;
+                        DiffImage(expected, actual, options.tolerance, diff);
+                        Png::Save(out + ".diff.png", diff);
+                    }
+                }
+                results.push_back(r);
+            }
+            return results;
+        }
+
+        inline bool AllPassed(const std::vector<Result>& results) {
+            for (const Result& r : results) {
+                if (!r.passed) return false;
+            }
+            return !results.empty();
+        }
+
+        inline std::string ReportJson(const std::vector<Result>& results) {
+            std::string json;
+            OtterJson::Writer w(json);
+            w.BeginObject();
+            w.Key("passed").Bool(AllPassed(results));
+            w.Key("scenes").BeginArray();
+            for (const Result& r : results) {
+                w.BeginObject();
+                w.Key("name").String(r.scene);
+                w.Key("passed").Bool(r.passed);
+                w.Key("missing").Bool(r.missing);
+                w.Key("recorded").Bool(r.recorded);
+                w.Key("mismatched").Int(r.compare.mismatched);
+                w.Key("maxDelta").Int(r.compare.maxDelta);
+                w.Key("renderMs").Number(r.renderMs);
+                w.EndObject();
+            }
+            w.EndArray();
+            w.EndObject();
+            return json;
+        }
+
+        // 单个图元的吞吐量；像素数按图元大致覆盖的面积计
+        struct Throughput {
+            std::string name;
+            long long ops = 0;
+            double seconds = 0;
+            double opsPerSec = 0;
+            double mpixPerSec = 0;
+        };
+
+        // 每个图元重复绘制至少 secondsPerPrimitive 秒
+        inline std::vector<Throughput> BenchmarkThroughput(int width = 1280, int height = 720, double secondsPerPrimitive = 0.2) {
+            using Clock = std::chrono::steady_clock;
+            Surface surface(width, height);
+            Canvas canvas(&surface);
+            Surface image;
+            MakeTestImage(image, 128);
+            Surface big;
+            MakeTestImage(big, 256);
+            Surface scaledOut(200, 150);
+            ScaledImageCache scaledCache;
+            DisplayList dashboard;
+            RecordDashboard(dashboard, width, height, 48);
+            TileRenderer tiles(0);
+
+            std::vector<PointF> star;
+            for (int i = 0; i < 10; ++i) {
+                const float r = (i % 2) ? 9.0f : 20.0f, a = i * 3.14159265f / 5;
+                star.push_back(PointF(r * std::cos(a), r * std::sin(a)));
+            }
+            std::vector<PointF> moved(star.size());
+
+            std::vector<Throughput> results;
+            auto px = [&](long long i, int margin) { return int((i * 7919) % (std::max)(width - margin, 1)); };
+            auto py = [&](long long i, int margin) { return int((i * 104729) % (std::max)(height - margin, 1)); };
+            auto run = [&](const char* name, double pixelsPerOp, int batch, auto&& draw) {
+                canvas.Clear(Color(255, 255, 255, 255));
+                long long ops = 0;
+                double sec = 0;
+                const auto t0 = Clock::now();
+                do {
+                    for (int i = 0; i < batch; ++i, ++ops) draw(ops);
+                    sec = std::chrono::duration<double>(Clock::now() - t0).count();
+                } while (sec < secondsPerPrimitive);
+                Throughput t;
+                t.name = name;
+                t.ops = ops;
+                t.seconds = sec;
+                t.opsPerSec = sec > 0 ? ops / sec : 0.0;
+                t.mpixPerSec = t.opsPerSec * pixelsPerOp / 1e6;
+                results.push_back(t);
+            };
+
+            run("fill_rect_small", 24.0 * 16, 1000, [&](long long i) {
+                canvas.FillRectangle(px(i, 24), py(i, 16), 24, 16, Color(200, 30, 120, 220)); });
+            run("fill_rect_large", 320.0 * 200, 20, [&](long long i) {
+                canvas.FillRectangle(px(i, 320), py(i, 200), 320, 200, Color(120, 30, 120, 220)); });
+            run("fill_rect_opaque", 320.0 * 200, 20, [&](long long i) {
+                canvas.FillRectangle(px(i, 320), py(i, 200), 320, 200, Color(255, 30, 120, 220)); });
+            run("draw_rect", 2.0 * (64 + 48), 500, [&](long long i) {
+                canvas.DrawRectangle(px(i, 64), py(i, 48), 64, 48, Color(255, 0, 0, 0)); });
+            run("fill_circle", 3.14159265 * 12 * 12, 500, [&](long long i) {
+                canvas.FillCircle(px(i, 30) + 12, py(i, 30) + 12, 12, Color(180, 220, 60, 40)); });
+            run("draw_line", 43.0 * 1.5, 500, [&](long long i) {
+                canvas.DrawLine(float(px(i, 40)), float(py(i, 20)), float(px(i, 40) + 40), float(py(i, 20) + 16), Color(255, 0, 0, 0), 1.5f); });
+            run("fill_polygon_star", 700.0, 500, [&](long long i) {
+                const float x = float(px(i, 40) + 20), y = float(py(i, 40) + 20);
+                for (size_t k = 0; k < star.size(); ++k) moved[k] = PointF(star[k].X + x, star[k].Y + y);
+                canvas.FillPolygon(moved, Color(160, 20, 200, 90)); });
+            run("draw_string", 7.0 * 5 * 9, 500, [&](long long i) {
+                canvas.DrawString(L"CPU 42%", float(px(i, 60)), float(py(i, 12)), 9.0f, Color(255, 0, 0, 0)); });
+            run("image_opaque", 128.0 * 128, 100, [&](long long i) {
+                Blit::DrawSurface(canvas, image, px(i, 128), py(i, 128), 1.0f, Blit::BlendMode::Copy); });
+            run("image_blend", 128.0 * 128, 100, [&](long long i) {
+                Blit::DrawSurface(canvas, image, px(i, 128), py(i, 128), 0.6f); });
+            run("image_scaled", 200.0 * 150, 20, [&](long long i) {
+                Resample::Bilinear(big, big.Bounds(), scaledOut);
+                Blit::DrawSurface(canvas, scaledOut, px(i, 200), py(i, 150), 1.0f); });
+            run("image_scaled_cached", 200.0 * 150, 20, [&](long long i) {
+                Blit::DrawSurface(canvas, scaledCache.Get(big, 200, 150), px(i, 200), py(i, 150), 1.0f); });
+            run("image_pattern", 512.0 * 256, 10, [&](long long i) {
+                Blit::FillPattern(canvas, image, Rect(px(i, 512), py(i, 256), 512, 256), 1.0f); });
+            const GradientPaint linear = GradientPaint::Linear(PointF(0, 0), PointF(320, 200), Color(255, 30, 60, 120), Color(255, 250, 180, 60));
+            const GradientPaint radial = GradientPaint::Radial(PointF(160, 100), 120, Color(255, 255, 255, 255), Color(160, 20, 80, 160));
+            run("gradient_linear", 320.0 * 200, 20, [&](long long i) {
+                canvas.FillRectangle(px(i, 320), py(i, 200), 320, 200, linear); });
+            run("gradient_radial", 320.0 * 200, 20, [&](long long i) {
+                canvas.FillRectangle(px(i, 320), py(i, 200), 320, 200, radial); });
+            Path blob;
+            blob.MoveTo(0.0f, 20.0f);
+            blob.QuadTo(20.0f, -10.0f, 40.0f, 20.0f);
+            blob.CubicTo(50.0f, 40.0f, 10.0f, 50.0f, 0.0f, 20.0f);
+            blob.Close();
+            run("fill_path_curves", 900.0, 500, [&](long long i) {
+                canvas.SetOrigin(px(i, 50), py(i, 50));
+                canvas.FillPath(blob, Color(160, 20, 200, 90));
+                canvas.SetOrigin(0, 0); });
+            // 静态宽线：坐标不变（平移用原点），描边几何命中缓存
+            run("stroke_polygon_wide", 4.0 * 130, 500, [&](long long i) {
+                canvas.SetOrigin(px(i, 40) + 20, py(i, 40) + 20);
+                canvas.DrawPolygon(star, Color(255, 0, 0, 0), 3.0f);
+                canvas.SetOrigin(0, 0); });
+            StrokeStyle dashed(2.0f);
+            dashed.dashes = { 6.0f, 3.0f };
+            run("stroke_rect_dashed", 2.0 * 2 * (120 + 80) * 2 / 3, 200, [&](long long i) {
+                canvas.DrawRectangle(px(i, 120), py(i, 80), 120, 80, Color(255, 0, 0, 0), dashed); });
+            run("dashboard_replay", double(width) * height, 1, [&](long long) { dashboard.Replay(canvas); });
+            run("dashboard_tiled", double(width) * height, 1, [&](long long) { tiles.Render(dashboard, canvas); });
+            return results;
+        }
+
+        inline std::string ThroughputJson(const std::vector<Throughput>& results) {
+            std::string json;
+            OtterJson::Writer w(json);
+            w.BeginObject();
+            w.Key("format").String("otter-throughput");
+            w.Key("version").Int(1);
+            w.Key("isa").String(Blit::IsaName(Blit::CurrentIsa()));
+            w.Key("results").BeginArray();
+            for (const Throughput& t : results) {
+                w.BeginObject();
+                w.Key("name").String(t.name);
+                w.Key("ops").Int(t.ops);
+                w.Key("seconds").Number(t.seconds);
+                w.Key("opsPerSec").Number(t.opsPerSec);
+                w.Key("mpixPerSec").Number(t.mpixPerSec);
+                w.EndObject();
+            }
+            w.EndArray();
+            w.EndObject();
+            return json;
+        }
+
+        struct ThroughputDelta {
+            std::string name;
+            double baselineOpsPerSec = 0;
+            double currentOpsPerSec = 0;
+            double ratio = 0;               // 当前/基准
+            bool regressed = false;         // 下降超过 maxDrop
+        };
+
+        // 与基准JSON（ThroughputJson 的输出）逐项比较；基准中没有的图元不比较。基准无法解析时返回 false
+        inline bool CompareThroughput(const std::string& baselineJson, const std::vector<Throughput>& current,
+            double maxDrop, std::vector<ThroughputDelta>& out) {
+            out.clear();
+            OtterJson::Document doc;
+            if (doc.Parse(baselineJson) != OtterJson::ParseStatus::Ok) return false;
+            const OtterJson::Value list = doc.Root()["results"];
+            if (!list.IsArray()) return false;
+            for (const Throughput& t : current) {
+                for (OtterJson::Value entry : list.Elements()) {
+                    if (entry["name"].GetString() != t.name) continue;
+                    ThroughputDelta d;
+                    d.name = t.name;
+                    d.baselineOpsPerSec = entry["opsPerSec"].GetDouble();
+                    d.currentOpsPerSec = t.opsPerSec;
+                    d.ratio = d.baselineOpsPerSec > 0 ? t.opsPerSec / d.baselineOpsPerSec : 0.0;
+                    d.regressed = d.baselineOpsPerSec > 0 && d.ratio < 1.0 - maxDrop;
+                    out.push_back(d);
+                    break;
+                }
+            }
+            return true;
+        }
+    }
+}
@@ -0,0 +1,297 @@
+#pragma once
+// OtterGradient.h
+// 渐变填充：线性/径向、多个色标，超出范围时按 Pad/Repeat/Reflect 处理。每组色标只生成一次256项预乘颜色查找表
+// （按色标内容缓存，相同色标的画刷共享同一张表），逐行着色时用SSE2一次计算4个像素的渐变位置再查表。
+// GradientPaint 为值类型，可直接传给 Canvas 的 FillRectangle/FillCircle/FillPolygon。不依赖Windows
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "OtterRaster.h"
+#include "OtterLruCache.h"
+
+namespace OtterRaster {
+
+    struct GradientStop {
+        float offset = 0.0f;            // 0~1
+        Color color;
+
+        GradientStop() = default;
+        GradientStop(float offset_, Color color_) : offset(offset_), color(color_) {}
+    };
+
+    enum class GradientSpread {
+        Pad,            // 两端颜色延伸
+        Repeat,         // 重复
+        Reflect,        // 往返重复
+    };
+
+    // 色标插值为256项预乘颜色；在预乘空间插值，渐变到透明时不会出现暗边
+    class GradientLut {
+    public:
+        static constexpr int kSize = 256;
+
+        // stops 须已按 offset 排序且不为空
+        explicit GradientLut(const std::vector<GradientStop>& stops) {
+            size_t k = 0;
+            m_opaque = true;
+            for (int i = 0; i < kSize; ++i) {
+                const float t = float(i) / (kSize - 1);
+                while (k + 1 < stops.size() && stops[k + 1].offset < t) ++k;
+                const GradientStop& a = stops[k];
+                const GradientStop& b = stops[(std::min)(k + 1, stops.size() - 1)];
+                const float span = b.offset - a.offset;
+                float f = span > 0.0f ? (t - a.offset) / span : (t < a.offset ? 0.0f : 1.0f);
+                f = (std::min)((std::max)(f, 0.0f), 1.0f);
+                m_colors[i] = Lerp(Premultiply(a.color), Premultiply(b.color), f);
+                m_opaque &= (m_colors[i] >> 24) == 255;
+            }
+        }
+
+        const uint32_t* Data() const { return m_colors; }
+        uint32_t At(int index) const { return m_colors[index]; }
+        bool IsOpaque() const { return m_opaque; }
+
+    private:
+        static uint32_t Lerp(uint32_t a, uint32_t b, float f) {
+            uint32_t out = 0;
+            for (int s = 0; s < 32; s += 8) {
+                const float ca = float((a >> s) & 0xFF), cb = float((b >> s) & 0xFF);
+                out |= uint32_t(ca + (cb - ca) * f + 0.5f) << s;
+            }
+            return out;
+        }
+
+        uint32_t m_colors[kSize];
+        bool m_opaque = true;
+    };
+
+    // 按色标内容缓存查找表。非线程安全：每个线程使用 ForThread() 的实例或自行持有；
+    // 取得的查找表不可变，可跨线程使用
+    class GradientLutCache {
+    public:
+        static constexpr size_t kDefaultCapacity = 64;
+
+        explicit GradientLutCache(size_t capacity = kDefaultCapacity) : m_cache(capacity) {}
+
+        // stops 须已规范化（见 GradientPaint::Normalize）
+        std::shared_ptr<const GradientLut> Get(const std::vector<GradientStop>& stops) {
+            std::string key(stops.size() * 8, '\0');
+            for (size_t i = 0; i < stops.size(); ++i) {
+                std::memcpy(&key[i * 8], &stops[i].offset, 4);
+                key[i * 8 + 4] = char(stops[i].color.a);
+                key[i * 8 + 5] = char(stops[i].color.r);
+                key[i * 8 + 6] = char(stops[i].color.g);
+                key[i * 8 + 7] = char(stops[i].color.b);
+            }
+            return *m_cache.Get(key, [&] { return std::make_shared<const GradientLut>(stops); });
+        }
+
+        OtterCache::CacheStats GetStats() const { return m_cache.Stats(); }
+        void SetCapacity(size_t capacity) { m_cache.SetCapacity(capacity); }
+        void Clear() { m_cache.Clear(); }
+
+        static GradientLutCache& ForThread() {
+            static thread_local GradientLutCache cache;
+            return cache;
+        }
+
+    private:
+        OtterCache::LruCache<std::string, std::shared_ptr<const GradientLut>> m_cache;
+    };
+
+    // 渐变画刷：坐标为画布坐标（与图元相同，受画布原点影响）。复制只增加查找表引用计数
+    class GradientPaint : public Shader {
+    public:
+        enum class Kind { Linear, Radial };
+
+        GradientPaint() : GradientPaint(Kind::Linear, GradientSpread::Pad, {}) {}
+
+        // 线性渐变：start 处为 offset 0，end 处为 offset 1，等值线垂直于 start→end
+        static GradientPaint Linear(PointF start, PointF end, std::vector<GradientStop> stops,
+            GradientSpread spread = GradientSpread::Pad) {
+            GradientPaint paint(Kind::Linear, spread, std::move(stops));
+            const float dx = end.X - start.X, dy = end.Y - start.Y, len2 = dx * dx + dy * dy;
+            paint.m_x = start.X;
+            paint.m_y = start.Y;
+            paint.m_gx = len2 > 0.0f ? dx / len2 : 0.0f;
+            paint.m_gy = len2 > 0.0f ? dy / len2 : 0.0f;
+            return paint;
+        }
+
+        static GradientPaint Linear(PointF start, PointF end, Color from, Color to,
+            GradientSpread spread = GradientSpread::Pad) {
+            return Linear(start, end, { GradientStop(0.0f, from), GradientStop(1.0f, to) }, spread);
+        }
+
+        // 径向渐变：圆心为 offset 0，半径处为 offset 1
+        static GradientPaint Radial(PointF center, float radius, std::vector<GradientStop> stops,
+            GradientSpread spread = GradientSpread::Pad) {
+            GradientPaint paint(Kind::Radial, spread, std::move(stops));
+            paint.m_x = center.X;
+            paint.m_y = center.Y;
+            paint.m_gx = radius > 0.0f ? 1.0f / radius : 0.0f;
+            return paint;
+        }
+
+        static GradientPaint Radial(PointF center, float radius, Color inner, Color outer,
+            GradientSpread spread = GradientSpread::Pad) {
+            return Radial(center, radius, { GradientStop(0.0f, inner), GradientStop(1.0f, outer) }, spread);
+        }
+
+        Kind GetKind() const { return m_kind; }
+        GradientSpread GetSpread() const { return m_spread; }
+        const std::shared_ptr<const GradientLut>& GetLut() const { return m_lut; }
+
+        bool IsOpaque() const override { return m_lut->IsOpaque(); }
+
+        // 每个像素的渐变位置都由其绝对坐标算出，结果与行从哪里开始、分几段着色无关（SSE2与标量逐位一致）
+        void ShadeRow(int x, int y, int count, uint32_t* out) const override {
+            const uint32_t* lut = m_lut->Data();
+            const float py = y + 0.5f - m_y;
+            const float ty = py * m_gy, py2 = py * py;
+            int i = 0;
+#if OTTER_HAS_SSE2
+            const __m128i lane = _mm_add_epi32(_mm_set1_epi32(x), _mm_setr_epi32(0, 1, 2, 3));
+            const __m128 half = _mm_set1_ps(0.5f), origin = _mm_set1_ps(m_x), scale = _mm_set1_ps(m_gx);
+            alignas(16) int32_t index[4];
+            if (m_kind == Kind::Linear) {
+                const __m128 t0 = _mm_set1_ps(ty);
+                for (; i + 4 <= count; i += 4) {
+                    const __m128 px = _mm_sub_ps(_mm_add_ps(_mm_cvtepi32_ps(_mm_add_epi32(lane, _mm_set1_epi32(i))), half), origin);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(index), ToIndex(_mm_add_ps(_mm_mul_ps(px, scale), t0)));
+                    out[i] = lut[index[0]]; out[i + 1] = lut[index[1]]; out[i + 2] = lut[index[2]]; out[i + 3] = lut[index[3]];
+                }
+            }
+            else {
+                const __m128 dy2 = _mm_set1_ps(py2);
+                for (; i + 4 <= count; i += 4) {
+                    const __m128 px = _mm_sub_ps(_mm_add_ps(_mm_cvtepi32_ps(_mm_add_epi32(lane, _mm_set1_epi32(i))), half), origin);
+                    const __m128 d = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(px, px), dy2));
+                    _mm_store_si128(reinterpret_cast<__m128i*>(index), ToIndex(_mm_mul_ps(d, scale)));
+                    out[i] = lut[index[0]]; out[i + 1] = lut[index[1]]; out[i + 2] = lut[index[2]]; out[i + 3] = lut[index[3]];
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                const float px = float(x + i) + 0.5f - m_x;
+                const float t = m_kind == Kind::Linear ? px * m_gx + ty : std::sqrt(px * px + py2) * m_gx;
+                out[i] = lut[ToIndex(t)];
+            }
+        }
+
+        // 色标按 offset 排序（相同 offset 保持原顺序，可做硬分界）并限制在 0~1；空色标为透明
+        static std::vector<GradientStop> Normalize(std::vector<GradientStop> stops) {
+            if (stops.empty()) stops.push_back(GradientStop(0.0f, Color(0, 0, 0, 0)));
+            for (GradientStop& s : stops) s.offset = (std::min)((std::max)(s.offset, 0.0f), 1.0f);
+            std::stable_sort(stops.begin(), stops.end(),
+                [](const GradientStop& a, const GradientStop& b) { return a.offset < b.offset; });
+            return stops;
+        }
+
+    private:
+        GradientPaint(Kind kind, GradientSpread spread, std::vector<GradientStop> stops)
+            : m_kind(kind), m_spread(spread), m_lut(GradientLutCache::ForThread().Get(Normalize(std::move(stops)))) {}
+
+        int ToIndex(float t) const {
+            t = (std::min)((std::max)(t, -1e6f), 1e6f);
+            if (m_spread == GradientSpread::Repeat) t -= std::floor(t);
+            else if (m_spread == GradientSpread::Reflect) {
+                float u = t * 0.5f;
+                u -= std::floor(u);
+                t = 1.0f - std::fabs(2.0f * u - 1.0f);
+            }
+            t = (std::min)((std::max)(t, 0.0f), 1.0f);
+            return int(std::lrint(t * (GradientLut::kSize - 1)));
+        }
+
+#if OTTER_HAS_SSE2
+        static __m128 Floor(__m128 t) {
+            const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(t));
+            return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, t), _mm_set1_ps(1.0f)));
+        }
+
+        __m128i ToIndex(__m128 t) const {
+            t = _mm_min_ps(_mm_max_ps(t, _mm_set1_ps(-1e6f)), _mm_set1_ps(1e6f));
+            if (m_spread == GradientSpread::Repeat) t = _mm_sub_ps(t, Floor(t));
+            else if (m_spread == GradientSpread::Reflect) {
+                __m128 u = _mm_mul_ps(t, _mm_set1_ps(0.5f));
+                u = _mm_sub_ps(u, Floor(u));
+                const __m128 v = _mm_sub_ps(_mm_add_ps(u, u), _mm_set1_ps(1.0f));
+                const __m128 absV = _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+                t = _mm_sub_ps(_mm_set1_ps(1.0f), absV);
+            }
+            t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+            return _mm_cvtps_epi32(_mm_mul_ps(t, _mm_set1_ps(float(GradientLut::kSize - 1))));
+        }
+#endif
+
+        Kind m_kind;
+        GradientSpread m_spread;
+        float m_x = 0, m_y = 0;         // 线性：起点；径向：圆心
+        float m_gx = 0, m_gy = 0;       // 线性：方向/长度²；径向：1/半径
+        std::shared_ptr<const GradientLut> m_lut;
+    };
+
+    // 渐变填充吞吐量（百万像素/秒）：查表着色与逐像素插值色标的对比
+    struct GradientBenchmark {
+        double linearMPixPerSec = 0;
+        double radialMPixPerSec = 0;
+        double perPixelMPixPerSec = 0;  // 不用查找表，逐像素查找色标并插值
+        double createPerSec = 0;        // 每帧重新创建画刷（查找表命中缓存）
+    };
+
+    inline GradientBenchmark BenchmarkGradients(int width = 1280, int height = 720, int frames = 20) {
+        using Clock = std::chrono::steady_clock;
+        Surface surface(width, height);
+        Canvas canvas(&surface);
+        const std::vector<GradientStop> stops = { {0.0f, Color(255, 30, 60, 120)}, {0.4f, Color(255, 80, 160, 220)},
+            {0.7f, Color(200, 240, 240, 250)}, {1.0f, Color(255, 250, 180, 60)} };
+        const double mpix = double(width) * height * frames / 1e6;
+        auto run = [&](auto&& draw) {
+            const auto t0 = Clock::now();
+            for (int f = 0; f < frames; ++f) draw(f);
+            const double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+            return sec > 0 ? mpix / sec : 0.0;
+        };
+
+        GradientBenchmark bench;
+        const GradientPaint linear = GradientPaint::Linear(PointF(0, 0), PointF(float(width), float(height)), stops);
+        const GradientPaint radial = GradientPaint::Radial(PointF(width * 0.5f, height * 0.5f), height * 0.6f, stops, GradientSpread::Reflect);
+        bench.linearMPixPerSec = run([&](int) { canvas.FillRectangle(0, 0, width, height, linear); });
+        bench.radialMPixPerSec = run([&](int) { canvas.FillRectangle(0, 0, width, height, radial); });
+
+        const float gx = float(width) / (float(width) * width + float(height) * height);
+        const float gy = float(height) / (float(width) * width + float(height) * height);
+        bench.perPixelMPixPerSec = run([&](int) {
+            for (int y = 0; y < height; ++y) {
+                uint32_t* row = surface.Row(y);
+                for (int x = 0; x < width; ++x) {
+                    const float t = (std::min)((std::max)((x + 0.5f) * gx + (y + 0.5f) * gy, 0.0f), 1.0f);
+                    size_t k = 0;
+                    while (k + 2 < stops.size() && stops[k + 1].offset < t) ++k;
+                    const float f = (t - stops[k].offset) / (stops[k + 1].offset - stops[k].offset);
+                    const Color& a = stops[k].color;
+                    const Color& b = stops[k + 1].color;
+                    const Color c(uint8_t(a.a + (b.a - a.a) * f), uint8_t(a.r + (b.r - a.r) * f),
+                        uint8_t(a.g + (b.g - a.g) * f), uint8_t(a.b + (b.b - a.b) * f));
+                    row[x] = Span::OverPixel(row[x], Premultiply(c));
+                }
+            }
+        });
+
+        const int creates = 100000;
+        const auto t0 = Clock::now();
+        float sink = 0;
+        for (int i = 0; i < creates; ++i) {
+            const GradientPaint p = GradientPaint::Linear(PointF(0, float(i)), PointF(100, float(i)), stops);
+            sink += p.IsOpaque() ? 1.0f : 0.0f;
+        }
+        const double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        bench.createPerSec = sec > 0 && sink >= 0 ? creates / sec : 0.0;
+        return bench;
+    }
+}
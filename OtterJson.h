@@ -0,0 +1,694 @@
+#pragma once
+// OtterJson.h
+// 网络层JSON：基于扁平token表的按需读取器（string_view访问原始缓冲区）与直接写入响应缓冲区的写入器
+// Document/Writer 可跨消息复用，预热后不再分配内存
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "OtterSimd.h"
+
+namespace OtterJson {
+
+    enum class Type : uint8_t { Null, False, True, Number, String, Array, Object };
+
+    enum class ParseStatus : uint8_t {
+        Ok = 0,
+        Empty,
+        UnexpectedCharacter,
+        UnterminatedString,
+        InvalidString,
+        InvalidNumber,
+        InvalidLiteral,
+        DepthExceeded,
+        TrailingCharacters,
+        TooLarge,
+    };
+
+    // token表项：容器的 end 指向其后第一个token，便于跳过整个子树
+    struct Token {
+        Type type;
+        uint8_t escaped;    // 字符串含转义
+        uint32_t offset;    // 字符串为引号后的位置
+        uint32_t length;
+        uint32_t end;
+    };
+
+    class Document;
+    class ArrayIterator;
+    class MemberIterator;
+    template <typename It> struct Range;
+
+    // 查找下一个引号、反斜杠或控制字符的位置（SSE2 每次16字节），没有则返回 n
+    inline size_t FindSpecial(const char* base, size_t p, size_t n) {
+#if OTTER_HAS_SSE2
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i slash = _mm_set1_epi8('\\');
+        const __m128i ctrl = _mm_set1_epi8(0x1F);
+        while (p + 16 <= n) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + p));
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash));
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+            if (mask) return p + OtterSimd::CountTrailingZeros(mask);
+            p += 16;
+        }
+#endif
+        while (p < n) {
+            unsigned char c = static_cast<unsigned char>(base[p]);
+            if (c == '"' || c == '\\' || c < 0x20) return p;
+            ++p;
+        }
+        return n;
+    }
+
+    // 将JSON字符串的原始内容（不含引号）反转义追加到 out，失败返回 false
+    inline bool Unescape(std::string_view raw, std::string& out) {
+        auto hex = [](char c) -> int {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        };
+        auto read4 = [&](size_t i, uint32_t& cp) -> bool {
+            if (i + 4 > raw.size()) return false;
+            cp = 0;
+            for (size_t k = 0; k < 4; ++k) {
+                int h = hex(raw[i + k]);
+                if (h < 0) return false;
+                cp = (cp << 4) | static_cast<uint32_t>(h);
+            }
+            return true;
+        };
+
+        for (size_t i = 0; i < raw.size(); ++i) {
+            char c = raw[i];
+            if (c != '\\') { out.push_back(c); continue; }
+            if (++i >= raw.size()) return false;
+            switch (raw[i]) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                uint32_t cp;
+                if (!read4(i + 1, cp)) return false;
+                i += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    uint32_t lo;
+                    if (i + 2 >= raw.size() || raw[i + 1] != '\\' || raw[i + 2] != 'u' || !read4(i + 3, lo)) return false;
+                    if (lo < 0xDC00 || lo > 0xDFFF) return false;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    i += 6;
+                }
+                if (cp < 0x80) {
+                    out.push_back(static_cast<char>(cp));
+                }
+                else if (cp < 0x800) {
+                    out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                }
+                else if (cp < 0x10000) {
+                    out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                }
+                else {
+                    out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                }
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 按需访问的值视图，生命周期不超过 Document 及其缓冲区
+    class Value {
+    public:
+        Value() = default;
+        Value(const Document* doc, uint32_t index) : m_doc(doc), m_index(index) {}
+
+        bool Valid() const { return m_doc != nullptr; }
+        explicit operator bool() const { return Valid(); }
+
+        Type GetType() const;
+        bool IsNull() const { return Valid() && GetType() == Type::Null; }
+        bool IsBool() const { return Valid() && (GetType() == Type::True || GetType() == Type::False); }
+        bool IsNumber() const { return Valid() && GetType() == Type::Number; }
+        bool IsString() const { return Valid() && GetType() == Type::String; }
+        bool IsArray() const { return Valid() && GetType() == Type::Array; }
+        bool IsObject() const { return Valid() && GetType() == Type::Object; }
+
+        // 原始文本：字符串不含引号且保留转义，数字为原文
+        std::string_view Raw() const;
+        bool HasEscapes() const;
+
+        // 字符串不含转义时直接返回缓冲区视图，否则返回 false
+        bool GetStringView(std::string_view& out) const {
+            if (!IsString() || HasEscapes()) return false;
+            out = Raw();
+            return true;
+        }
+
+        // 反转义后的字符串（有分配）
+        std::string GetString(std::string_view def = {}) const {
+            if (!IsString()) return std::string(def);
+            std::string out;
+            if (!Unescape(Raw(), out)) return std::string(def);
+            return out;
+        }
+
+        double GetDouble(double def = 0.0) const {
+            if (!IsNumber()) return def;
+            std::string_view r = Raw();
+            double v = def;
+            auto res = std::from_chars(r.data(), r.data() + r.size(), v);
+            return res.ec == std::errc() ? v : def;
+        }
+
+        int64_t GetInt64(int64_t def = 0) const {
+            if (!IsNumber()) return def;
+            std::string_view r = Raw();
+            int64_t v = def;
+            auto res = std::from_chars(r.data(), r.data() + r.size(), v);
+            if (res.ec == std::errc() && res.ptr == r.data() + r.size()) return v;
+            return static_cast<int64_t>(GetDouble(static_cast<double>(def)));
+        }
+
+        bool GetBool(bool def = false) const {
+            if (!IsBool()) return def;
+            return GetType() == Type::True;
+        }
+
+        // 数组元素个数或对象成员个数
+        size_t Size() const;
+
+        // 对象成员查找（线性），不存在返回无效值
+        Value operator[](std::string_view key) const;
+        Value operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+        // 数组下标访问
+        Value operator[](size_t index) const;
+        Value operator[](int index) const { return (*this)[static_cast<size_t>(index)]; }
+
+        Range<ArrayIterator> Elements() const;
+        Range<MemberIterator> Members() const;
+
+    private:
+        const Document* m_doc = nullptr;
+        uint32_t m_index = 0;
+    };
+
+    // 数组元素遍历
+    class ArrayIterator {
+    public:
+        ArrayIterator(const Document* doc, uint32_t index) : m_doc(doc), m_index(index) {}
+        Value operator*() const { return Value(m_doc, m_index); }
+        ArrayIterator& operator++();
+        bool operator!=(const ArrayIterator& o) const { return m_index != o.m_index; }
+    private:
+        const Document* m_doc;
+        uint32_t m_index;
+    };
+
+    // 对象成员遍历：key 为键，value 为值
+    struct Member {
+        Value key;
+        Value value;
+    };
+    class MemberIterator {
+    public:
+        MemberIterator(const Document* doc, uint32_t index) : m_doc(doc), m_index(index) {}
+        Member operator*() const { return { Value(m_doc, m_index), Value(m_doc, m_index + 1) }; }
+        MemberIterator& operator++();
+        bool operator!=(const MemberIterator& o) const { return m_index != o.m_index; }
+    private:
+        const Document* m_doc;
+        uint32_t m_index;
+    };
+
+    template <typename It>
+    struct Range {
+        It b, e;
+        It begin() const { return b; }
+        It end() const { return e; }
+    };
+
+    // 解析文档：只记录token位置，不复制字符串
+    class Document {
+    public:
+        static constexpr int kMaxDepth = 512;
+
+        ParseStatus Parse(std::string_view json) {
+            m_tokens.clear();
+            m_json = json;
+            m_pos = 0;
+            m_errorOffset = 0;
+            if (json.size() >= 0xFFFFFFFFu) return Fail(ParseStatus::TooLarge);
+
+            SkipWhitespace();
+            if (m_pos >= m_json.size()) return Fail(ParseStatus::Empty);
+            ParseStatus st = ParseValue(0);
+            if (st != ParseStatus::Ok) return st;
+            SkipWhitespace();
+            if (m_pos != m_json.size()) return Fail(ParseStatus::TrailingCharacters);
+            return ParseStatus::Ok;
+        }
+
+        Value Root() const { return m_tokens.empty() ? Value() : Value(this, 0); }
+        size_t ErrorOffset() const { return m_errorOffset; }
+        size_t TokenCount() const { return m_tokens.size(); }
+        std::string_view Source() const { return m_json; }
+
+        const Token& TokenAt(uint32_t i) const { return m_tokens[i]; }
+
+    private:
+        ParseStatus Fail(ParseStatus st) {
+            m_errorOffset = m_pos;
+            return st;
+        }
+
+        void SkipWhitespace() {
+            while (m_pos < m_json.size()) {
+                char c = m_json[m_pos];
+                if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+                ++m_pos;
+            }
+        }
+
+        uint32_t Push(Type type, size_t offset, size_t length) {
+            m_tokens.push_back({ type, 0, static_cast<uint32_t>(offset), static_cast<uint32_t>(length), 0 });
+            return static_cast<uint32_t>(m_tokens.size() - 1);
+        }
+
+        ParseStatus ParseValue(int depth) {
+            if (m_pos >= m_json.size()) return Fail(ParseStatus::UnexpectedCharacter);
+            char c = m_json[m_pos];
+            switch (c) {
+            case '{': return ParseObject(depth + 1);
+            case '[': return ParseArray(depth + 1);
+            case '"': return ParseString();
+            case 't': return ParseLiteral("true", Type::True);
+            case 'f': return ParseLiteral("false", Type::False);
+            case 'n': return ParseLiteral("null", Type::Null);
+            default:
+                if (c == '-' || (c >= '0' && c <= '9')) return ParseNumber();
+                return Fail(ParseStatus::UnexpectedCharacter);
+            }
+        }
+
+        ParseStatus ParseLiteral(std::string_view word, Type type) {
+            if (m_json.compare(m_pos, word.size(), word) != 0) return Fail(ParseStatus::InvalidLiteral);
+            uint32_t t = Push(type, m_pos, word.size());
+            m_tokens[t].end = t + 1;
+            m_pos += word.size();
+            return ParseStatus::Ok;
+        }
+
+        ParseStatus ParseNumber() {
+            size_t start = m_pos;
+            const size_t n = m_json.size();
+            auto digits = [&]() {
+                size_t s = m_pos;
+                while (m_pos < n && m_json[m_pos] >= '0' && m_json[m_pos] <= '9') ++m_pos;
+                return m_pos - s;
+            };
+            if (m_json[m_pos] == '-') ++m_pos;
+            if (m_pos < n && m_json[m_pos] == '0') {
+                ++m_pos;
+            }
+            else if (digits() == 0) {
+                return Fail(ParseStatus::InvalidNumber);
+            }
+            if (m_pos < n && m_json[m_pos] == '.') {
+                ++m_pos;
+                if (digits() == 0) return Fail(ParseStatus::InvalidNumber);
+            }
+            if (m_pos < n && (m_json[m_pos] == 'e' || m_json[m_pos] == 'E')) {
+                ++m_pos;
+                if (m_pos < n && (m_json[m_pos] == '+' || m_json[m_pos] == '-')) ++m_pos;
+                if (digits() == 0) return Fail(ParseStatus::InvalidNumber);
+            }
+            uint32_t t = Push(Type::Number, start, m_pos - start);
+            m_tokens[t].end = t + 1;
+            return ParseStatus::Ok;
+        }
+
+        ParseStatus ParseString() {
+            size_t start = ++m_pos;
+            bool escaped = false;
+            for (;;) {
+                size_t p = FindSpecial(m_json.data(), m_pos, m_json.size());
+                if (p >= m_json.size()) { m_pos = p; return Fail(ParseStatus::UnterminatedString); }
+                char c = m_json[p];
+                if (c == '"') {
+                    uint32_t t = Push(Type::String, start, p - start);
+                    m_tokens[t].escaped = escaped ? 1 : 0;
+                    m_tokens[t].end = t + 1;
+                    m_pos = p + 1;
+                    return ParseStatus::Ok;
+                }
+                if (c == '\\') {
+                    escaped = true;
+                    if (p + 1 >= m_json.size()) { m_pos = p; return Fail(ParseStatus::UnterminatedString); }
+                    size_t next = p + 2;
+                    switch (m_json[p + 1]) {
+                    case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                        break;
+                    case 'u':
+                        // \u 后必须是4个十六进制数字
+                        for (size_t k = 0; k < 4; ++k, ++next) {
+                            if (next >= m_json.size() || !std::isxdigit(static_cast<unsigned char>(m_json[next]))) {
+                                m_pos = p;
+                                return Fail(ParseStatus::InvalidString);
+                            }
+                        }
+                        break;
+                    default:
+                        m_pos = p;
+                        return Fail(ParseStatus::InvalidString);
+                    }
+                    m_pos = next;
+                    continue;
+                }
+                m_pos = p;
+                return Fail(ParseStatus::InvalidString);
+            }
+        }
+
+        ParseStatus ParseArray(int depth) {
+            if (depth > kMaxDepth) return Fail(ParseStatus::DepthExceeded);
+            uint32_t t = Push(Type::Array, m_pos, 0);
+            ++m_pos;
+            SkipWhitespace();
+            if (m_pos < m_json.size() && m_json[m_pos] == ']') {
+                ++m_pos;
+                m_tokens[t].end = t + 1;
+                return ParseStatus::Ok;
+            }
+            uint32_t count = 0;
+            for (;;) {
+                SkipWhitespace();
+                ParseStatus st = ParseValue(depth);
+                if (st != ParseStatus::Ok) return st;
+                ++count;
+                SkipWhitespace();
+                if (m_pos >= m_json.size()) return Fail(ParseStatus::UnexpectedCharacter);
+                char c = m_json[m_pos++];
+                if (c == ',') continue;
+                if (c == ']') break;
+                --m_pos;
+                return Fail(ParseStatus::UnexpectedCharacter);
+            }
+            m_tokens[t].length = count;
+            m_tokens[t].end = static_cast<uint32_t>(m_tokens.size());
+            return ParseStatus::Ok;
+        }
+
+        ParseStatus ParseObject(int depth) {
+            if (depth > kMaxDepth) return Fail(ParseStatus::DepthExceeded);
+            uint32_t t = Push(Type::Object, m_pos, 0);
+            ++m_pos;
+            SkipWhitespace();
+            if (m_pos < m_json.size() && m_json[m_pos] == '}') {
+                ++m_pos;
+                m_tokens[t].end = t + 1;
+                return ParseStatus::Ok;
+            }
+            uint32_t count = 0;
+            for (;;) {
+                SkipWhitespace();
+                if (m_pos >= m_json.size() || m_json[m_pos] != '"') return Fail(ParseStatus::UnexpectedCharacter);
+                ParseStatus st = ParseString();
+                if (st != ParseStatus::Ok) return st;
+                SkipWhitespace();
+                if (m_pos >= m_json.size() || m_json[m_pos] != ':') return Fail(ParseStatus::UnexpectedCharacter);
+                ++m_pos;
+                SkipWhitespace();
+                st = ParseValue(depth);
+                if (st != ParseStatus::Ok) return st;
+                ++count;
+                SkipWhitespace();
+                if (m_pos >= m_json.size()) return Fail(ParseStatus::UnexpectedCharacter);
+                char c = m_json[m_pos++];
+                if (c == ',') continue;
+                if (c == '}') break;
+                --m_pos;
+                return Fail(ParseStatus::UnexpectedCharacter);
+            }
+            m_tokens[t].length = count;
+            m_tokens[t].end = static_cast<uint32_t>(m_tokens.size());
+            return ParseStatus::Ok;
+        }
+
+        std::string_view m_json;
+        size_t m_pos = 0;
+        size_t m_errorOffset = 0;
+        std::vector<Token> m_tokens;
+    };
+
+    inline Type Value::GetType() const { return m_doc->TokenAt(m_index).type; }
+
+    inline std::string_view Value::Raw() const {
+        if (!Valid()) return {};
+        const Token& t = m_doc->TokenAt(m_index);
+        if (t.type == Type::Array || t.type == Type::Object) return {};
+        return m_doc->Source().substr(t.offset, t.length);
+    }
+
+    inline bool Value::HasEscapes() const {
+        return Valid() && m_doc->TokenAt(m_index).escaped != 0;
+    }
+
+    inline size_t Value::Size() const {
+        if (!IsArray() && !IsObject()) return 0;
+        return m_doc->TokenAt(m_index).length;
+    }
+
+    inline Value Value::operator[](std::string_view key) const {
+        if (!IsObject()) return {};
+        const Token& obj = m_doc->TokenAt(m_index);
+        std::string scratch;
+        for (uint32_t i = m_index + 1; i < obj.end; i = m_doc->TokenAt(i + 1).end) {
+            const Token& k = m_doc->TokenAt(i);
+            std::string_view raw = m_doc->Source().substr(k.offset, k.length);
+            if (k.escaped) {
+                scratch.clear();
+                if (Unescape(raw, scratch) && scratch == key) return Value(m_doc, i + 1);
+            }
+            else if (raw == key) {
+                return Value(m_doc, i + 1);
+            }
+        }
+        return {};
+    }
+
+    inline Value Value::operator[](size_t index) const {
+        if (!IsArray()) return {};
+        const Token& arr = m_doc->TokenAt(m_index);
+        size_t n = 0;
+        for (uint32_t i = m_index + 1; i < arr.end; i = m_doc->TokenAt(i).end) {
+            if (n++ == index) return Value(m_doc, i);
+        }
+        return {};
+    }
+
+    inline ArrayIterator& ArrayIterator::operator++() {
+        m_index = m_doc->TokenAt(m_index).end;
+        return *this;
+    }
+
+    inline MemberIterator& MemberIterator::operator++() {
+        m_index = m_doc->TokenAt(m_index + 1).end;
+        return *this;
+    }
+
+    inline Range<ArrayIterator> Value::Elements() const {
+        if (!IsArray()) return { ArrayIterator(nullptr, 0), ArrayIterator(nullptr, 0) };
+        return { ArrayIterator(m_doc, m_index + 1), ArrayIterator(m_doc, m_doc->TokenAt(m_index).end) };
+    }
+
+    inline Range<MemberIterator> Value::Members() const {
+        if (!IsObject()) return { MemberIterator(nullptr, 0), MemberIterator(nullptr, 0) };
+        return { MemberIterator(m_doc, m_index + 1), MemberIterator(m_doc, m_doc->TokenAt(m_index).end) };
+    }
+
+    // 直接追加到目标缓冲区的写入器（不校验结构，调用方保证配对）
+    class Writer {
+    public:
+        explicit Writer(std::string& out) : m_out(out) {}
+
+        Writer& BeginObject() { Prefix(); m_out.push_back('{'); m_needComma = false; return *this; }
+        Writer& EndObject() { m_out.push_back('}'); m_needComma = true; return *this; }
+        Writer& BeginArray() { Prefix(); m_out.push_back('['); m_needComma = false; return *this; }
+        Writer& EndArray() { m_out.push_back(']'); m_needComma = true; return *this; }
+
+        Writer& Key(std::string_view key) {
+            if (m_needComma) m_out.push_back(',');
+            WriteEscaped(key);
+            m_out.push_back(':');
+            m_needComma = false;
+            return *this;
+        }
+
+        Writer& String(std::string_view s) { Prefix(); WriteEscaped(s); return *this; }
+
+        Writer& Number(double v) {
+            Prefix();
+            if (v != v || v - v != 0.0) { m_out.append("null"); return *this; } // NaN/Inf
+            char buf[32];
+            auto res = std::to_chars(buf, buf + sizeof(buf), v);
+            m_out.append(buf, res.ptr);
+            return *this;
+        }
+
+        Writer& Int(int64_t v) {
+            Prefix();
+            char buf[24];
+            auto res = std::to_chars(buf, buf + sizeof(buf), v);
+            m_out.append(buf, res.ptr);
+            return *this;
+        }
+
+        Writer& Bool(bool v) { Prefix(); m_out.append(v ? "true" : "false"); return *this; }
+        Writer& Null() { Prefix(); m_out.append("null"); return *this; }
+
+        // 写入已序列化的JSON片段
+        Writer& Raw(std::string_view json) { Prefix(); m_out.append(json); return *this; }
+
+        std::string& Buffer() { return m_out; }
+
+    private:
+        void Prefix() {
+            if (m_needComma) m_out.push_back(',');
+            m_needComma = true;
+        }
+
+        void WriteEscaped(std::string_view s) {
+            static const char* kHex = "0123456789abcdef";
+            m_out.push_back('"');
+            size_t i = 0;
+            const size_t n = s.size();
+            while (i < n) {
+                size_t run = FindSpecial(s.data(), i, n);
+                m_out.append(s.data() + i, run - i);
+                if (run >= n) break;
+                unsigned char c = static_cast<unsigned char>(s[run]);
+                switch (c) {
+                case '"': m_out.append("\\\""); break;
+                case '\\': m_out.append("\\\\"); break;
+                case '\n': m_out.append("\\n"); break;
+                case '\r': m_out.append("\\r"); break;
+                case '\t': m_out.append("\\t"); break;
+                case '\b': m_out.append("\\b"); break;
+                case '\f': m_out.append("\\f"); break;
+                default: {
+                    char u[6] = { '\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF] };
+                    m_out.append(u, 6);
+                }
+                }
+                i = run + 1;
+            }
+            m_out.push_back('"');
+        }
+
+        std::string& m_out;
+        bool m_needComma = false;
+    };
+
+    // 基准测试结果
+    struct JsonBenchmark {
+        size_t payloadBytes = 0;
+        size_t iterations = 0;
+        double parseMBPerSec = 0.0;
+        double writeMBPerSec = 0.0;
+    };
+
+    // 生成仪表盘样例数据：widgets 个指标组件，每个附带历史曲线与标签
+    inline std::string MakeDashboardPayload(int widgets = 64, int historyLength = 32) {
+        std::string out;
+        Writer w(out);
+        w.BeginObject();
+        w.Key("timestamp").Int(1760000000123);
+        w.Key("host").String("otter-dashboard-01");
+        w.Key("widgets").BeginArray();
+        for (int i = 0; i < widgets; ++i) {
+            w.BeginObject();
+            w.Key("id").String("metric-" + std::to_string(i));
+            w.Key("title").String(i % 3 == 0 ? "CPU \"core\" load" : "Network throughput (eth0)");
+            w.Key("type").String(i % 2 ? "gauge" : "sparkline");
+            w.Key("value").Number(37.5 + i * 1.25);
+            w.Key("unit").String("%");
+            w.Key("alert").Bool(i % 7 == 0);
+            w.Key("history").BeginArray();
+            for (int h = 0; h < historyLength; ++h) w.Number((i * 31 + h * 17) % 1000 / 10.0);
+            w.EndArray();
+            w.Key("tags").BeginArray().String("rack-" + std::to_string(i % 4)).String("prod").EndArray();
+            w.EndObject();
+        }
+        w.EndArray();
+        w.EndObject();
+        return out;
+    }
+
+    // 对仪表盘数据测量解析与写入吞吐量
+    inline JsonBenchmark BenchmarkDashboardPayloads(size_t iterations = 2000) {
+        using Clock = std::chrono::steady_clock;
+        std::string payload = MakeDashboardPayload();
+        JsonBenchmark bench;
+        bench.payloadBytes = payload.size();
+        bench.iterations = iterations;
+
+        Document doc;
+        double sink = 0.0;
+        auto t0 = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            if (doc.Parse(payload) != ParseStatus::Ok) return bench;
+            for (Value widget : doc.Root()["widgets"].Elements()) {
+                sink += widget["value"].GetDouble();
+                for (Value h : widget["history"].Elements()) sink += h.GetDouble();
+            }
+        }
+        double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        double mb = static_cast<double>(payload.size()) * iterations / (1024.0 * 1024.0);
+        bench.parseMBPerSec = sec > 0 && sink >= 0 ? mb / sec : 0.0;
+
+        std::string response;
+        response.reserve(payload.size());
+        t0 = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            response.clear();
+            Writer w(response);
+            w.BeginObject().Key("widgets").BeginArray();
+            for (Value widget : doc.Root()["widgets"].Elements()) {
+                std::string_view id;
+                w.BeginObject();
+                if (widget["id"].GetStringView(id)) w.Key("id").String(id);
+                w.Key("value").Number(widget["value"].GetDouble());
+                w.Key("alert").Bool(widget["alert"].GetBool());
+                w.Key("history").BeginArray();
+                for (Value h : widget["history"].Elements()) w.Number(h.GetDouble());
+                w.EndArray().EndObject();
+            }
+            w.EndArray().EndObject();
+        }
+        sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        mb = static_cast<double>(response.size()) * iterations / (1024.0 * 1024.0);
+        bench.writeMBPerSec = sec > 0 ? mb / sec : 0.0;
+        return bench;
+    }
+}
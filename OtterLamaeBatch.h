@@ -0,0 +1,275 @@
+#pragma once
+// OtterLamaeBatch.h
+// OtterLamae 批量解析："标识符 数值" 行流 -> 列式数组（标识符ID + double）
+// 整块接收缓冲区一次扫描，不抛异常，错误按行记录
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "OtterSimd.h"
+
+namespace OtterLamae {
+
+    // 单行解析状态
+    enum class LineStatus : uint8_t {
+        Ok = 0,
+        MissingValue,       // 只有标识符
+        InvalidNumber,      // 数值无法解析
+        ExtraCharacters,    // 数值后仍有内容
+    };
+
+    // 行错误记录
+    struct LineError {
+        size_t offset;      // 行首在本次 Parse 缓冲区中的字节偏移
+        uint32_t line;      // 解析器收到的第几行（从0开始，跨多次 Parse 连续计数）
+        LineStatus status;
+    };
+
+    // 标识符驻留表：相同标识符映射为同一个ID
+    class IdentifierTable {
+    public:
+        IdentifierTable() : m_slots(64, kEmpty) {}
+
+        uint32_t Intern(std::string_view name) {
+            uint64_t h = Hash(name);
+            size_t mask = m_slots.size() - 1;
+            for (size_t i = static_cast<size_t>(h) & mask;; i = (i + 1) & mask) {
+                uint32_t id = m_slots[i];
+                if (id == kEmpty) {
+                    id = static_cast<uint32_t>(m_names.size());
+                    m_names.emplace_back(name);
+                    m_hashes.push_back(h);
+                    m_slots[i] = id;
+                    if (m_names.size() * 2 > m_slots.size()) Grow();
+                    return id;
+                }
+                if (m_hashes[id] == h && m_names[id] == name) return id;
+            }
+        }
+
+        // 查找但不插入，不存在返回 kInvalid
+        uint32_t Find(std::string_view name) const {
+            uint64_t h = Hash(name);
+            size_t mask = m_slots.size() - 1;
+            for (size_t i = static_cast<size_t>(h) & mask;; i = (i + 1) & mask) {
+                uint32_t id = m_slots[i];
+                if (id == kEmpty) return kInvalid;
+                if (m_hashes[id] == h && m_names[id] == name) return id;
+            }
+        }
+
+        const std::string& Name(uint32_t id) const { return m_names[id]; }
+        size_t Size() const { return m_names.size(); }
+
+        static constexpr uint32_t kInvalid = 0xFFFFFFFFu;
+
+    private:
+        static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+
+        static uint64_t Hash(std::string_view s) {
+            uint64_t h = 1469598103934665603ull;   // FNV-1a
+            for (unsigned char c : s) { h ^= c; h *= 1099511628211ull; }
+            return h;
+        }
+
+        void Grow() {
+            std::vector<uint32_t> slots(m_slots.size() * 2, kEmpty);
+            size_t mask = slots.size() - 1;
+            for (uint32_t id = 0; id < m_names.size(); ++id) {
+                size_t i = static_cast<size_t>(m_hashes[id]) & mask;
+                while (slots[i] != kEmpty) i = (i + 1) & mask;
+                slots[i] = id;
+            }
+            m_slots.swap(slots);
+        }
+
+        std::vector<uint32_t> m_slots;
+        std::deque<std::string> m_names;
+        std::vector<uint64_t> m_hashes;
+    };
+
+    // 列式输出：ids[i] 与 values[i] 一一对应
+    struct ValueColumns {
+        std::vector<uint32_t> ids;
+        std::vector<double> values;
+        std::vector<LineError> errors;
+
+        void clear() {
+            ids.clear();
+            values.clear();
+            errors.clear();
+        }
+
+        size_t size() const { return ids.size(); }
+    };
+
+    // 批量解析结果
+    struct BatchResult {
+        size_t consumed = 0;    // 已消费字节数（未结束的尾行留给下一次接收）
+        size_t parsed = 0;      // 成功行数
+        size_t failed = 0;      // 失败行数
+    };
+
+    class BatchParser {
+    public:
+        explicit BatchParser(IdentifierTable& table) : m_table(table) {}
+
+        // 解析缓冲区中的完整行并追加到 out；finalChunk 为 true 时无换行的尾行也解析。
+        // 未结束的尾行不计行号，下次连同后续数据传入时再计
+        BatchResult Parse(const char* data, size_t size, ValueColumns& out, bool finalChunk = false) {
+            BatchResult result;
+            const char* p = data;
+            const char* end = data + size;
+            const char* lineStart = data;
+
+#if OTTER_HAS_SSE2
+            const __m128i newline = _mm_set1_epi8('\n');
+            while (end - p >= 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+                while (mask) {
+                    const char* nl = p + OtterSimd::CountTrailingZeros(mask);
+                    ParseLine(data, lineStart, nl, m_lineNo++, out, result);
+                    lineStart = nl + 1;
+                    mask &= mask - 1;
+                }
+                p += 16;
+            }
+#endif
+            while (p < end) {
+                if (*p == '\n') {
+                    ParseLine(data, lineStart, p, m_lineNo++, out, result);
+                    lineStart = p + 1;
+                }
+                ++p;
+            }
+
+            if (finalChunk && lineStart < end) {
+                ParseLine(data, lineStart, end, m_lineNo++, out, result);
+                lineStart = end;
+            }
+
+            result.consumed = static_cast<size_t>(lineStart - data);
+            return result;
+        }
+
+        BatchResult Parse(std::string_view buffer, ValueColumns& out, bool finalChunk = false) {
+            return Parse(buffer.data(), buffer.size(), out, finalChunk);
+        }
+
+        // 已解析的行数（含空行），即下一行的行号
+        uint32_t LineCount() const { return m_lineNo; }
+
+        // 开始新的数据流时行号从0重新计数
+        void ResetLineCount() { m_lineNo = 0; }
+
+    private:
+        static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+        void ParseLine(const char* base, const char* b, const char* e, uint32_t lineNo,
+            ValueColumns& out, BatchResult& result) {
+            while (b < e && IsSpace(*b)) ++b;
+            while (e > b && IsSpace(e[-1])) --e;
+            if (b == e) return; // 空行跳过
+
+            const char* idEnd = b;
+            while (idEnd < e && !IsSpace(*idEnd)) ++idEnd;
+
+            const char* v = idEnd;
+            while (v < e && IsSpace(*v)) ++v;
+
+            LineStatus status = LineStatus::Ok;
+            double value = 0.0;
+            if (v == e) {
+                status = LineStatus::MissingValue;
+            }
+            else {
+                // from_chars 不接受 '+'，跳过后其后不能再有符号（"+-5" 无效）
+                if (*v == '+') {
+                    ++v;
+                    if (v < e && (*v == '-' || *v == '+')) status = LineStatus::InvalidNumber;
+                }
+                if (status == LineStatus::Ok) {
+                    auto [ptr, ec] = std::from_chars(v, e, value);
+                    if (ec != std::errc() || ptr == v) {
+                        status = LineStatus::InvalidNumber;
+                    }
+                    else if (ptr != e) {
+                        status = IsSpace(*ptr) ? LineStatus::ExtraCharacters : LineStatus::InvalidNumber;
+                    }
+                }
+            }
+
+            if (status != LineStatus::Ok) {
+                out.errors.push_back({ static_cast<size_t>(b - base), lineNo, status });
+                ++result.failed;
+                return;
+            }
+
+            out.ids.push_back(m_table.Intern(std::string_view(b, static_cast<size_t>(idEnd - b))));
+            out.values.push_back(value);
+            ++result.parsed;
+        }
+
+        IdentifierTable& m_table;
+        uint32_t m_lineNo = 0;
+    };
+
+    // 吞吐量测试结果
+    struct BatchBenchmark {
+        size_t lines = 0;
+        double batchLinesPerSec = 0.0;
+        double batchMBPerSec = 0.0;
+        double legacyLinesPerSec = 0.0;     // 逐行 istringstream 解析
+    };
+
+    // 生成 lines 行传感器数据，对比批量解析与逐行解析的吞吐量
+    inline BatchBenchmark BenchmarkBatchParse(size_t lines = 1000000, size_t identifiers = 64) {
+        std::string buffer;
+        buffer.reserve(lines * 16);
+        uint32_t seed = 12345;
+        for (size_t i = 0; i < lines; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            buffer += "S";
+            buffer += std::to_string(seed % identifiers);
+            buffer += ' ';
+            buffer += std::to_string((seed >> 8) % 100000 / 100.0);
+            buffer += '\n';
+        }
+
+        using Clock = std::chrono::steady_clock;
+        BatchBenchmark bench;
+        bench.lines = lines;
+
+        IdentifierTable table;
+        BatchParser parser(table);
+        ValueColumns columns;
+        columns.ids.reserve(lines);
+        columns.values.reserve(lines);
+        auto t0 = Clock::now();
+        parser.Parse(buffer, columns, true);
+        double batchSec = std::chrono::duration<double>(Clock::now() - t0).count();
+        bench.batchLinesPerSec = batchSec > 0 ? lines / batchSec : 0.0;
+        bench.batchMBPerSec = batchSec > 0 ? buffer.size() / batchSec / (1024.0 * 1024.0) : 0.0;
+
+        std::istringstream stream(buffer);
+        std::string line;
+        double sink = 0.0;
+        t0 = Clock::now();
+        while (std::getline(stream, line)) {
+            std::istringstream iss(line);
+            std::string identifier;
+            double value;
+            if (iss >> identifier >> value) sink += value;
+        }
+        double legacySec = std::chrono::duration<double>(Clock::now() - t0).count();
+        bench.legacyLinesPerSec = legacySec > 0 && sink >= 0 ? lines / legacySec : 0.0;
+        return bench;
+    }
+}
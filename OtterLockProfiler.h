@@ -0,0 +1,246 @@
+#pragma once
+// OtterLockProfiler.h
+// 锁竞争分析：定义 OTTER_LOCK_PROFILING 后，OtterProfile::Mutex 记录获取次数、
+// 等待时间与持有时间直方图；未定义时退化为 std::mutex，无额外开销。
+#include <mutex>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace OtterProfile {
+
+    // 对数分桶直方图：第 i 桶统计 [2^i, 2^(i+1)) 纳秒
+    class LatencyHistogram {
+    public:
+        static constexpr int kBuckets = 40;
+
+        void Record(uint64_t ns) {
+            m_buckets[BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+            m_total.fetch_add(ns, std::memory_order_relaxed);
+            uint64_t prev = m_max.load(std::memory_order_relaxed);
+            while (ns > prev && !m_max.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+        }
+
+        void Reset() {
+            for (auto& b : m_buckets) b.store(0, std::memory_order_relaxed);
+            m_total.store(0, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+        }
+
+        std::vector<uint64_t> Buckets() const {
+            std::vector<uint64_t> out(kBuckets);
+            for (int i = 0; i < kBuckets; ++i) out[i] = m_buckets[i].load(std::memory_order_relaxed);
+            return out;
+        }
+
+        uint64_t TotalNs() const { return m_total.load(std::memory_order_relaxed); }
+        uint64_t MaxNs() const { return m_max.load(std::memory_order_relaxed); }
+
+        static int BucketOf(uint64_t ns) {
+            int b = 0;
+            while (ns > 1 && b < kBuckets - 1) { ns >>= 1; ++b; }
+            return b;
+        }
+
+        // 桶上界（纳秒），用于估算百分位
+        static uint64_t BucketUpperNs(int bucket) {
+            return bucket >= 63 ? UINT64_MAX : (uint64_t(1) << (bucket + 1));
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, kBuckets> m_buckets{};
+        std::atomic<uint64_t> m_total{ 0 };
+        std::atomic<uint64_t> m_max{ 0 };
+    };
+
+    // 单个命名锁的累计数据（同名锁共享一份）
+    struct LockStats {
+        std::string name;
+        std::atomic<uint64_t> acquisitions{ 0 };
+        std::atomic<uint64_t> contended{ 0 };   // 需要等待的获取次数
+        LatencyHistogram wait;
+        LatencyHistogram hold;
+
+        explicit LockStats(std::string n) : name(std::move(n)) {}
+    };
+
+    // 运行时可读取的锁报告
+    struct LockReport {
+        std::string name;
+        uint64_t acquisitions = 0;
+        uint64_t contended = 0;
+        uint64_t totalWaitNs = 0, maxWaitNs = 0;
+        uint64_t totalHoldNs = 0, maxHoldNs = 0;
+        std::vector<uint64_t> waitBuckets;      // 见 LatencyHistogram 分桶
+        std::vector<uint64_t> holdBuckets;
+
+        // 由直方图估算百分位（返回桶上界，纳秒）
+        static uint64_t Percentile(const std::vector<uint64_t>& buckets, double p) {
+            uint64_t total = 0;
+            for (uint64_t c : buckets) total += c;
+            if (total == 0) return 0;
+            uint64_t target = static_cast<uint64_t>(p * static_cast<double>(total));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                seen += buckets[i];
+                if (seen > target) return LatencyHistogram::BucketUpperNs(static_cast<int>(i));
+            }
+            return LatencyHistogram::BucketUpperNs(static_cast<int>(buckets.size()) - 1);
+        }
+
+        uint64_t WaitPercentileNs(double p) const { return Percentile(waitBuckets, p); }
+        uint64_t HoldPercentileNs(double p) const { return Percentile(holdBuckets, p); }
+    };
+
+    // 全局锁注册表
+    class LockRegistry {
+    public:
+        static LockRegistry& Instance() {
+            static LockRegistry registry;
+            return registry;
+        }
+
+        std::shared_ptr<LockStats> Acquire(const char* name) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& slot = m_stats[name ? name : "unnamed"];
+            if (!slot) slot = std::make_shared<LockStats>(name ? name : "unnamed");
+            return slot;
+        }
+
+        std::vector<LockReport> Reports() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::vector<LockReport> out;
+            out.reserve(m_stats.size());
+            for (const auto& [name, stats] : m_stats) {
+                LockReport r;
+                r.name = name;
+                r.acquisitions = stats->acquisitions.load(std::memory_order_relaxed);
+                r.contended = stats->contended.load(std::memory_order_relaxed);
+                r.totalWaitNs = stats->wait.TotalNs();
+                r.maxWaitNs = stats->wait.MaxNs();
+                r.totalHoldNs = stats->hold.TotalNs();
+                r.maxHoldNs = stats->hold.MaxNs();
+                r.waitBuckets = stats->wait.Buckets();
+                r.holdBuckets = stats->hold.Buckets();
+                out.push_back(std::move(r));
+            }
+            return out;
+        }
+
+        void Reset() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& [name, stats] : m_stats) {
+                stats->acquisitions.store(0, std::memory_order_relaxed);
+                stats->contended.store(0, std::memory_order_relaxed);
+                stats->wait.Reset();
+                stats->hold.Reset();
+            }
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::map<std::string, std::shared_ptr<LockStats>> m_stats;
+    };
+
+    // 带统计的互斥锁，满足 Lockable 要求，可直接用于 std::lock_guard
+    class ProfiledMutex {
+    public:
+        explicit ProfiledMutex(const char* name)
+            : m_stats(LockRegistry::Instance().Acquire(name)) {}
+
+        ProfiledMutex(const ProfiledMutex&) = delete;
+        ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+        void lock() {
+            if (m_mutex.try_lock()) {
+                OnAcquired(0);
+                return;
+            }
+            auto start = Clock::now();
+            m_mutex.lock();
+            m_acquiredAt = Clock::now();
+            m_stats->contended.fetch_add(1, std::memory_order_relaxed);
+            m_stats->acquisitions.fetch_add(1, std::memory_order_relaxed);
+            m_stats->wait.Record(ToNs(m_acquiredAt - start));
+        }
+
+        bool try_lock() {
+            if (!m_mutex.try_lock()) return false;
+            OnAcquired(0);
+            return true;
+        }
+
+        void unlock() {
+            uint64_t held = ToNs(Clock::now() - m_acquiredAt);
+            m_mutex.unlock();
+            m_stats->hold.Record(held);
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static uint64_t ToNs(Clock::duration d) {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+        }
+
+        void OnAcquired(uint64_t waitNs) {
+            m_acquiredAt = Clock::now();
+            m_stats->acquisitions.fetch_add(1, std::memory_order_relaxed);
+            m_stats->wait.Record(waitNs);
+        }
+
+        std::mutex m_mutex;
+        std::shared_ptr<LockStats> m_stats;
+        Clock::time_point m_acquiredAt{};   // 仅持锁线程读写
+    };
+
+    // 未开启分析时使用的命名锁：名字仅用于接口统一
+    class PlainMutex : public std::mutex {
+    public:
+        explicit PlainMutex(const char*) {}
+    };
+
+#ifdef OTTER_LOCK_PROFILING
+    using Mutex = ProfiledMutex;
+    constexpr bool kLockProfilingEnabled = true;
+#else
+    using Mutex = PlainMutex;
+    constexpr bool kLockProfilingEnabled = false;
+#endif
+
+    // 获取所有命名锁的报告（未开启分析时为空）
+    inline std::vector<LockReport> GetLockReports() {
+        if (!kLockProfilingEnabled) return {};
+        return LockRegistry::Instance().Reports();
+    }
+
+    // 清零统计，用于对比优化前后
+    inline void ResetLockReports() {
+        LockRegistry::Instance().Reset();
+    }
+
+    // 文本格式报告
+    inline std::string FormatLockReports(const std::vector<LockReport>& reports) {
+        std::ostringstream ss;
+        ss << std::left << std::setw(32) << "lock" << std::right
+           << std::setw(12) << "acquire" << std::setw(12) << "contended"
+           << std::setw(14) << "wait_p50_ns" << std::setw(14) << "wait_p99_ns" << std::setw(14) << "wait_max_ns"
+           << std::setw(14) << "hold_p50_ns" << std::setw(14) << "hold_p99_ns" << std::setw(14) << "hold_max_ns" << "\n";
+        for (const auto& r : reports) {
+            ss << std::left << std::setw(32) << r.name << std::right
+               << std::setw(12) << r.acquisitions << std::setw(12) << r.contended
+               << std::setw(14) << r.WaitPercentileNs(0.50) << std::setw(14) << r.WaitPercentileNs(0.99)
+               << std::setw(14) << r.maxWaitNs
+               << std::setw(14) << r.HoldPercentileNs(0.50) << std::setw(14) << r.HoldPercentileNs(0.99)
+               << std::setw(14) << r.maxHoldNs << "\n";
+        }
+        return ss.str();
+    }
+}
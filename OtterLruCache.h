@@ -0,0 +1,216 @@
+#pragma once
+// OtterLruCache.h
+// 通用LRU缓存：按键查找（哈希）或按句柄直接访问（下标+代数校验，不哈希）
+// 通过句柄获取的条目被固定，Release 之前不会被淘汰。非线程安全，由调用方保证单线程使用
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace OtterCache {
+
+    // 缓存句柄：slot 为槽位下标，generation 用于识别槽位是否已被复用
+    template <typename Tag>
+    struct Handle {
+        uint32_t slot = 0xFFFFFFFFu;
+        uint32_t generation = 0;
+
+        bool IsValid() const { return slot != 0xFFFFFFFFu; }
+        bool operator==(const Handle& o) const { return slot == o.slot && generation == o.generation; }
+        bool operator!=(const Handle& o) const { return !(*this == o); }
+    };
+
+    struct CacheStats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t size = 0;
+        size_t pinned = 0;
+    };
+
+    template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Tag = Key>
+    class LruCache {
+    public:
+        using HandleType = Handle<Tag>;
+
+        explicit LruCache(size_t capacity = 64) : m_capacity(capacity == 0 ? 1 : capacity) {}
+
+        // 按键查找，不存在时调用 create() 创建；返回的指针在下一次插入前有效
+        template <typename Create>
+        Value* Get(const Key& key, Create&& create) {
+            return &m_slots[FindOrCreate(key, create)].value;
+        }
+
+        // 仅查找，不创建
+        Value* Find(const Key& key) {
+            auto it = m_index.find(key);
+            if (it == m_index.end()) return nullptr;
+            ++m_stats.hits;
+            Touch(it->second);
+            return &m_slots[it->second].value;
+        }
+
+        // 获取并固定条目，返回句柄；同一条目可多次 Acquire，需对应次数的 Release
+        template <typename Create>
+        HandleType Acquire(const Key& key, Create&& create) {
+            uint32_t slot = FindOrCreate(key, create);
+            ++m_slots[slot].pins;
+            HandleType h;
+            h.slot = slot;
+            h.generation = m_slots[slot].generation;
+            return h;
+        }
+
+        // 句柄访问：只做下标与代数比较；句柄已释放失效时返回 nullptr
+        Value* Resolve(HandleType h) {
+            if (h.slot >= m_slots.size()) return nullptr;
+            Slot& s = m_slots[h.slot];
+            if (!s.used || s.generation != h.generation) return nullptr;
+            Touch(h.slot);
+            return &s.value;
+        }
+
+        void Release(HandleType h) {
+            if (h.slot >= m_slots.size()) return;
+            Slot& s = m_slots[h.slot];
+            if (!s.used || s.generation != h.generation || s.pins == 0) return;
+            --s.pins;
+            Trim();
+        }
+
+        bool Erase(const Key& key) {
+            auto it = m_index.find(key);
+            if (it == m_index.end() || m_slots[it->second].pins) return false;
+            Free(it->second);
+            return true;
+        }
+
+        // 清空所有条目（包括被固定的，已发出的句柄全部失效）
+        void Clear() {
+            for (uint32_t i = 0; i < m_slots.size(); ++i) {
+                if (m_slots[i].used) { m_slots[i].pins = 0; Free(i); }
+            }
+        }
+
+        void SetCapacity(size_t capacity) {
+            m_capacity = capacity == 0 ? 1 : capacity;
+            Trim();
+        }
+
+        size_t Capacity() const { return m_capacity; }
+        size_t Size() const { return m_index.size(); }
+
+        CacheStats Stats() const {
+            CacheStats s = m_stats;
+            s.size = m_index.size();
+            for (const Slot& slot : m_slots) s.pinned += slot.used && slot.pins ? 1 : 0;
+            return s;
+        }
+
+        void ResetStats() { m_stats = CacheStats(); }
+
+        // 按最近使用顺序遍历（最近的在前）：fn(const Key&, Value&)
+        template <typename Fn>
+        void ForEach(Fn&& fn) {
+            for (uint32_t i = m_head; i != kNone; i = m_slots[i].next) fn(m_slots[i].key, m_slots[i].value);
+        }
+
+    private:
+        static constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+        struct Slot {
+            Key key{};
+            Value value{};
+            uint32_t generation = 0;
+            uint32_t pins = 0;
+            uint32_t prev = kNone, next = kNone;
+            bool used = false;
+        };
+
+        template <typename Create>
+        uint32_t FindOrCreate(const Key& key, Create& create) {
+            auto it = m_index.find(key);
+            if (it != m_index.end()) {
+                ++m_stats.hits;
+                Touch(it->second);
+                return it->second;
+            }
+            ++m_stats.misses;
+            uint32_t slot;
+            if (!m_freeSlots.empty()) {
+                slot = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            }
+            else {
+                slot = static_cast<uint32_t>(m_slots.size());
+                m_slots.emplace_back();
+            }
+            Slot& s = m_slots[slot];
+            s.key = key;
+            s.value = create();
+            s.used = true;
+            s.pins = 0;
+            m_index.emplace(key, slot);
+            LinkFront(slot);
+            Trim(slot);
+            return slot;
+        }
+
+        // 淘汰最久未用且未固定的条目，keep 为本次刚插入的条目
+        void Trim(uint32_t keep = kNone) {
+            uint32_t i = m_tail;
+            while (m_index.size() > m_capacity && i != kNone) {
+                uint32_t prev = m_slots[i].prev;
+                if (i != keep && m_slots[i].pins == 0) {
+                    Free(i);
+                    ++m_stats.evictions;
+                }
+                i = prev;
+            }
+        }
+
+        void Free(uint32_t slot) {
+            Slot& s = m_slots[slot];
+            m_index.erase(s.key);
+            Unlink(slot);
+            s.key = Key{};
+            s.value = Value{};
+            s.used = false;
+            ++s.generation;
+            m_freeSlots.push_back(slot);
+        }
+
+        void Touch(uint32_t slot) {
+            if (m_head == slot) return;
+            Unlink(slot);
+            LinkFront(slot);
+        }
+
+        void LinkFront(uint32_t slot) {
+            Slot& s = m_slots[slot];
+            s.prev = kNone;
+            s.next = m_head;
+            if (m_head != kNone) m_slots[m_head].prev = slot;
+            m_head = slot;
+            if (m_tail == kNone) m_tail = slot;
+        }
+
+        void Unlink(uint32_t slot) {
+            Slot& s = m_slots[slot];
+            if (s.prev != kNone) m_slots[s.prev].next = s.next;
+            else if (m_head == slot) m_head = s.next;
+            if (s.next != kNone) m_slots[s.next].prev = s.prev;
+            else if (m_tail == slot) m_tail = s.prev;
+            s.prev = s.next = kNone;
+        }
+
+        size_t m_capacity;
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+        std::unordered_map<Key, uint32_t, Hash> m_index;
+        uint32_t m_head = kNone, m_tail = kNone;
+        CacheStats m_stats;
+    };
+}
@@ -0,0 +1,159 @@
+#pragma once
+// OtterMip.h
+// 缩放缓存：按需生成的 mip 金字塔（逐级1/2盒式滤波）+ 最近使用的若干个目标尺寸缩放结果。
+// 缩放绘制从不小于目标尺寸的最小一级开始，只做最后一步双线性插值；目标尺寸不变时直接复用。不依赖Windows
+#include <vector>
+#include "OtterRaster.h"
+
+namespace OtterRaster {
+    namespace Resample {
+
+        // 预乘像素的两个通道一组（0x00FF00FF 掩码）做定点运算，一次处理R/B或A/G
+        constexpr uint32_t kChannelMask = 0x00FF00FFu;
+
+        // 长宽各减半（至少1像素），2×2 盒式平均；奇数尺寸时最后一行/列与相邻像素平均
+        inline void Downsample2x(const Surface& src, Surface& dst) {
+            const int sw = src.Width(), sh = src.Height();
+            const int dw = (std::max)(1, sw / 2), dh = (std::max)(1, sh / 2);
+            dst.Allocate(dw, dh);
+            for (int y = 0; y < dh; ++y) {
+                const uint32_t* r0 = src.Row((std::min)(2 * y, sh - 1));
+                const uint32_t* r1 = src.Row((std::min)(2 * y + 1, sh - 1));
+                uint32_t* out = dst.Row(y);
+                for (int x = 0; x < dw; ++x) {
+                    const int x0 = (std::min)(2 * x, sw - 1), x1 = (std::min)(2 * x + 1, sw - 1);
+                    const uint32_t a = r0[x0], b = r0[x1], c = r1[x0], d = r1[x1];
+                    uint32_t rb = (a & kChannelMask) + (b & kChannelMask) + (c & kChannelMask) + (d & kChannelMask);
+                    uint32_t ag = ((a >> 8) & kChannelMask) + ((b >> 8) & kChannelMask)
+                        + ((c >> 8) & kChannelMask) + ((d >> 8) & kChannelMask);
+                    rb = ((rb + 0x00020002u) >> 2) & kChannelMask;
+                    ag = ((ag + 0x00020002u) >> 2) & kChannelMask;
+                    out[x] = rb | (ag << 8);
+                }
+            }
+        }
+
+        // a、b 按 f/256 插值
+        inline uint32_t Lerp(uint32_t a, uint32_t b, uint32_t f) {
+            const uint32_t g = 256 - f;
+            uint32_t rb = (((a & kChannelMask) * g + (b & kChannelMask) * f) >> 8) & kChannelMask;
+            uint32_t ag = ((((a >> 8) & kChannelMask) * g + ((b >> 8) & kChannelMask) * f) >> 8) & kChannelMask;
+            return rb | (ag << 8);
+        }
+
+        // 把 src 的 srcRect 部分双线性缩放到 dst（dst 已分配为目标尺寸），像素中心对齐
+        inline void Bilinear(const Surface& src, const Rect& srcRect, Surface& dst) {
+            const Rect from = srcRect.Intersect(src.Bounds());
+            const int dw = dst.Width(), dh = dst.Height();
+            if (from.IsEmpty() || dw <= 0 || dh <= 0) return;
+
+            // 每列的源坐标与权重只算一次
+            std::vector<int> xs(size_t(dw) * 2);
+            std::vector<uint32_t> fx(dw);
+            const float scaleX = float(from.w) / dw, scaleY = float(from.h) / dh;
+            for (int x = 0; x < dw; ++x) {
+                float sx = (std::max)(0.0f, (x + 0.5f) * scaleX - 0.5f);
+                int x0 = (std::min)(static_cast<int>(sx), from.w - 1);
+                xs[2 * x] = from.x + x0;
+                xs[2 * x + 1] = from.x + (std::min)(x0 + 1, from.w - 1);
+                fx[x] = static_cast<uint32_t>((sx - x0) * 256.0f);
+            }
+            for (int y = 0; y < dh; ++y) {
+                float sy = (std::max)(0.0f, (y + 0.5f) * scaleY - 0.5f);
+                int y0 = (std::min)(static_cast<int>(sy), from.h - 1);
+                const uint32_t fy = static_cast<uint32_t>((sy - y0) * 256.0f);
+                const uint32_t* r0 = src.Row(from.y + y0);
+                const uint32_t* r1 = src.Row(from.y + (std::min)(y0 + 1, from.h - 1));
+                uint32_t* out = dst.Row(y);
+                for (int x = 0; x < dw; ++x) {
+                    const int a = xs[2 * x], b = xs[2 * x + 1];
+                    const uint32_t top = Lerp(r0[a], r0[b], fx[x]);
+                    out[x] = fy ? Lerp(top, Lerp(r1[a], r1[b], fx[x]), fy) : top;
+                }
+            }
+        }
+    }
+
+    class ScaledImageCache {
+    public:
+        static constexpr size_t kDefaultVariants = 4;
+
+        struct Stats {
+            size_t variantHits = 0;     // 直接复用缩放结果
+            size_t variantBuilds = 0;   // 重新生成缩放结果
+            size_t levelsBuilt = 0;     // 生成的 mip 级数
+        };
+
+        explicit ScaledImageCache(size_t maxVariants = kDefaultVariants)
+            : m_maxVariants(maxVariants == 0 ? 1 : maxVariants) {}
+
+        // 取得 source 缩放到 width×height 的结果，在下一次 Get 前有效；source 变化后需先 Invalidate()
+        const Surface& Get(const Surface& source, int width, int height) {
+            width = (std::max)(width, 1);
+            height = (std::max)(height, 1);
+            for (size_t i = 0; i < m_variants.size(); ++i) {
+                if (m_variants[i].Width() == width && m_variants[i].Height() == height) {
+                    ++m_stats.variantHits;
+                    if (i != 0) std::rotate(m_variants.begin(), m_variants.begin() + i, m_variants.begin() + i + 1);
+                    return m_variants.front();
+                }
+            }
+            ++m_stats.variantBuilds;
+            if (m_variants.size() >= m_maxVariants) m_variants.pop_back();
+            m_variants.insert(m_variants.begin(), Surface());
+            Surface& out = m_variants.front();
+            out.Allocate(width, height);
+            const Surface& level = Level(source, LevelFor(source, width, height));
+            Resample::Bilinear(level, level.Bounds(), out);
+            return out;
+        }
+
+        // 尺寸不小于目标的最小一级（0 为原图）
+        int LevelFor(const Surface& source, int width, int height) const {
+            int level = 0, w = source.Width(), h = source.Height();
+            while (w / 2 >= width && h / 2 >= height && w > 1 && h > 1) {
+                w /= 2; h /= 2;
+                ++level;
+            }
+            return level;
+        }
+
+        // 第 level 级，按需生成
+        const Surface& Level(const Surface& source, int level) {
+            if (level <= 0) return source;
+            while (int(m_levels.size()) < level) {
+                const Surface& prev = m_levels.empty() ? source : m_levels.back();
+                Surface next;
+                Resample::Downsample2x(prev, next);
+                m_levels.push_back(std::move(next));
+                ++m_stats.levelsBuilt;
+            }
+            return m_levels[level - 1];
+        }
+
+        void Invalidate() {
+            m_levels.clear();
+            m_variants.clear();
+        }
+
+        // 只丢弃缩放结果（保留 mip 级）
+        void ClearVariants() { m_variants.clear(); }
+
+        size_t LevelCount() const { return m_levels.size(); }
+
+        size_t ByteSize() const {
+            size_t bytes = 0;
+            for (const Surface& s : m_levels) bytes += size_t(s.Stride()) * s.Height();
+            for (const Surface& s : m_variants) bytes += size_t(s.Stride()) * s.Height();
+            return bytes;
+        }
+
+        const Stats& GetStats() const { return m_stats; }
+
+    private:
+        std::vector<Surface> m_levels;      // 第1级起
+        std::vector<Surface> m_variants;    // 目标尺寸的缩放结果，最近使用的在前
+        size_t m_maxVariants;
+        Stats m_stats;
+    };
+}
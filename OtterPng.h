@@ -0,0 +1,549 @@
+#pragma once
+// OtterPng.h
+// 最小PNG编解码：编码为8位RGBA（逐行选择滤波方式，LZ77+固定霍夫曼压缩），
+// 解码支持非隔行的8位灰度/灰度透明/RGB/RGBA/调色板图像。像素在预乘BGRA表面与非预乘RGBA之间转换。不依赖Windows
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "OtterRaster.h"
+
+namespace OtterRaster {
+    namespace Png {
+
+        inline uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+            static const auto table = [] {
+                std::vector<uint32_t> t(256);
+                for (uint32_t n = 0; n < 256; ++n) {
+                    uint32_t c = n;
+                    for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    t[n] = c;
+                }
+                return t;
+            }();
+            crc = ~crc;
+            for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return ~crc;
+        }
+
+        inline uint32_t Adler32(const uint8_t* data, size_t size) {
+            uint32_t a = 1, b = 0;
+            while (size > 0) {
+                const size_t n = (std::min)(size, size_t(5552));    // 5552 字节内不会溢出
+                for (size_t i = 0; i < n; ++i) {
+                    a += data[i];
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+                data += n;
+                size -= n;
+            }
+            return (b << 16) | a;
+        }
+
+        namespace Detail {
+
+            constexpr uint16_t kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+            constexpr uint8_t kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+            constexpr uint16_t kDistBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+            constexpr uint8_t kDistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+            // 低位在前的位写入器；霍夫曼码按高位在前写入，需先反转
+            class BitWriter {
+            public:
+                explicit BitWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+                void Bits(uint32_t value, int count) {
+                    m_acc |= uint64_t(value) << m_count;
+                    m_count += count;
+                    while (m_count >= 8) {
+                        m_out.push_back(uint8_t(m_acc));
+                        m_acc >>= 8;
+                        m_count -= 8;
+                    }
+                }
+
+                void Code(uint32_t code, int length) {
+                    uint32_t reversed = 0;
+                    for (int i = 0; i < length; ++i) reversed |= ((code >> i) & 1) << (length - 1 - i);
+                    Bits(reversed, length);
+                }
+
+                void Flush() {
+                    if (m_count > 0) m_out.push_back(uint8_t(m_acc));
+                    m_acc = 0;
+                    m_count = 0;
+                }
+
+            private:
+                std::vector<uint8_t>& m_out;
+                uint64_t m_acc = 0;
+                int m_count = 0;
+            };
+
+            inline void FixedLiteral(BitWriter& w, int symbol) {
+                if (symbol < 144) w.Code(0x30 + symbol, 8);
+                else if (symbol < 256) w.Code(0x190 + symbol - 144, 9);
+                else if (symbol < 280) w.Code(symbol - 256, 7);
+                else w.Code(0xC0 + symbol - 280, 8);
+            }
+
+            inline void FixedMatch(BitWriter& w, int length, int distance) {
+                int lc = 28;
+                while (kLengthBase[lc] > length) --lc;
+                FixedLiteral(w, 257 + lc);
+                w.Bits(uint32_t(length - kLengthBase[lc]), kLengthExtra[lc]);
+                int dc = 29;
+                while (kDistBase[dc] > distance) --dc;
+                w.Code(uint32_t(dc), 5);
+                w.Bits(uint32_t(distance - kDistBase[dc]), kDistExtra[dc]);
+            }
+
+            // 单个固定霍夫曼块；哈希链查找最长匹配（32KB窗口，链长有限）
+            inline void Deflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+                constexpr int kHashBits = 15, kWindow = 32768, kMaxChain = 32, kMinMatch = 3, kMaxMatch = 258;
+                std::vector<int32_t> head(size_t(1) << kHashBits, -1), prev(kWindow, -1);
+                auto hash = [&](size_t i) {
+                    const uint32_t v = uint32_t(data[i]) | (uint32_t(data[i + 1]) << 8) | (uint32_t(data[i + 2]) << 16);
+                    return (v * 2654435761u) >> (32 - kHashBits);
+                };
+                auto insert = [&](size_t i) {
+                    if (i + kMinMatch > size) return;
+                    const uint32_t h = hash(i);
+                    prev[i & (kWindow - 1)] = head[h];
+                    head[h] = int32_t(i);
+                };
+
+                BitWriter w(out);
+                w.Bits(1, 1);       // BFINAL
+                w.Bits(1, 2);       // 固定霍夫曼
+                size_t i = 0;
+                while (i < size) {
+                    int bestLength = 0, bestDistance = 0;
+                    if (i + kMinMatch <= size) {
+                        const size_t limit = (std::min)(size - i, size_t(kMaxMatch));
+                        int32_t candidate = head[hash(i)];
+                        for (int chain = 0; candidate >= 0 && chain < kMaxChain; ++chain) {
+                            const size_t distance = i - size_t(candidate);
+                            if (distance > size_t(kWindow - 1)) break;
+                            if (data[candidate + bestLength] == data[i + bestLength]) {
+                                size_t length = 0;
+                                while (length < limit && data[candidate + length] == data[i + length]) ++length;
+                                if (int(length) > bestLength) {
+                                    bestLength = int(length);
+                                    bestDistance = int(distance);
+                                    if (length == limit) break;
+                                }
+                            }
+                            candidate = prev[size_t(candidate) & (kWindow - 1)];
+                        }
+                    }
+                    if (bestLength >= kMinMatch) {
+                        FixedMatch(w, bestLength, bestDistance);
+                        for (int k = 0; k < bestLength; ++k) insert(i + k);
+                        i += size_t(bestLength);
+                    }
+                    else {
+                        FixedLiteral(w, data[i]);
+                        insert(i);
+                        ++i;
+                    }
+                }
+                FixedLiteral(w, 256);
+                w.Flush();
+            }
+
+            // 规范霍夫曼表：按码长计数与按码排序的符号，逐位解码
+            struct Huffman {
+                uint16_t counts[16] = {};
+                uint16_t symbols[320] = {};
+
+                bool Build(const uint8_t* lengths, int n) {
+                    std::memset(counts, 0, sizeof(counts));
+                    for (int i = 0; i < n; ++i) ++counts[lengths[i]];
+                    counts[0] = 0;
+                    int left = 1;
+                    for (int len = 1; len < 16; ++len) {
+                        left = (left << 1) - counts[len];
+                        if (left < 0) return false;     // 超额订阅
+                    }
+                    uint16_t offsets[16] = {};
+                    for (int len = 1; len < 15; ++len) offsets[len + 1] = uint16_t(offsets[len] + counts[len]);
+                    for (int i = 0; i < n; ++i) {
+                        if (lengths[i]) symbols[offsets[lengths[i]]++] = uint16_t(i);
+                    }
+                    return true;
+                }
+            };
+
+            class Inflater {
+            public:
+                Inflater(const uint8_t* data, size_t size, std::vector<uint8_t>& out) : m_in(data), m_size(size), m_out(out) {}
+
+                bool Run() {
+                    int last = 0;
+                    do {
+                        int type = 0;
+                        if (!Need(1, last) || !Need(2, type)) return false;
+                        bool ok = false;
+                        if (type == 0) ok = Stored();
+                        else if (type == 1) ok = Fixed();
+                        else if (type == 2) ok = Dynamic();
+                        if (!ok) return false;
+                    } while (!last);
+                    return true;
+                }
+
+            private:
+                bool Need(int count, int& value) {
+                    uint32_t v = m_acc;
+                    while (m_count < count) {
+                        if (m_pos >= m_size) return false;
+                        v |= uint32_t(m_in[m_pos++]) << m_count;
+                        m_count += 8;
+                    }
+                    value = int(v & ((1u << count) - 1));
+                    m_acc = v >> count;
+                    m_count -= count;
+                    return true;
+                }
+
+                int Decode(const Huffman& h) {
+                    int code = 0, first = 0, index = 0;
+                    for (int len = 1; len < 16; ++len) {
+                        int bit = 0;
+                        if (!Need(1, bit)) return -1;
+                        code |= bit;
+                        const int count = h.counts[len];
+                        if (code - count < first) return h.symbols[index + (code - first)];
+                        index += count;
+                        first = (first + count) << 1;
+                        code <<= 1;
+                    }
+                    return -1;
+                }
+
+                bool Stored() {
+                    m_acc = 0;
+                    m_count = 0;        // 丢弃到字节边界
+                    if (m_pos + 4 > m_size) return false;
+                    const size_t len = size_t(m_in[m_pos]) | (size_t(m_in[m_pos + 1]) << 8);
+                    const size_t nlen = size_t(m_in[m_pos + 2]) | (size_t(m_in[m_pos + 3]) << 8);
+                    m_pos += 4;
+                    if (len != (~nlen & 0xFFFF) || m_pos + len > m_size) return false;
+                    m_out.insert(m_out.end(), m_in + m_pos, m_in + m_pos + len);
+                    m_pos += len;
+                    return true;
+                }
+
+                bool Codes(const Huffman& lit, const Huffman& dist) {
+                    for (;;) {
+                        int symbol = Decode(lit);
+                        if (symbol < 0) return false;
+                        if (symbol < 256) {
+                            m_out.push_back(uint8_t(symbol));
+                            continue;
+                        }
+                        if (symbol == 256) return true;
+                        symbol -= 257;
+                        if (symbol >= 29) return false;
+                        int extra = 0;
+                        if (!Need(kLengthExtra[symbol], extra)) return false;
+                        const size_t length = size_t(kLengthBase[symbol] + extra);
+                        const int dc = Decode(dist);
+                        if (dc < 0 || dc >= 30 || !Need(kDistExtra[dc], extra)) return false;
+                        const size_t distance = size_t(kDistBase[dc] + extra);
+                        if (distance > m_out.size()) return false;
+                        const size_t from = m_out.size() - distance;
+                        for (size_t k = 0; k < length; ++k) m_out.push_back(m_out[from + k]);    // 可与输出重叠
+                    }
+                }
+
+                bool Fixed() {
+                    uint8_t lengths[288];
+                    for (int i = 0; i < 144; ++i) lengths[i] = 8;
+                    for (int i = 144; i < 256; ++i) lengths[i] = 9;
+                    for (int i = 256; i < 280; ++i) lengths[i] = 7;
+                    for (int i = 280; i < 288; ++i) lengths[i] = 8;
+                    Huffman lit, dist;
+                    lit.Build(lengths, 288);
+                    std::memset(lengths, 5, 30);
+                    dist.Build(lengths, 30);
+                    return Codes(lit, dist);
+                }
+
+                bool Dynamic() {
+                    static constexpr uint8_t kOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+                    int nlen = 0, ndist = 0, ncode = 0;
+                    if (!Need(5, nlen) || !Need(5, ndist) || !Need(4, ncode)) return false;
+                    nlen += 257;
+                    ndist += 1;
+                    ncode += 4;
+                    if (nlen > 286 || ndist > 30) return false;
+
+                    uint8_t lengths[320] = {};
+                    for (int i = 0; i < ncode; ++i) {
+                        int v = 0;
+                        if (!Need(3, v)) return false;
+                        lengths[kOrder[i]] = uint8_t(v);
+                    }
+                    Huffman lencode;
+                    if (!lencode.Build(lengths, 19)) return false;
+
+                    int index = 0;
+                    std::memset(lengths, 0, sizeof(lengths));
+                    while (index < nlen + ndist) {
+                        int symbol = Decode(lencode);
+                        if (symbol < 0) return false;
+                        if (symbol < 16) {
+                            lengths[index++] = uint8_t(symbol);
+                            continue;
+                        }
+                        int repeat = 0, value = 0;
+                        if (symbol == 16) {
+                            if (index == 0 || !Need(2, repeat)) return false;
+                            value = lengths[index - 1];
+                            repeat += 3;
+                        }
+                        else if (symbol == 17) {
+                            if (!Need(3, repeat)) return false;
+                            repeat += 3;
+                        }
+                        else {
+                            if (!Need(7, repeat)) return false;
+                            repeat += 11;
+                        }
+                        if (index + repeat > nlen + ndist) return false;
+                        while (repeat--) lengths[index++] = uint8_t(value);
+                    }
+                    if (lengths[256] == 0) return false;
+
+                    Huffman lit, dist;
+                    if (!lit.Build(lengths, nlen) || !dist.Build(lengths + nlen, ndist)) return false;
+                    return Codes(lit, dist);
+                }
+
+                const uint8_t* m_in;
+                size_t m_size;
+                size_t m_pos = 0;
+                uint32_t m_acc = 0;
+                int m_count = 0;
+                std::vector<uint8_t>& m_out;
+            };
+
+            inline void PutU32(std::vector<uint8_t>& out, uint32_t v) {
+                out.push_back(uint8_t(v >> 24));
+                out.push_back(uint8_t(v >> 16));
+                out.push_back(uint8_t(v >> 8));
+                out.push_back(uint8_t(v));
+            }
+
+            inline uint32_t GetU32(const uint8_t* p) {
+                return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+            }
+
+            inline void Chunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t size) {
+                PutU32(out, uint32_t(size));
+                const size_t start = out.size();
+                out.insert(out.end(), type, type + 4);
+                if (size) out.insert(out.end(), data, data + size);
+                PutU32(out, Crc32(out.data() + start, size + 4));
+            }
+
+            inline int Paeth(int a, int b, int c) {
+                const int p = a + b - c;
+                const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+                if (pa <= pb && pa <= pc) return a;
+                return pb <= pc ? b : c;
+            }
+
+            // 对一行应用滤波方式 type，prior 为上一行（首行为全零）
+            inline void FilterRow(int type, const uint8_t* row, const uint8_t* prior, size_t bytes, int bpp, uint8_t* out) {
+                for (size_t i = 0; i < bytes; ++i) {
+                    const int a = i >= size_t(bpp) ? row[i - bpp] : 0;
+                    const int b = prior[i];
+                    const int c = i >= size_t(bpp) ? prior[i - bpp] : 0;
+                    int predicted = 0;
+                    switch (type) {
+                    case 1: predicted = a; break;
+                    case 2: predicted = b; break;
+                    case 3: predicted = (a + b) >> 1; break;
+                    case 4: predicted = Paeth(a, b, c); break;
+                    default: break;
+                    }
+                    out[i] = uint8_t(row[i] - predicted);
+                }
+            }
+        }
+
+        // 编码为8位RGBA PNG（非预乘）；每行选绝对值和最小的滤波方式
+        inline bool Encode(const Surface& surface, std::vector<uint8_t>& out) {
+            out.clear();
+            if (!surface.Valid()) return false;
+            const int w = surface.Width(), h = surface.Height();
+            const size_t rowBytes = size_t(w) * 4;
+
+            std::vector<uint8_t> filtered;
+            filtered.reserve((rowBytes + 1) * size_t(h));
+            std::vector<uint8_t> prior(rowBytes, 0), row(rowBytes), candidate(rowBytes), best(rowBytes);
+            for (int y = 0; y < h; ++y) {
+                const uint32_t* src = surface.Row(y);
+                for (int x = 0; x < w; ++x) {
+                    const Color c = Unpremultiply(src[x]);
+                    uint8_t* p = &row[size_t(x) * 4];
+                    p[0] = c.r; p[1] = c.g; p[2] = c.b; p[3] = c.a;
+                }
+                long long bestScore = -1;
+                int bestType = 0;
+                for (int type = 0; type < 5; ++type) {
+                    Detail::FilterRow(type, row.data(), prior.data(), rowBytes, 4, candidate.data());
+                    long long score = 0;
+                    for (uint8_t v : candidate) score += v < 128 ? v : 256 - v;
+                    if (bestScore < 0 || score < bestScore) {
+                        bestScore = score;
+                        bestType = type;
+                        best.swap(candidate);
+                    }
+                }
+                filtered.push_back(uint8_t(bestType));
+                filtered.insert(filtered.end(), best.begin(), best.end());
+                prior.swap(row);
+            }
+
+            std::vector<uint8_t> zlib = { 0x78, 0x01 };
+            Detail::Deflate(filtered.data(), filtered.size(), zlib);
+            Detail::PutU32(zlib, Adler32(filtered.data(), filtered.size()));
+
+            static const uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            out.assign(kSignature, kSignature + 8);
+            std::vector<uint8_t> ihdr;
+            Detail::PutU32(ihdr, uint32_t(w));
+            Detail::PutU32(ihdr, uint32_t(h));
+            ihdr.insert(ihdr.end(), { 8, 6, 0, 0, 0 });      // 8位、RGBA、deflate、自适应滤波、非隔行
+            Detail::Chunk(out, "IHDR", ihdr.data(), ihdr.size());
+            Detail::Chunk(out, "IDAT", zlib.data(), zlib.size());
+            Detail::Chunk(out, "IEND", nullptr, 0);
+            return true;
+        }
+
+        // 解码为预乘BGRA表面；不支持的格式（16位、低于8位、隔行）返回 false
+        inline bool Decode(const uint8_t* data, size_t size, Surface& out) {
+            static const uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            if (size < 8 || std::memcmp(data, kSignature, 8) != 0) return false;
+
+            int w = 0, h = 0, colorType = -1;
+            std::vector<uint8_t> idat, palette, paletteAlpha;
+            bool ended = false;
+            for (size_t pos = 8; pos + 12 <= size && !ended;) {
+                const size_t length = Detail::GetU32(data + pos);
+                if (length > size - pos - 12) return false;
+                const uint8_t* type = data + pos + 4;
+                const uint8_t* body = data + pos + 8;
+                if (Crc32(type, length + 4) != Detail::GetU32(body + length)) return false;
+                if (std::memcmp(type, "IHDR", 4) == 0) {
+                    if (length < 13) return false;
+                    w = int(Detail::GetU32(body));
+                    h = int(Detail::GetU32(body + 4));
+                    colorType = body[9];
+                    if (body[8] != 8 || body[10] != 0 || body[11] != 0 || body[12] != 0) return false;
+                    if (w <= 0 || h <= 0 || w > (1 << 15) || h > (1 << 15)) return false;
+                }
+                else if (std::memcmp(type, "PLTE", 4) == 0) palette.assign(body, body + length);
+                else if (std::memcmp(type, "tRNS", 4) == 0) paletteAlpha.assign(body, body + length);
+                else if (std::memcmp(type, "IDAT", 4) == 0) idat.insert(idat.end(), body, body + length);
+                else if (std::memcmp(type, "IEND", 4) == 0) ended = true;
+                pos += length + 12;
+            }
+
+            int channels = 0;
+            switch (colorType) {
+            case 0: channels = 1; break;
+            case 2: channels = 3; break;
+            case 3: channels = 1; break;
+            case 4: channels = 2; break;
+            case 6: channels = 4; break;
+            default: return false;
+            }
+            if (colorType == 3 && palette.size() < 3) return false;
+            if (idat.size() < 6 || (idat[0] & 0x0F) != 8 || (idat[1] & 0x20) != 0 || ((idat[0] << 8) | idat[1]) % 31 != 0) return false;
+
+            std::vector<uint8_t> raw;
+            const size_t rowBytes = size_t(w) * channels;
+            raw.reserve((rowBytes + 1) * size_t(h));
+            Detail::Inflater inflater(idat.data() + 2, idat.size() - 6, raw);
+            if (!inflater.Run() || raw.size() < (rowBytes + 1) * size_t(h)) return false;
+            if (Adler32(raw.data(), (rowBytes + 1) * size_t(h)) != Detail::GetU32(idat.data() + idat.size() - 4)) return false;
+
+            out.Allocate(w, h);
+            std::vector<uint8_t> prior(rowBytes, 0), row(rowBytes);
+            for (int y = 0; y < h; ++y) {
+                const uint8_t* line = raw.data() + size_t(y) * (rowBytes + 1);
+                const int filter = line[0];
+                if (filter > 4) return false;
+                for (size_t i = 0; i < rowBytes; ++i) {
+                    const int a = i >= size_t(channels) ? row[i - channels] : 0;
+                    const int b = prior[i];
+                    const int c = i >= size_t(channels) ? prior[i - channels] : 0;
+                    int predicted = 0;
+                    switch (filter) {
+                    case 1: predicted = a; break;
+                    case 2: predicted = b; break;
+                    case 3: predicted = (a + b) >> 1; break;
+                    case 4: predicted = Detail::Paeth(a, b, c); break;
+                    default: break;
+                    }
+                    row[i] = uint8_t(line[1 + i] + predicted);
+                }
+                uint32_t* dst = out.Row(y);
+                for (int x = 0; x < w; ++x) {
+                    const uint8_t* p = &row[size_t(x) * channels];
+                    Color color;
+                    switch (colorType) {
+                    case 0: color = Color(p[0], p[0], p[0]); break;
+                    case 2: color = Color(p[0], p[1], p[2]); break;
+                    case 3: {
+                        const size_t index = p[0];
+                        if (index * 3 + 2 >= palette.size()) return false;
+                        color = Color(index < paletteAlpha.size() ? paletteAlpha[index] : 255,
+                            palette[index * 3], palette[index * 3 + 1], palette[index * 3 + 2]);
+                        break;
+                    }
+                    case 4: color = Color(p[1], p[0], p[0], p[0]); break;
+                    default: color = Color(p[3], p[0], p[1], p[2]); break;
+                    }
+                    dst[x] = Premultiply(color);
+                }
+                prior.swap(row);
+            }
+            return true;
+        }
+
+        inline bool Save(const std::string& path, const Surface& surface) {
+            std::vector<uint8_t> bytes;
+            if (!Encode(surface, bytes)) return false;
+            FILE* file = std::fopen(path.c_str(), "wb");
+            if (!file) return false;
+            const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+            return std::fclose(file) == 0 && ok;
+        }
+
+        inline bool Load(const std::string& path, Surface& out) {
+            FILE* file = std::fopen(path.c_str(), "rb");
+            if (!file) return false;
+            std::vector<uint8_t> bytes;
+            uint8_t buffer[65536];
+            size_t n;
+            while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) bytes.insert(bytes.end(), buffer, buffer + n);
+            std::fclose(file);
+            return Decode(bytes.data(), bytes.size(), out);
+        }
+    }
+}
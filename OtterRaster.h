@@ -0,0 +1,2375 @@
+#pragma once
+// OtterRaster.h
+// 可移植CPU光栅化后端：32位预乘BGRA表面、SIMD扫描线混合、解析式抗锯齿
+// 不依赖Windows，可在Linux无头环境下绘制、计时与逐像素比较
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "OtterSimd.h"
+#include "OtterFontData.h"
+#include "OtterLruCache.h"
+
+namespace OtterRaster {
+
+    // 非预乘颜色，参数顺序与 Gdiplus::Color(a, r, g, b) 一致
+    struct Color {
+        uint8_t a = 255, r = 0, g = 0, b = 0;
+
+        Color() = default;
+        Color(uint8_t r_, uint8_t g_, uint8_t b_) : a(255), r(r_), g(g_), b(b_) {}
+        Color(uint8_t a_, uint8_t r_, uint8_t g_, uint8_t b_) : a(a_), r(r_), g(g_), b(b_) {}
+
+        static Color FromArgb(uint32_t argb) {
+            return Color(uint8_t(argb >> 24), uint8_t(argb >> 16), uint8_t(argb >> 8), uint8_t(argb));
+        }
+    };
+
+    // x*y/255 四舍五入，与SIMD路径结果逐位一致
+    inline uint32_t MulDiv255(uint32_t x, uint32_t y) {
+        uint32_t t = x * y + 128;
+        return (t + (t >> 8)) >> 8;
+    }
+
+    // 预乘后的像素值（内存顺序 B,G,R,A，与Windows 32位DIB/PARGB一致）
+    inline uint32_t Premultiply(Color c) {
+        uint32_t a = c.a;
+        return (a << 24) | (MulDiv255(c.r, a) << 16) | (MulDiv255(c.g, a) << 8) | MulDiv255(c.b, a);
+    }
+
+    // 预乘像素还原为非预乘颜色
+    inline Color Unpremultiply(uint32_t p) {
+        uint32_t a = p >> 24;
+        if (a == 0) return Color(0, 0, 0, 0);
+        auto un = [a](uint32_t v) { return uint8_t((std::min)(255u, (v * 255 + a / 2) / a)); };
+        return Color(uint8_t(a), un((p >> 16) & 0xFF), un((p >> 8) & 0xFF), un(p & 0xFF));
+    }
+
+    struct Point {
+        int X = 0, Y = 0;
+        Point() = default;
+        Point(int x, int y) : X(x), Y(y) {}
+    };
+
+    struct PointF {
+        float X = 0, Y = 0;
+        PointF() = default;
+        PointF(float x, float y) : X(x), Y(y) {}
+    };
+
+    // 整数矩形，右下为开区间
+    struct Rect {
+        int x = 0, y = 0, w = 0, h = 0;
+
+        Rect() = default;
+        Rect(int x_, int y_, int w_, int h_) : x(x_), y(y_), w(w_), h(h_) {}
+
+        int Right() const { return x + w; }
+        int Bottom() const { return y + h; }
+        bool IsEmpty() const { return w <= 0 || h <= 0; }
+        long long Area() const { return IsEmpty() ? 0 : (long long)w * h; }
+
+        bool Contains(const Rect& o) const {
+            return o.x >= x && o.y >= y && o.Right() <= Right() && o.Bottom() <= Bottom();
+        }
+
+        Rect Intersect(const Rect& o) const {
+            int x0 = (std::max)(x, o.x), y0 = (std::max)(y, o.y);
+            int x1 = (std::min)(Right(), o.Right()), y1 = (std::min)(Bottom(), o.Bottom());
+            if (x1 <= x0 || y1 <= y0) return Rect();
+            return Rect(x0, y0, x1 - x0, y1 - y0);
+        }
+
+        Rect Union(const Rect& o) const {
+            if (IsEmpty()) return o;
+            if (o.IsEmpty()) return *this;
+            int x0 = (std::min)(x, o.x), y0 = (std::min)(y, o.y);
+            int x1 = (std::max)(Right(), o.Right()), y1 = (std::max)(Bottom(), o.Bottom());
+            return Rect(x0, y0, x1 - x0, y1 - y0);
+        }
+
+        bool operator==(const Rect& o) const { return x == o.x && y == o.y && w == o.w && h == o.h; }
+        bool operator!=(const Rect& o) const { return !(*this == o); }
+    };
+
+    // 32位预乘像素表面：可自有（行按64字节对齐）或包装外部内存（如DIB位图）
+    class Surface {
+    public:
+        static constexpr int kRowAlign = 64;
+
+        Surface() = default;
+
+        Surface(int width, int height) { Allocate(width, height); }
+
+        // 包装外部像素，stride 为字节数
+        static Surface Wrap(void* pixels, int width, int height, int stride) {
+            Surface s;
+            s.m_pixels = static_cast<uint8_t*>(pixels);
+            s.m_width = width;
+            s.m_height = height;
+            s.m_stride = stride;
+            return s;
+        }
+
+        Surface(Surface&& o) noexcept { *this = std::move(o); }
+        Surface& operator=(Surface&& o) noexcept {
+            if (this != &o) {
+                m_storage = std::move(o.m_storage);
+                m_pixels = o.m_pixels;
+                m_width = o.m_width;
+                m_height = o.m_height;
+                m_stride = o.m_stride;
+                o.m_pixels = nullptr;
+                o.m_width = o.m_height = o.m_stride = 0;
+            }
+            return *this;
+        }
+        Surface(const Surface&) = delete;
+        Surface& operator=(const Surface&) = delete;
+
+        void Allocate(int width, int height) {
+            width = (std::max)(width, 0);
+            height = (std::max)(height, 0);
+            int stride = ((width * 4 + kRowAlign - 1) / kRowAlign) * kRowAlign;
+            size_t bytes = size_t(stride) * height + kRowAlign;
+            m_storage.reset(new uint8_t[bytes]);
+            uintptr_t p = reinterpret_cast<uintptr_t>(m_storage.get());
+            m_pixels = reinterpret_cast<uint8_t*>((p + kRowAlign - 1) & ~uintptr_t(kRowAlign - 1));
+            m_width = width;
+            m_height = height;
+            m_stride = stride;
+            std::memset(m_pixels, 0, size_t(stride) * height);
+        }
+
+        bool Valid() const { return m_pixels != nullptr && m_width > 0 && m_height > 0; }
+        bool OwnsPixels() const { return m_storage != nullptr; }
+        int Width() const { return m_width; }
+        int Height() const { return m_height; }
+        int Stride() const { return m_stride; }
+        Rect Bounds() const { return Rect(0, 0, m_width, m_height); }
+        uint8_t* Data() { return m_pixels; }
+        const uint8_t* Data() const { return m_pixels; }
+
+        uint32_t* Row(int y) { return reinterpret_cast<uint32_t*>(m_pixels + size_t(y) * m_stride); }
+        const uint32_t* Row(int y) const { return reinterpret_cast<const uint32_t*>(m_pixels + size_t(y) * m_stride); }
+        uint32_t Pixel(int x, int y) const { return Row(y)[x]; }
+
+    private:
+        std::unique_ptr<uint8_t[]> m_storage;
+        uint8_t* m_pixels = nullptr;
+        int m_width = 0, m_height = 0, m_stride = 0;
+    };
+
+    // 扫描线内核：dst 为预乘像素，color 为预乘颜色
+    namespace Span {
+
+#if OTTER_HAS_SSE2
+        inline __m128i Div255(__m128i x) {
+            x = _mm_add_epi16(x, _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+        }
+
+        inline __m128i AlphaOf(__m128i px16) {
+            return _mm_shufflehi_epi16(_mm_shufflelo_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        }
+
+        // 两个像素（16位通道）source-over：src + dst * (255 - srcA) / 255
+        inline __m128i Over16(__m128i dst16, __m128i src16) {
+            __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), AlphaOf(src16));
+            return _mm_add_epi16(src16, Div255(_mm_mullo_epi16(dst16, inv)));
+        }
+#endif
+
+        inline uint32_t OverPixel(uint32_t d, uint32_t s) {
+            uint32_t inv = 255 - (s >> 24);
+            uint32_t b = (s & 0xFF) + MulDiv255(d & 0xFF, inv);
+            uint32_t g = ((s >> 8) & 0xFF) + MulDiv255((d >> 8) & 0xFF, inv);
+            uint32_t r = ((s >> 16) & 0xFF) + MulDiv255((d >> 16) & 0xFF, inv);
+            uint32_t a = (s >> 24) + MulDiv255(d >> 24, inv);
+            return (a << 24) | (r << 16) | (g << 8) | b;
+        }
+
+        inline uint32_t ScalePixel(uint32_t s, uint32_t k) {
+            return (MulDiv255(s >> 24, k) << 24) | (MulDiv255((s >> 16) & 0xFF, k) << 16)
+                | (MulDiv255((s >> 8) & 0xFF, k) << 8) | MulDiv255(s & 0xFF, k);
+        }
+
+        // 直接写入
+        inline void Fill(uint32_t* dst, int count, uint32_t color) {
+            int i = 0;
+#if OTTER_HAS_SSE2
+            const __m128i c = _mm_set1_epi32(static_cast<int>(color));
+            for (; i + 4 <= count; i += 4) _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), c);
+#endif
+            for (; i < count; ++i) dst[i] = color;
+        }
+
+        // 常量颜色 source-over
+        inline void FillOver(uint32_t* dst, int count, uint32_t color) {
+            if ((color >> 24) == 255) { Fill(dst, count, color); return; }
+            if (color == 0) return;
+            int i = 0;
+#if OTTER_HAS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i src16 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero);
+            for (; i + 4 <= count; i += 4) {
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                __m128i lo = Over16(_mm_unpacklo_epi8(d, zero), src16);
+                __m128i hi = Over16(_mm_unpackhi_epi8(d, zero), src16);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+#endif
+            for (; i < count; ++i) dst[i] = OverPixel(dst[i], color);
+        }
+
+        // 按覆盖率掩码混合常量颜色
+        inline void MaskOver(uint32_t* dst, const uint8_t* mask, int count, uint32_t color) {
+            int i = 0;
+#if OTTER_HAS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i c16 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero);
+            for (; i + 4 <= count; i += 4) {
+                uint32_t m4;
+                std::memcpy(&m4, mask + i, 4);
+                if (m4 == 0) continue;
+                __m128i m = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(m4)), zero);
+                m = _mm_unpacklo_epi16(m, m);
+                __m128i mlo = _mm_unpacklo_epi32(m, m);
+                __m128i mhi = _mm_unpackhi_epi32(m, m);
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                __m128i lo = Over16(_mm_unpacklo_epi8(d, zero), Div255(_mm_mullo_epi16(c16, mlo)));
+                __m128i hi = Over16(_mm_unpackhi_epi8(d, zero), Div255(_mm_mullo_epi16(c16, mhi)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+#endif
+            for (; i < count; ++i) {
+                if (mask[i]) dst[i] = OverPixel(dst[i], ScalePixel(color, mask[i]));
+            }
+        }
+
+        // 预乘像素行 source-over：dst = src + dst * (1 - srcA)
+        inline void BlendOver(uint32_t* dst, const uint32_t* src, int count) {
+            int i = 0;
+#if OTTER_HAS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 4 <= count; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                int alpha = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_srli_epi32(s, 24), zero)) & 0x1111;
+                if (alpha == 0x1111) continue;                  // 4个像素全透明
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                __m128i lo = Over16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero));
+                __m128i hi = Over16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+#endif
+            for (; i < count; ++i) {
+                uint32_t a = src[i] >> 24;
+                if (a == 255) dst[i] = src[i];
+                else if (src[i] != 0) dst[i] = OverPixel(dst[i], src[i]);
+            }
+        }
+
+        // 预乘像素行按覆盖率掩码 source-over：dst = src*m + dst * (1 - srcA*m)
+        inline void MaskBlendOver(uint32_t* dst, const uint32_t* src, const uint8_t* mask, int count) {
+            int i = 0;
+#if OTTER_HAS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 4 <= count; i += 4) {
+                uint32_t m4;
+                std::memcpy(&m4, mask + i, 4);
+                if (m4 == 0) continue;
+                __m128i m = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(m4)), zero);
+                m = _mm_unpacklo_epi16(m, m);
+                __m128i mlo = _mm_unpacklo_epi32(m, m);
+                __m128i mhi = _mm_unpackhi_epi32(m, m);
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                __m128i lo = Over16(_mm_unpacklo_epi8(d, zero), Div255(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), mlo)));
+                __m128i hi = Over16(_mm_unpackhi_epi8(d, zero), Div255(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), mhi)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+#endif
+            for (; i < count; ++i) {
+                if (mask[i]) dst[i] = OverPixel(dst[i], ScalePixel(src[i], mask[i]));
+            }
+        }
+
+        // 覆盖率行写入：全覆盖段走 FillOver，部分覆盖段走 MaskOver
+        inline void CoverageOver(uint32_t* dst, const uint8_t* cov, int count, uint32_t color) {
+            int i = 0;
+            while (i < count) {
+                uint8_t c = cov[i];
+                int j = i + 1;
+                if (c == 0) {
+                    while (j < count && cov[j] == 0) ++j;
+                }
+                else if (c == 255) {
+                    while (j < count && cov[j] == 255) ++j;
+                    FillOver(dst + i, j - i, color);
+                }
+                else {
+                    while (j < count && cov[j] != 0 && cov[j] != 255) ++j;
+                    MaskOver(dst + i, cov + i, j - i, color);
+                }
+                i = j;
+            }
+        }
+    }
+
+    enum class FillRule { NonZero, EvenOdd };
+
+    // 浮点路径：由 MoveTo/LineTo/QuadTo/CubicTo/Close 组成的若干子路径，填充时未闭合的子路径自动闭合
+    class Path {
+    public:
+        enum class Verb : uint8_t { Move, Line, Quad, Cubic, Close };
+
+        static constexpr float kDefaultTolerance = 0.2f;    // 曲线展平的最大偏差（像素）
+
+        // 每个路径对象有唯一标识，复制得到新标识；内容每次修改版本号加一。
+        // (Id, Version) 相同即内容相同，用作描边缓存等的键
+        Path() : m_id(NextId()) {}
+
+        Path(const Path& other)
+            : m_verbs(other.m_verbs), m_points(other.m_points), m_start(other.m_start),
+            m_pendingMove(other.m_pendingMove), m_id(NextId()), m_version(other.m_version) {}
+
+        Path(Path&& other) noexcept
+            : m_verbs(std::move(other.m_verbs)), m_points(std::move(other.m_points)), m_start(other.m_start),
+            m_pendingMove(other.m_pendingMove), m_id(other.m_id), m_version(other.m_version) {
+            other.Reset();
+            other.m_id = NextId();
+        }
+
+        Path& operator=(const Path& other) {
+            if (this != &other) {
+                m_verbs = other.m_verbs;
+                m_points = other.m_points;
+                m_start = other.m_start;
+                m_pendingMove = other.m_pendingMove;
+                m_id = NextId();
+                m_version = other.m_version;
+            }
+            return *this;
+        }
+
+        Path& operator=(Path&& other) noexcept {
+            if (this != &other) {
+                m_verbs = std::move(other.m_verbs);
+                m_points = std::move(other.m_points);
+                m_start = other.m_start;
+                m_pendingMove = other.m_pendingMove;
+                m_id = other.m_id;
+                m_version = other.m_version;
+                other.Reset();
+                other.m_id = NextId();
+            }
+            return *this;
+        }
+
+        uint64_t Id() const { return m_id; }
+        uint64_t Version() const { return m_version; }
+
+        void MoveTo(float x, float y) {
+            ++m_version;
+            m_verbs.push_back(Verb::Move);
+            m_points.push_back(PointF(x, y));
+            m_start = m_points.size() - 1;
+            m_pendingMove = false;
+        }
+
+        void LineTo(float x, float y) {
+            EnsureStart();
+            ++m_version;
+            m_verbs.push_back(Verb::Line);
+            m_points.push_back(PointF(x, y));
+        }
+
+        void QuadTo(float cx, float cy, float x, float y) {
+            EnsureStart();
+            ++m_version;
+            m_verbs.push_back(Verb::Quad);
+            m_points.push_back(PointF(cx, cy));
+            m_points.push_back(PointF(x, y));
+        }
+
+        void CubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y) {
+            EnsureStart();
+            ++m_version;
+            m_verbs.push_back(Verb::Cubic);
+            m_points.push_back(PointF(c1x, c1y));
+            m_points.push_back(PointF(c2x, c2y));
+            m_points.push_back(PointF(x, y));
+        }
+
+        // 闭合当前子路径；之后的 LineTo 等从该子路径起点开始
+        void Close() {
+            if (m_verbs.empty() || m_verbs.back() == Verb::Close) return;
+            ++m_version;
+            m_verbs.push_back(Verb::Close);
+            m_pendingMove = true;
+        }
+
+        template <typename PointT>
+        void AddPolyline(const PointT* points, size_t count) {
+            if (count == 0) return;
+            Reserve(m_verbs.size() + count, m_points.size() + count);
+            MoveTo(float(points[0].X), float(points[0].Y));
+            for (size_t i = 1; i < count; ++i) LineTo(float(points[i].X), float(points[i].Y));
+        }
+
+        template <typename PointT>
+        void AddPolygon(const PointT* points, size_t count) {
+            AddPolyline(points, count);
+            Close();
+        }
+
+        void AddRect(float x, float y, float width, float height) {
+            MoveTo(x, y);
+            LineTo(x + width, y);
+            LineTo(x + width, y + height);
+            LineTo(x, y + height);
+            Close();
+        }
+
+        // 椭圆：四段三次曲线
+        void AddEllipse(float cx, float cy, float rx, float ry) {
+            const float k = 0.5522847f, kx = rx * k, ky = ry * k;
+            MoveTo(cx + rx, cy);
+            CubicTo(cx + rx, cy + ky, cx + kx, cy + ry, cx, cy + ry);
+            CubicTo(cx - kx, cy + ry, cx - rx, cy + ky, cx - rx, cy);
+            CubicTo(cx - rx, cy - ky, cx - kx, cy - ry, cx, cy - ry);
+            CubicTo(cx + kx, cy - ry, cx + rx, cy - ky, cx + rx, cy);
+            Close();
+        }
+
+        void Reset() {
+            ++m_version;
+            m_verbs.clear();
+            m_points.clear();
+            m_start = 0;
+            m_pendingMove = false;
+        }
+
+        void Reserve(size_t verbs, size_t points) {
+            m_verbs.reserve(verbs);
+            m_points.reserve(points);
+        }
+
+        bool Empty() const { return m_verbs.empty(); }
+        const std::vector<Verb>& Verbs() const { return m_verbs; }
+        const std::vector<PointF>& Points() const { return m_points; }
+
+        // 控制点包围盒（包含曲线）；空路径返回 false
+        bool Bounds(PointF& min, PointF& max) const {
+            if (m_points.empty()) return false;
+            min = max = m_points[0];
+            for (const PointF& p : m_points) {
+                min.X = (std::min)(min.X, p.X); min.Y = (std::min)(min.Y, p.Y);
+                max.X = (std::max)(max.X, p.X); max.Y = (std::max)(max.Y, p.Y);
+            }
+            return true;
+        }
+
+        // 按子路径展平为折线：fn(点, 点数, 是否闭合)。曲线按二阶导数上界自适应分段，弦与曲线的偏差不超过 tolerance；
+        // points 为调用方提供的缓冲区，可跨调用复用
+        template <typename PolylineFn>
+        void Flatten(float tolerance, std::vector<PointF>& points, PolylineFn&& fn) const {
+            tolerance = (std::max)(tolerance, 0.01f);
+            points.clear();
+            size_t p = 0;
+            auto flush = [&](bool closed) {
+                if (points.size() > 1 || (closed && !points.empty())) fn(points.data(), points.size(), closed);
+                points.clear();
+            };
+            for (Verb verb : m_verbs) {
+                switch (verb) {
+                case Verb::Move:
+                    flush(false);
+                    points.push_back(m_points[p++]);
+                    break;
+                case Verb::Line:
+                    points.push_back(m_points[p++]);
+                    break;
+                case Verb::Quad: {
+                    const PointF a = points.back(), c = m_points[p], b = m_points[p + 1];
+                    p += 2;
+                    const float ddx = a.X - 2 * c.X + b.X, ddy = a.Y - 2 * c.Y + b.Y;
+                    const int n = Segments(std::sqrt(ddx * ddx + ddy * ddy) * 0.25f, tolerance);
+                    for (int i = 1; i <= n; ++i) {
+                        const float t = float(i) / n, mt = 1 - t;
+                        points.push_back(PointF(mt * mt * a.X + 2 * mt * t * c.X + t * t * b.X,
+                            mt * mt * a.Y + 2 * mt * t * c.Y + t * t * b.Y));
+                    }
+                    break;
+                }
+                case Verb::Cubic: {
+                    const PointF a = points.back(), c1 = m_points[p], c2 = m_points[p + 1], b = m_points[p + 2];
+                    p += 3;
+                    const float d1x = a.X - 2 * c1.X + c2.X, d1y = a.Y - 2 * c1.Y + c2.Y;
+                    const float d2x = c1.X - 2 * c2.X + b.X, d2y = c1.Y - 2 * c2.Y + b.Y;
+                    const float dd = std::sqrt((std::max)(d1x * d1x + d1y * d1y, d2x * d2x + d2y * d2y));
+                    const int n = Segments(dd * 0.75f, tolerance);
+                    for (int i = 1; i <= n; ++i) {
+                        const float t = float(i) / n, mt = 1 - t;
+                        const float w0 = mt * mt * mt, w1 = 3 * mt * mt * t, w2 = 3 * mt * t * t, w3 = t * t * t;
+                        points.push_back(PointF(w0 * a.X + w1 * c1.X + w2 * c2.X + w3 * b.X,
+                            w0 * a.Y + w1 * c1.Y + w2 * c2.Y + w3 * b.Y));
+                    }
+                    break;
+                }
+                case Verb::Close: {
+                    flush(true);
+                    break;
+                }
+                }
+            }
+            flush(false);
+        }
+
+    private:
+        static uint64_t NextId() {
+            static std::atomic<uint64_t> next{ 1 };
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // 均匀分 n 段的偏差约为 k / n²（k 为二阶导数上界的 1/8），取满足 tolerance 的最小 n
+        static int Segments(float k, float tolerance) {
+            return (std::max)(1, (std::min)(1024, static_cast<int>(std::ceil(std::sqrt(k / tolerance)))));
+        }
+
+        // 没有当前子路径时补一个 MoveTo：路径开头为原点，Close 之后为该子路径起点
+        void EnsureStart() {
+            if (m_verbs.empty()) MoveTo(0.0f, 0.0f);
+            else if (m_pendingMove) {
+                const PointF start = m_points[m_start];
+                MoveTo(start.X, start.Y);
+            }
+        }
+
+        std::vector<Verb> m_verbs;
+        std::vector<PointF> m_points;
+        size_t m_start = 0;             // 当前子路径起点下标
+        bool m_pendingMove = false;     // Close 之后，下一条线段前补 MoveTo(起点)
+        uint64_t m_id;
+        uint64_t m_version = 0;
+    };
+
+    // 拐角与线帽，与 GDI+ 的 LineJoin/LineCap 对应
+    enum class LineJoin : uint8_t { Miter, Bevel, Round };
+    enum class LineCap : uint8_t { Flat, Square, Round };
+
+    // 画笔：宽度不足0.5像素时按0.5绘制；dashes 为实线段与间隔交替的长度（像素），奇数个时重复一遍，为空是实线
+    struct StrokeStyle {
+        float width = 1.0f;
+        LineJoin join = LineJoin::Miter;
+        LineCap cap = LineCap::Flat;
+        float miterLimit = 10.0f;       // 尖角长度超过 miterLimit 倍线宽时改为斜角
+        std::vector<float> dashes;
+        float dashOffset = 0.0f;
+
+        StrokeStyle() = default;
+        StrokeStyle(float width_, LineJoin join_ = LineJoin::Miter, LineCap cap_ = LineCap::Flat)
+            : width(width_), join(join_), cap(cap_) {}
+
+        bool Dashed() const {
+            for (float d : dashes) {
+                if (d > 0.0f) return true;
+            }
+            return false;
+        }
+    };
+
+    // 描边几何：若干闭合轮廓，坐标与输入相同。各轮廓的环绕方向一致，按非零规则填充时重叠处不会相互抵消
+    struct StrokeGeometry {
+        std::vector<PointF> points;
+        std::vector<uint32_t> contours;     // 各轮廓点数
+        PointF min, max;                    // 包围盒，空几何时无意义
+
+        void Clear() {
+            points.clear();
+            contours.clear();
+        }
+
+        bool Empty() const { return contours.empty(); }
+    };
+
+    // 描边生成：沿折线两侧生成偏移轮廓，拐角、线帽并入轮廓，虚线先切分为开放折线。
+    // 自相交处同向叠加，按非零规则填充即为描边区域；曲线展平与圆弧的偏差分别不超过 kTolerance、kArcTolerance
+    class Stroker {
+    public:
+        static constexpr float kTolerance = 0.2f;
+        static constexpr float kArcTolerance = 0.1f;       // 圆角、圆头为内接多边形，边缘偏差直接影响覆盖率
+
+        // 折线描边，追加到 out；closed 为 true 时首尾相连并在起点处生成拐角
+        template <typename PointT>
+        void Stroke(const PointT* points, size_t count, bool closed, const StrokeStyle& style, StrokeGeometry& out) {
+            m_input.resize(count);
+            for (size_t i = 0; i < count; ++i) m_input[i] = PointF(float(points[i].X), float(points[i].Y));
+            StrokePolyline(m_input.data(), count, closed, style, out);
+        }
+
+        // 路径描边：曲线按 kTolerance 展平
+        void Stroke(const Path& path, const StrokeStyle& style, StrokeGeometry& out) {
+            path.Flatten(kTolerance, m_flatten, [&](const PointF* pts, size_t n, bool closed) {
+                if (n > 1) StrokePolyline(pts, n, closed, style, out);
+            });
+        }
+
+    private:
+        void StrokePolyline(const PointF* pts, size_t n, bool closed, const StrokeStyle& style, StrokeGeometry& out) {
+            if (n == 0) return;
+            m_out = &out;
+            m_style = &style;
+            m_hw = (std::max)(style.width, 0.5f) * 0.5f;
+            if (style.Dashed()) Dash(pts, n, closed);
+            else Run(pts, n, closed);
+        }
+
+        // 去掉重复点后生成轮廓：左侧偏移线正向、右侧偏移线反向，开放折线两端以线帽相连，
+        // 闭合折线左右两侧各为一个轮廓（内侧反向即为空洞）
+        void Run(const PointF* pts, size_t n, bool closed) {
+            m_clean.clear();
+            for (size_t i = 0; i < n; ++i) {
+                if (m_clean.empty() || !Same(m_clean.back(), pts[i])) m_clean.push_back(pts[i]);
+            }
+            if (closed) {
+                while (m_clean.size() > 1 && Same(m_clean.back(), m_clean.front())) m_clean.pop_back();
+            }
+            const size_t count = m_clean.size();
+            if (count == 1) {
+                Dot(m_clean[0], PointF(1.0f, 0.0f));
+                return;
+            }
+            const PointF* p = m_clean.data();
+            const size_t segments = closed ? count : count - 1;
+            m_dirs.resize(segments);
+            m_lens.resize(segments);
+            for (size_t i = 0; i < segments; ++i) {
+                const PointF a = p[i], b = p[i + 1 < count ? i + 1 : 0];
+                m_lens[i] = Distance(a, b);
+                m_dirs[i] = PointF((b.X - a.X) / m_lens[i], (b.Y - a.Y) / m_lens[i]);
+            }
+
+            for (float side : { 1.0f, -1.0f }) {
+                std::vector<PointF>& out = side > 0.0f ? m_left : m_right;
+                out.clear();
+                if (!closed) out.push_back(Offset(p[0], m_dirs[0], side));
+                for (size_t i = closed ? 0 : 1; i < (closed ? count : count - 1); ++i) {
+                    const size_t prev = i ? i - 1 : segments - 1;
+                    Vertex(p[i], m_dirs[prev], m_dirs[i], (std::min)(m_lens[prev], m_lens[i]), side, out);
+                }
+                if (!closed) out.push_back(Offset(p[count - 1], m_dirs[segments - 1], side));
+            }
+
+            if (closed) {
+                Emit(m_left.data(), m_left.size(), false);
+                std::reverse(m_right.begin(), m_right.end());
+                Emit(m_right.data(), m_right.size(), false);
+                return;
+            }
+            m_outline.assign(m_left.begin(), m_left.end());
+            CapPoints(p[count - 1], m_dirs[segments - 1], m_outline);
+            m_outline.insert(m_outline.end(), m_right.rbegin(), m_right.rend());
+            CapPoints(p[0], PointF(-m_dirs[0].X, -m_dirs[0].Y), m_outline);
+            Emit(m_outline.data(), m_outline.size(), false);
+        }
+
+        // 切分虚线：每个实线段作为开放折线描边；闭合折线首尾的实线段相连
+        void Dash(const PointF* pts, size_t n, bool closed) {
+            const std::vector<float>& src = m_style->dashes;
+            m_pattern.clear();
+            for (int pass = 0; pass < ((src.size() % 2) ? 2 : 1); ++pass) {
+                for (float d : src) m_pattern.push_back((std::max)(d, 0.0f));
+            }
+            float period = 0.0f;
+            for (float d : m_pattern) period += d;
+
+            float length = 0.0f;
+            const size_t segments = closed ? n : n - 1;
+            for (size_t i = 0; i < segments; ++i) length += Distance(pts[i], pts[i + 1 < n ? i + 1 : 0]);
+            if (length / period > 1e6f) {          // 间隔远小于像素，按实线绘制
+                Run(pts, n, closed);
+                return;
+            }
+
+            float offset = std::fmod(m_style->dashOffset, period);
+            if (offset < 0.0f) offset += period;
+            size_t index = 0;
+            for (size_t guard = 0; guard < m_pattern.size() && offset >= m_pattern[index] && offset > 0.0f; ++guard) {
+                offset -= m_pattern[index];
+                index = (index + 1) % m_pattern.size();
+            }
+            float remaining = m_pattern[index] - offset;
+            bool on = index % 2 == 0;
+
+            m_piece.clear();
+            m_head.clear();
+            bool headOpen = on && closed;           // 起点处的实线段留到最后与末尾的实线段相连
+            if (on) m_piece.push_back(pts[0]);
+            PointF d(1.0f, 0.0f);
+            for (size_t i = 0; i < segments; ++i) {
+                const PointF a = pts[i], b = pts[i + 1 < n ? i + 1 : 0];
+                const float len = Distance(a, b);
+                if (len <= 0.0f) continue;
+                d = PointF((b.X - a.X) / len, (b.Y - a.Y) / len);
+                float pos = 0.0f;
+                while (len - pos > remaining) {
+                    pos += remaining;
+                    const PointF q(a.X + d.X * pos, a.Y + d.Y * pos);
+                    if (on) {
+                        m_piece.push_back(q);
+                        if (headOpen) {
+                            m_head.swap(m_piece);
+                            headOpen = false;
+                        }
+                        else {
+                            FlushPiece(d);
+                        }
+                        m_piece.clear();
+                    }
+                    else {
+                        m_piece.push_back(q);
+                    }
+                    on = !on;
+                    index = (index + 1) % m_pattern.size();
+                    remaining = m_pattern[index];
+                }
+                remaining -= len - pos;
+                if (on) m_piece.push_back(b);
+            }
+            if (on && !m_head.empty()) {
+                m_piece.insert(m_piece.end(), m_head.begin() + 1, m_head.end());
+                m_head.clear();
+            }
+            if (on) {
+                if (headOpen) Run(m_piece.data(), m_piece.size(), true);   // 整条闭合折线都是实线
+                else FlushPiece(d);
+            }
+            if (!m_head.empty()) {
+                m_piece.swap(m_head);
+                FlushPiece(d);
+            }
+        }
+
+        // 长度为零的实线段按线帽画点，方向取所在线段方向
+        void FlushPiece(PointF direction) {
+            if (m_piece.empty()) return;
+            bool dot = true;
+            for (const PointF& p : m_piece) dot &= Same(p, m_piece[0]);
+            if (dot) Dot(m_piece[0], direction);
+            else Run(m_piece.data(), m_piece.size(), false);
+        }
+
+        // 偏移点：side 为 1 时在线段方向左侧（法向 (-dy, dx)），-1 时在右侧
+        PointF Offset(PointF p, PointF d, float side) const {
+            const float s = side * m_hw;
+            return PointF(p.X - d.Y * s, p.Y + d.X * s);
+        }
+
+        // 顶点一侧的偏移点：转向外侧按拐角样式生成，内侧取两条偏移线的交点；
+        // 相邻线段短于交点所需长度时改经过顶点（形成同向的小环，不影响非零填充）
+        void Vertex(PointF p, PointF d0, PointF d1, float shorter, float side, std::vector<PointF>& out) {
+            const float cross = d0.X * d1.Y - d0.Y * d1.X;
+            const float dot = d0.X * d1.X + d0.Y * d1.Y;
+            const PointF o0 = Offset(p, d0, side), o1 = Offset(p, d1, side);
+            if (dot > 0.0f && std::fabs(cross) < 1e-6f) {
+                out.push_back(o1);
+                return;
+            }
+            const bool outer = side * cross < 0.0f || (cross == 0.0f && side > 0.0f);
+            if (!outer) {
+                const float half = m_hw * std::fabs(cross) / (1.0f + dot);     // 交点到顶点沿线段方向的距离
+                if (dot > -0.999f && half <= shorter * 0.5f) {
+                    const float k = 1.0f / (1.0f + dot);
+                    out.push_back(PointF(p.X + (o0.X + o1.X - 2.0f * p.X) * k, p.Y + (o0.Y + o1.Y - 2.0f * p.Y) * k));
+                }
+                else {
+                    out.push_back(o0);
+                    out.push_back(p);
+                    out.push_back(o1);
+                }
+                return;
+            }
+            out.push_back(o0);
+            switch (m_style->join) {
+            case LineJoin::Round:
+                ArcPoints(p, PointF(o0.X - p.X, o0.Y - p.Y), -side * std::fabs(std::atan2(cross, dot)), out);
+                break;
+            case LineJoin::Miter: {
+                const float cosHalf = std::sqrt((std::max)(0.0f, (1.0f + dot) * 0.5f));
+                if (cosHalf * m_style->miterLimit > 1.0f) {
+                    const float k = 1.0f / (1.0f + dot);
+                    out.push_back(PointF(p.X + (o0.X + o1.X - 2.0f * p.X) * k, p.Y + (o0.Y + o1.Y - 2.0f * p.Y) * k));
+                }
+                break;
+            }
+            case LineJoin::Bevel:
+                break;
+            }
+            out.push_back(o1);
+        }
+
+        // 线帽在偏移点之间补的点，d 为指向线段外侧的单位方向：从左侧偏移点绕到右侧偏移点
+        void CapPoints(PointF p, PointF d, std::vector<PointF>& out) {
+            const PointF nrm(-d.Y * m_hw, d.X * m_hw);
+            if (m_style->cap == LineCap::Square) {
+                const float ex = d.X * m_hw, ey = d.Y * m_hw;
+                out.push_back(PointF(p.X + nrm.X + ex, p.Y + nrm.Y + ey));
+                out.push_back(PointF(p.X - nrm.X + ex, p.Y - nrm.Y + ey));
+            }
+            else if (m_style->cap == LineCap::Round) {
+                ArcPoints(p, nrm, -3.14159265f, out);
+            }
+        }
+
+        // 零长度线段：圆头画圆，方头画沿 d 方向的正方形，平头不绘制
+        void Dot(PointF p, PointF d) {
+            m_outline.clear();
+            if (m_style->cap == LineCap::Square) {
+                const float ex = d.X * m_hw, ey = d.Y * m_hw;
+                const PointF square[4] = { {p.X - ey + ex, p.Y + ex + ey}, {p.X + ey + ex, p.Y - ex + ey},
+                    {p.X + ey - ex, p.Y - ex - ey}, {p.X - ey - ex, p.Y + ex - ey} };
+                Emit(square, 4, true);
+            }
+            else if (m_style->cap == LineCap::Round) {
+                m_outline.push_back(PointF(p.X + m_hw, p.Y));
+                ArcPoints(p, PointF(m_hw, 0.0f), 6.28318531f, m_outline);
+                Emit(m_outline.data(), m_outline.size(), true);
+            }
+        }
+
+        // 以 c 为圆心、从 c+v 开始转过 angle 的圆弧，只追加两端之间的点
+        void ArcPoints(PointF c, PointF v, float angle, std::vector<PointF>& out) const {
+            const float step = 2.0f * std::acos((std::max)(0.0f, 1.0f - kArcTolerance / m_hw));
+            const int n = (std::max)(1, (std::min)(256, static_cast<int>(std::ceil(std::fabs(angle) / (std::max)(step, 0.01f)))));
+            const float da = angle / n, cs = std::cos(da), sn = std::sin(da);
+            for (int i = 1; i < n; ++i) {
+                v = PointF(v.X * cs - v.Y * sn, v.X * sn + v.Y * cs);
+                out.push_back(PointF(c.X + v.X, c.Y + v.Y));
+            }
+        }
+
+        // 追加轮廓。描边轮廓的方向与线段方向无关（左侧正向、右侧反向），
+        // orient 为 true 时把单独生成的点（圆、正方形）调整为同一方向；退化轮廓丢弃
+        void Emit(const PointF* pts, size_t n, bool orient) {
+            if (n < 3) return;
+            StrokeGeometry& out = *m_out;
+            const size_t start = out.points.size();
+            out.points.insert(out.points.end(), pts, pts + n);
+            if (orient) {
+                float area = 0.0f;
+                for (size_t i = 0, j = n - 1; i < n; j = i++) area += pts[j].X * pts[i].Y - pts[i].X * pts[j].Y;
+                if (area > 0.0f) std::reverse(out.points.begin() + start, out.points.end());
+            }
+            if (out.contours.empty()) out.min = out.max = pts[0];
+            for (size_t i = 0; i < n; ++i) {
+                out.min.X = (std::min)(out.min.X, pts[i].X); out.min.Y = (std::min)(out.min.Y, pts[i].Y);
+                out.max.X = (std::max)(out.max.X, pts[i].X); out.max.Y = (std::max)(out.max.Y, pts[i].Y);
+            }
+            out.contours.push_back(uint32_t(n));
+        }
+
+        static bool Same(PointF a, PointF b) { return a.X == b.X && a.Y == b.Y; }
+
+        static float Distance(PointF a, PointF b) {
+            const float dx = b.X - a.X, dy = b.Y - a.Y;
+            return std::sqrt(dx * dx + dy * dy);
+        }
+
+        static PointF Direction(PointF a, PointF b) {
+            const float len = Distance(a, b);
+            return PointF((b.X - a.X) / len, (b.Y - a.Y) / len);
+        }
+
+        StrokeGeometry* m_out = nullptr;
+        const StrokeStyle* m_style = nullptr;
+        float m_hw = 0.5f;
+        std::vector<PointF> m_input, m_flatten, m_clean, m_piece, m_head;
+        std::vector<PointF> m_dirs, m_left, m_right, m_outline;
+        std::vector<float> m_lens, m_pattern;
+    };
+
+    // 覆盖率累积光栅化器：收集线段后按包围盒累积有符号面积，逐行前缀和得到覆盖率
+    class Rasterizer {
+    public:
+        void Reset() {
+            m_edges.clear();
+            m_minX = m_minY = 1e30f;
+            m_maxX = m_maxY = -1e30f;
+        }
+
+        bool Empty() const { return m_edges.empty(); }
+
+        void AddLine(float x0, float y0, float x1, float y1) {
+            if (y0 == y1) {
+                // 水平线不产生覆盖，但仍参与包围盒以保持裁剪一致
+                Extend(x0, y0); Extend(x1, y1);
+                return;
+            }
+            m_edges.push_back({ x0, y0, x1, y1 });
+            Extend(x0, y0);
+            Extend(x1, y1);
+        }
+
+        // 二次贝塞尔曲线，按平坦度细分
+        void AddQuad(float x0, float y0, float cx, float cy, float x1, float y1) {
+            float ddx = x0 - 2 * cx + x1, ddy = y0 - 2 * cy + y1;
+            float dd = std::sqrt(ddx * ddx + ddy * ddy);
+            int n = (std::max)(1, (std::min)(64, static_cast<int>(std::ceil(std::sqrt(dd * 2.0f)))));
+            float px = x0, py = y0;
+            for (int i = 1; i <= n; ++i) {
+                float t = static_cast<float>(i) / n, mt = 1 - t;
+                float qx = mt * mt * x0 + 2 * mt * t * cx + t * t * x1;
+                float qy = mt * mt * y0 + 2 * mt * t * cy + t * t * y1;
+                AddLine(px, py, qx, qy);
+                px = qx; py = qy;
+            }
+        }
+
+        // 闭合多边形
+        template <typename PointT>
+        void AddPolygon(const PointT* pts, size_t n, float dx = 0, float dy = 0) {
+            if (n < 2) return;
+            for (size_t i = 0; i < n; ++i) {
+                const PointT& a = pts[i];
+                const PointT& b = pts[(i + 1) % n];
+                AddLine(float(a.X) + dx, float(a.Y) + dy, float(b.X) + dx, float(b.Y) + dy);
+            }
+        }
+
+        // 路径（子路径自动闭合），曲线按 tolerance 展平
+        void AddPath(const Path& path, float dx = 0, float dy = 0, float tolerance = Path::kDefaultTolerance) {
+            m_edges.reserve(m_edges.size() + path.Points().size());
+            path.Flatten(tolerance, m_flatten, [&](const PointF* pts, size_t n, bool) {
+                for (size_t i = 0; i < n; ++i) {
+                    const PointF& a = pts[i];
+                    const PointF& b = pts[i + 1 < n ? i + 1 : 0];
+                    AddLine(a.X + dx, a.Y + dy, b.X + dx, b.Y + dy);
+                }
+            });
+        }
+
+        // 填充到表面，clip 为设备像素裁剪矩形；antiAlias 为 false 时覆盖率二值化
+        // keepPath 为 true 时保留路径，用于同一路径按多个裁剪矩形依次填充
+        void Fill(Surface& surface, uint32_t color, const Rect& clip,
+            FillRule rule = FillRule::NonZero, bool antiAlias = true, bool keepPath = false) {
+            if (m_edges.empty() || !surface.Valid()) { if (!keepPath) Reset(); return; }
+
+            const Rect area = PathBounds().Intersect(clip).Intersect(surface.Bounds());
+            Sweep(area, rule, antiAlias, [&](int y, const uint8_t* cover) {
+                Span::CoverageOver(surface.Row(y) + area.x, cover, area.w, color);
+            });
+            if (!keepPath) Reset();
+        }
+
+        // 按覆盖率逐行回调 fn(设备行号, 起始列, 覆盖率行, 宽度)，用于逐像素着色（渐变等）的填充；
+        // clip 须已在表面范围内
+        template <typename RowFn>
+        void FillCoverage(const Rect& clip, FillRule rule, bool antiAlias, bool keepPath, RowFn&& fn) {
+            if (!m_edges.empty()) {
+                const Rect area = PathBounds().Intersect(clip);
+                Sweep(area, rule, antiAlias, [&](int y, const uint8_t* cover) { fn(y, area.x, cover, area.w); });
+            }
+            if (!keepPath) Reset();
+        }
+
+        // 覆盖率写入8位掩码，mask 左上角对应 area 左上角；用于字形缓存等离屏光栅化
+        void FillMask(uint8_t* mask, int maskStride, const Rect& area,
+            FillRule rule = FillRule::NonZero, bool antiAlias = true) {
+            for (int y = 0; y < area.h; ++y) std::memset(mask + size_t(y) * maskStride, 0, size_t((std::max)(area.w, 0)));
+            Sweep(area, rule, antiAlias, [&](int y, const uint8_t* cover) {
+                std::memcpy(mask + size_t(y - area.y) * maskStride, cover, size_t(area.w));
+            });
+            Reset();
+        }
+
+        // 当前路径的整数包围盒
+        Rect PathBounds() const {
+            if (m_minX > m_maxX) return Rect();
+            Rect bounds(static_cast<int>(std::floor(m_minX)), static_cast<int>(std::floor(m_minY)), 0, 0);
+            bounds.w = static_cast<int>(std::ceil(m_maxX)) - bounds.x;
+            bounds.h = static_cast<int>(std::ceil(m_maxY)) - bounds.y;
+            return bounds;
+        }
+
+    private:
+        struct Edge { float x0, y0, x1, y1; };
+
+        // 在 area 内累积覆盖率，对每个非空行调用 fn(设备行号, 覆盖率行)
+        template <typename RowFn>
+        void Sweep(const Rect& area, FillRule rule, bool antiAlias, RowFn&& fn) {
+            if (m_edges.empty() || area.IsEmpty()) return;
+            const int w = area.w, h = area.h, stride = w + 2;
+            size_t need = size_t(stride) * h;
+            if (m_accum.size() < need) m_accum.resize(need, 0.0f);   // 缓冲区使用后逐行清零，保持全零
+            if (m_cover.size() < size_t(w)) m_cover.resize(w);
+
+            const float ox = static_cast<float>(area.x), oy = static_cast<float>(area.y);
+            const float fw = static_cast<float>(w);
+            for (const Edge& e : m_edges) {
+                float x0 = e.x0 - ox, y0 = e.y0 - oy, x1 = e.x1 - ox, y1 = e.y1 - oy;
+                ClipAndAccumulate(x0, y0, x1, y1, fw, h, stride);
+            }
+
+            for (int y = 0; y < h; ++y) {
+                float* acc = &m_accum[size_t(y) * stride];
+                float sum = 0.0f;
+                bool any = false;
+                for (int x = 0; x < w; ++x) {
+                    sum += acc[x];
+                    acc[x] = 0.0f;
+                    float c = std::fabs(sum);
+                    if (rule == FillRule::EvenOdd) {
+                        c = std::fmod(c, 2.0f);
+                        if (c > 1.0f) c = 2.0f - c;
+                    }
+                    else if (c > 1.0f) {
+                        c = 1.0f;
+                    }
+                    uint8_t v = static_cast<uint8_t>(c * 255.0f + 0.5f);
+                    if (!antiAlias) v = v >= 128 ? 255 : 0;
+                    m_cover[x] = v;
+                    any |= v != 0;
+                }
+                acc[w] = acc[w + 1] = 0.0f;
+                if (any) fn(area.y + y, m_cover.data());
+            }
+        }
+
+        void Extend(float x, float y) {
+            m_minX = (std::min)(m_minX, x); m_maxX = (std::max)(m_maxX, x);
+            m_minY = (std::min)(m_minY, y); m_maxY = (std::max)(m_maxY, y);
+        }
+
+        // 在 x=0 与 x=w 处切分，超出部分贴到边界（保持其对右侧像素的覆盖贡献）
+        void ClipAndAccumulate(float x0, float y0, float x1, float y1, float w, int h, int stride) {
+            const float bounds[2] = { 0.0f, w };
+            for (float bx : bounds) {
+                if ((x0 < bx) != (x1 < bx) && x0 != bx && x1 != bx) {
+                    float t = (bx - x0) / (x1 - x0);
+                    float ym = y0 + (y1 - y0) * t;
+                    ClipAndAccumulate(x0, y0, bx, ym, w, h, stride);
+                    ClipAndAccumulate(bx, ym, x1, y1, w, h, stride);
+                    return;
+                }
+            }
+            x0 = (std::min)((std::max)(x0, 0.0f), w);
+            x1 = (std::min)((std::max)(x1, 0.0f), w);
+            Accumulate(x0, y0, x1, y1, w, h, stride);
+        }
+
+        void Accumulate(float x0, float y0, float x1, float y1, float w, int h, int stride) {
+            if (y0 == y1) return;
+            float dir = 1.0f;
+            if (y0 > y1) { std::swap(x0, x1); std::swap(y0, y1); dir = -1.0f; }
+            if (y1 <= 0.0f || y0 >= static_cast<float>(h)) return;
+            const float dxdy = (x1 - x0) / (y1 - y0);
+            float x = x0;
+            if (y0 < 0.0f) { x -= y0 * dxdy; y0 = 0.0f; }
+            if (y1 > static_cast<float>(h)) y1 = static_cast<float>(h);
+
+            const int yEnd = (std::min)(h, static_cast<int>(std::ceil(y1)));
+            for (int y = static_cast<int>(y0); y < yEnd; ++y) {
+                float* row = &m_accum[size_t(y) * stride];
+                float dy = (std::min)(static_cast<float>(y + 1), y1) - (std::max)(static_cast<float>(y), y0);
+                float xnext = (std::min)((std::max)(x + dxdy * dy, 0.0f), w);
+                float d = dy * dir;
+                float xa = x < xnext ? x : xnext;
+                float xb = x < xnext ? xnext : x;
+                float xaFloor = std::floor(xa);
+                int xai = static_cast<int>(xaFloor);
+                float xbCeil = std::ceil(xb);
+                int xbi = static_cast<int>(xbCeil);
+                if (xbi <= xai + 1) {
+                    float xmf = 0.5f * (x + xnext) - xaFloor;
+                    row[xai] += d - d * xmf;
+                    row[xai + 1] += d * xmf;
+                }
+                else {
+                    float s = 1.0f / (xb - xa);
+                    float xaf = xa - xaFloor;
+                    float a0 = 0.5f * s * (1.0f - xaf) * (1.0f - xaf);
+                    float xbf = xb - xbCeil + 1.0f;
+                    float am = 0.5f * s * xbf * xbf;
+                    row[xai] += d * a0;
+                    if (xbi == xai + 2) {
+                        row[xai + 1] += d * (1.0f - a0 - am);
+                    }
+                    else {
+                        float a1 = s * (1.5f - xaf);
+                        row[xai + 1] += d * (a1 - a0);
+                        for (int xi = xai + 2; xi < xbi - 1; ++xi) row[xi] += d * s;
+                        float a2 = a1 + static_cast<float>(xbi - xai - 3) * s;
+                        row[xbi - 1] += d * (1.0f - a2 - am);
+                    }
+                    row[xbi] += d * am;
+                }
+                x = xnext;
+            }
+        }
+
+        std::vector<Edge> m_edges;
+        std::vector<PointF> m_flatten;
+        std::vector<float> m_accum;
+        std::vector<uint8_t> m_cover;
+        float m_minX = 1e30f, m_minY = 1e30f, m_maxX = -1e30f, m_maxY = -1e30f;
+    };
+
+    // 内置字体字形：度量与轮廓，供 Canvas 与 GlyphCache 共用
+    namespace Glyphs {
+        // fontSize 单位为磅（96 DPI 下 1磅 = 4/3 像素，与GDI+默认一致）
+        inline float EmPixels(float fontSize) { return fontSize * 96.0f / 72.0f; }
+
+        inline float LineHeight(float fontSize) {
+            return EmPixels(fontSize) * (FontData::kAscender - FontData::kDescender) / FontData::kUnitsPerEm;
+        }
+
+        // 字体外的字符显示为 '?'
+        inline int IndexOf(wchar_t ch) {
+            if (ch < FontData::kFirstChar || ch > FontData::kLastChar) ch = L'?';
+            return ch - FontData::kFirstChar;
+        }
+
+        inline const FontData::Glyph& For(wchar_t ch) { return FontData::kGlyphs[IndexOf(ch)]; }
+
+        // TrueType 二次轮廓：相邻两个控制点之间隐含一个曲线上的中点
+        inline void AddContour(Rasterizer& raster, int start, int end, float ox, float baseline, float scale) {
+            int n = end - start;
+            if (n < 2) return;
+            auto px = [&](int i) { return ox + (FontData::kPoints[2 * (start + i)] >> 1) * scale; };
+            auto py = [&](int i) { return baseline - FontData::kPoints[2 * (start + i) + 1] * scale; };
+            auto on = [&](int i) { return (FontData::kPoints[2 * (start + i)] & 1) != 0; };
+
+            int first = 0;
+            while (first < n && !on(first)) ++first;
+            float sx, sy;
+            if (first == n) {
+                sx = (px(0) + px(1)) * 0.5f; sy = (py(0) + py(1)) * 0.5f;
+                first = 0;
+            }
+            else {
+                sx = px(first); sy = py(first);
+            }
+
+            float cx = sx, cy = sy;
+            bool hasCtrl = false;
+            float ctrlX = 0, ctrlY = 0;
+            for (int k = 1; k <= n; ++k) {
+                int i = (first + k) % n;
+                float x = px(i), y = py(i);
+                if (on(i)) {
+                    if (hasCtrl) raster.AddQuad(cx, cy, ctrlX, ctrlY, x, y);
+                    else raster.AddLine(cx, cy, x, y);
+                    cx = x; cy = y;
+                    hasCtrl = false;
+                }
+                else {
+                    if (hasCtrl) {
+                        float mx = (ctrlX + x) * 0.5f, my = (ctrlY + y) * 0.5f;
+                        raster.AddQuad(cx, cy, ctrlX, ctrlY, mx, my);
+                        cx = mx; cy = my;
+                    }
+                    ctrlX = x; ctrlY = y;
+                    hasCtrl = true;
+                }
+            }
+            if (hasCtrl) raster.AddQuad(cx, cy, ctrlX, ctrlY, sx, sy);
+            else if (cx != sx || cy != sy) raster.AddLine(cx, cy, sx, sy);
+        }
+
+        inline void AddOutline(Rasterizer& raster, const FontData::Glyph& g, float ox, float baseline, float scale) {
+            for (int c = 0; c < g.contourCount; ++c) {
+                int ci = g.firstContour + c;
+                int start = ci == 0 ? 0 : FontData::kContourEnds[ci - 1];
+                int end = FontData::kContourEnds[ci];
+                AddContour(raster, start, end, ox, baseline, scale);
+            }
+        }
+    }
+
+    // Skyline 矩形装箱：维护各列已占用高度的轮廓线，新矩形放在顶边最低处（其次最左）
+    class SkylinePacker {
+    public:
+        explicit SkylinePacker(int width = 0, int height = 0) { Reset(width, height); }
+
+        void Reset(int width, int height) {
+            m_width = width;
+            m_height = height;
+            m_usedArea = 0;
+            m_skyline.assign(1, Segment{ 0, 0, width });
+        }
+
+        // 放入 w×h 的矩形，成功时 out 为其左上角
+        bool Insert(int w, int h, Point& out) {
+            if (w <= 0 || h <= 0 || w > m_width || h > m_height) return false;
+            size_t best = m_skyline.size();
+            int bestTop = 0, bestY = 0, bestWidth = 0;
+            for (size_t i = 0; i < m_skyline.size(); ++i) {
+                int y;
+                if (!Fits(i, w, h, y)) continue;
+                if (best == m_skyline.size() || y + h < bestTop || (y + h == bestTop && m_skyline[i].w < bestWidth)) {
+                    best = i; bestTop = y + h; bestY = y; bestWidth = m_skyline[i].w;
+                }
+            }
+            if (best == m_skyline.size()) return false;
+
+            out = Point(m_skyline[best].x, bestY);
+            m_skyline.insert(m_skyline.begin() + best, Segment{ out.X, bestY + h, w });
+            // 新线段遮住的部分从后续线段中裁掉
+            for (size_t i = best + 1; i < m_skyline.size();) {
+                Segment& s = m_skyline[i];
+                int shrink = out.X + w - s.x;
+                if (shrink <= 0) break;
+                if (shrink < s.w) { s.x += shrink; s.w -= shrink; break; }
+                m_skyline.erase(m_skyline.begin() + i);
+            }
+            // 合并等高的相邻线段
+            for (size_t i = 0; i + 1 < m_skyline.size();) {
+                if (m_skyline[i].y == m_skyline[i + 1].y) {
+                    m_skyline[i].w += m_skyline[i + 1].w;
+                    m_skyline.erase(m_skyline.begin() + i + 1);
+                }
+                else {
+                    ++i;
+                }
+            }
+            m_usedArea += (long long)w * h;
+            return true;
+        }
+
+        int Width() const { return m_width; }
+        int Height() const { return m_height; }
+
+        // 已放入矩形面积占总面积的比例
+        double Occupancy() const {
+            long long total = (long long)m_width * m_height;
+            return total > 0 ? double(m_usedArea) / double(total) : 0.0;
+        }
+
+    private:
+        struct Segment { int x, y, w; };
+
+        // 从第 index 段起放置宽 w 的矩形，y 为跨越各段的最高点
+        bool Fits(size_t index, int w, int h, int& y) const {
+            if (m_skyline[index].x + w > m_width) return false;
+            y = 0;
+            int left = w;
+            for (size_t i = index; left > 0; ++i) {
+                if (i >= m_skyline.size()) return false;
+                y = (std::max)(y, m_skyline[i].y);
+                if (y + h > m_height) return false;
+                left -= m_skyline[i].w;
+            }
+            return true;
+        }
+
+        int m_width = 0, m_height = 0;
+        long long m_usedArea = 0;
+        std::vector<Segment> m_skyline;
+    };
+
+    // 文本缓存：字形覆盖率掩码按 (字号, 字符, 水平亚像素偏移, 抗锯齿) 光栅化一次并打包进8位图集页；
+    // 最近绘制的字符串保存为定位好的字形序列（run），重复绘制时只做逐行 SIMD 掩码混合。
+    // 图集写满时整体清空重建。非线程安全：每个线程使用 ForThread() 的实例或自行持有
+    class GlyphCache {
+    public:
+        static constexpr int kSubpixelSteps = 4;        // 字形水平亚像素位置数
+        static constexpr int kRunOriginSteps = 16;      // 序列起点的小数位置按 1/16 像素区分
+        static constexpr int kPageSize = 512;           // 图集页边长（8位掩码，每页256KB）
+        static constexpr float kMaxEmPixels = 128.0f;   // 更大的字号不缓存，直接按路径绘制
+        static constexpr size_t kMaxRunLength = 256;    // 更长的字符串只缓存字形，不缓存序列
+
+        // 图集中的字形：掩码左上角相对笔位置与基线的偏移（整数像素）及其在页中的位置
+        struct Glyph {
+            int16_t left = 0, top = 0;
+            uint16_t width = 0, height = 0;
+            uint16_t x = 0, y = 0;
+            uint16_t page = 0;
+        };
+
+        // 序列中的字形：相对字符串整数原点（x 向下取整，基线）的位置
+        struct RunGlyph {
+            int x, y;
+            uint32_t glyph;
+        };
+
+        struct TextRun {
+            std::vector<RunGlyph> glyphs;
+            Rect bounds;    // 相对整数原点的包围盒
+        };
+
+        struct Stats {
+            size_t glyphHits = 0, glyphMisses = 0, glyphs = 0;
+            size_t runHits = 0, runMisses = 0, runs = 0;
+            size_t atlasPages = 0, atlasResets = 0;
+            double atlasOccupancy = 0.0;    // 各页平均占用率
+        };
+
+        explicit GlyphCache(size_t maxRuns = 2048, int maxPages = 4)
+            : m_runs(maxRuns), m_maxPages(maxPages < 1 ? 1 : maxPages) {}
+
+        // 当前线程的共享实例
+        static GlyphCache& ForThread() {
+            static thread_local GlyphCache cache;
+            return cache;
+        }
+
+        static bool Cacheable(float fontSize) {
+            float em = Glyphs::EmPixels(fontSize);
+            return em > 0.0f && em <= kMaxEmPixels;
+        }
+
+        // 取得字符串的字形序列，x 的小数部分决定起始亚像素位置；
+        // 返回值在下一次调用 Layout/Clear 前有效，字号不可缓存或图集放不下时返回 nullptr
+        const TextRun* Layout(const wchar_t* text, size_t length, float x, float fontSize, bool antiAlias) {
+            if (!Cacheable(fontSize)) return nullptr;
+            int startSub = static_cast<int>((x - std::floor(x)) * kRunOriginSteps + 0.5f);
+            uint32_t sizeBits;
+            std::memcpy(&sizeBits, &fontSize, sizeof(sizeBits));
+            const uint64_t params = (uint64_t(sizeBits) << 32) | (uint64_t(startSub) << 1) | (antiAlias ? 1u : 0u);
+
+            const bool cacheRun = length <= kMaxRunLength;
+            if (cacheRun) {
+                m_key.text.assign(text, length);
+                m_key.params = params;
+                if (TextRun* run = m_runs.Find(m_key)) return run;
+            }
+
+            // 图集在排版途中被清空时，已取得的字形下标失效，重排一次
+            bool built = false;
+            for (int attempt = 0; attempt < 2 && !built; ++attempt) {
+                built = BuildRun(text, length, startSub, fontSize, sizeBits, antiAlias, m_scratch);
+            }
+            if (!built) return nullptr;
+            if (!cacheRun) return &m_scratch;
+            return m_runs.Get(m_key, [&] { return std::move(m_scratch); });
+        }
+
+        const Glyph& GlyphAt(uint32_t index) const { return m_glyphs[index]; }
+
+        // 字形掩码第 row 行
+        const uint8_t* MaskRow(const Glyph& g, int row) const {
+            return m_pages[g.page].pixels.data() + size_t(g.y + row) * kPageSize + g.x;
+        }
+
+        // 清空图集与序列缓存
+        void Clear() {
+            m_glyphs.clear();
+            m_glyphIndex.clear();
+            m_pages.clear();
+            m_runs.Clear();
+        }
+
+        void SetMaxRuns(size_t maxRuns) { m_runs.SetCapacity(maxRuns); }
+
+        Stats GetStats() const {
+            Stats s = m_stats;
+            OtterCache::CacheStats runs = m_runs.Stats();
+            s.runHits = runs.hits;
+            s.runMisses = runs.misses;
+            s.runs = runs.size;
+            s.glyphs = m_glyphs.size();
+            s.atlasPages = m_pages.size();
+            for (const Page& p : m_pages) s.atlasOccupancy += p.packer.Occupancy();
+            if (!m_pages.empty()) s.atlasOccupancy /= double(m_pages.size());
+            return s;
+        }
+
+        void ResetStats() {
+            m_stats = Stats();
+            m_runs.ResetStats();
+        }
+
+    private:
+        struct Page {
+            std::vector<uint8_t> pixels;
+            SkylinePacker packer;
+        };
+
+        struct RunKey {
+            std::wstring text;
+            uint64_t params = 0;
+            bool operator==(const RunKey& o) const { return params == o.params && text == o.text; }
+        };
+
+        struct RunKeyHash {
+            size_t operator()(const RunKey& k) const {
+                return std::hash<std::wstring>()(k.text) ^ (std::hash<uint64_t>()(k.params) * 0x9E3779B97F4A7C15ull);
+            }
+        };
+
+        bool BuildRun(const wchar_t* text, size_t length, int startSub, float fontSize, uint32_t sizeBits,
+            bool antiAlias, TextRun& run) {
+            const float scale = Glyphs::EmPixels(fontSize) / FontData::kUnitsPerEm;
+            const float lineHeight = Glyphs::LineHeight(fontSize);
+            const float startX = float(startSub) / kRunOriginSteps;
+            const size_t resets = m_stats.atlasResets;
+            run.glyphs.clear();
+            run.bounds = Rect();
+            float penX = startX;
+            int line = 0;
+            for (size_t i = 0; i < length; ++i) {
+                wchar_t ch = text[i];
+                if (ch == L'\n') {
+                    penX = startX;
+                    ++line;
+                    continue;
+                }
+                const int index = Glyphs::IndexOf(ch);
+                float gx = std::floor(penX);
+                int sub = static_cast<int>((penX - gx) * kSubpixelSteps + 0.5f);
+                if (sub == kSubpixelSteps) { gx += 1.0f; sub = 0; }
+                uint32_t gi;
+                if (!FindGlyph(index, sub, sizeBits, scale, antiAlias, gi)) return false;
+                if (m_stats.atlasResets != resets) return false;
+                const Glyph& g = m_glyphs[gi];
+                if (g.width) {
+                    RunGlyph rg{ int(gx) + g.left, int(std::floor(line * lineHeight + 0.5f)) + g.top, gi };
+                    run.glyphs.push_back(rg);
+                    run.bounds = run.bounds.Union(Rect(rg.x, rg.y, g.width, g.height));
+                }
+                penX += FontData::kGlyphs[index].advance * scale;
+            }
+            return true;
+        }
+
+        bool FindGlyph(int index, int sub, uint32_t sizeBits, float scale, bool antiAlias, uint32_t& out) {
+            const uint64_t key = (uint64_t(sizeBits) << 32) | (uint64_t(index) << 8) | (uint64_t(sub) << 1) | (antiAlias ? 1u : 0u);
+            auto it = m_glyphIndex.find(key);
+            if (it != m_glyphIndex.end()) {
+                ++m_stats.glyphHits;
+                out = it->second;
+                return true;
+            }
+            ++m_stats.glyphMisses;
+
+            Glyphs::AddOutline(m_raster, FontData::kGlyphs[index], float(sub) / kSubpixelSteps, 0.0f, scale);
+            const Rect b = m_raster.PathBounds();
+            Glyph g;
+            if (!b.IsEmpty()) {
+                Point pos;
+                int page = Allocate(b.w, b.h, pos);
+                if (page < 0) { m_raster.Reset(); return false; }
+                g.left = int16_t(b.x); g.top = int16_t(b.y);
+                g.width = uint16_t(b.w); g.height = uint16_t(b.h);
+                g.x = uint16_t(pos.X); g.y = uint16_t(pos.Y);
+                g.page = uint16_t(page);
+                m_raster.FillMask(m_pages[page].pixels.data() + size_t(pos.Y) * kPageSize + pos.X, kPageSize, b,
+                    FillRule::NonZero, antiAlias);
+            }
+            m_raster.Reset();
+            out = static_cast<uint32_t>(m_glyphs.size());
+            m_glyphs.push_back(g);
+            m_glyphIndex.emplace(key, out);
+            return true;
+        }
+
+        // 在现有页中分配；都放不下时新建页，页数已满则清空整个缓存（调用方需重排）
+        int Allocate(int w, int h, Point& pos) {
+            if (w > kPageSize || h > kPageSize) return -1;
+            for (size_t i = 0; i < m_pages.size(); ++i) {
+                if (m_pages[i].packer.Insert(w, h, pos)) return int(i);
+            }
+            if (int(m_pages.size()) >= m_maxPages) {
+                Clear();
+                ++m_stats.atlasResets;
+            }
+            m_pages.emplace_back();
+            Page& page = m_pages.back();
+            page.pixels.assign(size_t(kPageSize) * kPageSize, 0);
+            page.packer.Reset(kPageSize, kPageSize);
+            return page.packer.Insert(w, h, pos) ? int(m_pages.size() - 1) : -1;
+        }
+
+        std::vector<Glyph> m_glyphs;
+        std::unordered_map<uint64_t, uint32_t> m_glyphIndex;
+        std::vector<Page> m_pages;
+        OtterCache::LruCache<RunKey, TextRun, RunKeyHash> m_runs;
+        int m_maxPages;
+        RunKey m_key;
+        TextRun m_scratch;
+        Rasterizer m_raster;
+        Stats m_stats;
+    };
+
+    // 描边缓存：按 (路径标识与版本, 画笔) 或 (折线坐标, 是否闭合, 画笔) 缓存描边几何，
+    // 静态的坐标轴、边框等每帧只需填充缓存的轮廓。非线程安全：每个线程使用 ForThread() 的实例或自行持有
+    class StrokeCache {
+    public:
+        static constexpr size_t kMaxCachedPoints = 65536;  // 更长的折线/路径不缓存，直接描边
+
+        struct Stats {
+            size_t hits = 0, misses = 0, entries = 0;
+            size_t bypassed = 0;        // 超出长度上限而未缓存的次数
+            size_t points = 0;          // 缓存中描边几何的总点数
+        };
+
+        explicit StrokeCache(size_t capacity = 512) : m_entries(capacity) {}
+
+        static StrokeCache& ForThread() {
+            static thread_local StrokeCache cache;
+            return cache;
+        }
+
+        // 值得缓存的描边：宽线、虚线或需要圆弧的线帽，且不是单条平头/方头线段（直接生成只有一个四边形）
+        static bool Cacheable(size_t count, const StrokeStyle& style) {
+            if (count > kMaxCachedPoints) return false;
+            const bool dashed = style.Dashed();
+            if (style.width <= 1.0f && !dashed) return false;
+            return count > 2 || dashed || style.cap == LineCap::Round;
+        }
+
+        // 返回值在下一次调用 Get/Clear 前有效
+        const StrokeGeometry& Get(const Path& path, const StrokeStyle& style) {
+            if (path.Points().size() > kMaxCachedPoints) {
+                ++m_stats.bypassed;
+                m_scratch.Clear();
+                m_stroker.Stroke(path, style, m_scratch);
+                return m_scratch;
+            }
+            m_key.id = path.Id();
+            m_key.bytes.clear();
+            AppendStyle(style);
+            const uint64_t version = path.Version();
+            m_key.bytes.append(reinterpret_cast<const char*>(&version), sizeof(version));
+            return *m_entries.Get(m_key, [&] {
+                StrokeGeometry g;
+                m_stroker.Stroke(path, style, g);
+                return g;
+            });
+        }
+
+        template <typename PointT>
+        const StrokeGeometry& Get(const PointT* points, size_t count, bool closed, const StrokeStyle& style) {
+            if (count > kMaxCachedPoints) {
+                ++m_stats.bypassed;
+                m_scratch.Clear();
+                m_stroker.Stroke(points, count, closed, style, m_scratch);
+                return m_scratch;
+            }
+            m_key.id = 0;
+            m_key.bytes.clear();
+            AppendStyle(style);
+            m_key.bytes.push_back(closed ? 'c' : 'o');
+            m_key.bytes.reserve(m_key.bytes.size() + count * 2 * sizeof(float));
+            for (size_t i = 0; i < count; ++i) {
+                Append(float(points[i].X));
+                Append(float(points[i].Y));
+            }
+            return *m_entries.Get(m_key, [&] {
+                StrokeGeometry g;
+                m_stroker.Stroke(points, count, closed, style, g);
+                return g;
+            });
+        }
+
+        void Clear() { m_entries.Clear(); }
+        void SetCapacity(size_t capacity) { m_entries.SetCapacity(capacity); }
+
+        Stats GetStats() {
+            Stats s = m_stats;
+            OtterCache::CacheStats entries = m_entries.Stats();
+            s.hits = entries.hits;
+            s.misses = entries.misses;
+            s.entries = entries.size;
+            m_entries.ForEach([&](const Key&, StrokeGeometry& g) { s.points += g.points.size(); });
+            return s;
+        }
+
+        void ResetStats() {
+            m_stats = Stats();
+            m_entries.ResetStats();
+        }
+
+    private:
+        // id 为路径标识（按坐标缓存时为0），bytes 为画笔参数、路径版本或坐标的原始字节
+        struct Key {
+            uint64_t id = 0;
+            std::string bytes;
+            bool operator==(const Key& o) const { return id == o.id && bytes == o.bytes; }
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& k) const {
+                return std::hash<std::string>()(k.bytes) ^ (std::hash<uint64_t>()(k.id) * 0x9E3779B97F4A7C15ull);
+            }
+        };
+
+        void Append(float v) { m_key.bytes.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+        void AppendStyle(const StrokeStyle& style) {
+            Append(style.width);
+            Append(style.miterLimit);
+            m_key.bytes.push_back(char(style.join));
+            m_key.bytes.push_back(char(style.cap));
+            if (style.Dashed()) {
+                Append(style.dashOffset);
+                for (float d : style.dashes) Append(d);
+            }
+        }
+
+        OtterCache::LruCache<Key, StrokeGeometry, KeyHash> m_entries;
+        Key m_key;
+        Stroker m_stroker;
+        StrokeGeometry m_scratch;
+        Stats m_stats;
+    };
+
+    // 逐像素着色器（渐变等）：为第 y 行从 x 开始的 count 个像素写出预乘颜色，坐标为画布坐标（不含原点偏移），
+    // 采样点为像素中心。实现须可在多个线程上同时调用
+    class Shader {
+    public:
+        virtual ~Shader() = default;
+        virtual void ShadeRow(int x, int y, int count, uint32_t* out) const = 0;
+        virtual bool IsOpaque() const { return false; }     // 所有输出像素不透明时全覆盖段直接复制
+    };
+
+    // 画布：与 OtterPaintbrush 同名的绘制接口，直接写入 Surface
+    // 约定：填充几何使用像素边界坐标；描边坐标偏移半像素，使整数坐标的1像素线条清晰
+    class Canvas {
+    public:
+        explicit Canvas(Surface* surface = nullptr) : m_surface(surface) {
+            if (surface) m_clip = surface->Bounds();
+        }
+
+        void SetSurface(Surface* surface) {
+            m_surface = surface;
+            m_clip = surface ? surface->Bounds() : Rect();
+        }
+
+        Surface* GetSurface() const { return m_surface; }
+
+        void SetAntiAlias(bool enabled) { m_antiAlias = enabled; }
+        bool GetAntiAlias() const { return m_antiAlias; }
+
+        void SetClip(const Rect& clip) { m_clip = m_surface ? clip.Intersect(m_surface->Bounds()) : Rect(); }
+        const Rect& GetClip() const { return m_clip; }
+
+        // 清除裁剪矩形与裁剪区域
+        void ResetClip() {
+            m_clip = m_surface ? m_surface->Bounds() : Rect();
+            m_clipRects.clear();
+            m_hasClipRects = false;
+        }
+
+        // 多矩形裁剪区域（如损坏区域），与 SetClip 的矩形求交后生效；count 为0表示全部裁掉
+        void SetClipRects(const Rect* rects, size_t count) {
+            m_clipRects.assign(rects, rects + count);
+            m_hasClipRects = true;
+        }
+
+        void ResetClipRects() {
+            m_clipRects.clear();
+            m_hasClipRects = false;
+        }
+
+        bool HasClipRects() const { return m_hasClipRects; }
+        const std::vector<Rect>& GetClipRects() const { return m_clipRects; }
+
+        // 对每个有效裁剪矩形调用 fn(const Rect&)
+        template <typename Fn>
+        void ForEachClip(Fn&& fn) const {
+            if (!m_hasClipRects) {
+                if (!m_clip.IsEmpty()) fn(m_clip);
+                return;
+            }
+            for (const Rect& r : m_clipRects) {
+                Rect c = r.Intersect(m_clip);
+                if (!c.IsEmpty()) fn(c);
+            }
+        }
+
+        // 坐标原点偏移：之后的图元坐标加上 (dx, dy)，裁剪矩形仍为设备坐标
+        void SetOrigin(int dx, int dy) { m_originX = dx; m_originY = dy; }
+        Point GetOrigin() const { return Point(m_originX, m_originY); }
+
+        // 清空裁剪区域（直接写入，不混合）
+        void Clear(Color color) {
+            if (!Ready()) return;
+            uint32_t c = Premultiply(color);
+            ForEachClip([&](const Rect& clip) {
+                for (int y = clip.y; y < clip.Bottom(); ++y) Span::Fill(m_surface->Row(y) + clip.x, clip.w, c);
+            });
+        }
+
+        void FillRectangle(int x, int y, int width, int height, Color color) {
+            if (!Ready()) return;
+            const Rect rect(x + m_originX, y + m_originY, width, height);
+            uint32_t c = Premultiply(color);
+            ForEachClip([&](const Rect& clip) {
+                Rect r = rect.Intersect(clip);
+                for (int yy = r.y; yy < r.Bottom(); ++yy) Span::FillOver(m_surface->Row(yy) + r.x, r.w, c);
+            });
+        }
+
+        void FillRectangle(int x, int y, int width, int height, const Shader& shader) {
+            if (!Ready()) return;
+            const Rect rect(x + m_originX, y + m_originY, width, height);
+            ForEachClip([&](const Rect& clip) {
+                Rect r = rect.Intersect(clip);
+                if (r.IsEmpty()) return;
+                if (m_shade.size() < size_t(r.w)) m_shade.resize(size_t(r.w));
+                for (int yy = r.y; yy < r.Bottom(); ++yy) {
+                    uint32_t* dst = m_surface->Row(yy) + r.x;
+                    if (shader.IsOpaque()) {
+                        shader.ShadeRow(r.x - m_originX, yy - m_originY, r.w, dst);
+                        continue;
+                    }
+                    shader.ShadeRow(r.x - m_originX, yy - m_originY, r.w, m_shade.data());
+                    Span::BlendOver(dst, m_shade.data(), r.w);
+                }
+            });
+        }
+
+        void DrawRectangle(int x, int y, int width, int height, Color color, float penWidth = 1.0f) {
+            if (!Ready()) return;
+            float hw = penWidth * 0.5f;
+            x += m_originX; y += m_originY;
+            float x0 = x + 0.5f, y0 = y + 0.5f, x1 = x + width + 0.5f, y1 = y + height + 0.5f;
+            const PointF outer[4] = { {x0 - hw, y0 - hw}, {x1 + hw, y0 - hw}, {x1 + hw, y1 + hw}, {x0 - hw, y1 + hw} };
+            m_raster.AddPolygon(outer, 4);
+            if (x1 - x0 > penWidth && y1 - y0 > penWidth) {
+                const PointF inner[4] = { {x0 + hw, y0 + hw}, {x0 + hw, y1 - hw}, {x1 - hw, y1 - hw}, {x1 - hw, y0 + hw} };
+                m_raster.AddPolygon(inner, 4);
+            }
+            FillPath(color, FillRule::NonZero);
+        }
+
+        // 按画笔（拐角、线帽、虚线）描边矩形
+        void DrawRectangle(int x, int y, int width, int height, Color color, const StrokeStyle& style) {
+            const Point corners[4] = { {x, y}, {x + width, y}, {x + width, y + height}, {x, y + height} };
+            StrokePolyline(corners, 4, true, color, style);
+        }
+
+        void FillCircle(int x, int y, int radius, Color color) {
+            Ring(float(x + m_originX), float(y + m_originY), 0.0f, float(radius), color);
+        }
+
+        void FillCircle(int x, int y, int radius, const Shader& shader) {
+            const float cx = float(x + m_originX), cy = float(y + m_originY), outer = float(radius);
+            if (!Ready() || outer <= 0.0f) return;
+            ForEachClip([&](const Rect& clip) {
+                RingCoverage(cx, cy, 0.0f, outer, clip, [&](int yy, int xs, const uint8_t* cover, int count) {
+                    ShadeCoverage(yy, xs, cover, count, shader);
+                });
+            });
+        }
+
+        void DrawCircle(int x, int y, int radius, Color color, float penWidth = 1.0f) {
+            float hw = penWidth * 0.5f;
+            Ring(x + m_originX + 0.5f, y + m_originY + 0.5f, (std::max)(0.0f, radius - hw), radius + hw, color);
+        }
+
+        // 实线仍按解析式圆环绘制；虚线先把圆展平为折线再描边
+        void DrawCircle(int x, int y, int radius, Color color, const StrokeStyle& style) {
+            if (!style.Dashed()) {
+                DrawCircle(x, y, radius, color, style.width);
+                return;
+            }
+            if (!Ready() || radius <= 0) return;
+            const float r = float(radius);
+            const float step = 2.0f * std::acos((std::max)(0.0f, 1.0f - Stroker::kTolerance / r));
+            const int n = (std::max)(8, (std::min)(4096, static_cast<int>(std::ceil(6.28318531f / (std::max)(step, 0.001f)))));
+            m_circle.resize(size_t(n));
+            for (int i = 0; i < n; ++i) {
+                const float a = 6.28318531f * i / n;
+                m_circle[size_t(i)] = PointF(x + r * std::cos(a), y + r * std::sin(a));
+            }
+            StrokePolyline(m_circle.data(), m_circle.size(), true, color, style);
+        }
+
+        template <typename PointT>
+        void FillPolygon(const std::vector<PointT>& points, Color color, FillRule rule = FillRule::NonZero) {
+            FillPolygon(points.data(), points.size(), color, rule);
+        }
+
+        template <typename PointT>
+        void FillPolygon(const PointT* points, size_t count, Color color, FillRule rule = FillRule::NonZero) {
+            if (!Ready() || count < 3) return;
+            m_raster.AddPolygon(points, count, float(m_originX), float(m_originY));
+            FillPath(color, rule);
+        }
+
+        template <typename PointT>
+        void FillPolygon(const std::vector<PointT>& points, const Shader& shader, FillRule rule = FillRule::NonZero) {
+            FillPolygon(points.data(), points.size(), shader, rule);
+        }
+
+        template <typename PointT>
+        void FillPolygon(const PointT* points, size_t count, const Shader& shader, FillRule rule = FillRule::NonZero) {
+            if (!Ready() || count < 3) return;
+            m_raster.AddPolygon(points, count, float(m_originX), float(m_originY));
+            FillPath(shader, rule);
+        }
+
+        template <typename PointT>
+        void DrawPolygon(const std::vector<PointT>& points, Color color, float penWidth = 1.0f) {
+            DrawPolygon(points.data(), points.size(), color, penWidth);
+        }
+
+        template <typename PointT>
+        void DrawPolygon(const PointT* points, size_t count, Color color, float penWidth = 1.0f) {
+            if (count < 2) return;
+            StrokePolyline(points, count, true, color, StrokeStyle(penWidth));
+        }
+
+        template <typename PointT>
+        void DrawPolygon(const std::vector<PointT>& points, Color color, const StrokeStyle& style) {
+            DrawPolygon(points.data(), points.size(), color, style);
+        }
+
+        template <typename PointT>
+        void DrawPolygon(const PointT* points, size_t count, Color color, const StrokeStyle& style) {
+            if (count < 2) return;
+            StrokePolyline(points, count, true, color, style);
+        }
+
+        // 开放折线描边（首尾不相连，两端为线帽）
+        template <typename PointT>
+        void DrawPolyline(const std::vector<PointT>& points, Color color, const StrokeStyle& style) {
+            DrawPolyline(points.data(), points.size(), color, style);
+        }
+
+        template <typename PointT>
+        void DrawPolyline(const PointT* points, size_t count, Color color, const StrokeStyle& style) {
+            if (count == 0) return;
+            StrokePolyline(points, count, false, color, style);
+        }
+
+        // 浮点路径填充：坐标不取整，曲线自适应展平
+        void FillPath(const Path& path, Color color, FillRule rule = FillRule::NonZero) {
+            if (!Ready() || path.Empty()) return;
+            m_raster.AddPath(path, float(m_originX), float(m_originY));
+            FillPath(color, rule);
+        }
+
+        void FillPath(const Path& path, const Shader& shader, FillRule rule = FillRule::NonZero) {
+            if (!Ready() || path.Empty()) return;
+            m_raster.AddPath(path, float(m_originX), float(m_originY));
+            FillPath(shader, rule);
+        }
+
+        // 路径描边：与 DrawPolygon 相同，坐标偏移半像素；宽线与虚线的描边几何按 (路径标识与版本, 画笔) 缓存
+        void StrokePath(const Path& path, Color color, float penWidth = 1.0f) {
+            StrokePath(path, color, StrokeStyle(penWidth));
+        }
+
+        void StrokePath(const Path& path, Color color, const StrokeStyle& style) {
+            if (!Ready() || path.Empty()) return;
+            const float ox = m_originX + 0.5f, oy = m_originY + 0.5f;
+            if (m_strokeCaching && StrokeCache::Cacheable(path.Points().size(), style)) {
+                FillStroke(Strokes().Get(path, style), ox, oy, color);
+                return;
+            }
+            m_stroke.Clear();
+            m_stroker.Stroke(path, style, m_stroke);
+            FillStroke(m_stroke, ox, oy, color);
+        }
+
+        void DrawLine(int x1, int y1, int x2, int y2, Color color, float penWidth = 1.0f) {
+            DrawLine(float(x1), float(y1), float(x2), float(y2), color, penWidth);
+        }
+
+        void DrawLine(float x1, float y1, float x2, float y2, Color color, float penWidth = 1.0f) {
+            DrawLine(x1, y1, x2, y2, color, StrokeStyle(penWidth));
+        }
+
+        void DrawLine(float x1, float y1, float x2, float y2, Color color, const StrokeStyle& style) {
+            const PointF ends[2] = { {x1, y1}, {x2, y2} };
+            StrokePolyline(ends, 2, false, color, style);
+        }
+
+        // 描边缓存：cache 为 nullptr 时使用当前线程的 StrokeCache::ForThread()
+        void SetStrokeCache(StrokeCache* cache) { m_strokeCache = cache; }
+        void EnableStrokeCache(bool enabled) { m_strokeCaching = enabled; }
+        bool IsStrokeCacheEnabled() const { return m_strokeCaching; }
+
+        // 文本：使用内置矢量字体，fontSize 单位为磅（96 DPI 下 1磅 = 4/3 像素，与GDI+默认一致）
+        void DrawString(const std::wstring& text, float x, float y, float fontSize, Color color) {
+            DrawString(text.data(), text.size(), x, y, fontSize, color);
+        }
+
+        // 基线对齐到整像素；字号不超过 GlyphCache::kMaxEmPixels 时经字形缓存绘制，否则按路径填充
+        void DrawString(const wchar_t* text, size_t length, float x, float y, float fontSize, Color color) {
+            if (!Ready() || length == 0) return;
+            const float scale = EmPixels(fontSize) / FontData::kUnitsPerEm;
+            x += m_originX;
+            const float baseline = std::floor(y + m_originY + FontData::kAscender * scale + 0.5f);
+            if (m_glyphCaching) {
+                GlyphCache& cache = m_glyphCache ? *m_glyphCache : GlyphCache::ForThread();
+                if (const GlyphCache::TextRun* run = cache.Layout(text, length, x, fontSize, m_antiAlias)) {
+                    DrawRun(cache, *run, static_cast<int>(std::floor(x)), static_cast<int>(baseline), Premultiply(color));
+                    return;
+                }
+            }
+            const float lineHeight = LineHeight(fontSize);
+            float penX = x;
+            int line = 0;
+            for (size_t i = 0; i < length; ++i) {
+                wchar_t ch = text[i];
+                if (ch == L'\n') {
+                    penX = x;
+                    ++line;
+                    continue;
+                }
+                const FontData::Glyph& g = GlyphFor(ch);
+                Glyphs::AddOutline(m_raster, g, penX, baseline + std::floor(line * lineHeight + 0.5f), scale);
+                penX += g.advance * scale;
+            }
+            FillPath(color, FillRule::NonZero);
+        }
+
+        // 文本字形缓存：cache 为 nullptr 时使用当前线程的 GlyphCache::ForThread()
+        void SetGlyphCache(GlyphCache* cache) { m_glyphCache = cache; }
+        void EnableGlyphCache(bool enabled) { m_glyphCaching = enabled; }
+        bool IsGlyphCacheEnabled() const { return m_glyphCaching; }
+
+        // 文本尺寸（像素）
+        static PointF MeasureString(const std::wstring& text, float fontSize) {
+            return MeasureString(text.data(), text.size(), fontSize);
+        }
+
+        static PointF MeasureString(const wchar_t* text, size_t length, float fontSize) {
+            const float scale = EmPixels(fontSize) / FontData::kUnitsPerEm;
+            float lineW = 0, maxW = 0;
+            int lines = 1;
+            for (size_t i = 0; i < length; ++i) {
+                wchar_t ch = text[i];
+                if (ch == L'\n') { maxW = (std::max)(maxW, lineW); lineW = 0; ++lines; continue; }
+                lineW += GlyphFor(ch).advance * scale;
+            }
+            return PointF((std::max)(maxW, lineW), lines * LineHeight(fontSize));
+        }
+
+        static float EmPixels(float fontSize) { return Glyphs::EmPixels(fontSize); }
+        static float LineHeight(float fontSize) { return Glyphs::LineHeight(fontSize); }
+        static const FontData::Glyph& GlyphFor(wchar_t ch) { return Glyphs::For(ch); }
+
+        // 混合预乘表面（source-over），x/y 为目标左上角
+        void DrawSurface(const Surface& src, int x, int y) {
+            if (!Ready() || !src.Valid()) return;
+            x += m_originX; y += m_originY;
+            const Rect rect(x, y, src.Width(), src.Height());
+            ForEachClip([&](const Rect& clip) {
+                Rect r = rect.Intersect(clip);
+                for (int yy = r.y; yy < r.Bottom(); ++yy) {
+                    Span::BlendOver(m_surface->Row(yy) + r.x, src.Row(yy - y) + (r.x - x), r.w);
+                }
+            });
+        }
+
+        Rasterizer& GetRasterizer() { return m_raster; }
+
+    private:
+        bool Ready() const { return m_surface && m_surface->Valid() && !m_clip.IsEmpty(); }
+
+        // 按裁剪矩形逐个填充当前路径
+        void FillPath(Color color, FillRule rule) {
+            const uint32_t c = Premultiply(color);
+            if (!m_hasClipRects) {
+                m_raster.Fill(*m_surface, c, m_clip, rule, m_antiAlias);
+                return;
+            }
+            const Rect bounds = m_raster.PathBounds();
+            ForEachClip([&](const Rect& clip) {
+                if (!bounds.Intersect(clip).IsEmpty()) m_raster.Fill(*m_surface, c, clip, rule, m_antiAlias, true);
+            });
+            m_raster.Reset();
+        }
+
+        // 按裁剪矩形逐个用着色器填充当前路径
+        void FillPath(const Shader& shader, FillRule rule) {
+            const Rect bounds = m_raster.PathBounds();
+            ForEachClip([&](const Rect& clip) {
+                if (bounds.Intersect(clip).IsEmpty()) return;
+                m_raster.FillCoverage(clip, rule, m_antiAlias, true, [&](int y, int x, const uint8_t* cover, int w) {
+                    ShadeCoverage(y, x, cover, w, shader);
+                });
+            });
+            m_raster.Reset();
+        }
+
+        StrokeCache& Strokes() { return m_strokeCache ? *m_strokeCache : StrokeCache::ForThread(); }
+
+        // 折线描边，坐标偏移半像素（像素中心）；值得缓存时经描边缓存取得几何
+        template <typename PointT>
+        void StrokePolyline(const PointT* points, size_t count, bool closed, Color color, const StrokeStyle& style) {
+            if (!Ready()) return;
+            const float ox = m_originX + 0.5f, oy = m_originY + 0.5f;
+            if (m_strokeCaching && StrokeCache::Cacheable(count, style)) {
+                FillStroke(Strokes().Get(points, count, closed, style), ox, oy, color);
+                return;
+            }
+            m_stroke.Clear();
+            m_stroker.Stroke(points, count, closed, style, m_stroke);
+            FillStroke(m_stroke, ox, oy, color);
+        }
+
+        // 填充描边几何；包围盒在裁剪矩形外时跳过
+        void FillStroke(const StrokeGeometry& geometry, float dx, float dy, Color color) {
+            if (geometry.Empty()) return;
+            const Rect bounds(static_cast<int>(std::floor(geometry.min.X + dx)), static_cast<int>(std::floor(geometry.min.Y + dy)),
+                static_cast<int>(std::ceil(geometry.max.X - geometry.min.X)) + 2, static_cast<int>(std::ceil(geometry.max.Y - geometry.min.Y)) + 2);
+            if (bounds.Intersect(m_clip).IsEmpty()) return;
+            const PointF* p = geometry.points.data();
+            for (uint32_t n : geometry.contours) {
+                m_raster.AddPolygon(p, n, dx, dy);
+                p += n;
+            }
+            FillPath(color, FillRule::NonZero);
+        }
+
+        // 解析式圆环：覆盖率由像素中心到圆心的距离计算
+        void Ring(float cx, float cy, float inner, float outer, Color color) {
+            if (!Ready() || outer <= 0.0f) return;
+            ForEachClip([&](const Rect& clip) { RingClipped(cx, cy, inner, outer, color, clip); });
+        }
+
+        void RingClipped(float cx, float cy, float inner, float outer, Color color, const Rect& clip) {
+            const uint32_t c = Premultiply(color);
+            RingCoverage(cx, cy, inner, outer, clip, [&](int y, int xs, const uint8_t* cover, int count) {
+                Span::CoverageOver(m_surface->Row(y) + xs, cover, count, c);
+            });
+        }
+
+        // 圆环覆盖率逐行回调 fn(设备行号, 起始列, 覆盖率行, 宽度)
+        template <typename RowFn>
+        void RingCoverage(float cx, float cy, float inner, float outer, const Rect& clip, RowFn&& fn) {
+            int y0 = (std::max)(clip.y, static_cast<int>(std::floor(cy - outer - 1)));
+            int y1 = (std::min)(clip.Bottom(), static_cast<int>(std::ceil(cy + outer + 1)));
+            int xs = (std::max)(clip.x, static_cast<int>(std::floor(cx - outer - 1)));
+            int xe = (std::min)(clip.Right(), static_cast<int>(std::ceil(cx + outer + 1)));
+            if (xe <= xs || y1 <= y0) return;
+            m_cover.resize(size_t(xe - xs));
+            const float outerEdge = outer + 0.5f;
+            const float innerSolid = outer - 0.5f;
+            for (int y = y0; y < y1; ++y) {
+                float dy = y + 0.5f - cy;
+                if (std::fabs(dy) >= outerEdge) continue;
+                float solidHalf = (inner <= 0.0f && std::fabs(dy) < innerSolid)
+                    ? std::sqrt(innerSolid * innerSolid - dy * dy) : -1.0f;
+                bool any = false;
+                for (int x = xs; x < xe; ++x) {
+                    float dx = x + 0.5f - cx;
+                    float cov;
+                    if (std::fabs(dx) <= solidHalf) {
+                        cov = 1.0f;
+                    }
+                    else {
+                        float d = std::sqrt(dx * dx + dy * dy);
+                        cov = (std::min)(outer + 0.5f - d, 1.0f);
+                        if (inner > 0.0f) cov = (std::min)(cov, d - inner + 0.5f);
+                        cov = (std::max)(0.0f, cov);
+                    }
+                    uint8_t v = static_cast<uint8_t>(cov * 255.0f + 0.5f);
+                    if (!m_antiAlias) v = v >= 128 ? 255 : 0;
+                    m_cover[size_t(x - xs)] = v;
+                    any |= v != 0;
+                }
+                if (any) fn(y, xs, m_cover.data(), xe - xs);
+            }
+        }
+
+        // 覆盖率行混合着色器颜色：只为非零覆盖的连续段着色，全覆盖段不再乘覆盖率
+        void ShadeCoverage(int y, int x, const uint8_t* cover, int count, const Shader& shader) {
+            if (m_shade.size() < size_t(count)) m_shade.resize(size_t(count));
+            uint32_t* dst = m_surface->Row(y) + x;
+            int i = 0;
+            while (i < count) {
+                if (cover[i] == 0) { ++i; continue; }
+                int j = i;
+                bool full = true;
+                while (j < count && cover[j] != 0) full &= cover[j++] == 255;
+                const int n = j - i;
+                if (full && shader.IsOpaque()) {
+                    shader.ShadeRow(x + i - m_originX, y - m_originY, n, dst + i);
+                }
+                else {
+                    shader.ShadeRow(x + i - m_originX, y - m_originY, n, m_shade.data());
+                    if (full) Span::BlendOver(dst + i, m_shade.data(), n);
+                    else Span::MaskBlendOver(dst + i, m_shade.data(), cover + i, n);
+                }
+                i = j;
+            }
+        }
+
+        // 逐字形按裁剪矩形做掩码混合
+        void DrawRun(const GlyphCache& cache, const GlyphCache::TextRun& run, int ox, int oy, uint32_t color) {
+            const Rect bounds(run.bounds.x + ox, run.bounds.y + oy, run.bounds.w, run.bounds.h);
+            ForEachClip([&](const Rect& clip) {
+                if (bounds.Intersect(clip).IsEmpty()) return;
+                for (const GlyphCache::RunGlyph& rg : run.glyphs) {
+                    const GlyphCache::Glyph& g = cache.GlyphAt(rg.glyph);
+                    const int gx = ox + rg.x, gy = oy + rg.y;
+                    const Rect r = Rect(gx, gy, g.width, g.height).Intersect(clip);
+                    for (int yy = r.y; yy < r.Bottom(); ++yy) {
+                        Span::MaskOver(m_surface->Row(yy) + r.x, cache.MaskRow(g, yy - gy) + (r.x - gx), r.w, color);
+                    }
+                }
+            });
+        }
+
+        Surface* m_surface = nullptr;
+        Rect m_clip;
+        std::vector<Rect> m_clipRects;
+        bool m_hasClipRects = false;
+        int m_originX = 0, m_originY = 0;
+        bool m_antiAlias = true;
+        Rasterizer m_raster;
+        std::vector<uint8_t> m_cover;
+        std::vector<uint32_t> m_shade;      // 着色器输出行
+        std::vector<PointF> m_circle;       // 虚线圆的展平缓冲区
+        Stroker m_stroker;                  // 不缓存的描边
+        StrokeGeometry m_stroke;
+        StrokeCache* m_strokeCache = nullptr;
+        bool m_strokeCaching = true;
+        GlyphCache* m_glyphCache = nullptr;
+        bool m_glyphCaching = true;
+    };
+
+    // 逐像素比较结果
+    struct CompareResult {
+        long long mismatched = 0;   // 任一通道差值超过容差的像素数
+        int maxDelta = 0;           // 最大通道差值
+        bool sameSize = true;
+        bool Matches() const { return sameSize && mismatched == 0; }
+    };
+
+    inline CompareResult CompareSurfaces(const Surface& a, const Surface& b, int tolerance = 0) {
+        CompareResult r;
+        if (a.Width() != b.Width() || a.Height() != b.Height()) { r.sameSize = false; return r; }
+        for (int y = 0; y < a.Height(); ++y) {
+            const uint32_t* ra = a.Row(y);
+            const uint32_t* rb = b.Row(y);
+            for (int x = 0; x < a.Width(); ++x) {
+                if (ra[x] == rb[x]) continue;
+                int worst = 0;
+                for (int s = 0; s < 32; s += 8) {
+                    int d = std::abs(int((ra[x] >> s) & 0xFF) - int((rb[x] >> s) & 0xFF));
+                    worst = (std::max)(worst, d);
+                }
+                r.maxDelta = (std::max)(r.maxDelta, worst);
+                if (worst > tolerance) ++r.mismatched;
+            }
+        }
+        return r;
+    }
+
+    // 图元吞吐量（每秒图元数）
+    struct PrimitiveBenchmark {
+        double fillRectPerSec = 0, fillCirclePerSec = 0, fillPolygonPerSec = 0;
+        double drawLinePerSec = 0, drawStringPerSec = 0;
+    };
+
+    inline PrimitiveBenchmark BenchmarkPrimitives(int width = 1280, int height = 720, int count = 20000) {
+        using Clock = std::chrono::steady_clock;
+        Surface surface(width, height);
+        Canvas canvas(&surface);
+        PrimitiveBenchmark bench;
+        auto run = [&](auto&& draw) {
+            auto t0 = Clock::now();
+            for (int i = 0; i < count; ++i) draw(i);
+            double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+            return sec > 0 ? count / sec : 0.0;
+        };
+        auto px = [&](int i) { return (i * 7919) % width; };
+        auto py = [&](int i) { return (i * 104729) % height; };
+        bench.fillRectPerSec = run([&](int i) { canvas.FillRectangle(px(i), py(i), 24, 16, Color(200, 30, 120, 220)); });
+        bench.fillCirclePerSec = run([&](int i) { canvas.FillCircle(px(i), py(i), 10, Color(180, 220, 60, 40)); });
+        bench.fillPolygonPerSec = run([&](int i) {
+            const Point tri[3] = { {px(i), py(i)}, {px(i) + 20, py(i) + 5}, {px(i) + 8, py(i) + 22} };
+            canvas.FillPolygon(tri, 3, Color(160, 20, 200, 90));
+        });
+        bench.drawLinePerSec = run([&](int i) { canvas.DrawLine(px(i), py(i), px(i) + 30, py(i) + 12, Color(255, 0, 0, 0)); });
+        bench.drawStringPerSec = run([&](int i) { canvas.DrawString(L"CPU 42%", float(px(i)), float(py(i)), 9.0f, Color(255, 0, 0, 0)); });
+        return bench;
+    }
+
+    // 表格文本吞吐量（每秒绘制的标签数）：每帧重绘 rows×cols 个短标签，少量标签逐帧变化
+    struct TextBenchmark {
+        double uncachedLabelsPerSec = 0, cachedLabelsPerSec = 0;
+        GlyphCache::Stats stats;
+    };
+
+    inline TextBenchmark BenchmarkText(int rows = 60, int cols = 8, int frames = 30, float fontSize = 9.0f) {
+        using Clock = std::chrono::steady_clock;
+        Surface surface(cols * 120, rows * 16);
+        Canvas canvas(&surface);
+        GlyphCache cache;
+        canvas.SetGlyphCache(&cache);
+        std::wstring label;
+        auto run = [&](bool cached) {
+            canvas.EnableGlyphCache(cached);
+            auto t0 = Clock::now();
+            for (int f = 0; f < frames; ++f) {
+                canvas.Clear(Color(255, 255, 255, 255));
+                for (int r = 0; r < rows; ++r) {
+                    for (int c = 0; c < cols; ++c) {
+                        int value = (r * 31 + c * 17 + (c == 0 ? f : 0)) % 1000;    // 第一列每帧变化
+                        label = L"Item " + std::to_wstring(value) + L".5%";
+                        canvas.DrawString(label, c * 120.0f + 4.0f, r * 16.0f + 2.0f, fontSize, Color(255, 0, 0, 0));
+                    }
+                }
+            }
+            double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+            return sec > 0 ? double(rows) * cols * frames / sec : 0.0;
+        };
+        TextBenchmark bench;
+        bench.uncachedLabelsPerSec = run(false);
+        bench.cachedLabelsPerSec = run(true);
+        bench.stats = cache.GetStats();
+        return bench;
+    }
+
+    // 浮点路径耗时（毫秒/次）：segments 段折线的面积图（非零与奇偶规则）、segments 段三次曲线的波形、折线描边
+    struct PathBenchmark {
+        size_t segments = 0;
+        size_t curveLines = 0;          // 曲线路径展平后的线段数
+        double polylineNonZeroMs = 0, polylineEvenOddMs = 0, curveFillMs = 0, strokeMs = 0;
+
+        double SegmentsPerSec(double ms) const { return ms > 0 ? segments / (ms / 1e3) : 0.0; }
+    };
+
+    inline PathBenchmark BenchmarkPaths(int width = 1280, int height = 720, int segments = 100000, int iterations = 5) {
+        using Clock = std::chrono::steady_clock;
+        Surface surface(width, height);
+        Canvas canvas(&surface);
+        segments = (std::max)(segments, 1);
+
+        // 伪随机游走，结果可复现
+        std::vector<float> values(size_t(segments) + 1);
+        uint32_t seed = 12345;
+        float v = height * 0.5f;
+        for (float& value : values) {
+            seed = seed * 1664525u + 1013904223u;
+            v += (float((seed >> 8) & 0xFFFF) / 65535.0f - 0.5f) * height * 0.02f;
+            v = (std::min)((std::max)(v, height * 0.1f), height * 0.9f);
+            value = v;
+        }
+        const float step = float(width) / segments;
+
+        Path area, line, curve;
+        area.Reserve(size_t(segments) + 4, size_t(segments) + 4);
+        line.Reserve(size_t(segments) + 1, size_t(segments) + 1);
+        area.MoveTo(0.0f, float(height));
+        line.MoveTo(0.0f, values[0]);
+        for (int i = 0; i <= segments; ++i) {
+            area.LineTo(i * step, values[size_t(i)]);
+            if (i > 0) line.LineTo(i * step, values[size_t(i)]);
+        }
+        area.LineTo(float(width), float(height));
+        area.Close();
+
+        curve.MoveTo(0.0f, height * 0.5f);
+        const float amplitude = height * 0.4f;
+        for (int i = 0; i < segments; ++i) {
+            const float x0 = i * step, x1 = x0 + step;
+            const float y = height * 0.5f + ((i & 1) ? amplitude : -amplitude) * (0.5f + 0.5f * float(i % 7) / 6.0f);
+            curve.CubicTo(x0 + step * 0.3f, y, x1 - step * 0.3f, y, x1, height * 0.5f);
+        }
+        curve.Close();
+        std::vector<PointF> scratch;
+        PathBenchmark bench;
+        bench.segments = size_t(segments);
+        curve.Flatten(Path::kDefaultTolerance, scratch, [&](const PointF*, size_t n, bool) { bench.curveLines += n; });
+
+        auto run = [&](auto&& draw) {
+            canvas.Clear(Color(255, 255, 255, 255));
+            const auto t0 = Clock::now();
+            for (int i = 0; i < iterations; ++i) draw();
+            return std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / (std::max)(iterations, 1);
+        };
+        bench.polylineNonZeroMs = run([&] { canvas.FillPath(area, Color(160, 30, 120, 220), FillRule::NonZero); });
+        bench.polylineEvenOddMs = run([&] { canvas.FillPath(area, Color(160, 30, 120, 220), FillRule::EvenOdd); });
+        bench.curveFillMs = run([&] { canvas.FillPath(curve, Color(160, 220, 80, 40), FillRule::EvenOdd); });
+        bench.strokeMs = run([&] { canvas.StrokePath(line, Color(255, 0, 0, 0), 1.0f); });
+        return bench;
+    }
+
+    // 描边耗时（毫秒/帧）：每帧绘制 polylines 条静态折线（如图表曲线、网格与边框）。
+    // 几何项只计描边几何（每帧重新生成与 StrokeCache 命中），帧项包含填充；虚线为同样的折线加 6/3 虚线
+    struct StrokeBenchmark {
+        size_t polylines = 0, points = 0;
+        double strokeMs = 0, lookupMs = 0, dashedStrokeMs = 0, dashedLookupMs = 0;
+        double uncachedFrameMs = 0, cachedFrameMs = 0, dashedUncachedFrameMs = 0, dashedCachedFrameMs = 0;
+
+        double GeometrySpeedup() const { return lookupMs > 0 ? strokeMs / lookupMs : 0.0; }
+        double FrameSpeedup() const { return cachedFrameMs > 0 ? uncachedFrameMs / cachedFrameMs : 0.0; }
+    };
+
+    inline StrokeBenchmark BenchmarkStrokes(int width = 1280, int height = 720, int polylines = 64, int pointsPerPolyline = 256,
+        int frames = 10) {
+        using Clock = std::chrono::steady_clock;
+        Surface surface(width, height);
+        Canvas canvas(&surface);
+        StrokeCache cache;
+        canvas.SetStrokeCache(&cache);
+        polylines = (std::max)(polylines, 1);
+        pointsPerPolyline = (std::max)(pointsPerPolyline, 2);
+        frames = (std::max)(frames, 1);
+
+        std::vector<std::vector<PointF>> lines(static_cast<size_t>(polylines));
+        for (int i = 0; i < polylines; ++i) {
+            const float baseline = height * (i + 0.5f) / polylines;
+            const float amplitude = height * 0.5f / polylines;
+            for (int k = 0; k < pointsPerPolyline; ++k) {
+                const float x = width * float(k) / (pointsPerPolyline - 1);
+                lines[size_t(i)].push_back(PointF(x, baseline + amplitude * std::sin(k * 0.35f + i)));
+            }
+        }
+        StrokeStyle solid(2.5f, LineJoin::Round, LineCap::Round);
+        StrokeStyle dashed(2.0f);
+        dashed.dashes = { 6.0f, 3.0f };
+
+        auto time = [&](auto&& frame) {
+            frame();    // 预热（填充缓存）
+            const auto t0 = Clock::now();
+            for (int f = 0; f < frames; ++f) frame();
+            return std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / frames;
+        };
+        Stroker stroker;
+        StrokeGeometry geometry;
+        auto strokeAll = [&](const StrokeStyle& style) {
+            return time([&] {
+                for (const auto& line : lines) {
+                    geometry.Clear();
+                    stroker.Stroke(line.data(), line.size(), false, style, geometry);
+                }
+            });
+        };
+        auto lookupAll = [&](const StrokeStyle& style) {
+            cache.Clear();
+            return time([&] {
+                for (const auto& line : lines) cache.Get(line.data(), line.size(), false, style);
+            });
+        };
+        auto drawAll = [&](const StrokeStyle& style, bool cached) {
+            canvas.EnableStrokeCache(cached);
+            cache.Clear();
+            canvas.Clear(Color(255, 255, 255, 255));
+            return time([&] {
+                for (const auto& line : lines) canvas.DrawPolyline(line, Color(255, 0, 0, 0), style);
+            });
+        };
+
+        StrokeBenchmark bench;
+        bench.polylines = size_t(polylines);
+        bench.points = size_t(polylines) * size_t(pointsPerPolyline);
+        bench.strokeMs = strokeAll(solid);
+        bench.lookupMs = lookupAll(solid);
+        bench.dashedStrokeMs = strokeAll(dashed);
+        bench.dashedLookupMs = lookupAll(dashed);
+        bench.uncachedFrameMs = drawAll(solid, false);
+        bench.cachedFrameMs = drawAll(solid, true);
+        bench.dashedUncachedFrameMs = drawAll(dashed, false);
+        bench.dashedCachedFrameMs = drawAll(dashed, true);
+        return bench;
+    }
+}
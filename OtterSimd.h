@@ -0,0 +1,108 @@
+#pragma once
+// OtterSimd.h
+// 与平台无关的SIMD辅助：编译期与运行时指令集检测、位扫描与字节查找
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OTTER_HAS_SSE2 1
+#include <emmintrin.h>
+#else
+#define OTTER_HAS_SSE2 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// x86 上可按运行时检测结果调用 AVX2 内核：函数用 OTTER_TARGET_AVX2 标注，无需全局编译选项
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define OTTER_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#define OTTER_HAS_AVX2_DISPATCH 1
+#define OTTER_TARGET_AVX2
+#include <immintrin.h>
+#elif defined(__GNUC__) || defined(__clang__)
+#define OTTER_HAS_AVX2_DISPATCH 1
+#define OTTER_TARGET_AVX2 __attribute__((target("avx2")))
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define OTTER_HAS_AVX2_DISPATCH 0
+#endif
+#else
+#define OTTER_X86 0
+#define OTTER_HAS_AVX2_DISPATCH 0
+#endif
+
+namespace OtterSimd {
+
+    // 最低位1的位置（mask 不能为0）
+    inline unsigned CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    // 运行时检测CPU与操作系统是否支持AVX2（需要 OSXSAVE 且 XCR0 启用了 YMM 状态）
+    inline bool DetectAvx2() {
+#if OTTER_HAS_AVX2_DISPATCH
+        unsigned regs1[4] = {}, regs7[4] = {};
+#if defined(_MSC_VER) && !defined(__clang__)
+        int r[4];
+        __cpuid(r, 0);
+        if (r[0] < 7) return false;
+        __cpuid(r, 1);
+        for (int i = 0; i < 4; ++i) regs1[i] = static_cast<unsigned>(r[i]);
+        __cpuidex(r, 7, 0);
+        for (int i = 0; i < 4; ++i) regs7[i] = static_cast<unsigned>(r[i]);
+#else
+        if (__get_cpuid_max(0, nullptr) < 7) return false;
+        __get_cpuid(1, &regs1[0], &regs1[1], &regs1[2], &regs1[3]);
+        __get_cpuid_count(7, 0, &regs7[0], &regs7[1], &regs7[2], &regs7[3]);
+#endif
+        const bool osxsave = (regs1[2] & (1u << 27)) != 0;
+        const bool avx = (regs1[2] & (1u << 28)) != 0;
+        if (!osxsave || !avx) return false;
+#if defined(_MSC_VER) && !defined(__clang__)
+        const unsigned long long xcr0 = _xgetbv(0);
+#else
+        unsigned eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        const unsigned long long xcr0 = (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+        if ((xcr0 & 0x6) != 0x6) return false;
+        return (regs7[1] & (1u << 5)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    inline bool HasAvx2() {
+        static const bool supported = DetectAvx2();
+        return supported;
+    }
+
+    // 查找字节，返回指针或 nullptr（SSE2 每次比较16字节）
+    inline const char* FindByte(const char* p, const char* end, char ch) {
+#if OTTER_HAS_SSE2
+        const __m128i needle = _mm_set1_epi8(ch);
+        while (end - p >= 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+            if (mask) return p + CountTrailingZeros(mask);
+            p += 16;
+        }
+#endif
+        while (p < end) {
+            if (*p == ch) return p;
+            ++p;
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,389 @@
+#pragma once
+// OtterTiles.h
+// 分块并行光栅化：显示列表的命令按包围盒分入固定大小的屏幕块，各块在工作窃取线程池上并行回放。
+// 每块只回放与之相交的命令（保持录制顺序）且只写自己的像素，结果与线程数、调度顺序无关。不依赖Windows
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "OtterDisplayList.h"
+#include "OtterTrace.h"
+
+namespace OtterRaster {
+
+    // 工作窃取线程池：任务按连续区间预先分给各参与者，参与者先做自己的（从前往后，保持局部性），
+    // 做完后从其他参与者的队尾窃取。调用线程作为 0 号参与者一起执行
+    class WorkStealingPool {
+    public:
+        struct Stats {
+            size_t runs = 0;
+            size_t tasks = 0;
+            size_t steals = 0;          // 由非预分配的参与者执行的任务数
+        };
+
+        // threads 为参与者总数（含调用线程），0 时取硬件线程数
+        explicit WorkStealingPool(size_t threads = 0) {
+            if (threads == 0) threads = (std::max)(1u, std::thread::hardware_concurrency());
+            for (size_t i = 0; i < threads; ++i) m_queues.push_back(std::make_unique<Queue>());
+            for (size_t i = 1; i < threads; ++i) m_workers.emplace_back([this, i] { WorkerLoop(i); });
+        }
+
+        ~WorkStealingPool() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+            for (std::thread& t : m_workers) t.join();
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        size_t ThreadCount() const { return m_queues.size(); }
+
+        // 对 [0, count) 的每个任务调用 fn(task, participant)，全部完成后返回。
+        // participant 在 [0, ThreadCount()) 内，同一时刻只有一个任务使用同一个 participant
+        template <typename Fn>
+        void Run(size_t count, Fn&& fn) {
+            if (count == 0) return;
+            ++m_stats.runs;
+            m_stats.tasks += count;
+            if (m_queues.size() == 1) {
+                for (size_t i = 0; i < count; ++i) fn(i, size_t(0));
+                return;
+            }
+            const size_t n = m_queues.size();
+            for (size_t p = 0; p < n; ++p) {
+                Queue& q = *m_queues[p];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                q.tasks.clear();
+                for (size_t i = count * p / n; i < count * (p + 1) / n; ++i) q.tasks.push_back(uint32_t(i));
+            }
+            std::function<void(size_t, size_t)> job = [&fn](size_t task, size_t participant) { fn(task, participant); };
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_job = &job;
+                m_remaining = count;
+                m_active = n - 1;
+                ++m_generation;
+            }
+            m_wake.notify_all();
+            Work(0, job);
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this] { return m_remaining == 0 && m_active == 0; });
+            m_job = nullptr;
+        }
+
+        Stats GetStats() const {
+            Stats stats = m_stats;
+            stats.steals = m_steals.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        void ResetStats() {
+            m_stats = Stats();
+            m_steals = 0;
+        }
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<uint32_t> tasks;
+        };
+
+        bool Pop(size_t participant, uint32_t& task) {
+            Queue& q = *m_queues[participant];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) return false;
+            task = q.tasks.front();
+            q.tasks.pop_front();
+            return true;
+        }
+
+        bool Steal(size_t participant, uint32_t& task) {
+            const size_t n = m_queues.size();
+            for (size_t k = 1; k < n; ++k) {
+                Queue& q = *m_queues[(participant + k) % n];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                if (q.tasks.empty()) continue;
+                task = q.tasks.back();
+                q.tasks.pop_back();
+                m_steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        void Work(size_t participant, const std::function<void(size_t, size_t)>& job) {
+            uint32_t task;
+            size_t finished = 0;
+            while (Pop(participant, task) || Steal(participant, task)) {
+                job(task, participant);
+                ++finished;
+            }
+            if (finished == 0) return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_remaining -= finished;
+            if (m_remaining == 0) m_done.notify_all();
+        }
+
+        void WorkerLoop(size_t participant) {
+            OTTER_TRACE_THREAD_NAME("raster worker");
+            uint64_t seen = 0;
+            for (;;) {
+                const std::function<void(size_t, size_t)>* job;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+                    if (m_stopping) return;
+                    seen = m_generation;
+                    job = m_job;
+                }
+                Work(participant, *job);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_active == 0) m_done.notify_all();
+            }
+        }
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        const std::function<void(size_t, size_t)>* m_job = nullptr;
+        size_t m_remaining = 0;
+        size_t m_active = 0;            // 本轮尚未退出 Work 的工作线程数，Run 等它们退出后才返回
+        uint64_t m_generation = 0;
+        bool m_stopping = false;
+        Stats m_stats;
+        std::atomic<size_t> m_steals{ 0 };
+    };
+
+    // 分块渲染器：把显示列表回放到画布，与 DisplayList::Replay 用法相同。
+    // 每块使用独立的 Canvas（裁剪为块与目标裁剪的交集）与各线程自己的字形缓存
+    class TileRenderer {
+    public:
+        static constexpr int kDefaultTileSize = 64;
+
+        struct Stats {
+            size_t frames = 0;
+            size_t tiles = 0;           // 最近一帧与裁剪区域相交的块数
+            size_t activeTiles = 0;     // 最近一帧有绘制命令的块数
+            size_t binnedCommands = 0;  // 最近一帧分入各块的绘制命令总数（一条命令可跨多块）
+            double binMs = 0;           // 最近一帧分块耗时
+            double rasterMs = 0;        // 最近一帧并行回放耗时
+        };
+
+        // threads 为参与光栅化的线程总数（含调用线程），0 时取硬件线程数
+        explicit TileRenderer(size_t threads = 0, int tileSize = kDefaultTileSize)
+            : m_pool(threads), m_tileSize((std::max)(tileSize, 8)), m_canvases(m_pool.ThreadCount()) {}
+
+        size_t ThreadCount() const { return m_pool.ThreadCount(); }
+        int TileSize() const { return m_tileSize; }
+
+        // 回放到画布：使用画布当前的原点、裁剪矩形与裁剪区域（如损坏区域）
+        void Render(const DisplayList& list, Canvas& canvas) {
+            using Clock = std::chrono::steady_clock;
+            Surface* surface = canvas.GetSurface();
+            const Rect clip = canvas.GetClip();
+            if (!surface || !surface->Valid() || clip.IsEmpty() || list.Empty()) return;
+            OTTER_TRACE_SCOPE("raster", "TileRender");
+
+            const auto t0 = Clock::now();
+            Bin(list, canvas.GetOrigin(), clip);
+            const auto t1 = Clock::now();
+
+            m_pool.Run(m_active.size(), [&](size_t task, size_t participant) {
+                OTTER_TRACE_SCOPE("raster", "Tile");
+                const Tile& tile = m_tiles[m_active[task]];
+                Canvas& tc = m_canvases[participant];
+                tc.SetSurface(surface);
+                tc.SetAntiAlias(canvas.GetAntiAlias());
+                tc.SetOrigin(canvas.GetOrigin().X, canvas.GetOrigin().Y);
+                tc.SetClip(tile.rect);
+                if (canvas.HasClipRects()) tc.SetClipRects(canvas.GetClipRects().data(), canvas.GetClipRects().size());
+                else tc.ResetClipRects();
+                list.Replay(tc, tile.commands.data(), tile.commands.size());
+            });
+            const auto t2 = Clock::now();
+
+            ++m_stats.frames;
+            m_stats.binMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            m_stats.rasterMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        }
+
+        const Stats& GetStats() const { return m_stats; }
+        WorkStealingPool::Stats GetPoolStats() const { return m_pool.GetStats(); }
+
+    private:
+        struct Tile {
+            Rect rect;                          // 块与目标裁剪的交集（设备坐标）
+            std::vector<uint32_t> commands;     // 按录制顺序
+            bool draws = false;                 // 含绘制命令（只有状态命令的块跳过）
+        };
+
+        // 按块网格分入命令；块网格对齐设备坐标，与裁剪矩形无关，保证同一像素总由同样的命令序列产生
+        void Bin(const DisplayList& list, Point origin, const Rect& clip) {
+            const int ts = m_tileSize;
+            const int tx0 = FloorDiv(clip.x, ts), ty0 = FloorDiv(clip.y, ts);
+            const int tx1 = FloorDiv(clip.Right() - 1, ts), ty1 = FloorDiv(clip.Bottom() - 1, ts);
+            const int cols = tx1 - tx0 + 1, rows = ty1 - ty0 + 1;
+            m_tiles.resize(size_t(cols) * rows);
+            for (int ty = 0; ty < rows; ++ty) {
+                for (int tx = 0; tx < cols; ++tx) {
+                    Tile& tile = m_tiles[size_t(ty) * cols + tx];
+                    tile.rect = Rect((tx0 + tx) * ts, (ty0 + ty) * ts, ts, ts).Intersect(clip);
+                    tile.commands.clear();
+                    tile.draws = false;
+                }
+            }
+
+            const std::vector<DrawCommand>& commands = list.Commands();
+            const std::vector<Rect>& bounds = list.CommandBounds();
+            size_t binned = 0;
+            for (size_t i = 0; i < commands.size(); ++i) {
+                if (DisplayList::IsStateOp(commands[i].op)) {
+                    const bool draws = commands[i].op == DrawOp::Clear;
+                    for (Tile& tile : m_tiles) {
+                        tile.commands.push_back(uint32_t(i));
+                        tile.draws |= draws;
+                    }
+                    continue;
+                }
+                const Rect& b = bounds[i];
+                const Rect r = Rect(b.x + origin.X, b.y + origin.Y, b.w, b.h).Intersect(clip);
+                if (r.IsEmpty()) continue;
+                const int c0 = FloorDiv(r.x, ts) - tx0, c1 = FloorDiv(r.Right() - 1, ts) - tx0;
+                const int r0 = FloorDiv(r.y, ts) - ty0, r1 = FloorDiv(r.Bottom() - 1, ts) - ty0;
+                for (int ty = r0; ty <= r1; ++ty) {
+                    for (int tx = c0; tx <= c1; ++tx) {
+                        Tile& tile = m_tiles[size_t(ty) * cols + tx];
+                        tile.commands.push_back(uint32_t(i));
+                        tile.draws = true;
+                        ++binned;
+                    }
+                }
+            }
+
+            // 命令多的块排在前面，先开始执行，减少最后的长尾
+            m_active.clear();
+            for (size_t i = 0; i < m_tiles.size(); ++i) {
+                if (m_tiles[i].draws && !m_tiles[i].rect.IsEmpty()) m_active.push_back(uint32_t(i));
+            }
+            std::stable_sort(m_active.begin(), m_active.end(), [this](uint32_t a, uint32_t b) {
+                return m_tiles[a].commands.size() > m_tiles[b].commands.size();
+            });
+            m_stats.tiles = m_tiles.size();
+            m_stats.activeTiles = m_active.size();
+            m_stats.binnedCommands = binned;
+        }
+
+        static int FloorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+        WorkStealingPool m_pool;
+        int m_tileSize;
+        std::vector<Canvas> m_canvases;     // 每个参与者一个
+        std::vector<Tile> m_tiles;
+        std::vector<uint32_t> m_active;
+        Stats m_stats;
+    };
+
+    // 多核扩展性：同一个复杂仪表盘场景在不同线程数下的每帧耗时
+    struct TileScalingResult {
+        size_t threads = 0;
+        double msPerFrame = 0;
+        double speedup = 0;             // 相对单线程分块渲染
+    };
+
+    // 仪表盘场景：标题栏、panels 个面板（折线图、面积图、仪表环、柱状图与文字标签）
+    inline void RecordDashboard(DisplayList& list, int width, int height, int panels = 48) {
+        list.Reset();
+        list.Clear(Color(255, 245, 246, 248));
+        list.FillRectangle(0, 0, width, 40, Color(255, 32, 40, 56));
+        list.DrawString(L"Operations Dashboard", 12.0f, 10.0f, 14.0f, Color(255, 255, 255, 255));
+        const int cols = (std::max)(1, (int)std::lround(std::sqrt(panels * double(width) / (std::max)(height - 40, 1))));
+        const int rows = (panels + cols - 1) / cols;
+        const int pw = width / cols, ph = (height - 40) / (std::max)(rows, 1);
+        std::vector<PointF> pts;
+        for (int p = 0; p < panels; ++p) {
+            const int x = (p % cols) * pw + 6, y = 40 + (p / cols) * ph + 6, w = pw - 12, h = ph - 12;
+            if (w < 40 || h < 40) continue;
+            list.FillRectangle(x, y, w, h, Color(255, 255, 255, 255));
+            list.DrawRectangle(x, y, w, h, Color(255, 210, 214, 222));
+            list.DrawString(L"Panel " + std::to_wstring(p + 1), float(x + 8), float(y + 6), 9.0f, Color(255, 40, 40, 40));
+            const int cx = x + 8, cy = y + 24, cw = w - 16, ch = h - 32;
+            switch (p % 4) {
+            case 0: {   // 折线图
+                float prevX = 0, prevY = 0;
+                for (int i = 0; i <= 40; ++i) {
+                    float fx = cx + cw * i / 40.0f;
+                    float fy = cy + ch * (0.5f + 0.4f * std::sin(i * 0.35f + p));
+                    if (i > 0) list.DrawLine(prevX, prevY, fx, fy, Color(255, 30, 120, 220), 1.5f);
+                    prevX = fx; prevY = fy;
+                }
+                break;
+            }
+            case 1: {   // 面积图
+                pts.clear();
+                pts.emplace_back(float(cx), float(cy + ch));
+                for (int i = 0; i <= 48; ++i) {
+                    pts.emplace_back(cx + cw * i / 48.0f, cy + ch * (0.55f + 0.35f * std::cos(i * 0.27f + p * 0.5f)));
+                }
+                pts.emplace_back(float(cx + cw), float(cy + ch));
+                list.FillPolygon(pts, Color(140, 46, 184, 114));
+                break;
+            }
+            case 2: {   // 仪表环
+                const int r = (std::min)(cw, ch) / 2 - 2;
+                if (r <= 4) break;
+                list.FillCircle(cx + cw / 2, cy + ch / 2, r, Color(255, 236, 239, 244));
+                list.DrawCircle(cx + cw / 2, cy + ch / 2, r - 4, Color(255, 240, 140, 40), 6.0f);
+                list.DrawString(std::to_wstring(40 + p) + L"%", float(cx + cw / 2 - 12), float(cy + ch / 2 - 8), 11.0f, Color(255, 20, 20, 20));
+                break;
+            }
+            default: {  // 柱状图
+                for (int i = 0; i < 12; ++i) {
+                    const int bh = int(ch * (0.2f + 0.7f * ((i * 37 + p * 11) % 100) / 100.0f));
+                    list.FillRectangle(cx + i * cw / 12 + 1, cy + ch - bh, (std::max)(cw / 12 - 2, 1), bh, Color(255, 120, 90, 200));
+                }
+                break;
+            }
+            }
+        }
+    }
+
+    // 依次用 1、2、4…直到 maxThreads（0 为硬件线程数）个线程渲染同一帧 frames 次
+    inline std::vector<TileScalingResult> BenchmarkTileScaling(int width = 1920, int height = 1080, int frames = 30,
+        size_t maxThreads = 0, int panels = 48) {
+        using Clock = std::chrono::steady_clock;
+        if (maxThreads == 0) maxThreads = (std::max)(1u, std::thread::hardware_concurrency());
+        DisplayList list;
+        RecordDashboard(list, width, height, panels);
+        Surface surface(width, height);
+        Canvas canvas(&surface);
+
+        std::vector<TileScalingResult> results;
+        for (size_t threads = 1;; threads = (std::min)(threads * 2, maxThreads)) {
+            TileRenderer renderer(threads);
+            renderer.Render(list, canvas);      // 预热（字形缓存、缓冲区分配）
+            const auto t0 = Clock::now();
+            for (int f = 0; f < frames; ++f) renderer.Render(list, canvas);
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / (std::max)(frames, 1);
+            TileScalingResult r;
+            r.threads = threads;
+            r.msPerFrame = ms;
+            r.speedup = results.empty() || ms <= 0 ? 1.0 : results.front().msPerFrame / ms;
+            results.push_back(r);
+            if (threads >= maxThreads) break;
+        }
+        return results;
+    }
+}
@@ -0,0 +1,420 @@
+#pragma once
+// OtterTrace.h
+// 帧追踪：定义 OTTER_TRACING 后，OTTER_TRACE_* 宏把作用域事件写入各线程自己的环形缓冲区
+// （满后覆盖最旧的事件），可导出为 Chrome/Perfetto 可读的 trace-event JSON，并记录每帧耗时历史供叠加显示。
+// 未定义时宏展开为空语句，无任何开销。不依赖Windows
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace OtterTrace {
+
+#ifdef OTTER_TRACING
+    constexpr bool kTracingEnabled = true;
+#else
+    constexpr bool kTracingEnabled = false;
+#endif
+
+    enum class EventType : uint8_t {
+        Complete,       // 有起止时间的作用域（ph "X"）
+        Instant,        // 时间点（ph "i"）
+        Counter         // 数值（ph "C"）
+    };
+
+    constexpr size_t kArgCapacity = 32;     // Event::arg 的字节数（含结尾0）
+
+    // name/category/detail 须为静态字符串或 Intern 返回的字符串
+    struct Event {
+        const char* name = nullptr;
+        const char* category = nullptr;
+        const char* detail = nullptr;
+        int64_t startNs = 0;
+        int64_t durationNs = 0;
+        double value = 0;
+        EventType type = EventType::Complete;
+        char arg[kArgCapacity] = {};    // 复制进事件的短文本（不驻留），没有 detail 时导出为 detail
+    };
+
+    // 复制到定长缓冲区，超长时在UTF-8字符边界截断
+    inline void CopyArg(char (&out)[kArgCapacity], std::string_view text) {
+        size_t n = (std::min)(text.size(), kArgCapacity - 1);
+        if (n < text.size()) {
+            while (n > 0 && (static_cast<unsigned char>(text[n]) & 0xC0) == 0x80) --n;
+        }
+        std::memcpy(out, text.data(), n);
+        out[n] = '\0';
+    }
+
+    inline int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 单个线程的事件环形缓冲区：只有所属线程写入，锁只在导出时才会有竞争
+    class ThreadBuffer {
+    public:
+        ThreadBuffer(uint32_t threadId, size_t capacity) : m_threadId(threadId), m_events(RoundUp(capacity)) {}
+
+        void Push(const Event& e) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_events[size_t(m_written) & (m_events.size() - 1)] = e;
+            ++m_written;
+        }
+
+        // 按时间顺序复制仍在缓冲区内的事件
+        void CopyTo(std::vector<Event>& out) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const uint64_t count = (std::min)(m_written, uint64_t(m_events.size()));
+            for (uint64_t i = m_written - count; i < m_written; ++i) out.push_back(m_events[size_t(i) & (m_events.size() - 1)]);
+        }
+
+        void Clear() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_written = 0;
+        }
+
+        uint64_t Written() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_written;
+        }
+
+        uint32_t ThreadId() const { return m_threadId; }
+        size_t Capacity() const { return m_events.size(); }
+
+        void SetName(const char* name) { m_name.store(name, std::memory_order_relaxed); }
+        const char* Name() const { return m_name.load(std::memory_order_relaxed); }
+
+    private:
+        static size_t RoundUp(size_t n) {
+            size_t p = 64;
+            while (p < n) p <<= 1;
+            return p;
+        }
+
+        mutable std::mutex m_mutex;
+        uint32_t m_threadId;
+        std::atomic<const char*> m_name{ nullptr };
+        std::vector<Event> m_events;
+        uint64_t m_written = 0;
+    };
+
+    // 每帧耗时历史（毫秒），最近的在后
+    class FrameHistory {
+    public:
+        static constexpr size_t kCapacity = 240;
+
+        void Add(double ms) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_frames[m_count % kCapacity] = float(ms);
+            ++m_count;
+        }
+
+        std::vector<float> Snapshot() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const size_t n = (std::min)(m_count, kCapacity);
+            std::vector<float> out;
+            out.reserve(n);
+            for (size_t i = m_count - n; i < m_count; ++i) out.push_back(m_frames[i % kCapacity]);
+            return out;
+        }
+
+        void Clear() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_count = 0;
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        float m_frames[kCapacity] = {};
+        size_t m_count = 0;
+    };
+
+    // 全局追踪器：登记各线程缓冲区（线程退出后保留，导出时仍可读取）
+    class Tracer {
+    public:
+        static constexpr size_t kDefaultCapacity = 16384;
+
+        static Tracer& Instance() {
+            static Tracer tracer;
+            return tracer;
+        }
+
+        // 运行时开关（编译期已开启时才有意义），默认开启
+        void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+        bool Enabled() const { return kTracingEnabled && m_enabled.load(std::memory_order_relaxed); }
+
+        // 之后新建线程缓冲区的容量（事件数，向上取2的幂）
+        void SetBufferCapacity(size_t events) { m_capacity.store((std::max)(events, size_t(64)), std::memory_order_relaxed); }
+
+        ThreadBuffer& CurrentThread() {
+            thread_local ThreadBuffer* buffer = nullptr;
+            if (!buffer) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_buffers.push_back(std::make_shared<ThreadBuffer>(uint32_t(m_buffers.size() + 1), m_capacity.load(std::memory_order_relaxed)));
+                buffer = m_buffers.back().get();
+            }
+            return *buffer;
+        }
+
+        void Record(const Event& e) {
+            if (Enabled()) CurrentThread().Push(e);
+        }
+
+        // 导出中显示的线程名
+        void SetThreadName(const char* name) { CurrentThread().SetName(Intern(name)); }
+
+        // 动态字符串转为进程内长期有效的指针。驻留表只增不减，只用于取值有限的文本；
+        // 图片键、URL 等不受控的文本用 OTTER_TRACE_SCOPE_ARG 复制进事件
+        const char* Intern(const std::string& text) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_strings.insert(text).first->c_str();
+        }
+
+        FrameHistory& Frames() { return m_frames; }
+
+        void Clear() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& b : m_buffers) b->Clear();
+            m_frames.Clear();
+        }
+
+        // Chrome trace-event JSON（chrome://tracing 或 ui.perfetto.dev 打开），时间单位微秒
+        std::string ExportChromeJson() const {
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                buffers = m_buffers;
+            }
+            std::ostringstream os;
+            os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+            bool first = true;
+            std::vector<Event> events;
+            char num[64];
+            for (const auto& buffer : buffers) {
+                const uint32_t tid = buffer->ThreadId();
+                if (const char* name = buffer->Name()) {
+                    os << (first ? "" : ",") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":";
+                    WriteString(os, name);
+                    os << "}}";
+                    first = false;
+                }
+                events.clear();
+                buffer->CopyTo(events);
+                for (const Event& e : events) {
+                    os << (first ? "" : ",") << "{\"name\":";
+                    first = false;
+                    WriteString(os, e.name ? e.name : "");
+                    os << ",\"cat\":";
+                    WriteString(os, e.category ? e.category : "");
+                    std::snprintf(num, sizeof(num), "%.3f", e.startNs / 1000.0);
+                    os << ",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << num;
+                    switch (e.type) {
+                    case EventType::Complete:
+                        std::snprintf(num, sizeof(num), "%.3f", e.durationNs / 1000.0);
+                        os << ",\"ph\":\"X\",\"dur\":" << num;
+                        if (const char* detail = DetailOf(e)) {
+                            os << ",\"args\":{\"detail\":";
+                            WriteString(os, detail);
+                            os << "}";
+                        }
+                        break;
+                    case EventType::Instant:
+                        os << ",\"ph\":\"i\",\"s\":\"t\"";
+                        if (const char* detail = DetailOf(e)) {
+                            os << ",\"args\":{\"detail\":";
+                            WriteString(os, detail);
+                            os << "}";
+                        }
+                        break;
+                    case EventType::Counter:
+                        std::snprintf(num, sizeof(num), "%.6g", e.value);
+                        os << ",\"ph\":\"C\",\"args\":{\"value\":" << num << "}";
+                        break;
+                    }
+                    os << "}";
+                }
+            }
+            os << "]}";
+            return os.str();
+        }
+
+        bool WriteChromeJson(const std::string& path) const {
+            const std::string json = ExportChromeJson();
+            FILE* file = std::fopen(path.c_str(), "wb");
+            if (!file) return false;
+            const bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+            return std::fclose(file) == 0 && ok;
+        }
+
+    private:
+        Tracer() = default;
+
+        static const char* DetailOf(const Event& e) {
+            if (e.detail) return e.detail;
+            return e.arg[0] ? e.arg : nullptr;
+        }
+
+        static void WriteString(std::ostringstream& os, const char* s) {
+            os << '"';
+            for (; *s; ++s) {
+                const unsigned char c = static_cast<unsigned char>(*s);
+                switch (c) {
+                case '"': os << "\\\""; break;
+                case '\\': os << "\\\\"; break;
+                case '\n': os << "\\n"; break;
+                case '\r': os << "\\r"; break;
+                case '\t': os << "\\t"; break;
+                default:
+                    if (c < 0x20) {
+                        char esc[8];
+                        std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+                        os << esc;
+                    }
+                    else {
+                        os << *s;
+                    }
+                }
+            }
+            os << '"';
+        }
+
+        mutable std::mutex m_mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+        std::unordered_set<std::string> m_strings;
+        std::atomic<bool> m_enabled{ true };
+        std::atomic<size_t> m_capacity{ kDefaultCapacity };
+        FrameHistory m_frames;
+    };
+
+    // 作用域事件：构造时记下开始时间，析构时写入一条 Complete 事件
+    class Scope {
+    public:
+        Scope(const char* category, const char* name, const char* detail = nullptr)
+            : m_category(category), m_name(name), m_detail(detail),
+            m_start(Tracer::Instance().Enabled() ? NowNs() : -1) {}
+
+        ~Scope() {
+            if (m_start < 0) return;
+            Event e;
+            e.name = m_name;
+            e.category = m_category;
+            e.detail = m_detail;
+            e.startNs = m_start;
+            e.durationNs = NowNs() - m_start;
+            Tracer::Instance().Record(e);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    protected:
+        const char* m_category;
+        const char* m_name;
+        const char* m_detail;
+        int64_t m_start;
+    };
+
+    // 作用域事件，附带复制进事件的短文本（超过 kArgCapacity - 1 字节时截断）；不经过驻留表，
+    // 适合图片键这类取值不受控的文本
+    class ArgScope {
+    public:
+        ArgScope(const char* category, const char* name, std::string_view arg)
+            : m_category(category), m_name(name), m_start(Tracer::Instance().Enabled() ? NowNs() : -1) {
+            if (m_start >= 0) CopyArg(m_arg, arg);
+        }
+
+        ~ArgScope() {
+            if (m_start < 0) return;
+            Event e;
+            e.name = m_name;
+            e.category = m_category;
+            e.startNs = m_start;
+            e.durationNs = NowNs() - m_start;
+            std::memcpy(e.arg, m_arg, sizeof(m_arg));
+            Tracer::Instance().Record(e);
+        }
+
+        ArgScope(const ArgScope&) = delete;
+        ArgScope& operator=(const ArgScope&) = delete;
+
+    private:
+        const char* m_category;
+        const char* m_name;
+        int64_t m_start;
+        char m_arg[kArgCapacity] = {};
+    };
+
+    // 帧作用域：除事件外，把耗时加入帧历史
+    class FrameScope : public Scope {
+    public:
+        explicit FrameScope(const char* name = "frame") : Scope("frame", name) {}
+
+        ~FrameScope() {
+            if (m_start >= 0) Tracer::Instance().Frames().Add((NowNs() - m_start) / 1e6);
+        }
+    };
+
+    inline void Instant(const char* category, const char* name, const char* detail = nullptr) {
+        Tracer& tracer = Tracer::Instance();
+        if (!tracer.Enabled()) return;
+        Event e;
+        e.name = name;
+        e.category = category;
+        e.detail = detail;
+        e.startNs = NowNs();
+        e.type = EventType::Instant;
+        tracer.Record(e);
+    }
+
+    inline void Counter(const char* category, const char* name, double value) {
+        Tracer& tracer = Tracer::Instance();
+        if (!tracer.Enabled()) return;
+        Event e;
+        e.name = name;
+        e.category = category;
+        e.startNs = NowNs();
+        e.value = value;
+        e.type = EventType::Counter;
+        tracer.Record(e);
+    }
+
+    // 取值有限的动态字符串作 detail 时使用（驻留后不释放）；未开启追踪时不做任何事
+    inline const char* Intern(const std::string& text) {
+        return Tracer::Instance().Enabled() ? Tracer::Instance().Intern(text) : nullptr;
+    }
+}
+
+#define OTTER_TRACE_CONCAT_INNER(a, b) a##b
+#define OTTER_TRACE_CONCAT(a, b) OTTER_TRACE_CONCAT_INNER(a, b)
+
+#ifdef OTTER_TRACING
+// 当前作用域计为一个事件；detail 版本的第三个参数须为静态字符串或 OtterTrace::Intern 的结果，
+// arg 版本的第三个参数为任意字符串（复制进事件，不驻留）
+#define OTTER_TRACE_SCOPE(category, name) OtterTrace::Scope OTTER_TRACE_CONCAT(otterTraceScope_, __LINE__)(category, name)
+#define OTTER_TRACE_SCOPE_DETAIL(category, name, detail) OtterTrace::Scope OTTER_TRACE_CONCAT(otterTraceScope_, __LINE__)(category, name, detail)
+#define OTTER_TRACE_SCOPE_ARG(category, name, arg) OtterTrace::ArgScope OTTER_TRACE_CONCAT(otterTraceScope_, __LINE__)(category, name, arg)
+// 当前作用域计为一帧（加入帧耗时历史）
+#define OTTER_TRACE_FRAME(name) OtterTrace::FrameScope OTTER_TRACE_CONCAT(otterTraceFrame_, __LINE__)(name)
+#define OTTER_TRACE_INSTANT(category, name) OtterTrace::Instant(category, name)
+#define OTTER_TRACE_COUNTER(category, name, value) OtterTrace::Counter(category, name, double(value))
+#define OTTER_TRACE_THREAD_NAME(name) OtterTrace::Tracer::Instance().SetThreadName(name)
+#else
+#define OTTER_TRACE_SCOPE(category, name) ((void)0)
+#define OTTER_TRACE_SCOPE_DETAIL(category, name, detail) ((void)0)
+#define OTTER_TRACE_SCOPE_ARG(category, name, arg) ((void)0)
+#define OTTER_TRACE_FRAME(name) ((void)0)
+#define OTTER_TRACE_INSTANT(category, name) ((void)0)
+#define OTTER_TRACE_COUNTER(category, name, value) ((void)0)
+#define OTTER_TRACE_THREAD_NAME(name) ((void)0)
+#endif
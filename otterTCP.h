@@ -17,25 +17,50 @@
 #include <queue>
 #include <condition_variable>
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <charconv>
 #include <fstream>
 #include <filesystem>
 #include <memory>
 #include <unordered_set>
+#include "OtterLockProfiler.h"
+#include "OtterLamaeBatch.h"
+#include "OtterJson.h"
+#include "OtterTrace.h"
 
 #pragma comment(lib, "ws2_32.lib")
 
 class PortMonitor {
 public:
+    // 内部锁类型（定义 OTTER_LOCK_PROFILING 时记录竞争数据）
+    using LockType = OtterProfile::Mutex;
+
+    // 获取内部锁的竞争报告（未开启分析时为空）
+    static std::vector<OtterProfile::LockReport> getLockReports() {
+        return OtterProfile::GetLockReports();
+    }
+
     //MessageHandler
     using MessageHandler = std::function<std::string(const std::string&)>;
     // 设置消息处理器（新增）
     void setMessageHandler(MessageHandler handler) {
-        std::lock_guard<std::mutex> lock(m_handlersMutex);
+        std::lock_guard<LockType> lock(m_handlersMutex);
         m_messageHandler = handler;
     }
 
     using ParamHandler = std::function<std::string(const std::string&)>;
 
+    // JSON处理器：request 指向接收缓冲区，response 直接写入响应缓冲区
+    using JsonHandler = std::function<void(const OtterJson::Value& request, OtterJson::Writer& response)>;
+
+    // 设置JSON处理器：消息体（HTTP请求取头部之后的部分）为合法JSON时调用
+    void setJsonHandler(JsonHandler handler) {
+        std::lock_guard<LockType> lock(m_handlersMutex);
+        m_jsonHandler = handler;
+    }
+
     // 消息记录结构体
     struct MessageRecord {
         std::string content;       // 消息内容
@@ -118,7 +143,7 @@ public:
 
     // 设置动态参数处理器
     void setParamHandler(const std::string& paramName, ParamHandler handler) {
-        std::lock_guard<std::mutex> lock(m_handlersMutex);
+        std::lock_guard<LockType> lock(m_handlersMutex);
         m_paramHandlers[paramName] = handler;
     }
 
@@ -174,13 +199,13 @@ public:
 
     // 获取所有消息记录
     std::vector<MessageRecord> getMessageHistory() const {
-        std::lock_guard<std::mutex> lock(m_historyMutex);
+        std::lock_guard<LockType> lock(m_historyMutex);
         return m_messageHistory;
     }
 
     // 获取特定连接的消息记录
     std::vector<MessageRecord> getConnectionMessages(SOCKET socket) const {
-        std::lock_guard<std::mutex> lock(m_historyMutex);
+        std::lock_guard<LockType> lock(m_historyMutex);
         std::vector<MessageRecord> result;
 
         for (const auto& record : m_messageHistory) {
@@ -197,7 +222,7 @@ public:
         std::vector<std::thread> threadsToJoin;
 
         {
-            std::lock_guard<std::mutex> lock(m_connectionsMutex);
+            std::lock_guard<LockType> lock(m_connectionsMutex);
             // 标记所有连接为关闭状态并关闭套接字
             for (auto& conn : m_connections) {
                 if (conn.active) {
@@ -220,14 +245,14 @@ public:
 
         // 清空消息历史
         {
-            std::lock_guard<std::mutex> lock(m_historyMutex);
+            std::lock_guard<LockType> lock(m_historyMutex);
             m_messageHistory.clear();
         }
     }
 
     // 获取所有活跃连接
     std::vector<SOCKET> getActiveConnections() const {
-        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        std::lock_guard<LockType> lock(m_connectionsMutex);
         std::vector<SOCKET> result;
 
         for (const auto& conn : m_connections) {
@@ -257,7 +282,7 @@ public:
         // 关闭所有活跃连接
         std::vector<std::thread> threadsToJoin;
         {
-            std::lock_guard<std::mutex> lock(m_connectionsMutex);
+            std::lock_guard<LockType> lock(m_connectionsMutex);
             for (auto& conn : m_connections) {
                 if (conn.active) {
                     conn.shouldClose = true;
@@ -372,7 +397,7 @@ public:
 
     // 关闭特定连接
     void closeConnection(SOCKET socket) {
-        std::lock_guard<std::mutex> lock(m_connectionsMutex);
+        std::lock_guard<LockType> lock(m_connectionsMutex);
         auto it = std::find_if(m_connections.begin(), m_connections.end(),
             [socket](const ConnectionInfo& conn) {
                 return conn.socket == socket;
@@ -423,6 +448,8 @@ private:
             unsigned long mode = 1;
             ioctlsocket(clientSocket, FIONBIO, &mode);
 
+            OTTER_TRACE_INSTANT("net", "Accept");
+
             // 创建新连接信息
             ConnectionInfo conn;
             conn.socket = clientSocket;
@@ -436,7 +463,7 @@ private:
                 });
 
             {
-                std::lock_guard<std::mutex> lock(m_connectionsMutex);
+                std::lock_guard<LockType> lock(m_connectionsMutex);
                 // 检查连接数限制
                 if (m_connections.size() >= 1000) {
                     std::cerr << "Connection limit reached (1000), rejecting new connection" << std::endl;
@@ -456,6 +483,13 @@ private:
         std::vector<char> buffer(BUFFER_SIZE);
         time_t lastActivityTime = time(nullptr);
 
+        // JSON解析与响应缓冲区在连接生命周期内复用
+        OtterJson::Document jsonDoc;
+        std::string jsonResponse;
+        // 尚未收完的HTTP请求（头部或 Content-Length 指定的消息体可能分多次到达）
+        std::string httpPending;
+        OTTER_TRACE_THREAD_NAME("net connection");
+
         // 设置接收超时（200毫秒）
         timeval tv{};
         tv.tv_sec = 0;
@@ -468,6 +502,8 @@ private:
             int bytesReceived = recv(conn.socket, buffer.data(), BUFFER_SIZE, 0);
 
             if (bytesReceived > 0) {
+                OTTER_TRACE_SCOPE("net", "Request");
+                OTTER_TRACE_COUNTER("net", "RecvBytes", bytesReceived);
                 lastActivityTime = time(nullptr);
                 std::string request(buffer.data(), bytesReceived);
 
@@ -475,30 +511,52 @@ private:
                 recordMessage(request, false, conn.socket);
 
                 // ===== 新增处理逻辑 =====
+                // 处理器在锁内复制、锁外调用：耗时的处理器不阻塞其他连接与 set*Handler
                 std::string response;
+                MessageHandler messageHandler;
                 {
-                    std::lock_guard<std::mutex> lock(m_handlersMutex);
-                    if (m_messageHandler) {
-                        response = m_messageHandler(request);
-                    }
+                    std::lock_guard<LockType> lock(m_handlersMutex);
+                    messageHandler = m_messageHandler;
+                }
+                if (messageHandler) {
+                    OTTER_TRACE_SCOPE("net", "MessageHandler");
+                    response = messageHandler(request);
                 }
 
-                // 如果消息处理器返回了响应，则发送
-                if (!response.empty()) {
+                // 如果消息处理器返回了响应，则发送；同一段非HTTP数据不再交给JSON处理器
+                const bool messageAnswered = !response.empty();
+                if (messageAnswered) {
                     send(conn.socket, response.c_str(), response.size(), 0);
                     recordMessage(response, true, conn.socket);
                 }
                 // ===== 结束新增 =====
 
-                // 处理请求
-                std::istringstream iss(request);
-                std::string method, path, protocol;
-                iss >> method >> path >> protocol;
-
-                if (method == "GET") {
-                    std::string response = processHttpRequest(path);
-                    send(conn.socket, response.c_str(), response.size(), 0);
-                    recordMessage(response, true, conn.socket);
+                // 非HTTP数据直接处理；HTTP请求收完头部与消息体后再处理
+                if (httpPending.empty() && !isHttpRequestStart(request)) {
+                    processRequest(conn.socket, request, messageAnswered, jsonDoc, jsonResponse);
+                    continue;
+                }
+                httpPending += request;
+                while (!httpPending.empty()) {
+                    if (!isHttpRequestStart(httpPending)) {
+                        // 完整请求之后跟着的非HTTP数据
+                        processRequest(conn.socket, httpPending, messageAnswered, jsonDoc, jsonResponse);
+                        httpPending.clear();
+                        break;
+                    }
+                    bool tooLarge = false;
+                    size_t length = httpRequestLength(httpPending, tooLarge);
+                    if (tooLarge) {
+                        std::string reply = buildHttpResponse(413, "text/plain; charset=utf-8", "Error: Request too large");
+                        send(conn.socket, reply.c_str(), static_cast<int>(reply.size()), 0);
+                        recordMessage(reply, true, conn.socket);
+                        httpPending.clear();
+                        break;
+                    }
+                    if (length == 0) break;     // 等待后续数据
+                    std::string complete = httpPending.substr(0, length);
+                    httpPending.erase(0, length);
+                    processRequest(conn.socket, complete, messageAnswered, jsonDoc, jsonResponse);
                 }
             }
             else if (bytesReceived == 0) {
@@ -526,6 +584,147 @@ private:
         conn.closeSocket();
     }
 
+    // 单次HTTP请求（头部加消息体）的大小上限
+    static constexpr size_t MAX_HTTP_REQUEST = 1 << 20;
+
+    // 缓冲区开头是否为HTTP请求行（数据太短时按方法名前缀判断）
+    static bool isHttpRequestStart(const std::string& data) {
+        static const char* const methods[] = { "GET ", "POST ", "PUT ", "DELETE ", "PATCH ", "HEAD ", "OPTIONS " };
+        for (const char* method : methods) {
+            size_t n = (std::min)(data.size(), strlen(method));
+            if (n > 0 && data.compare(0, n, method, n) == 0) return true;
+        }
+        return false;
+    }
+
+    // 完整HTTP请求的字节数：头部以空行结束，消息体长度取 Content-Length（不支持 chunked 编码）；
+    // 尚未收完时返回0，请求超过 MAX_HTTP_REQUEST 时设置 tooLarge
+    static size_t httpRequestLength(const std::string& data, bool& tooLarge) {
+        tooLarge = false;
+        size_t headerEnd = data.find("\r\n\r\n");
+        if (headerEnd == std::string::npos) {
+            tooLarge = data.size() > MAX_HTTP_REQUEST;
+            return 0;
+        }
+        size_t contentLength = 0;
+        std::string_view value = httpHeaderValue(data, headerEnd, "content-length:");
+        std::from_chars(value.data(), value.data() + value.size(), contentLength);
+        if (contentLength > MAX_HTTP_REQUEST || headerEnd + 4 > MAX_HTTP_REQUEST - contentLength) {
+            tooLarge = true;
+            return 0;
+        }
+        size_t total = headerEnd + 4 + contentLength;
+        return data.size() < total ? 0 : total;
+    }
+
+    // 头部 [0, headerEnd) 中字段的值（name 为小写并带冒号，去掉前导空白）；没有该字段时返回空
+    static std::string_view httpHeaderValue(std::string_view data, size_t headerEnd, std::string_view name) {
+        for (size_t line = data.find("\r\n"); line < headerEnd; line = data.find("\r\n", line + 2)) {
+            size_t start = line + 2;
+            if (headerEnd - start < name.size()) continue;
+            bool match = true;
+            for (size_t i = 0; i < name.size() && match; ++i) {
+                match = tolower(static_cast<unsigned char>(data[start + i])) == name[i];
+            }
+            if (!match) continue;
+            size_t v = start + name.size();
+            size_t e = data.find("\r\n", start);
+            while (v < e && (data[v] == ' ' || data[v] == '\t')) ++v;
+            return data.substr(v, e - v);
+        }
+        return {};
+    }
+
+    // Content-Type 是否为 application/json（忽略大小写与 charset 等参数）
+    static bool isJsonContentType(std::string_view value) {
+        static const char type[] = "application/json";
+        const size_t typeLen = sizeof(type) - 1;
+        if (value.size() < typeLen) return false;
+        for (size_t i = 0; i < typeLen; ++i) {
+            if (tolower(static_cast<unsigned char>(value[i])) != type[i]) return false;
+        }
+        return value.size() == typeLen || value[typeLen] == ';' || value[typeLen] == ' ' || value[typeLen] == '\t';
+    }
+
+    // 处理一个完整请求：JSON请求交给 m_jsonHandler，其余 GET 请求按查询参数处理。
+    // messageAnswered 表示消息处理器已应答过这段数据
+    void processRequest(SOCKET socket, const std::string& request, bool messageAnswered,
+        OtterJson::Document& doc, std::string& responseBody) {
+        if (processJsonRequest(socket, request, messageAnswered, doc, responseBody)) {
+            return;
+        }
+
+        std::istringstream iss(request);
+        std::string method, path, protocol;
+        iss >> method >> path >> protocol;
+
+        if (method == "GET") {
+            std::string response = processHttpRequest(path);
+            send(socket, response.c_str(), response.size(), 0);
+            recordMessage(response, true, socket);
+        }
+    }
+
+    // 处理JSON请求，返回是否已响应。HTTP请求须为 Content-Type: application/json 的 POST；
+    // 非HTTP数据须以 { 或 [ 开头，且消息处理器没有应答，避免同一条消息收到两份响应
+    bool processJsonRequest(SOCKET socket, const std::string& request, bool messageAnswered,
+        OtterJson::Document& doc, std::string& responseBody) {
+        std::string_view body(request);
+        bool isHttp = false;
+        size_t headerEnd = body.find("\r\n\r\n");
+        if (headerEnd != std::string_view::npos && body.find("HTTP/1.") < headerEnd) {
+            if (body.compare(0, 5, "POST ") != 0 ||
+                !isJsonContentType(httpHeaderValue(body, headerEnd, "content-type:"))) {
+                return false;
+            }
+            body.remove_prefix(headerEnd + 4);
+            isHttp = true;
+        }
+        else if (messageAnswered || body.empty() || (body.front() != '{' && body.front() != '[')) {
+            return false;
+        }
+        if (doc.Parse(body) != OtterJson::ParseStatus::Ok) {
+            return false;
+        }
+
+        JsonHandler jsonHandler;
+        {
+            std::lock_guard<LockType> lock(m_handlersMutex);
+            jsonHandler = m_jsonHandler;
+        }
+        if (!jsonHandler) return false;
+
+        responseBody.clear();
+        {
+            OtterJson::Writer writer(responseBody);
+            OTTER_TRACE_SCOPE("net", "JsonHandler");
+            jsonHandler(doc.Root(), writer);
+        }
+
+        if (isHttp) {
+            // 响应头与消息体分两段发送，避免拼接复制
+            char header[256];
+            int headerLen = snprintf(header, sizeof(header),
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: application/json; charset=utf-8\r\n"
+                "Connection: close\r\n"
+                "Access-Control-Allow-Origin: *\r\n"
+                "Content-Length: %zu\r\n\r\n", responseBody.size());
+            WSABUF buffers[2];
+            buffers[0].buf = header;
+            buffers[0].len = static_cast<ULONG>(headerLen);
+            buffers[1].buf = const_cast<char*>(responseBody.data());
+            buffers[1].len = static_cast<ULONG>(responseBody.size());
+            DWORD sent = 0;
+            WSASend(socket, buffers, 2, &sent, 0, nullptr, nullptr);
+        }
+        else {
+            send(socket, responseBody.data(), static_cast<int>(responseBody.size()), 0);
+        }
+        recordMessage(responseBody, true, socket);
+        return true;
+    }
+
     // 处理HTTP请求
     std::string processHttpRequest(const std::string& path) {
         std::string response;
@@ -536,13 +735,22 @@ private:
             std::string query = path.substr(queryStart + 1);
             std::map<std::string, std::string> params = parseQueryParams(query);
 
-            std::lock_guard<std::mutex> lock(m_handlersMutex);
-            for (const auto& [param, value] : params) {
-                if (m_paramHandlers.count(param)) {
-                    response = buildHttpResponse(200, "text/plain; charset=utf-8", m_paramHandlers[param](value));
-                    break;
+            ParamHandler handler;
+            const std::string* argument = nullptr;
+            {
+                std::lock_guard<LockType> lock(m_handlersMutex);
+                for (const auto& [param, value] : params) {
+                    auto it = m_paramHandlers.find(param);
+                    if (it != m_paramHandlers.end()) {
+                        handler = it->second;
+                        argument = &value;
+                        break;
+                    }
                 }
             }
+            if (handler) {
+                response = buildHttpResponse(200, "text/plain; charset=utf-8", handler(*argument));
+            }
         }
 
         if (response.empty()) {
@@ -588,13 +796,14 @@ private:
         case 200: return "OK";
         case 400: return "Bad Request";
         case 404: return "Not Found";
+        case 413: return "Payload Too Large";
         default: return "Unknown";
         }
     }
 
     // 记录消息
     void recordMessage(const std::string& message, bool isOutgoing, SOCKET socket) {
-        std::lock_guard<std::mutex> lock(m_historyMutex);
+        std::lock_guard<LockType> lock(m_historyMutex);
         m_messageHistory.emplace_back(message, isOutgoing, socket);
 
         // 限制历史记录大小
@@ -614,10 +823,11 @@ private:
     std::map<std::string, ParamHandler> m_paramHandlers; // 参数处理器
     std::vector<MessageRecord> m_messageHistory;  // 消息历史记录
 
-    mutable std::mutex m_handlersMutex;           // 保护参数处理器
-    mutable std::mutex m_historyMutex;            // 保护消息历史
-    mutable std::mutex m_connectionsMutex;        // 保护连接列表
+    mutable LockType m_handlersMutex{ "PortMonitor::handlers" };       // 保护参数处理器
+    mutable LockType m_historyMutex{ "PortMonitor::history" };         // 保护消息历史
+    mutable LockType m_connectionsMutex{ "PortMonitor::connections" }; // 保护连接列表
     MessageHandler m_messageHandler; // 消息处理器成员变量
+    JsonHandler m_jsonHandler;       // JSON处理器
 };
 
 // Otter数据流命名空间
@@ -0,0 +1,147 @@
+// BlitTest.cpp
+// OtterRaster::Blit：各内核（标量/SSE2/AVX2）的 over 与 copy 在随机预乘像素、0-70 的行长与多种不透明度下与标量逐位一致
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "OtterTest.h"
+#include "../OtterBlit.h"
+
+using namespace OtterRaster;
+using Blit::Isa;
+
+// 随机预乘像素，夹杂全透明的连续段（触发 SIMD 的整组跳过）与不透明像素
+static std::vector<uint32_t> RandomRow(std::mt19937& rng, int count) {
+    std::vector<uint32_t> row(size_t(count) + 8);
+    for (size_t i = 0; i < row.size();) {
+        const uint32_t kind = rng() % 8;
+        if (kind == 0) {
+            for (int j = 0; j < 8 && i < row.size(); ++j) row[i++] = 0;
+            continue;
+        }
+        const uint32_t a = kind < 3 ? 255 : rng() % 256;
+        const uint32_t b = rng() % (a + 1);
+        const uint32_t g = rng() % (a + 1);
+        const uint32_t r = rng() % (a + 1);
+        row[i++] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+    return row;
+}
+
+static void KernelsMatchScalar() {
+    const uint32_t opacities[] = { 0, 1, 64, 127, 128, 200, 254, 255 };
+    const Blit::Kernels scalar = Blit::KernelsFor(Isa::Scalar);
+    std::mt19937 rng(2024);
+
+    for (Isa isa : { Isa::SSE2, Isa::AVX2 }) {
+        if (!Blit::Supported(isa)) {
+            std::printf("  跳过 %s（不支持）\n", Blit::IsaName(isa));
+            continue;
+        }
+        const Blit::Kernels kernels = Blit::KernelsFor(isa);
+        OTTER_CHECK(kernels.isa == isa);
+        int mismatches = 0;
+        for (int count = 0; count <= 70; ++count) {
+            for (uint32_t k : opacities) {
+                for (int offset = 0; offset < 3; ++offset) {        // 起点不对齐
+                    const std::vector<uint32_t> src = RandomRow(rng, count + offset);
+                    const std::vector<uint32_t> dst = RandomRow(rng, count + offset);
+
+                    std::vector<uint32_t> expected = dst, actual = dst;
+                    scalar.over(expected.data() + offset, src.data() + offset, count, k);
+                    kernels.over(actual.data() + offset, src.data() + offset, count, k);
+                    if (expected != actual) {
+                        if (++mismatches <= 5) std::printf("  %s over 不一致：count=%d k=%u\n", Blit::IsaName(isa), count, k);
+                    }
+
+                    expected = dst;
+                    actual = dst;
+                    scalar.copy(expected.data() + offset, src.data() + offset, count, k);
+                    kernels.copy(actual.data() + offset, src.data() + offset, count, k);
+                    if (expected != actual) {
+                        if (++mismatches <= 5) std::printf("  %s copy 不一致：count=%d k=%u\n", Blit::IsaName(isa), count, k);
+                    }
+                }
+            }
+        }
+        OTTER_CHECK_EQ(mismatches, 0);
+    }
+}
+
+// 按网格遍历 alpha 与颜色分量，覆盖舍入的边界情况
+static void KernelsMatchScalarOnGrid() {
+    std::vector<uint32_t> src;
+    for (uint32_t a = 0; a < 256; a += 5) {
+        for (uint32_t c = 0; c <= a; c += 3) src.push_back((a << 24) | (c << 16) | ((a - c) << 8) | (c / 2));
+    }
+    while (src.size() % 8) src.push_back(0xFFFFFFFFu);
+    std::vector<uint32_t> dst(src.size());
+    for (size_t i = 0; i < dst.size(); ++i) {
+        const uint32_t a = uint32_t(i * 7 % 256);
+        dst[i] = (a << 24) | ((a * 3 / 4) << 16) | ((a / 2) << 8) | (a / 3);
+    }
+
+    const Blit::Kernels scalar = Blit::KernelsFor(Isa::Scalar);
+    for (Isa isa : { Isa::SSE2, Isa::AVX2 }) {
+        if (!Blit::Supported(isa)) continue;
+        const Blit::Kernels kernels = Blit::KernelsFor(isa);
+        int mismatches = 0;
+        for (uint32_t k = 0; k <= 255; k += 17) {
+            std::vector<uint32_t> expected = dst, actual = dst;
+            scalar.over(expected.data(), src.data(), int(src.size()), k);
+            kernels.over(actual.data(), src.data(), int(src.size()), k);
+            mismatches += expected != actual;
+            expected = dst;
+            actual = dst;
+            scalar.copy(expected.data(), src.data(), int(src.size()), k);
+            kernels.copy(actual.data(), src.data(), int(src.size()), k);
+            mismatches += expected != actual;
+        }
+        OTTER_CHECK_EQ(mismatches, 0);
+    }
+}
+
+// SetIsa 切换全局内核后 Composite 结果不变，并可恢复原内核
+static void SetIsaSwitchesComposite() {
+    std::mt19937 rng(7);
+    Surface src(53, 9), base(64, 16);
+    for (int y = 0; y < src.Height(); ++y) {
+        const std::vector<uint32_t> row = RandomRow(rng, src.Width());
+        std::copy(row.begin(), row.begin() + src.Width(), src.Row(y));
+    }
+    for (int y = 0; y < base.Height(); ++y) {
+        const std::vector<uint32_t> row = RandomRow(rng, base.Width());
+        std::copy(row.begin(), row.begin() + base.Width(), base.Row(y));
+    }
+
+    auto render = [&](Blit::BlendMode mode, float opacity) {
+        Surface dst(base.Width(), base.Height());
+        for (int y = 0; y < base.Height(); ++y) std::copy(base.Row(y), base.Row(y) + base.Width(), dst.Row(y));
+        Blit::Composite(dst, Rect(2, 1, 60, 14), 5, 3, src, src.Bounds(), opacity, mode);
+        std::vector<uint32_t> out;
+        for (int y = 0; y < dst.Height(); ++y) out.insert(out.end(), dst.Row(y), dst.Row(y) + dst.Width());
+        return out;
+    };
+
+    const Isa saved = Blit::CurrentIsa();
+    OTTER_CHECK(Blit::SetIsa(Isa::Scalar));
+    OTTER_CHECK(Blit::CurrentIsa() == Isa::Scalar);
+    const std::vector<uint32_t> over = render(Blit::BlendMode::SourceOver, 0.6f);
+    const std::vector<uint32_t> copy = render(Blit::BlendMode::Copy, 0.3f);
+    for (Isa isa : { Isa::SSE2, Isa::AVX2 }) {
+        if (!Blit::SetIsa(isa)) continue;
+        OTTER_CHECK(Blit::CurrentIsa() == isa);
+        OTTER_CHECK(render(Blit::BlendMode::SourceOver, 0.6f) == over);
+        OTTER_CHECK(render(Blit::BlendMode::Copy, 0.3f) == copy);
+    }
+    OTTER_CHECK(Blit::SetIsa(saved));
+    OTTER_CHECK(Blit::CurrentIsa() == saved);
+}
+
+int main() {
+    OtterTest::Run("KernelsMatchScalar", KernelsMatchScalar);
+    OtterTest::Run("KernelsMatchScalarOnGrid", KernelsMatchScalarOnGrid);
+    OtterTest::Run("SetIsaSwitchesComposite", SetIsaSwitchesComposite);
+    return OtterTest::Finish();
+}
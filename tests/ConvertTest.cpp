@@ -0,0 +1,158 @@
+// ConvertTest.cpp
+// 各源格式的行转换与逐像素标量参考（Premultiply、位展开、调色板查表）逐位比较；
+// 宽度取非4倍数以覆盖SIMD主循环之后的尾部
+#include <vector>
+#include "OtterTest.h"
+#include "../OtterConvert.h"
+
+using namespace OtterRaster;
+using Convert::SourceFormat;
+
+static const int kWidths[] = { 1, 2, 3, 5, 7, 13, 30, 67 };
+static const int kHeight = 5;
+
+static uint32_t g_seed = 12345;
+static uint8_t NextByte() {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return uint8_t(g_seed >> 24);
+}
+
+static int RowBytes(SourceFormat format, int width) {
+    return ((width * Convert::BitsPerPixel(format) + 31) / 32) * 4;
+}
+
+// 逐像素参考实现：只用 Premultiply() 与按位运算
+static uint32_t Reference(SourceFormat format, const uint8_t* row, int x, const uint32_t* argbPalette, size_t paletteCount) {
+    auto palette = [&](unsigned index) { return index < paletteCount ? Premultiply(Color::FromArgb(argbPalette[index])) : 0u; };
+    auto expand = [](uint32_t v, int bits) { return (v << (8 - bits)) | (v >> (2 * bits - 8)); };
+    switch (format) {
+    case SourceFormat::Bgra32Premultiplied:
+        return uint32_t(row[4 * x]) | (uint32_t(row[4 * x + 1]) << 8) | (uint32_t(row[4 * x + 2]) << 16) | (uint32_t(row[4 * x + 3]) << 24);
+    case SourceFormat::Bgra32:
+        return Premultiply(Color(row[4 * x + 3], row[4 * x + 2], row[4 * x + 1], row[4 * x]));
+    case SourceFormat::Bgrx32:
+        return Premultiply(Color(255, row[4 * x + 2], row[4 * x + 1], row[4 * x]));
+    case SourceFormat::Bgr24:
+        return Premultiply(Color(255, row[3 * x + 2], row[3 * x + 1], row[3 * x]));
+    case SourceFormat::Bgr565: {
+        const uint32_t v = uint32_t(row[2 * x]) | (uint32_t(row[2 * x + 1]) << 8);
+        return Premultiply(Color(255, uint8_t(expand(v >> 11, 5)), uint8_t(expand((v >> 5) & 63, 6)), uint8_t(expand(v & 31, 5))));
+    }
+    case SourceFormat::Bgr555: {
+        const uint32_t v = uint32_t(row[2 * x]) | (uint32_t(row[2 * x + 1]) << 8);
+        return Premultiply(Color(255, uint8_t(expand((v >> 10) & 31, 5)), uint8_t(expand((v >> 5) & 31, 5)), uint8_t(expand(v & 31, 5))));
+    }
+    case SourceFormat::Indexed8: return palette(row[x]);
+    case SourceFormat::Indexed4: return palette((x & 1) ? (row[x / 2] & 0x0F) : (row[x / 2] >> 4));
+    case SourceFormat::Indexed1: return palette((row[x / 8] >> (7 - x % 8)) & 1);
+    }
+    return 0;
+}
+
+// 转换整幅图（正向与自下而上两种行距）并与参考逐像素比较
+static void CheckFormat(SourceFormat format, const std::vector<uint8_t>& src, int width, const uint32_t* argbPalette, size_t paletteCount) {
+    const int stride = RowBytes(format, width);
+    uint32_t palette[256];
+    Convert::PremultiplyPalette(argbPalette, paletteCount, palette);
+
+    for (int flip = 0; flip < 2; ++flip) {
+        const uint8_t* first = flip ? src.data() + size_t(kHeight - 1) * stride : src.data();
+        Surface dst;
+        OTTER_CHECK(Convert::ConvertImage(first, flip ? -stride : stride, width, kHeight, format, palette, dst));
+        OTTER_CHECK(dst.Width() == width && dst.Height() == kHeight);
+        int mismatched = 0;
+        for (int y = 0; y < kHeight; ++y) {
+            const uint8_t* row = first + (ptrdiff_t)y * (flip ? -stride : stride);
+            for (int x = 0; x < width; ++x) {
+                if (dst.Row(y)[x] != Reference(format, row, x, argbPalette, paletteCount)) ++mismatched;
+            }
+        }
+        if (!OTTER_CHECK_EQ(mismatched, 0)) {
+            std::printf("  格式 %s 宽度 %d%s：%d 个像素不一致\n", Convert::FormatName(format), width, flip ? " (自下而上)" : "", mismatched);
+        }
+    }
+}
+
+static std::vector<uint8_t> RandomImage(SourceFormat format, int width) {
+    std::vector<uint8_t> src(size_t(RowBytes(format, width)) * kHeight);
+    for (uint8_t& b : src) b = NextByte();
+    return src;
+}
+
+static void DirectFormatsMatchReference() {
+    for (SourceFormat format : { SourceFormat::Bgra32Premultiplied, SourceFormat::Bgra32, SourceFormat::Bgrx32,
+        SourceFormat::Bgr24, SourceFormat::Bgr565, SourceFormat::Bgr555 }) {
+        for (int width : kWidths) CheckFormat(format, RandomImage(format, width), width, nullptr, 0);
+    }
+}
+
+// 非预乘ARGB：4像素一组全不透明时直接复制，组内混有半透明、全透明像素时逐通道相乘
+static void ArgbOpaqueFastPath() {
+    for (int width : kWidths) {
+        std::vector<uint8_t> src = RandomImage(SourceFormat::Bgra32, width);
+        const int stride = RowBytes(SourceFormat::Bgra32, width);
+        for (int y = 0; y < kHeight; ++y) {
+            for (int x = 0; x < width; ++x) {
+                uint8_t& a = src[size_t(y) * stride + 4 * x + 3];
+                if (y == 0) a = 255;                                // 整行不透明
+                else if (y == 1) a = (x % 4 == 3) ? 254 : 255;      // 每组有一个几乎不透明的像素
+                else if (y == 2) a = (x % 5 == 0) ? 0 : 255;        // 全透明像素
+                else if (y == 3) a = uint8_t(x * 37);               // 任意alpha
+            }
+        }
+        CheckFormat(SourceFormat::Bgra32, src, width, nullptr, 0);
+
+        // 不透明像素转换后可无损还原
+        Surface dst;
+        Convert::ConvertImage(src.data(), stride, width, kHeight, SourceFormat::Bgra32, nullptr, dst);
+        bool lossless = true;
+        for (int x = 0; x < width; ++x) {
+            const Color c = Unpremultiply(dst.Row(0)[x]);
+            const uint8_t* s = &src[4 * x];
+            lossless = lossless && c.a == 255 && c.r == s[2] && c.g == s[1] && c.b == s[0];
+        }
+        OTTER_CHECK(lossless);
+    }
+}
+
+static void IndexedFormatsMatchReference() {
+    uint32_t argb[256];
+    for (uint32_t i = 0; i < 256; ++i) {
+        argb[i] = (uint32_t(NextByte()) << 24) | (uint32_t(NextByte()) << 16) | (uint32_t(NextByte()) << 8) | NextByte();
+    }
+    argb[0] = 0xFF000000u;
+    argb[1] = 0x00FFFFFFu;
+    const struct { SourceFormat format; size_t colors; } cases[] = {
+        { SourceFormat::Indexed8, 256 }, { SourceFormat::Indexed8, 200 },     // 超出调色板的索引为透明
+        { SourceFormat::Indexed4, 16 }, { SourceFormat::Indexed4, 9 },
+        { SourceFormat::Indexed1, 2 }, { SourceFormat::Indexed1, 1 },
+    };
+    for (const auto& c : cases) {
+        for (int width : kWidths) CheckFormat(c.format, RandomImage(c.format, width), width, argb, c.colors);
+    }
+
+    Surface dst;
+    const uint8_t bytes[4] = {};
+    OTTER_CHECK(!Convert::ConvertImage(bytes, 4, 4, 1, SourceFormat::Indexed8, nullptr, dst));
+    OTTER_CHECK(!Convert::ConvertImage(bytes, 4, 0, 1, SourceFormat::Bgra32, nullptr, dst));
+}
+
+static void PremultiplyPaletteFillsMissingEntries() {
+    const uint32_t argb[3] = { 0x80FF0000u, 0xFF00FF00u, 0x00123456u };
+    uint32_t table[256];
+    Convert::PremultiplyPalette(argb, 3, table);
+    OTTER_CHECK_EQ(table[0], Premultiply(Color(128, 255, 0, 0)));
+    OTTER_CHECK_EQ(table[1], 0xFF00FF00u);
+    OTTER_CHECK_EQ(table[2], 0u);
+    bool rest = true;
+    for (int i = 3; i < 256; ++i) rest = rest && table[i] == 0;
+    OTTER_CHECK(rest);
+}
+
+int main() {
+    OtterTest::Run("DirectFormatsMatchReference", DirectFormatsMatchReference);
+    OtterTest::Run("ArgbOpaqueFastPath", ArgbOpaqueFastPath);
+    OtterTest::Run("IndexedFormatsMatchReference", IndexedFormatsMatchReference);
+    OtterTest::Run("PremultiplyPaletteFillsMissingEntries", PremultiplyPaletteFillsMissingEntries);
+    return OtterTest::Finish();
+}
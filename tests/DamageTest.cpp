@@ -0,0 +1,158 @@
+// DamageTest.cpp
+// DamageRegion 的矩形合并规则、上限合并、裁剪与平移，以及 ApplyTo 对 Canvas 绘制的限制
+#include "OtterTest.h"
+#include "../OtterDamage.h"
+
+using namespace OtterRaster;
+
+static bool SameRect(const Rect& a, const Rect& b) {
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+static void ContainedRectIsDropped() {
+    DamageRegion region;
+    region.Add(10, 10, 100, 50);
+    region.Add(20, 20, 30, 10);
+    region.Add(10, 10, 100, 50);
+    OTTER_CHECK_EQ(region.Size(), 1u);
+    OTTER_CHECK(SameRect(region.Rects()[0], Rect(10, 10, 100, 50)));
+    OTTER_CHECK_EQ(region.Area(), 5000);
+
+    // 新矩形包含已有矩形时替换之
+    region.Add(0, 0, 200, 100);
+    OTTER_CHECK_EQ(region.Size(), 1u);
+    OTTER_CHECK(SameRect(region.Rects()[0], Rect(0, 0, 200, 100)));
+
+    region.Add(Rect(5, 5, 0, 10));
+    OTTER_CHECK_EQ(region.Size(), 1u);
+}
+
+static void TouchingRectsMergeWhenWasteIsSmall() {
+    DamageRegion side;
+    side.Add(0, 0, 10, 10);
+    side.Add(10, 0, 10, 10);            // 共边，浪费为0
+    OTTER_CHECK_EQ(side.Size(), 1u);
+    OTTER_CHECK(SameRect(side.Rects()[0], Rect(0, 0, 20, 10)));
+
+    DamageRegion limit;
+    limit.Add(0, 0, 10, 10);
+    limit.Add(10, 5, 10, 10);           // 并集 20×15，浪费100 等于较小矩形面积
+    OTTER_CHECK_EQ(limit.Size(), 1u);
+    OTTER_CHECK(SameRect(limit.Rects()[0], Rect(0, 0, 20, 15)));
+
+    DamageRegion corner;
+    corner.Add(0, 0, 10, 10);
+    corner.Add(10, 10, 100, 100);       // 只有角相接，浪费2000 远大于100
+    OTTER_CHECK_EQ(corner.Size(), 2u);
+    OTTER_CHECK_EQ(corner.Area(), 10100);
+
+    DamageRegion apart;
+    apart.Add(0, 0, 10, 10);
+    apart.Add(11, 0, 10, 10);           // 不相接的矩形不合并
+    OTTER_CHECK_EQ(apart.Size(), 2u);
+
+    // 合并后的矩形继续与其它矩形合并
+    DamageRegion chain;
+    chain.Add(0, 0, 10, 10);
+    chain.Add(20, 0, 10, 10);
+    chain.Add(10, 0, 10, 10);
+    OTTER_CHECK_EQ(chain.Size(), 1u);
+    OTTER_CHECK(SameRect(chain.Rects()[0], Rect(0, 0, 30, 10)));
+}
+
+static void CapMergesCheapestPair() {
+    DamageRegion region(2);
+    region.Add(0, 0, 20, 20);
+    region.Add(30, 0, 20, 20);
+    region.Add(100, 100, 30, 40);
+    // 三个互不相接的矩形：合并前两个浪费200，代价最小
+    OTTER_CHECK_EQ(region.Size(), 2u);
+    OTTER_CHECK_EQ(region.Area(), 2200);
+    OTTER_CHECK(SameRect(region.Rects()[0], Rect(0, 0, 50, 20)));
+    OTTER_CHECK(SameRect(region.Bounds(), Rect(0, 0, 130, 140)));
+
+    DamageRegion single(0);             // 上限至少为1
+    OTTER_CHECK_EQ(single.MaxRects(), 1u);
+    single.Add(0, 0, 10, 10);
+    single.Add(50, 50, 10, 10);
+    OTTER_CHECK_EQ(single.Size(), 1u);
+    OTTER_CHECK(SameRect(single.Rects()[0], Rect(0, 0, 60, 60)));
+}
+
+static void ClipAndOffset() {
+    DamageRegion region;
+    region.Add(-20, -20, 40, 40);
+    region.Add(90, 90, 40, 40);
+    region.Add(300, 300, 10, 10);
+    region.Clip(Rect(0, 0, 100, 100));
+    OTTER_CHECK_EQ(region.Size(), 2u);
+    OTTER_CHECK(SameRect(region.Rects()[0], Rect(0, 0, 20, 20)));
+    OTTER_CHECK(SameRect(region.Rects()[1], Rect(90, 90, 10, 10)));
+    OTTER_CHECK_EQ(region.Area(), 500);
+
+    region.Offset(5, -3);
+    OTTER_CHECK(SameRect(region.Rects()[0], Rect(5, -3, 20, 20)));
+    OTTER_CHECK(SameRect(region.Rects()[1], Rect(95, 87, 10, 10)));
+    OTTER_CHECK(region.Contains(5, -3));
+    OTTER_CHECK(!region.Contains(25, 0));
+    OTTER_CHECK(region.Intersects(Rect(100, 90, 10, 10)));
+    OTTER_CHECK(!region.Intersects(Rect(30, 30, 50, 50)));
+
+    region.Clip(Rect(1000, 1000, 10, 10));
+    OTTER_CHECK(region.Empty());
+
+    region.SetFull(Rect(0, 0, 64, 48));
+    OTTER_CHECK_EQ(region.Size(), 1u);
+    OTTER_CHECK_EQ(region.Area(), 64 * 48);
+}
+
+static void ApplyToLimitsCanvasFills() {
+    const Color background(255, 255, 255, 255), ink(255, 200, 20, 20);
+    Surface surface(64, 48);
+    Canvas canvas(&surface);
+    canvas.Clear(background);
+
+    DamageRegion region;
+    region.Add(4, 4, 10, 10);
+    region.Add(40, 20, 16, 8);
+    region.ApplyTo(canvas);
+    canvas.FillRectangle(0, 0, 64, 48, ink);
+    canvas.ResetClipRects();
+
+    long long painted = 0;
+    bool outsideClean = true, insideFilled = true;
+    for (int y = 0; y < surface.Height(); ++y) {
+        for (int x = 0; x < surface.Width(); ++x) {
+            const bool inside = region.Contains(x, y);
+            const uint32_t px = surface.Row(y)[x];
+            if (px == Premultiply(ink)) ++painted;
+            if (inside && px != Premultiply(ink)) insideFilled = false;
+            if (!inside && px != Premultiply(background)) outsideClean = false;
+        }
+    }
+    OTTER_CHECK(insideFilled);
+    OTTER_CHECK(outsideClean);
+    OTTER_CHECK_EQ(painted, region.Area());
+
+    // 空区域裁掉全部绘制
+    DamageRegion empty;
+    canvas.Clear(background);
+    empty.ApplyTo(canvas);
+    canvas.FillRectangle(0, 0, 64, 48, ink);
+    canvas.DrawLine(0.0f, 0.0f, 63.0f, 47.0f, ink, 3.0f);
+    canvas.ResetClipRects();
+    bool untouched = true;
+    for (int y = 0; y < surface.Height(); ++y) {
+        for (int x = 0; x < surface.Width(); ++x) untouched = untouched && surface.Row(y)[x] == Premultiply(background);
+    }
+    OTTER_CHECK(untouched);
+}
+
+int main() {
+    OtterTest::Run("ContainedRectIsDropped", ContainedRectIsDropped);
+    OtterTest::Run("TouchingRectsMergeWhenWasteIsSmall", TouchingRectsMergeWhenWasteIsSmall);
+    OtterTest::Run("CapMergesCheapestPair", CapMergesCheapestPair);
+    OtterTest::Run("ClipAndOffset", ClipAndOffset);
+    OtterTest::Run("ApplyToLimitsCanvasFills", ApplyToLimitsCanvasFills);
+    return OtterTest::Finish();
+}
@@ -0,0 +1,232 @@
+// DecodeQueueTest.cpp
+// DecodeQueue：优先级顺序、队列满时挤出（Dropped）、取消等待中与执行中的任务、失败结果、WaitIdle
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "OtterTest.h"
+#include "../OtterDecodeQueue.h"
+
+using namespace OtterAsync;
+using Queue = DecodeQueue<std::string, int>;
+
+// 阻塞唯一的工作线程，使之后提交的任务留在等待队列中，直到 Open
+class Gate {
+public:
+    Queue::Job Job() {
+        return [this](int& out, const std::atomic<bool>& cancelled) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_entered = true;
+            m_changed.notify_all();
+            while (!m_open && !cancelled) m_changed.wait_for(lock, std::chrono::milliseconds(1));
+            out = 1;
+            return true;
+        };
+    }
+
+    void WaitEntered() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [this] { return m_entered; });
+    }
+
+    void Open() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_open = true;
+        m_changed.notify_all();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    bool m_entered = false;
+    bool m_open = false;
+};
+
+// 记录执行顺序的任务
+static Queue::Job Recorder(std::vector<std::string>& order, std::mutex& mutex, const std::string& name, int value = 0) {
+    return [&order, &mutex, name, value](int& out, const std::atomic<bool>&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(name);
+        out = value;
+        return true;
+    };
+}
+
+static std::map<std::string, Queue::Completion> DrainAll(Queue& queue) {
+    std::map<std::string, Queue::Completion> done;
+    queue.Drain([&](Queue::Completion& c) { done.emplace(c.key, c); });
+    return done;
+}
+
+static void RunsByPriorityThenSubmission() {
+    Queue queue(1);
+    Gate gate;
+    std::vector<std::string> order;
+    std::mutex mutex;
+    OTTER_CHECK(queue.Submit("gate", gate.Job()));
+    gate.WaitEntered();
+
+    OTTER_CHECK(queue.Submit("a", Recorder(order, mutex, "a"), kPriorityBackground));
+    OTTER_CHECK(queue.Submit("b", Recorder(order, mutex, "b"), kPriorityNormal));
+    OTTER_CHECK(queue.Submit("c", Recorder(order, mutex, "c"), kPriorityVisible));
+    OTTER_CHECK(queue.Submit("d", Recorder(order, mutex, "d"), kPriorityNormal));
+    OTTER_CHECK(queue.Submit("e", Recorder(order, mutex, "e"), kPriorityNormal));
+    OTTER_CHECK_EQ(queue.PendingCount(), 5u);
+
+    // 重复提交只调整优先级，不产生第二个任务；SetPriority 同样可把任务提前
+    OTTER_CHECK(queue.Submit("e", Recorder(order, mutex, "e2"), kPriorityVisible));
+    OTTER_CHECK(queue.SetPriority("a", kPriorityVisible + 1));
+    OTTER_CHECK(!queue.SetPriority("missing", kPriorityVisible));
+    OTTER_CHECK_EQ(queue.PendingCount(), 5u);
+
+    // 执行中的键再次提交返回 true 但不排队
+    OTTER_CHECK(queue.Submit("gate", gate.Job()));
+    OTTER_CHECK_EQ(queue.PendingCount(), 5u);
+
+    gate.Open();
+    queue.WaitIdle();
+    const std::vector<std::string> expected = { "a", "c", "e", "b", "d" };
+    OTTER_CHECK(order == expected);
+    OTTER_CHECK_EQ(queue.GetStats().submitted, 6u);
+    OTTER_CHECK_EQ(queue.GetStats().ready, 6u);
+    OTTER_CHECK_EQ(DrainAll(queue).size(), 6u);
+}
+
+static void DropsLowestWhenFull() {
+    Queue queue(1, 2);
+    Gate gate;
+    std::vector<std::string> order;
+    std::mutex mutex;
+    int notifications = 0;
+    std::mutex notifyMutex;
+    queue.SetNotify([&] { std::lock_guard<std::mutex> lock(notifyMutex); ++notifications; });
+    OTTER_CHECK(queue.Submit("gate", gate.Job()));
+    gate.WaitEntered();
+
+    OTTER_CHECK(queue.Submit("x", Recorder(order, mutex, "x"), kPriorityNormal));
+    OTTER_CHECK(queue.Submit("y", Recorder(order, mutex, "y"), kPriorityBackground));
+    // 已满且没有更低优先级的任务：拒绝
+    OTTER_CHECK(!queue.Submit("z", Recorder(order, mutex, "z"), kPriorityBackground));
+    // 更高优先级的任务挤出最低的 y
+    OTTER_CHECK(queue.Submit("w", Recorder(order, mutex, "w"), kPriorityVisible));
+    OTTER_CHECK_EQ(queue.PendingCount(), 2u);
+    OTTER_CHECK(!queue.IsQueued("y"));
+    {
+        std::lock_guard<std::mutex> lock(notifyMutex);
+        OTTER_CHECK_EQ(notifications, 1);      // 挤出也会通知，UI线程据此取走 Dropped
+    }
+
+    gate.Open();
+    queue.WaitIdle();
+    auto done = DrainAll(queue);
+    OTTER_CHECK_EQ(done.size(), 4u);
+    OTTER_CHECK(done.count("y") && done.at("y").status == DecodeStatus::Dropped);
+    OTTER_CHECK(done.count("x") && done.at("x").status == DecodeStatus::Ready);
+    OTTER_CHECK(done.count("w") && done.at("w").status == DecodeStatus::Ready);
+    OTTER_CHECK(!done.count("z"));
+    const std::vector<std::string> expected = { "w", "x" };
+    OTTER_CHECK(order == expected);
+    const DecodeStats stats = queue.GetStats();
+    OTTER_CHECK_EQ(stats.dropped, 1u);
+    OTTER_CHECK_EQ(stats.peakPending, 2u);
+}
+
+static void CancelPendingAndRunning() {
+    Queue queue(1);
+    Gate gate;
+    std::vector<std::string> order;
+    std::mutex mutex;
+    OTTER_CHECK(queue.Submit("gate", gate.Job()));
+    gate.WaitEntered();
+    OTTER_CHECK(queue.Submit("p", Recorder(order, mutex, "p")));
+    OTTER_CHECK(queue.Submit("q", Recorder(order, mutex, "q")));
+
+    // 等待中的任务直接移除，不产生完成结果
+    OTTER_CHECK(queue.Cancel("p"));
+    OTTER_CHECK(!queue.IsQueued("p"));
+    OTTER_CHECK(!queue.Cancel("p"));
+    OTTER_CHECK(!queue.Cancel("unknown"));
+
+    // 执行中的任务置取消标志，任务返回后报告 Cancelled 且结果被丢弃
+    OTTER_CHECK(queue.Cancel("gate"));
+    queue.WaitIdle();
+    auto done = DrainAll(queue);
+    OTTER_CHECK_EQ(done.size(), 2u);
+    OTTER_CHECK(done.count("gate") && done.at("gate").status == DecodeStatus::Cancelled);
+    OTTER_CHECK(done.count("gate") && done.at("gate").result == 0);
+    OTTER_CHECK(done.count("q") && done.at("q").status == DecodeStatus::Ready);
+    OTTER_CHECK(!done.count("p"));
+    const std::vector<std::string> expected = { "q" };
+    OTTER_CHECK(order == expected);
+    OTTER_CHECK_EQ(queue.GetStats().cancelled, 2u);
+
+    // CancelAll 清空等待队列并取消执行中的任务
+    Gate gate2;
+    OTTER_CHECK(queue.Submit("gate2", gate2.Job()));
+    gate2.WaitEntered();
+    OTTER_CHECK(queue.Submit("r", Recorder(order, mutex, "r")));
+    OTTER_CHECK(queue.Submit("s", Recorder(order, mutex, "s")));
+    queue.CancelAll();
+    queue.WaitIdle();
+    done = DrainAll(queue);
+    OTTER_CHECK_EQ(done.size(), 1u);
+    OTTER_CHECK(done.count("gate2") && done.at("gate2").status == DecodeStatus::Cancelled);
+    OTTER_CHECK_EQ(order.size(), 1u);
+    OTTER_CHECK_EQ(queue.GetStats().cancelled, 5u);
+}
+
+static void FailedJobsKeepTheirResult() {
+    Queue queue(2);
+    OTTER_CHECK(queue.Submit("ok", [](int& out, const std::atomic<bool>&) { out = 7; return true; }));
+    OTTER_CHECK(queue.Submit("fail", [](int& out, const std::atomic<bool>&) { out = 42; return false; }));
+    OTTER_CHECK(queue.Submit("throw", [](int&, const std::atomic<bool>&) -> bool { throw std::runtime_error("decode"); }));
+    queue.WaitIdle();
+    auto done = DrainAll(queue);
+    OTTER_CHECK_EQ(done.size(), 3u);
+    OTTER_CHECK(done.count("ok") && done.at("ok").status == DecodeStatus::Ready && done.at("ok").result == 7);
+    OTTER_CHECK(done.count("fail") && done.at("fail").status == DecodeStatus::Failed && done.at("fail").result == 42);
+    OTTER_CHECK(done.count("throw") && done.at("throw").status == DecodeStatus::Failed);
+    OTTER_CHECK_EQ(queue.GetStats().ready, 1u);
+    OTTER_CHECK_EQ(queue.GetStats().failed, 2u);
+}
+
+static void WaitIdleWaitsForAllWork() {
+    Queue queue(3);
+    std::atomic<int> finished{ 0 };
+    const int jobs = 24;
+    for (int i = 0; i < jobs; ++i) {
+        OTTER_CHECK(queue.Submit("job" + std::to_string(i), [&finished, i](int& out, const std::atomic<bool>&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1 + i % 3));
+            out = i;
+            ++finished;
+            return true;
+        }, i % 3));
+    }
+    queue.WaitIdle();
+    OTTER_CHECK_EQ(finished.load(), jobs);
+    OTTER_CHECK_EQ(queue.PendingCount(), 0u);
+    OTTER_CHECK(!queue.IsQueued("job0"));
+    auto done = DrainAll(queue);
+    OTTER_CHECK_EQ(done.size(), size_t(jobs));
+    OTTER_CHECK(done.count("job5") && done.at("job5").result == 5);
+
+    // 空队列立即返回；Shutdown 后不再接受任务
+    queue.WaitIdle();
+    queue.Shutdown();
+    OTTER_CHECK(!queue.Submit("late", [](int&, const std::atomic<bool>&) { return true; }));
+    OTTER_CHECK_EQ(queue.WorkerCount(), 0u);
+}
+
+int main() {
+    OtterTest::Run("RunsByPriorityThenSubmission", RunsByPriorityThenSubmission);
+    OtterTest::Run("DropsLowestWhenFull", DropsLowestWhenFull);
+    OtterTest::Run("CancelPendingAndRunning", CancelPendingAndRunning);
+    OtterTest::Run("FailedJobsKeepTheirResult", FailedJobsKeepTheirResult);
+    OtterTest::Run("WaitIdleWaitsForAllWork", WaitIdleWaitsForAllWork);
+    return OtterTest::Finish();
+}
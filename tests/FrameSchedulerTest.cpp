@@ -0,0 +1,193 @@
+// FrameSchedulerTest.cpp
+// FrameScheduler 在 FakeFrameClock 下的行为：空闲等待、唤醒后立即出帧、同步点对齐、超时与掉帧统计、回调中取消
+#include <vector>
+#include "OtterTest.h"
+#include "../OtterFrameScheduler.h"
+
+using namespace OtterAnim;
+
+static const int64_t kInterval60 = 16667;
+
+// 时钟推进到下一帧的时刻（模拟消息循环按 TimeoutMicros 等待）再 Tick
+static bool WaitAndTick(FrameScheduler& scheduler, FakeFrameClock& clock, int64_t jitterUs = 0) {
+    const int64_t wait = scheduler.TimeoutMicros();
+    if (wait < 0) return false;
+    clock.Advance(wait + jitterUs);
+    return scheduler.Tick();
+}
+
+static void IdleWaitsForever() {
+    FakeFrameClock clock(5000);
+    FrameScheduler scheduler(clock, 60.0);
+    OTTER_CHECK_EQ(scheduler.IntervalMicros(), kInterval60);
+    OTTER_CHECK(scheduler.Idle());
+    OTTER_CHECK_EQ(scheduler.TimeoutMicros(), -1);
+    OTTER_CHECK_EQ(scheduler.NextFrameTime(), -1);
+    OTTER_CHECK(!scheduler.Tick());
+
+    // 动画结束后回到空闲
+    scheduler.Request([](const FrameInfo&) { return false; });
+    OTTER_CHECK(scheduler.Tick());
+    OTTER_CHECK(scheduler.Idle());
+    OTTER_CHECK_EQ(scheduler.TimeoutMicros(), -1);
+
+    // RequestFrame 只出一帧
+    scheduler.RequestFrame();
+    OTTER_CHECK_EQ(scheduler.TimeoutMicros(), 0);
+    OTTER_CHECK(scheduler.Tick());
+    OTTER_CHECK_EQ(scheduler.TimeoutMicros(), -1);
+    OTTER_CHECK_EQ(scheduler.GetStats().frames, 2u);
+}
+
+static void FirstFrameRunsImmediatelyAfterWake() {
+    FakeFrameClock clock(50000);
+    FrameScheduler scheduler(clock, 60.0);
+    std::vector<FrameInfo> frames;
+    scheduler.Request([&](const FrameInfo& info) { frames.push_back(info); return true; });
+    OTTER_CHECK_EQ(scheduler.TimeoutMicros(), 0);
+    OTTER_CHECK(scheduler.Tick());
+    OTTER_CHECK_EQ(frames.size(), 1u);
+    OTTER_CHECK_EQ(frames[0].frame, 0u);
+    OTTER_CHECK_EQ(frames[0].deltaUs, kInterval60);     // 从空闲开始的第一帧为一个帧间隔
+    OTTER_CHECK_EQ(frames[0].missedVblanks, 0);
+    OTTER_CHECK_EQ(frames[0].timeUs, 2 * kInterval60);  // 不大于50000的同步点
+    OTTER_CHECK_EQ(scheduler.GetStats().idleStarts, 1u);
+
+    // 同一时刻不会重复出帧
+    OTTER_CHECK(!scheduler.Tick());
+    OTTER_CHECK_EQ(scheduler.TimeoutMicros(), 3 * kInterval60 - 50000);
+}
+
+static void FramesAlignToPhase() {
+    const int64_t phase = 1234;
+    FakeFrameClock clock(100000);
+    FrameScheduler scheduler(clock, 60.0);
+    scheduler.SetPhase(phase);
+    std::vector<FrameInfo> frames;
+    scheduler.Request([&](const FrameInfo& info) { frames.push_back(info); return frames.size() < 12; });
+
+    OTTER_CHECK(scheduler.Tick());
+    // 提前一微秒不出帧，到点出帧；唤醒延迟不影响帧时刻
+    for (int i = 0; i < 11; ++i) {
+        clock.Advance(scheduler.TimeoutMicros() - 1);
+        OTTER_CHECK(!scheduler.Tick());
+        OTTER_CHECK(WaitAndTick(scheduler, clock, (i * 997) % 5000));
+    }
+    OTTER_CHECK_EQ(frames.size(), 12u);
+    bool aligned = true, steady = true;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        aligned = aligned && (frames[i].timeUs - phase) % kInterval60 == 0;
+        if (i > 0) steady = steady && frames[i].deltaUs == kInterval60 && frames[i].missedVblanks == 0
+            && frames[i].timeUs == frames[i - 1].timeUs + kInterval60;
+    }
+    OTTER_CHECK(aligned);
+    OTTER_CHECK(steady);
+    OTTER_CHECK_EQ(frames[0].timeUs, phase + 5 * kInterval60);
+    OTTER_CHECK(scheduler.Idle());
+
+    // 30Hz：间隔加倍，相位不变
+    scheduler.SetTargetRate(30.0);
+    OTTER_CHECK_EQ(scheduler.IntervalMicros(), 33333);
+    frames.clear();
+    scheduler.Request([&](const FrameInfo& info) { frames.push_back(info); return frames.size() < 3; });
+    while (WaitAndTick(scheduler, clock)) {}
+    OTTER_CHECK_EQ(frames.size(), 3u);
+    OTTER_CHECK_EQ((frames[2].timeUs - phase) % 33333, 0);
+    OTTER_CHECK_EQ(frames[2].deltaUs, 33333);
+}
+
+static void OverrunsAndMissedVblanks() {
+    FakeFrameClock clock(0);
+    FrameScheduler scheduler(clock, 60.0);
+    std::vector<FrameInfo> frames;
+    scheduler.Request([&](const FrameInfo& info) {
+        frames.push_back(info);
+        clock.Advance(20000);                           // 每帧耗时20ms，超过16.7ms预算
+        return frames.size() < 30;
+    });
+    while (WaitAndTick(scheduler, clock)) {}
+
+    const FrameStats& stats = scheduler.GetStats();
+    OTTER_CHECK_EQ(stats.frames, 30u);
+    OTTER_CHECK_EQ(stats.overruns, 30u);
+    OTTER_CHECK_EQ(stats.worstWorkUs, 20000);
+    OTTER_CHECK_NEAR(stats.AverageWorkUs(), 20000.0, 1e-9);
+    OTTER_CHECK_NEAR(stats.OverrunRate(), 1.0, 1e-9);
+    // 30帧耗时600ms 约36个同步点，应掉约6帧
+    OTTER_CHECK(stats.missedVblanks >= 5 && stats.missedVblanks <= 7);
+
+    size_t missed = 0;
+    for (const FrameInfo& f : frames) missed += size_t(f.missedVblanks);
+    OTTER_CHECK_EQ(missed, stats.missedVblanks);
+    const int64_t span = frames.back().timeUs - frames.front().timeUs;
+    OTTER_CHECK_EQ(int64_t(missed), span / kInterval60 - int64_t(frames.size() - 1));
+    bool deltas = true;
+    for (size_t i = 1; i < frames.size(); ++i) {
+        deltas = deltas && frames[i].deltaUs == (frames[i].missedVblanks + 1) * kInterval60;
+    }
+    OTTER_CHECK(deltas);
+
+    // 帧处理器的耗时同样计入预算
+    scheduler.ResetStats();
+    scheduler.SetFrameHandler([&](const FrameInfo&) { clock.Advance(10000); });
+    int left = 3;
+    scheduler.Request([&](const FrameInfo&) { clock.Advance(10000); return --left > 0; });
+    while (WaitAndTick(scheduler, clock)) {}
+    OTTER_CHECK_EQ(scheduler.GetStats().frames, 3u);
+    OTTER_CHECK_EQ(scheduler.GetStats().overruns, 3u);
+    OTTER_CHECK_EQ(scheduler.GetStats().lastWorkUs, 20000);
+}
+
+static void CancelInsideCallback() {
+    FakeFrameClock clock(0);
+    FrameScheduler scheduler(clock, 60.0);
+    int aCalls = 0, bCalls = 0, cCalls = 0;
+    FrameScheduler::Id a = 0, b = 0;
+    a = scheduler.Request([&](const FrameInfo&) {
+        ++aCalls;
+        if (aCalls == 2) {
+            OTTER_CHECK(scheduler.Cancel(b));           // 取消排在后面的回调：本帧即不再调用
+            OTTER_CHECK(scheduler.Cancel(a));           // 取消自己：返回值被忽略
+        }
+        return true;
+    });
+    b = scheduler.Request([&](const FrameInfo&) { ++bCalls; return true; });
+    OTTER_CHECK(a != 0 && b != 0 && a != b);
+
+    OTTER_CHECK(WaitAndTick(scheduler, clock));
+    OTTER_CHECK(aCalls == 1 && bCalls == 1);
+    OTTER_CHECK(WaitAndTick(scheduler, clock));
+    OTTER_CHECK(aCalls == 2 && bCalls == 1);
+    OTTER_CHECK(!scheduler.IsAnimating());
+    OTTER_CHECK(scheduler.Idle());
+    OTTER_CHECK_EQ(scheduler.TimeoutMicros(), -1);
+    OTTER_CHECK(!scheduler.Cancel(a));
+    OTTER_CHECK(!scheduler.Cancel(12345));
+
+    // 回调中新请求的动画从下一帧开始
+    scheduler.Request([&](const FrameInfo&) {
+        if (cCalls++ == 0) scheduler.Request([&](const FrameInfo&) { ++bCalls; return false; });
+        return cCalls < 2;
+    });
+    OTTER_CHECK(WaitAndTick(scheduler, clock));
+    OTTER_CHECK(cCalls == 1 && bCalls == 1);
+    OTTER_CHECK(WaitAndTick(scheduler, clock));
+    OTTER_CHECK(cCalls == 2 && bCalls == 2);
+    OTTER_CHECK(scheduler.Idle());
+
+    // CancelAll 也可在回调中调用
+    scheduler.Request([&](const FrameInfo&) { scheduler.CancelAll(); return true; });
+    scheduler.Request([&](const FrameInfo&) { ++bCalls; return true; });
+    OTTER_CHECK(WaitAndTick(scheduler, clock));
+    OTTER_CHECK_EQ(bCalls, 2);
+    OTTER_CHECK(scheduler.Idle());
+}
+
+int main() {
+    OtterTest::Run("IdleWaitsForever", IdleWaitsForever);
+    OtterTest::Run("FirstFrameRunsImmediatelyAfterWake", FirstFrameRunsImmediatelyAfterWake);
+    OtterTest::Run("FramesAlignToPhase", FramesAlignToPhase);
+    OtterTest::Run("OverrunsAndMissedVblanks", OverrunsAndMissedVblanks);
+    OtterTest::Run("CancelInsideCallback", CancelInsideCallback);
+    return OtterTest::Finish();
+}
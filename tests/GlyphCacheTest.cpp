@@ -0,0 +1,267 @@
+// GlyphCacheTest.cpp
+// 字形缓存：经图集绘制的 DrawString 与按路径填充的结果在容差内一致；图集写满时清空重建、显式 Clear 后重新排版；
+// SkylinePacker 装箱的位置、边界与不重叠。字体为 OtterFontData.h 内置轮廓，无需系统字体
+#include <cstring>
+#include <string>
+#include <vector>
+#include "OtterTest.h"
+#include "../OtterRaster.h"
+
+using namespace OtterRaster;
+
+static const Color kWhite(255, 255, 255, 255);
+
+struct TextCase {
+    const wchar_t* text;
+    float x, y, size;
+    bool antiAlias;
+};
+
+// 同一段文字分别经缓存与按路径绘制
+static void RenderBoth(const TextCase& t, GlyphCache* cache, Surface& cached, Surface& path, Color color = Color(255, 20, 20, 20)) {
+    cached.Allocate(640, 200);
+    path.Allocate(640, 200);
+    Canvas a(&cached), b(&path);
+    a.Clear(kWhite);
+    b.Clear(kWhite);
+    a.SetAntiAlias(t.antiAlias);
+    b.SetAntiAlias(t.antiAlias);
+    a.SetGlyphCache(cache);
+    b.EnableGlyphCache(false);
+    const size_t length = std::wcslen(t.text);
+    a.DrawString(t.text, length, t.x, t.y, t.size, color);
+    b.DrawString(t.text, length, t.x, t.y, t.size, color);
+}
+
+static long long Ink(const Surface& s) {
+    long long ink = 0;
+    for (int y = 0; y < s.Height(); ++y) {
+        for (int x = 0; x < s.Width(); ++x) ink += 255 - (s.Row(y)[x] & 0xFF);
+    }
+    return ink;
+}
+
+// 单个字形：图集掩码按1/4像素光栅化，起点恰为1/4像素时与路径填充一致（只差浮点舍入）
+static void SingleGlyphsMatchPathFill() {
+    GlyphCache cache;
+    long long aliasedFlips = 0;
+    for (float size : { 8.0f, 12.0f, 24.0f }) {
+        for (float sub : { 0.0f, 0.25f, 0.5f, 0.75f }) {
+            for (wchar_t ch = L'!'; ch < 127; ++ch) {
+                const wchar_t text[2] = { ch, 0 };
+                Surface cached, path;
+                RenderBoth(TextCase{ text, 10.0f + sub, 3.3f, size, true }, &cache, cached, path);
+                const CompareResult r = CompareSurfaces(cached, path, 2);
+                if (!OTTER_CHECK(r.Matches())) std::printf("  字符 %lc 字号 %g 偏移 %g：最大差值 %d\n", ch, size, sub, r.maxDelta);
+                RenderBoth(TextCase{ text, 10.0f + sub, 3.3f, size, false }, &cache, cached, path);
+                aliasedFlips += CompareSurfaces(cached, path).mismatched;
+            }
+        }
+    }
+    // 不抗锯齿时采样点恰在边上的像素可能因舍入翻转
+    OTTER_CHECK(aliasedFlips <= 8);
+}
+
+// 整段文字：后续字形的笔位置量化到1/4像素，边缘差值不超过约1/8像素的覆盖率
+static void CachedStringsMatchPathFill() {
+    const TextCase cases[] = {
+        { L"OtterGUI 0123456789 %+-.,:", 5.0f, 3.0f, 9.0f, true },
+        { L"Subpixel AVWT Wij", 5.37f, 10.6f, 10.5f, true },
+        { L"Light on dark 42%\nsecond line", 4.81f, 2.2f, 16.0f, true },
+        { L"Kerning? AV To Wa", 3.13f, 0.0f, 36.0f, true },
+        { L"{[(|)]}@#&*", 7.5f, 5.5f, 72.0f, true },
+        { L"\x4E2D\x6587 fallback", 6.0f, 4.0f, 12.0f, true },
+        { L"aliased 0123 AVWT", 5.25f, 7.0f, 12.0f, false },
+        { L"aliased large", 5.6f, 7.0f, 48.0f, false },
+    };
+    GlyphCache cache;
+    for (const TextCase& t : cases) {
+        Surface cached, path;
+        RenderBoth(t, &cache, cached, path);
+        const long long inkCached = Ink(cached), inkPath = Ink(path);
+        OTTER_CHECK(inkPath > 0);
+        OTTER_CHECK(std::llabs(inkCached - inkPath) <= inkPath / 50);
+        const CompareResult r = CompareSurfaces(cached, path, 40);
+        if (t.antiAlias) {
+            if (!OTTER_CHECK(r.Matches())) std::printf("  \"%ls\"：%lld 个像素超出容差\n", t.text, r.mismatched);
+        }
+        else {
+            // 不抗锯齿：只允许边缘少量像素翻转
+            long long inkPixels = 0;
+            for (int y = 0; y < path.Height(); ++y) {
+                for (int x = 0; x < path.Width(); ++x) inkPixels += path.Row(y)[x] != Premultiply(kWhite);
+            }
+            OTTER_CHECK(r.mismatched * 5 <= inkPixels);
+        }
+
+        // 再次绘制命中序列缓存，结果不变
+        Surface again, unused;
+        RenderBoth(t, &cache, again, unused);
+        OTTER_CHECK(CompareSurfaces(cached, again).Matches());
+    }
+    OTTER_CHECK(cache.GetStats().runHits >= sizeof(cases) / sizeof(cases[0]));
+
+    // 超过 kMaxEmPixels 的字号不经缓存，与路径填充完全一致
+    OTTER_CHECK(!GlyphCache::Cacheable(100.0f));
+    Surface cached, path;
+    RenderBoth(TextCase{ L"Big", 5.3f, 0.0f, 100.0f, true }, &cache, cached, path);
+    OTTER_CHECK(CompareSurfaces(cached, path).Matches());
+}
+
+struct PlacedGlyph {
+    int x, y, left, top, width, height;
+    std::vector<uint8_t> mask;
+};
+
+static std::vector<PlacedGlyph> Snapshot(const GlyphCache& cache, const GlyphCache::TextRun& run) {
+    std::vector<PlacedGlyph> out;
+    const GlyphCache::Stats stats = cache.GetStats();
+    for (const GlyphCache::RunGlyph& rg : run.glyphs) {
+        OTTER_CHECK(rg.glyph < stats.glyphs);
+        const GlyphCache::Glyph& g = cache.GlyphAt(rg.glyph);
+        OTTER_CHECK(g.page < stats.atlasPages);
+        OTTER_CHECK(g.x + g.width <= GlyphCache::kPageSize && g.y + g.height <= GlyphCache::kPageSize);
+        PlacedGlyph p{ rg.x, rg.y, g.left, g.top, g.width, g.height, {} };
+        for (int row = 0; row < g.height; ++row) {
+            const uint8_t* m = cache.MaskRow(g, row);
+            p.mask.insert(p.mask.end(), m, m + g.width);
+        }
+        out.push_back(std::move(p));
+    }
+    return out;
+}
+
+static bool SamePlacement(const std::vector<PlacedGlyph>& a, const std::vector<PlacedGlyph>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].x != b[i].x || a[i].y != b[i].y || a[i].left != b[i].left || a[i].top != b[i].top
+            || a[i].width != b[i].width || a[i].height != b[i].height || a[i].mask != b[i].mask) return false;
+    }
+    return true;
+}
+
+// 显式 Clear 后重新排版：图集、字形与序列全部重建，结果与之前相同
+static void ClearAndRelayout() {
+    GlyphCache cache;
+    const wchar_t* text = L"Hello atlas 123";
+    const size_t length = std::wcslen(text);
+    const GlyphCache::TextRun* run = cache.Layout(text, length, 3.5f, 12.0f, true);
+    OTTER_CHECK(run != nullptr);
+    const std::vector<PlacedGlyph> before = Snapshot(cache, *run);
+    OTTER_CHECK(!before.empty());
+    OTTER_CHECK(cache.Layout(text, length, 3.5f, 12.0f, true) == run);
+    GlyphCache::Stats s = cache.GetStats();
+    OTTER_CHECK(s.runHits == 1 && s.runMisses == 1 && s.runs == 1);
+    OTTER_CHECK(s.atlasPages == 1 && s.glyphs > 0 && s.atlasOccupancy > 0.0);
+    const size_t misses = s.glyphMisses;
+
+    cache.Clear();
+    s = cache.GetStats();
+    OTTER_CHECK(s.glyphs == 0 && s.atlasPages == 0 && s.runs == 0);
+
+    run = cache.Layout(text, length, 3.5f, 12.0f, true);
+    OTTER_CHECK(run != nullptr);
+    if (run) OTTER_CHECK(SamePlacement(before, Snapshot(cache, *run)));
+    s = cache.GetStats();
+    OTTER_CHECK_EQ(s.runMisses, 2u);
+    OTTER_CHECK_EQ(s.glyphMisses, 2 * misses);
+    OTTER_CHECK_EQ(s.atlasResets, 0u);
+
+    // 起点的亚像素位置不同是不同的序列
+    OTTER_CHECK(cache.Layout(text, length, 3.75f, 12.0f, true) != nullptr);
+    OTTER_CHECK_EQ(cache.GetStats().runs, 2u);
+}
+
+// 图集页数已满时 Allocate 在排版途中清空缓存，Layout 重排后返回完整、有效的序列
+static void AtlasResetDuringLayout() {
+    GlyphCache small(64, 1);
+    GlyphCache reference;
+    const wchar_t* texts[] = { L"ABCDEFGH", L"IJKLMNOP", L"QRSTUVWX", L"abcdefgh", L"ijklmnop", L"qrstuvwx", L"ABCDEFGH" };
+    for (const wchar_t* text : texts) {
+        const size_t length = std::wcslen(text);
+        const GlyphCache::TextRun* run = small.Layout(text, length, 1.5f, 90.0f, true);
+        const GlyphCache::TextRun* expected = reference.Layout(text, length, 1.5f, 90.0f, true);
+        OTTER_CHECK(run != nullptr && expected != nullptr);
+        if (!run || !expected) continue;
+        OTTER_CHECK(SamePlacement(Snapshot(small, *run), Snapshot(reference, *expected)));
+    }
+    const GlyphCache::Stats s = small.GetStats();
+    OTTER_CHECK(s.atlasResets >= 1);
+    OTTER_CHECK_EQ(s.atlasPages, 1u);
+    OTTER_CHECK_EQ(reference.GetStats().atlasResets, 0u);
+
+    // 一页放不下的序列返回 nullptr，DrawString 退回路径填充
+    const wchar_t* huge = L"ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    OTTER_CHECK(small.Layout(huge, std::wcslen(huge), 0.0f, 96.0f, true) == nullptr);
+
+    // 经小图集绘制（途中多次重建）与路径填充一致
+    for (const wchar_t* text : { L"ABCDEFGHIJKL", L"MNOPQRSTUVWX", L"abcdefghijkl", L"ABCDEFGHIJKLMNOPQRSTUVWXYZ" }) {
+        Surface cached, path;
+        RenderBoth(TextCase{ text, 2.25f, 0.0f, 60.0f, true }, &small, cached, path, Color(255, 0, 0, 0));
+        const CompareResult r = CompareSurfaces(cached, path, 40);
+        if (!OTTER_CHECK(r.Matches())) std::printf("  \"%ls\"：%lld 个像素超出容差\n", text, r.mismatched);
+    }
+    OTTER_CHECK(small.GetStats().atlasResets >= 2);
+}
+
+static bool Overlaps(const Rect& a, const Rect& b) {
+    return a.x < b.Right() && b.x < a.Right() && a.y < b.Bottom() && b.y < a.Bottom();
+}
+
+static void SkylinePackerInsert() {
+    SkylinePacker packer(64, 64);
+    Point p;
+    OTTER_CHECK(!packer.Insert(0, 10, p));
+    OTTER_CHECK(!packer.Insert(10, -1, p));
+    OTTER_CHECK(!packer.Insert(65, 1, p));
+    OTTER_CHECK(!packer.Insert(1, 65, p));
+
+    // 新矩形放在顶边最低处
+    OTTER_CHECK(packer.Insert(30, 10, p) && p.X == 0 && p.Y == 0);
+    OTTER_CHECK(packer.Insert(20, 20, p) && p.X == 30 && p.Y == 0);
+    OTTER_CHECK(packer.Insert(10, 5, p) && p.X == 50 && p.Y == 0);
+    OTTER_CHECK(packer.Insert(30, 4, p) && p.X == 0 && p.Y == 10);
+    // 跨越多段时取最高点
+    OTTER_CHECK(packer.Insert(64, 8, p) && p.X == 0 && p.Y == 20);
+    OTTER_CHECK_NEAR(packer.Occupancy(), (300 + 400 + 50 + 120 + 512) / 4096.0, 1e-12);
+
+    // 同尺寸方块恰好填满
+    packer.Reset(64, 64);
+    OTTER_CHECK_NEAR(packer.Occupancy(), 0.0, 0.0);
+    int placed = 0;
+    while (packer.Insert(16, 16, p)) ++placed;
+    OTTER_CHECK_EQ(placed, 16);
+    OTTER_CHECK_NEAR(packer.Occupancy(), 1.0, 1e-12);
+
+    // 随机尺寸：全部在边界内且互不重叠，占用率与面积一致
+    packer.Reset(256, 192);
+    std::vector<Rect> rects;
+    long long area = 0;
+    uint32_t seed = 7;
+    for (int i = 0; i < 400; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const int w = 3 + int((seed >> 8) % 29), h = 3 + int((seed >> 20) % 23);
+        if (!packer.Insert(w, h, p)) continue;
+        rects.push_back(Rect(p.X, p.Y, w, h));
+        area += (long long)w * h;
+    }
+    OTTER_CHECK(rects.size() > 40);
+    bool inside = true, disjoint = true;
+    for (size_t i = 0; i < rects.size(); ++i) {
+        inside = inside && rects[i].x >= 0 && rects[i].y >= 0 && rects[i].Right() <= 256 && rects[i].Bottom() <= 192;
+        for (size_t j = i + 1; j < rects.size(); ++j) disjoint = disjoint && !Overlaps(rects[i], rects[j]);
+    }
+    OTTER_CHECK(inside);
+    OTTER_CHECK(disjoint);
+    OTTER_CHECK_NEAR(packer.Occupancy(), double(area) / (256.0 * 192.0), 1e-12);
+    OTTER_CHECK(packer.Occupancy() > 0.6);
+}
+
+int main() {
+    OtterTest::Run("SingleGlyphsMatchPathFill", SingleGlyphsMatchPathFill);
+    OtterTest::Run("CachedStringsMatchPathFill", CachedStringsMatchPathFill);
+    OtterTest::Run("ClearAndRelayout", ClearAndRelayout);
+    OtterTest::Run("AtlasResetDuringLayout", AtlasResetDuringLayout);
+    OtterTest::Run("SkylinePackerInsert", SkylinePackerInsert);
+    return OtterTest::Finish();
+}
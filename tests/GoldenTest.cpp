@@ -0,0 +1,34 @@
+// GoldenTest.cpp
+// 黄金图像测试：渲染 OtterGolden.h 的全部场景并与 tests/golden 下的PNG比较，全部通过时退出码为0
+// 用法: OtterGoldenTest <黄金图目录> [--record] [--out <失败图目录>] [--report <报告JSON>]
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "../OtterGolden.h"
+
+namespace G = OtterRaster::Golden;
+
+int main(int argc, char** argv) {
+    G::Options options;
+    std::string report;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--record") == 0) options.mode = G::Mode::Record;
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) options.failureDirectory = argv[++i];
+        else if (std::strcmp(argv[i], "--report") == 0 && i + 1 < argc) report = argv[++i];
+        else options.directory = argv[i];
+    }
+
+    const std::vector<G::Result> results = G::RunSuite(options);
+    for (const G::Result& r : results) {
+        const char* state = r.recorded ? "REC " : r.passed ? " OK " : r.missing ? "MISS" : "FAIL";
+        std::printf("[%s] %-10s mismatched=%lld maxDelta=%d %.2f ms\n", state, r.scene.c_str(),
+            r.compare.mismatched, r.compare.maxDelta, r.renderMs);
+    }
+    if (!report.empty()) std::ofstream(report, std::ios::binary) << G::ReportJson(results);
+    if (!G::AllPassed(results)) {
+        std::printf("黄金图像比较失败，实际图与差异图写入 %s\n",
+            (options.failureDirectory.empty() ? options.directory : options.failureDirectory).c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+// GradientTest.cpp
+// GradientPaint::ShadeRow：整行一次着色（SSE2）与逐像素着色（标量）逐位一致，且与分段方式无关
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "OtterTest.h"
+#include "../OtterGradient.h"
+
+using namespace OtterRaster;
+
+static const std::vector<GradientStop>& Stops() {
+    static const std::vector<GradientStop> stops = { { 0.0f, Color(255, 200, 30, 40) }, { 0.3f, Color(128, 20, 220, 90) },
+        { 0.3f, Color(255, 250, 250, 10) }, { 1.0f, Color(0, 0, 0, 255) } };
+    return stops;
+}
+
+static std::vector<GradientPaint> Paints() {
+    std::vector<GradientPaint> paints;
+    for (GradientSpread spread : { GradientSpread::Pad, GradientSpread::Repeat, GradientSpread::Reflect }) {
+        paints.push_back(GradientPaint::Linear(PointF(13.25f, -7.5f), PointF(61.0f, 22.75f), Stops(), spread));
+        paints.push_back(GradientPaint::Linear(PointF(40.0f, 0.0f), PointF(33.0f, 90.0f), Stops(), spread));   // 接近竖直
+        paints.push_back(GradientPaint::Linear(PointF(0.5f, 0.5f), PointF(3.0f, 0.5f), Stops(), spread));      // 很短，多次重复
+        paints.push_back(GradientPaint::Radial(PointF(50.3f, 20.7f), 37.5f, Stops(), spread));
+        paints.push_back(GradientPaint::Radial(PointF(-5.0f, 3.0f), 4.0f, Stops(), spread));
+    }
+    return paints;
+}
+
+static void WholeRowMatchesPerPixel() {
+    int mismatches = 0;
+    for (const GradientPaint& paint : Paints()) {
+        for (int y : { -3, 0, 7, 20, 41 }) {
+            for (int x0 : { -17, 0, 1, 3, 30, 517, 2049 }) {
+                const int width = 131;
+                std::vector<uint32_t> row(width), pixel(width);
+                paint.ShadeRow(x0, y, width, row.data());
+                for (int i = 0; i < width; ++i) paint.ShadeRow(x0 + i, y, 1, &pixel[i]);
+                if (row != pixel && ++mismatches <= 5) {
+                    std::printf("  不一致：kind=%d spread=%d x0=%d y=%d\n",
+                        int(paint.GetKind()), int(paint.GetSpread()), x0, y);
+                }
+            }
+        }
+    }
+    OTTER_CHECK_EQ(mismatches, 0);
+}
+
+// 同一行按任意位置切成几段着色（如被裁剪或损坏区域分割）结果不变
+static void SplitRowsMatchWholeRow() {
+    std::mt19937 rng(31);
+    int mismatches = 0;
+    for (const GradientPaint& paint : Paints()) {
+        for (int round = 0; round < 40; ++round) {
+            const int x0 = int(rng() % 64) - 32, y = int(rng() % 80) - 10, width = 1 + int(rng() % 120);
+            std::vector<uint32_t> whole(width), split(width);
+            paint.ShadeRow(x0, y, width, whole.data());
+            for (int start = 0; start < width;) {
+                const int count = (std::min)(width - start, 1 + int(rng() % 11));
+                paint.ShadeRow(x0 + start, y, count, split.data() + start);
+                start += count;
+            }
+            mismatches += whole != split;
+        }
+    }
+    OTTER_CHECK_EQ(mismatches, 0);
+}
+
+// 抽查几个位置的颜色：线性起点与终点、径向圆心
+static void EndpointsUseStopColors() {
+    const std::vector<GradientStop> stops = { { 0.0f, Color(255, 255, 0, 0) }, { 1.0f, Color(255, 0, 0, 255) } };
+    const GradientPaint linear = GradientPaint::Linear(PointF(0.5f, 0.0f), PointF(100.5f, 0.0f), stops);
+    std::vector<uint32_t> row(101);
+    linear.ShadeRow(0, 0, 101, row.data());
+    OTTER_CHECK_EQ(row[0], Premultiply(stops[0].color));
+    OTTER_CHECK_EQ(row[100], Premultiply(stops[1].color));
+
+    const GradientPaint repeat = GradientPaint::Linear(PointF(0.5f, 0.0f), PointF(100.5f, 0.0f), stops, GradientSpread::Repeat);
+    uint32_t first = 0, wrapped = 0;
+    repeat.ShadeRow(20, 0, 1, &first);
+    repeat.ShadeRow(120, 0, 1, &wrapped);
+    OTTER_CHECK_EQ(first, wrapped);
+
+    const GradientPaint radial = GradientPaint::Radial(PointF(20.5f, 20.5f), 10.0f, stops);
+    uint32_t center = 0;
+    radial.ShadeRow(20, 20, 1, &center);
+    OTTER_CHECK_EQ(center, Premultiply(stops[0].color));
+}
+
+int main() {
+    OtterTest::Run("WholeRowMatchesPerPixel", WholeRowMatchesPerPixel);
+    OtterTest::Run("SplitRowsMatchWholeRow", SplitRowsMatchWholeRow);
+    OtterTest::Run("EndpointsUseStopColors", EndpointsUseStopColors);
+    return OtterTest::Finish();
+}
@@ -0,0 +1,189 @@
+// JsonTest.cpp
+// OtterJson：非法输入的错误码、转义与代理对、kMaxDepth 嵌套上限、Writer 控制字符转义、仪表盘数据往返
+#include <limits>
+#include <string>
+#include <string_view>
+#include "OtterTest.h"
+#include "../OtterJson.h"
+
+using namespace OtterJson;
+
+static ParseStatus ParseOf(std::string_view json) {
+    Document doc;
+    return doc.Parse(json);
+}
+
+// 按原样重新写出解析结果：数字沿用原文，字符串先反转义再由 Writer 转义
+static void Copy(Value v, Writer& w) {
+    switch (v.GetType()) {
+    case Type::Null: w.Null(); break;
+    case Type::False: w.Bool(false); break;
+    case Type::True: w.Bool(true); break;
+    case Type::Number: w.Raw(v.Raw()); break;
+    case Type::String: w.String(v.GetString()); break;
+    case Type::Array:
+        w.BeginArray();
+        for (Value e : v.Elements()) Copy(e, w);
+        w.EndArray();
+        break;
+    case Type::Object:
+        w.BeginObject();
+        for (Member m : v.Members()) {
+            w.Key(m.key.GetString());
+            Copy(m.value, w);
+        }
+        w.EndObject();
+        break;
+    }
+}
+
+static void RejectsMalformedInput() {
+    OTTER_CHECK(ParseOf("") == ParseStatus::Empty);
+    OTTER_CHECK(ParseOf(" \r\n\t") == ParseStatus::Empty);
+    OTTER_CHECK(ParseOf("{") == ParseStatus::UnexpectedCharacter);
+    OTTER_CHECK(ParseOf("[1,]") == ParseStatus::UnexpectedCharacter);
+    OTTER_CHECK(ParseOf("[1 2]") == ParseStatus::UnexpectedCharacter);
+    OTTER_CHECK(ParseOf("{\"a\"}") == ParseStatus::UnexpectedCharacter);
+    OTTER_CHECK(ParseOf("{\"a\":1,}") == ParseStatus::UnexpectedCharacter);
+    OTTER_CHECK(ParseOf("{1:2}") == ParseStatus::UnexpectedCharacter);
+    OTTER_CHECK(ParseOf("-") == ParseStatus::InvalidNumber);
+    OTTER_CHECK(ParseOf("1.") == ParseStatus::InvalidNumber);
+    OTTER_CHECK(ParseOf("1e+") == ParseStatus::InvalidNumber);
+    OTTER_CHECK(ParseOf("tru") == ParseStatus::InvalidLiteral);
+    OTTER_CHECK(ParseOf("nul") == ParseStatus::InvalidLiteral);
+    OTTER_CHECK(ParseOf("[1] 2") == ParseStatus::TrailingCharacters);
+    OTTER_CHECK(ParseOf("01") == ParseStatus::TrailingCharacters);
+    OTTER_CHECK(ParseOf("\"abc") == ParseStatus::UnterminatedString);
+    OTTER_CHECK(ParseOf("\"abc\\") == ParseStatus::UnterminatedString);
+    OTTER_CHECK(ParseOf("\"a\nb\"") == ParseStatus::InvalidString);
+
+    // 转义只接受 " \ / b f n r t 与 \u 加4个十六进制数字
+    OTTER_CHECK(ParseOf("[\"\\x\"]") == ParseStatus::InvalidString);
+    OTTER_CHECK(ParseOf("\"\\u12\"") == ParseStatus::InvalidString);
+    OTTER_CHECK(ParseOf("\"\\u12G4\"") == ParseStatus::InvalidString);
+    OTTER_CHECK(ParseOf("\"\\u00") == ParseStatus::InvalidString);
+    OTTER_CHECK(ParseOf("\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\u00E9\"") == ParseStatus::Ok);
+
+    // 出错位置指向出错的字符
+    Document doc;
+    OTTER_CHECK(doc.Parse("[true, \"\\q\"]") == ParseStatus::InvalidString);
+    OTTER_CHECK_EQ(doc.ErrorOffset(), 8u);
+
+    // 失败后文档可复用
+    OTTER_CHECK(doc.Parse("{\"ok\":true}") == ParseStatus::Ok);
+    OTTER_CHECK(doc.Root()["ok"].GetBool());
+}
+
+static void DecodesEscapesAndSurrogatePairs() {
+    Document doc;
+    OTTER_CHECK(doc.Parse("[\"plain\", \"a\\tb\\\"c\", \"\\u00e9\\u4e2d\", \"\\ud83d\\ude00!\", \"\\ud83d\", \"\\ud83d\\u0041\"]")
+        == ParseStatus::Ok);
+    Value root = doc.Root();
+    OTTER_CHECK_EQ(root.Size(), 6u);
+
+    std::string_view view;
+    OTTER_CHECK(root[0].GetStringView(view) && view == "plain");
+    OTTER_CHECK(!root[1].GetStringView(view));        // 含转义时不能零拷贝
+    OTTER_CHECK(root[1].HasEscapes());
+    OTTER_CHECK_EQ(root[1].GetString(), std::string("a\tb\"c"));
+    OTTER_CHECK_EQ(root[2].GetString(), std::string("\xC3\xA9\xE4\xB8\xAD"));
+    OTTER_CHECK_EQ(root[3].GetString(), std::string("\xF0\x9F\x98\x80!"));
+
+    // 落单或配错的高位代理项无法解码，返回默认值
+    OTTER_CHECK_EQ(root[4].GetString("bad"), std::string("bad"));
+    OTTER_CHECK_EQ(root[5].GetString("bad"), std::string("bad"));
+
+    // 带转义的键同样能查找
+    OTTER_CHECK(doc.Parse("{\"k\\u0065y\": 5}") == ParseStatus::Ok);
+    OTTER_CHECK_EQ(doc.Root()["key"].GetInt64(), 5);
+}
+
+static void LimitsNestingDepth() {
+    const int limit = Document::kMaxDepth;
+    Document doc;
+    std::string ok = std::string(limit, '[') + std::string(limit, ']');
+    OTTER_CHECK(doc.Parse(ok) == ParseStatus::Ok);
+    OTTER_CHECK_EQ(doc.TokenCount(), size_t(limit));
+
+    std::string deep = std::string(limit + 1, '[') + std::string(limit + 1, ']');
+    OTTER_CHECK(doc.Parse(deep) == ParseStatus::DepthExceeded);
+    OTTER_CHECK_EQ(doc.ErrorOffset(), size_t(limit));
+
+    // 对象与数组交替嵌套时按同一个深度计数
+    std::string mixed;
+    for (int i = 0; i <= limit; ++i) mixed += (i % 2) ? "[" : "{\"a\":";
+    OTTER_CHECK(doc.Parse(mixed) == ParseStatus::DepthExceeded);
+}
+
+static void WriterEscapesControlCharacters() {
+    std::string all;
+    for (int c = 0; c < 0x20; ++c) all.push_back(static_cast<char>(c));
+    all += "\"\\/ \xE4\xB8\xAD";
+
+    std::string out;
+    Writer w(out);
+    w.BeginArray().String(all).String("\x01\x1F").String("tab\there").EndArray();
+    OTTER_CHECK(out.find("\"\\u0001\\u001f\"") != std::string::npos);
+    OTTER_CHECK(out.find("\"tab\\there\"") != std::string::npos);
+    OTTER_CHECK(out.find("\\u0000\\u0001") != std::string::npos);
+    OTTER_CHECK(out.find("\\b\\t\\n\\u000b\\f\\r") != std::string::npos);
+    OTTER_CHECK(out.find("\\\"\\\\/") != std::string::npos);
+    for (char c : out) OTTER_CHECK(static_cast<unsigned char>(c) >= 0x20);
+
+    Document doc;
+    OTTER_CHECK(doc.Parse(out) == ParseStatus::Ok);
+    OTTER_CHECK_EQ(doc.Root()[0].GetString(), all);
+    OTTER_CHECK_EQ(doc.Root()[2].GetString(), std::string("tab\there"));
+
+    // 键同样转义；NaN 与无穷写为 null
+    out.clear();
+    Writer w2(out);
+    w2.BeginObject().Key("a\"b").Number(std::numeric_limits<double>::quiet_NaN())
+        .Key("c").Number(std::numeric_limits<double>::infinity()).EndObject();
+    OTTER_CHECK_EQ(out, std::string("{\"a\\\"b\":null,\"c\":null}"));
+}
+
+static void DashboardPayloadRoundTrip() {
+    const std::string payload = MakeDashboardPayload(16, 8);
+    Document doc;
+    OTTER_CHECK(doc.Parse(payload) == ParseStatus::Ok);
+    Value root = doc.Root();
+    OTTER_CHECK_EQ(root["timestamp"].GetInt64(), 1760000000123);
+    OTTER_CHECK_EQ(root["host"].GetString(), std::string("otter-dashboard-01"));
+
+    Value widgets = root["widgets"];
+    OTTER_CHECK_EQ(widgets.Size(), 16u);
+    Value first = widgets[0];
+    OTTER_CHECK_EQ(first["id"].GetString(), std::string("metric-0"));
+    OTTER_CHECK_EQ(first["title"].GetString(), std::string("CPU \"core\" load"));
+    OTTER_CHECK(first["alert"].GetBool());
+    OTTER_CHECK_EQ(first["history"].Size(), 8u);
+    OTTER_CHECK(!first["missing"].Valid());
+
+    int index = 0;
+    for (Value widget : widgets.Elements()) {
+        OTTER_CHECK_NEAR(widget["value"].GetDouble(), 37.5 + index * 1.25, 1e-9);
+        int h = 0;
+        for (Value v : widget["history"].Elements()) {
+            OTTER_CHECK_NEAR(v.GetDouble(), (index * 31 + h * 17) % 1000 / 10.0, 1e-9);
+            ++h;
+        }
+        ++index;
+    }
+    OTTER_CHECK_EQ(index, 16);
+
+    // 逐值重新写出应与原文逐字节相同
+    std::string copy;
+    Writer w(copy);
+    Copy(root, w);
+    OTTER_CHECK_EQ(copy, payload);
+}
+
+int main() {
+    OtterTest::Run("RejectsMalformedInput", RejectsMalformedInput);
+    OtterTest::Run("DecodesEscapesAndSurrogatePairs", DecodesEscapesAndSurrogatePairs);
+    OtterTest::Run("LimitsNestingDepth", LimitsNestingDepth);
+    OtterTest::Run("WriterEscapesControlCharacters", WriterEscapesControlCharacters);
+    OtterTest::Run("DashboardPayloadRoundTrip", DashboardPayloadRoundTrip);
+    return OtterTest::Finish();
+}
@@ -0,0 +1,80 @@
+// LamaeBatchTest.cpp
+// BatchParser：数值符号、行错误分类，以及分块接收时行号跨 Parse 连续计数
+#include <string>
+#include "OtterTest.h"
+#include "../OtterLamaeBatch.h"
+
+using namespace OtterLamae;
+
+static void SignsAndErrors() {
+    IdentifierTable table;
+    BatchParser parser(table);
+    ValueColumns cols;
+    const std::string text = "a +-5\nb 3\nc +2.5\nd -4\ne ++1\nf -+1\ng +\nh\ni 1 2\nj 1x\n";
+    const BatchResult r = parser.Parse(text, cols);
+    OTTER_CHECK_EQ(r.consumed, text.size());
+    OTTER_CHECK_EQ(r.parsed, 3u);
+    OTTER_CHECK_EQ(r.failed, 7u);
+    OTTER_CHECK(cols.size() == 3 && cols.values[0] == 3.0 && cols.values[1] == 2.5 && cols.values[2] == -4.0);
+    OTTER_CHECK_EQ(table.Name(cols.ids[1]), "c");
+
+    const LineStatus expected[] = { LineStatus::InvalidNumber, LineStatus::InvalidNumber, LineStatus::InvalidNumber,
+        LineStatus::InvalidNumber, LineStatus::MissingValue, LineStatus::ExtraCharacters, LineStatus::InvalidNumber };
+    const uint32_t lines[] = { 0, 4, 5, 6, 7, 8, 9 };
+    OTTER_CHECK_EQ(cols.errors.size(), 7u);
+    for (size_t i = 0; i < cols.errors.size() && i < 7; ++i) {
+        OTTER_CHECK(cols.errors[i].status == expected[i]);
+        OTTER_CHECK_EQ(cols.errors[i].line, lines[i]);
+    }
+    OTTER_CHECK_EQ(cols.errors[0].offset, 0u);
+    OTTER_CHECK_EQ(cols.errors[1].offset, text.find("e ++1"));
+}
+
+static void LineNumbersSpanChunks() {
+    IdentifierTable table;
+    BatchParser parser(table);
+    ValueColumns cols;
+    // 同一数据流按接收顺序分三块，第二块在行中间截断
+    const std::string stream = "s0 1\ns1 bad\n\ns3 3\ns4 4 extra\ns5 5\ns6 oops\ns7 7";
+    std::string pending;
+    for (const std::string& chunk : { stream.substr(0, 7), stream.substr(7, 20), stream.substr(27) }) {
+        pending += chunk;
+        pending.erase(0, parser.Parse(pending, cols).consumed);
+    }
+    parser.Parse(pending, cols, true);
+    OTTER_CHECK_EQ(parser.LineCount(), 8u);
+    OTTER_CHECK_EQ(cols.size(), 4u);
+    OTTER_CHECK_EQ(cols.errors.size(), 3u);
+    if (cols.errors.size() == 3) {
+        OTTER_CHECK_EQ(cols.errors[0].line, 1u);
+        OTTER_CHECK_EQ(cols.errors[1].line, 4u);
+        OTTER_CHECK(cols.errors[1].status == LineStatus::ExtraCharacters);
+        OTTER_CHECK_EQ(cols.errors[2].line, 6u);
+    }
+
+    // 逐字节接收时行号相同（覆盖SIMD扫描与标量尾部）
+    BatchParser bytewise(table);
+    ValueColumns byteCols;
+    pending.clear();
+    for (char c : stream) {
+        pending += c;
+        pending.erase(0, bytewise.Parse(pending, byteCols).consumed);
+    }
+    bytewise.Parse(pending, byteCols, true);
+    OTTER_CHECK_EQ(byteCols.errors.size(), cols.errors.size());
+    for (size_t i = 0; i < byteCols.errors.size() && i < cols.errors.size(); ++i) {
+        OTTER_CHECK_EQ(byteCols.errors[i].line, cols.errors[i].line);
+    }
+
+    parser.ResetLineCount();
+    cols.clear();
+    parser.Parse("x\n", cols);
+    OTTER_CHECK(cols.errors.size() == 1 && cols.errors[0].line == 0);
+    OTTER_CHECK_EQ(parser.LineCount(), 1u);
+}
+
+int main() {
+    OtterTest::Run("SignsAndErrors", SignsAndErrors);
+    OtterTest::Run("LineNumbersSpanChunks", LineNumbersSpanChunks);
+    return OtterTest::Finish();
+}
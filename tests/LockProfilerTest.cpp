@@ -0,0 +1,132 @@
+// LockProfilerTest.cpp
+// OtterProfile::ProfiledMutex：获取次数、竞争等待与持有时间的记录，同名锁共享统计，报告与百分位
+#define OTTER_LOCK_PROFILING
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "OtterTest.h"
+#include "../OtterLockProfiler.h"
+
+using namespace OtterProfile;
+
+static LockReport ReportOf(const std::string& name) {
+    for (const LockReport& r : GetLockReports()) {
+        if (r.name == name) return r;
+    }
+    return LockReport();
+}
+
+static uint64_t Sum(const std::vector<uint64_t>& buckets) {
+    uint64_t total = 0;
+    for (uint64_t c : buckets) total += c;
+    return total;
+}
+
+static void RecordsAcquisitions() {
+    static_assert(kLockProfilingEnabled, "OTTER_LOCK_PROFILING 应在包含前定义");
+    Mutex mutex("test::uncontended");
+    for (int i = 0; i < 100; ++i) {
+        std::lock_guard<Mutex> lock(mutex);
+    }
+    OTTER_CHECK(mutex.try_lock());
+    mutex.unlock();
+
+    const LockReport r = ReportOf("test::uncontended");
+    OTTER_CHECK_EQ(r.acquisitions, 101u);
+    OTTER_CHECK_EQ(r.contended, 0u);
+    OTTER_CHECK_EQ(Sum(r.waitBuckets), 101u);
+    OTTER_CHECK_EQ(Sum(r.holdBuckets), 101u);
+    OTTER_CHECK_EQ(r.maxWaitNs, 0u);
+
+    // 同名的锁共享一份统计
+    ProfiledMutex other("test::uncontended");
+    other.lock();
+    other.unlock();
+    OTTER_CHECK_EQ(ReportOf("test::uncontended").acquisitions, 102u);
+}
+
+static void RecordsContendedWaits() {
+    ProfiledMutex mutex("test::contended");
+    std::atomic<bool> held{ false };
+    std::thread owner([&] {
+        mutex.lock();
+        held = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        mutex.unlock();
+    });
+    while (!held) std::this_thread::yield();
+
+    // 持有期间其他线程 try_lock 失败且不计入获取次数
+    OTTER_CHECK(!mutex.try_lock());
+    const auto start = std::chrono::steady_clock::now();
+    mutex.lock();
+    const auto waited = std::chrono::steady_clock::now() - start;
+    mutex.unlock();
+    owner.join();
+
+    const LockReport r = ReportOf("test::contended");
+    OTTER_CHECK_EQ(r.acquisitions, 2u);
+    OTTER_CHECK_EQ(r.contended, 1u);
+    OTTER_CHECK(r.maxWaitNs >= 5000000u);               // 至少等待了持有者剩余的时间
+    OTTER_CHECK(r.maxWaitNs <= uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count()));
+    OTTER_CHECK(r.maxHoldNs >= 15000000u);
+    OTTER_CHECK(r.WaitPercentileNs(1.0) >= r.maxWaitNs);
+    OTTER_CHECK(r.HoldPercentileNs(0.99) >= 15000000u);
+}
+
+static void CountsEveryAcquisitionUnderLoad() {
+    ProfiledMutex mutex("test::load");
+    const int threads = 4, iterations = 2000;
+    int counter = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < iterations; ++i) {
+                std::lock_guard<ProfiledMutex> lock(mutex);
+                ++counter;
+            }
+        });
+    }
+    for (std::thread& w : workers) w.join();
+
+    const LockReport r = ReportOf("test::load");
+    OTTER_CHECK_EQ(counter, threads * iterations);
+    OTTER_CHECK_EQ(r.acquisitions, uint64_t(threads * iterations));
+    OTTER_CHECK(r.contended <= r.acquisitions);
+    OTTER_CHECK_EQ(Sum(r.waitBuckets), r.acquisitions);
+    OTTER_CHECK_EQ(Sum(r.holdBuckets), r.acquisitions);
+}
+
+static void ResetAndFormat() {
+    const std::string text = FormatLockReports(GetLockReports());
+    OTTER_CHECK(text.find("test::contended") != std::string::npos);
+    OTTER_CHECK(text.find("wait_p99_ns") != std::string::npos);
+
+    ResetLockReports();
+    const LockReport r = ReportOf("test::contended");
+    OTTER_CHECK_EQ(r.name, std::string("test::contended"));     // 重置只清零，不移除
+    OTTER_CHECK_EQ(r.acquisitions, 0u);
+    OTTER_CHECK_EQ(r.contended, 0u);
+    OTTER_CHECK_EQ(r.maxWaitNs, 0u);
+    OTTER_CHECK_EQ(Sum(r.holdBuckets), 0u);
+
+    // 分桶与百分位：[2^i, 2^(i+1)) 纳秒
+    OTTER_CHECK_EQ(LatencyHistogram::BucketOf(0), 0);
+    OTTER_CHECK_EQ(LatencyHistogram::BucketOf(1), 0);
+    OTTER_CHECK_EQ(LatencyHistogram::BucketOf(1024), 10);
+    OTTER_CHECK_EQ(LatencyHistogram::BucketOf(2047), 10);
+    const std::vector<uint64_t> buckets = { 0, 90, 0, 10 };
+    OTTER_CHECK_EQ(LockReport::Percentile(buckets, 0.5), 4u);
+    OTTER_CHECK_EQ(LockReport::Percentile(buckets, 0.95), 16u);
+    OTTER_CHECK_EQ(LockReport::Percentile({}, 0.5), 0u);
+}
+
+int main() {
+    OtterTest::Run("RecordsAcquisitions", RecordsAcquisitions);
+    OtterTest::Run("RecordsContendedWaits", RecordsContendedWaits);
+    OtterTest::Run("CountsEveryAcquisitionUnderLoad", CountsEveryAcquisitionUnderLoad);
+    OtterTest::Run("ResetAndFormat", ResetAndFormat);
+    return OtterTest::Finish();
+}
@@ -0,0 +1,44 @@
+#pragma once
+// OtterTest.h
+// 测试程序共用的最小断言工具：失败时打印文件、行号与表达式，main 以 OtterTest::Finish() 的返回值退出
+#include <cmath>
+#include <cstdio>
+
+namespace OtterTest {
+
+    inline int& Failures() {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline int& Checks() {
+        static int checks = 0;
+        return checks;
+    }
+
+    inline bool Check(bool ok, const char* expr, const char* file, int line) {
+        ++Checks();
+        if (!ok) {
+            ++Failures();
+            std::printf("%s:%d: 检查失败: %s\n", file, line, expr);
+        }
+        return ok;
+    }
+
+    // 依次运行测试函数并打印名称，便于定位失败所在的用例
+    template <typename F>
+    inline void Run(const char* name, F&& test) {
+        const int before = Failures();
+        test();
+        std::printf("[%s] %s\n", Failures() == before ? " OK " : "FAIL", name);
+    }
+
+    inline int Finish() {
+        std::printf("%d 项检查，%d 项失败\n", Checks(), Failures());
+        return Failures() == 0 ? 0 : 1;
+    }
+}
+
+#define OTTER_CHECK(expr) OtterTest::Check(static_cast<bool>(expr), #expr, __FILE__, __LINE__)
+#define OTTER_CHECK_EQ(a, b) OtterTest::Check((a) == (b), #a " == " #b, __FILE__, __LINE__)
+#define OTTER_CHECK_NEAR(a, b, eps) OtterTest::Check(std::fabs(double(a) - double(b)) <= double(eps), #a " ≈ " #b, __FILE__, __LINE__)
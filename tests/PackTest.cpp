@@ -0,0 +1,287 @@
+// PackTest.cpp
+// OtterPack：LZ4 块的往返（随机、重复、重叠匹配）与损坏数据的拒绝，资源包的生成、打开、查找与加载
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+#include "OtterTest.h"
+#include "../OtterAssetPack.h"
+
+using namespace OtterPack;
+
+static std::vector<uint8_t> RandomBytes(std::mt19937& rng, size_t size) {
+    std::vector<uint8_t> data(size);
+    for (uint8_t& b : data) b = uint8_t(rng());
+    return data;
+}
+
+static std::vector<uint8_t> CompressOf(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> packed;
+    Lz4::Compress(data.data(), data.size(), packed);
+    return packed;
+}
+
+static bool RoundTrips(const std::vector<uint8_t>& data) {
+    const std::vector<uint8_t> packed = CompressOf(data);
+    std::vector<uint8_t> out(data.size() + 1, 0xCD);
+    if (!Lz4::Decompress(packed.data(), packed.size(), out.data(), data.size())) return false;
+    if (out[data.size()] != 0xCD) return false;     // 不得写出 dstSize 之外
+    out.pop_back();
+    return out == data;
+}
+
+// 随机、整段重复、短周期（偏移小于匹配长度的重叠复制）与混合数据
+static std::vector<std::vector<uint8_t>> Samples(std::mt19937& rng) {
+    std::vector<std::vector<uint8_t>> samples;
+    for (size_t size : { 0, 1, 5, 12, 13, 17, 64, 1000, 70000 }) samples.push_back(RandomBytes(rng, size));
+
+    for (size_t size : { 13, 100, 4096, 100000 }) {
+        samples.emplace_back(size, uint8_t(0x5A));                  // 单字节游程：偏移1
+        std::vector<uint8_t> period(size);
+        for (size_t i = 0; i < size; ++i) period[i] = uint8_t("abc"[i % 3]);
+        samples.push_back(std::move(period));                       // 周期3
+    }
+
+    // 随机块整段重复，包含超过15+255的长匹配与长字面量
+    std::vector<uint8_t> block = RandomBytes(rng, 700);
+    std::vector<uint8_t> repeated;
+    for (int i = 0; i < 6; ++i) repeated.insert(repeated.end(), block.begin(), block.end());
+    samples.push_back(std::move(repeated));
+
+    // 类似图片：透明区域、渐变与噪声交替
+    std::vector<uint8_t> image;
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 256; ++x) {
+            uint8_t v = y % 3 == 0 ? 0 : y % 3 == 1 ? uint8_t(x) : uint8_t(rng());
+            image.insert(image.end(), { v, v, v, uint8_t(y % 3 == 0 ? 0 : 255) });
+        }
+    }
+    samples.push_back(std::move(image));
+
+    // 超过64KB窗口的重复：不能引用窗口之外的数据
+    std::vector<uint8_t> far = RandomBytes(rng, 70000);
+    far.insert(far.end(), far.begin(), far.begin() + 1000);
+    samples.push_back(std::move(far));
+    return samples;
+}
+
+static void Lz4RoundTrips() {
+    std::mt19937 rng(1234);
+    for (const std::vector<uint8_t>& data : Samples(rng)) {
+        if (!OTTER_CHECK(RoundTrips(data))) std::printf("  长度 %zu\n", data.size());
+    }
+
+    // 重复数据应明显变小，随机数据的膨胀有上限
+    std::vector<uint8_t> solid(65536, 7);
+    OTTER_CHECK(CompressOf(solid).size() < 512);
+    std::vector<uint8_t> noise = RandomBytes(rng, 65536);
+    OTTER_CHECK(CompressOf(noise).size() <= noise.size() + noise.size() / 255 + 16);
+
+    // 输出必须恰好 dstSize 字节
+    std::vector<uint8_t> data = RandomBytes(rng, 300);
+    std::vector<uint8_t> packed = CompressOf(data);
+    std::vector<uint8_t> out(data.size() + 1);
+    OTTER_CHECK(!Lz4::Decompress(packed.data(), packed.size(), out.data(), data.size() - 1));
+    OTTER_CHECK(!Lz4::Decompress(packed.data(), packed.size(), out.data(), data.size() + 1));
+}
+
+static void Lz4RejectsCorruptBlocks() {
+    std::mt19937 rng(99);
+
+    // 手工构造的非法块
+    uint8_t out[64];
+    const uint8_t zeroOffset[] = { 0x14, 'a', 0x00, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+    OTTER_CHECK(!Lz4::Decompress(zeroOffset, sizeof(zeroOffset), out, 10));
+    const uint8_t farOffset[] = { 0x14, 'a', 0x02, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+    OTTER_CHECK(!Lz4::Decompress(farOffset, sizeof(farOffset), out, 10));
+    const uint8_t longLiterals[] = { 0xF0, 0xFF, 0xFF };             // 长度字节在结尾中断
+    OTTER_CHECK(!Lz4::Decompress(longLiterals, sizeof(longLiterals), out, sizeof(out)));
+    const uint8_t tooLong[] = { 0x1F, 'a', 0x01, 0x00, 0xFF, 0x10 };   // 匹配超出输出容量
+    OTTER_CHECK(!Lz4::Decompress(tooLong, sizeof(tooLong), out, sizeof(out)));
+    const uint8_t missingOffset[] = { 0x14, 'a', 0x01 };
+    OTTER_CHECK(!Lz4::Decompress(missingOffset, sizeof(missingOffset), out, sizeof(out)));
+    const uint8_t valid[] = { 0x14, 'a', 0x01, 0x00, 0x50, 'b', 'b', 'b', 'b', 'b' };
+    OTTER_CHECK(Lz4::Decompress(valid, sizeof(valid), out, 14));
+    OTTER_CHECK(std::string(reinterpret_cast<char*>(out), 14) == "aaaaaaaaabbbbb");
+
+    std::vector<uint8_t> data;
+    for (const std::vector<uint8_t>& s : Samples(rng)) {
+        if (s.size() < 5000) data.insert(data.end(), s.begin(), s.end());
+    }
+    const std::vector<uint8_t> packed = CompressOf(data);
+
+    // 截断的块都不能得到完整输出
+    std::vector<uint8_t> buffer(data.size());
+    int truncatedOk = 0;
+    for (size_t n = 0; n < packed.size(); n += 1 + n / 64) {
+        truncatedOk += Lz4::Decompress(packed.data(), n, buffer.data(), buffer.size());
+    }
+    OTTER_CHECK_EQ(truncatedOk, 0);
+
+    // 随机翻转若干位：允许解出错误内容，但不能越界（输出缓冲区恰好 dstSize，配合 ASan 检查）
+    for (int round = 0; round < 3000; ++round) {
+        std::vector<uint8_t> corrupt = packed;
+        const int flips = 1 + int(rng() % 4);
+        for (int i = 0; i < flips; ++i) corrupt[rng() % corrupt.size()] ^= uint8_t(1u << (rng() % 8));
+        std::vector<uint8_t> exact(data.size());
+        Lz4::Decompress(corrupt.data(), corrupt.size(), exact.data(), exact.size());
+    }
+
+    // 完全随机的输入
+    for (int round = 0; round < 500; ++round) {
+        std::vector<uint8_t> junk = RandomBytes(rng, 1 + rng() % 200);
+        std::vector<uint8_t> exact(1 + rng() % 400);
+        Lz4::Decompress(junk.data(), junk.size(), exact.data(), exact.size());
+    }
+}
+
+static OtterRaster::Surface MakeSurface(int width, int height, uint32_t seed, bool noise) {
+    OtterRaster::Surface s(width, height);
+    std::mt19937 rng(seed);
+    for (int y = 0; y < height; ++y) {
+        uint32_t* row = s.Row(y);
+        for (int x = 0; x < width; ++x) row[x] = noise ? uint32_t(rng()) | 0xFF000000u : (x / 8 % 2 ? 0xFF336699u : 0u);
+    }
+    return s;
+}
+
+static bool SamePixels(const OtterRaster::Surface& a, const OtterRaster::Surface& b) {
+    if (a.Width() != b.Width() || a.Height() != b.Height()) return false;
+    for (int y = 0; y < a.Height(); ++y) {
+        if (std::memcmp(a.Row(y), b.Row(y), size_t(a.Width()) * 4) != 0) return false;
+    }
+    return true;
+}
+
+static void PackBuildOpenFindLoad() {
+    const OtterRaster::Surface noise = MakeSurface(48, 11, 1, true);
+    const OtterRaster::Surface stripes = MakeSurface(200, 50, 2, false);
+    const OtterRaster::Surface first = MakeSurface(3, 3, 3, true);
+    const OtterRaster::Surface second = MakeSurface(5, 4, 4, true);
+
+    AssetPackWriter writer;
+    OTTER_CHECK(writer.Add("noise", noise, true));        // 压不小，保持未压缩
+    OTTER_CHECK(writer.Add("stripes", stripes, true));    // 以LZ4存储
+    OTTER_CHECK(writer.Add("dup", first));
+    OTTER_CHECK(writer.Add("dup", second));                // 同名只保留最后一次
+    OTTER_CHECK(writer.Add("图标/中文", first));
+    OTTER_CHECK(!writer.Add("empty", OtterRaster::Surface()));
+    OTTER_CHECK(!writer.Add("empty", OtterRaster::Surface(0, 8)));
+    OTTER_CHECK_EQ(writer.Count(), 5u);
+
+    const std::vector<uint8_t> file = writer.Build();
+    OTTER_CHECK_EQ(file.size() % kDataAlign, 0u);
+    AssetPack pack;
+    OTTER_CHECK(pack.OpenMemory(file.data(), file.size()));
+    OTTER_CHECK_EQ(pack.Count(), 4u);
+    OTTER_CHECK_EQ(pack.ByteSize(), file.size());
+
+    AssetPack::Entry entry;
+    OtterRaster::Surface loaded;
+    OTTER_CHECK(pack.Find("noise", entry));
+    OTTER_CHECK(entry.compression == Compression::None);
+    OTTER_CHECK(pack.Load(entry, loaded) && SamePixels(loaded, noise));
+    OTTER_CHECK(!loaded.OwnsPixels());                      // 直接包装包内存
+    OTTER_CHECK(loaded.Data() >= file.data() && loaded.Data() < file.data() + file.size());
+
+    OTTER_CHECK(pack.Find("stripes", entry));
+    OTTER_CHECK(entry.compression == Compression::Lz4);
+    OTTER_CHECK(entry.storedSize < entry.rawSize);
+    OTTER_CHECK(pack.Load(entry, loaded) && SamePixels(loaded, stripes));
+    OTTER_CHECK(loaded.OwnsPixels());
+
+    OTTER_CHECK(pack.Find("dup", entry));
+    OTTER_CHECK(pack.Load(entry, loaded) && SamePixels(loaded, second));
+    OTTER_CHECK(pack.Find("图标/中文", entry));
+    OTTER_CHECK(pack.Load(entry, loaded) && SamePixels(loaded, first));
+    OTTER_CHECK(!pack.Find("missing", entry));
+    OTTER_CHECK(!pack.Find("empty", entry));
+    OTTER_CHECK(!pack.Find("dup ", entry));
+
+    // 按下标遍历得到全部键
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < pack.Count(); ++i) keys.push_back(pack.At(i).key);
+    std::sort(keys.begin(), keys.end());
+    const std::vector<std::string> expected = { "dup", "noise", "stripes", "图标/中文" };
+    OTTER_CHECK(keys == expected);
+
+    // 空包同样可以打开
+    const std::vector<uint8_t> emptyFile = AssetPackWriter().Build();
+    OTTER_CHECK(pack.OpenMemory(emptyFile.data(), emptyFile.size()));
+    OTTER_CHECK_EQ(pack.Count(), 0u);
+
+    // 写出文件后映射打开；Backing 持有映射，关闭 AssetPack 后包装的像素仍可读
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "otter_pack_test.otpk";
+    OTTER_CHECK(writer.Write(path.native()));
+    {
+        AssetPack mapped;
+        OTTER_CHECK(mapped.Open(path.native()));
+        OTTER_CHECK(mapped.Find("noise", entry) && mapped.Load(entry, loaded));
+        std::shared_ptr<const void> backing = mapped.Backing();
+        mapped.Reset();
+        OTTER_CHECK(backing != nullptr && SamePixels(loaded, noise));
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+static void PackRejectsCorruptFiles() {
+    AssetPackWriter writer;
+    writer.Add("a", MakeSurface(20, 20, 5, true));
+    writer.Add("b", MakeSurface(64, 64, 6, false), true);
+    const std::vector<uint8_t> file = writer.Build();
+
+    AssetPack pack;
+    OTTER_CHECK(!pack.OpenMemory(nullptr, 0));
+    OTTER_CHECK(!pack.OpenMemory(file.data(), sizeof(Header) - 1));
+    OTTER_CHECK(!pack.OpenMemory(file.data(), file.size() - 1));        // fileSize 超出
+
+    std::vector<uint8_t> bad = file;
+    bad[0] ^= 1;                                                         // magic
+    OTTER_CHECK(!pack.OpenMemory(bad.data(), bad.size()));
+    OTTER_CHECK(!pack.IsOpen());
+
+    // 索引中宽度为0的条目使整个包无法打开
+    bad = file;
+    IndexEntry e;
+    std::memcpy(&e, bad.data() + sizeof(Header), sizeof(e));
+    e.width = 0;
+    std::memcpy(bad.data() + sizeof(Header), &e, sizeof(e));
+    OTTER_CHECK(!pack.OpenMemory(bad.data(), bad.size()));
+
+    // 随机翻转：打开成功时，全部条目的查找与加载都不能越界
+    std::mt19937 rng(7);
+    int opened = 0;
+    for (int round = 0; round < 2000; ++round) {
+        bad = file;
+        const int flips = 1 + int(rng() % 3);
+        for (int i = 0; i < flips; ++i) {
+            // 一半的翻转落在头部与索引，否则很少命中
+            const size_t limit = rng() % 2 ? sizeof(Header) + 2 * sizeof(IndexEntry) : bad.size();
+            bad[rng() % limit] ^= uint8_t(1u << (rng() % 8));
+        }
+        if (!pack.OpenMemory(bad.data(), bad.size())) continue;
+        ++opened;
+        for (size_t i = 0; i < pack.Count(); ++i) {
+            AssetPack::Entry entry = pack.At(i);
+            OtterRaster::Surface loaded;
+            if (pack.Load(entry, loaded)) {
+                OTTER_CHECK(loaded.Width() == entry.width && loaded.Height() == entry.height);
+            }
+            pack.Find(entry.key, entry);
+        }
+    }
+    OTTER_CHECK(opened > 0);
+}
+
+int main() {
+    OtterTest::Run("Lz4RoundTrips", Lz4RoundTrips);
+    OtterTest::Run("Lz4RejectsCorruptBlocks", Lz4RejectsCorruptBlocks);
+    OtterTest::Run("PackBuildOpenFindLoad", PackBuildOpenFindLoad);
+    OtterTest::Run("PackRejectsCorruptFiles", PackRejectsCorruptFiles);
+    return OtterTest::Finish();
+}
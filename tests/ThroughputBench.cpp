@@ -0,0 +1,48 @@
+// ThroughputBench.cpp
+// 图元吞吐量基准：运行 BenchmarkThroughput 并与基准JSON比较，任一图元下降超过 --max-drop 时退出码为1
+// 用法: OtterThroughputBench [基准JSON] [--max-drop 0.15] [--seconds 0.2] [--write <输出JSON>]
+// 基准与机器相关，tests/throughput_baseline.json 只作为参考；在目标机器上用 --write 重新生成
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "../OtterGolden.h"
+
+namespace G = OtterRaster::Golden;
+
+int main(int argc, char** argv) {
+    std::string baselinePath, writePath;
+    double maxDrop = 0.15, seconds = 0.2;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max-drop") == 0 && i + 1 < argc) maxDrop = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--write") == 0 && i + 1 < argc) writePath = argv[++i];
+        else baselinePath = argv[i];
+    }
+
+    const std::vector<G::Throughput> perf = G::BenchmarkThroughput(1280, 720, seconds);
+    for (const G::Throughput& t : perf) {
+        std::printf("%-22s %12.0f ops/s %10.1f Mpix/s\n", t.name.c_str(), t.opsPerSec, t.mpixPerSec);
+    }
+    if (!writePath.empty()) std::ofstream(writePath, std::ios::binary) << G::ThroughputJson(perf);
+    if (baselinePath.empty()) return 0;
+
+    std::ifstream in(baselinePath, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::vector<G::ThroughputDelta> deltas;
+    if (!in || !G::CompareThroughput(buffer.str(), perf, maxDrop, deltas)) {
+        std::printf("无法读取基准 %s\n", baselinePath.c_str());
+        return 1;
+    }
+    int regressed = 0;
+    for (const G::ThroughputDelta& d : deltas) {
+        if (!d.regressed) continue;
+        ++regressed;
+        std::printf("性能回退: %s %.0f -> %.0f ops/s (%.0f%%)\n", d.name.c_str(), d.baselineOpsPerSec,
+            d.currentOpsPerSec, d.ratio * 100.0);
+    }
+    std::printf("%d/%zu 项图元下降超过 %.0f%%\n", regressed, deltas.size(), maxDrop * 100.0);
+    return regressed == 0 ? 0 : 1;
+}